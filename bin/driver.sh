@@ -14,7 +14,7 @@ function verbose () {
 }
 
 function usage () {
-    echo "Usage: ${PACKAGE_NAME} [Help] [Debug] [Optimize...] [Preprocess] [Link] [Include...] [Linkdir...] [Linklib...] [Output] FILES"
+    echo "Usage: ${PACKAGE_NAME} [Help] [Debug] [Optimize...] [Jobs] [Preprocess] [Link] [Assemble] [Depend...] [Cache...] [Server] [Report...] [Include...] [Linkdir...] [Linklib...] [Output] FILES"
     echo ""
     echo "[Help]:"
     echo "    --help  print help and exit"
@@ -37,23 +37,59 @@ function usage () {
     echo "    --propagate-copies            enable   copy propagation"
     echo "    --eliminate-unreachable-code  enable   unreachable code elimination"
     echo "    --eliminate-dead-stores       enable   dead store elimination"
+    echo "    --eliminate-tail-calls        enable   tail call elimination"
+    echo "    --layout-blocks               enable   block layout"
+    echo "    --eliminate-redundant-loads   enable   redundant load elimination"
+    echo "    --unroll-loops                enable   loop unrolling"
+    echo "    --unroll-factor=<factor>      unroll   loops with an unknown trip count <factor> times (default: 4)"
     echo "    --optimize                    enable   all level 1 optimizations"
     echo "    -O1                           alias    for --optimize"
     echo "    (Level 2):"
     echo "    --no-allocation               disable  register allocation"
     echo "    --no-coalescing               disable  register coalescing"
+    echo "    --omit-frame-pointer          enable   frame pointer omission"
+    echo "    --no-plt                      disable  procedure linkage table calls"
     echo "    --allocate-register           enable   register allocation (default)"
     echo "    -O2                           alias    for --allocate-register"
     echo "    (Level 3):"
     echo "    -O3                           alias    for -O1 -O2"
     echo ""
+    echo "[Jobs]:"
+    echo "    -j<jobs>  optimize and generate the functions of a file on <jobs> threads (default: 1)"
+    echo "    -j        optimize and generate the functions of a file on all cores"
+    echo ""
     echo "[Preprocess]:"
-    echo "    -E  enable macro expansion with gcc"
+    echo "    -E  enable macro expansion"
     echo ""
     echo "[Link]:"
     echo "    -s  compile, but do not assemble and link"
     echo "    -c  compile and assemble, but do not link"
     echo ""
+    echo "[Assemble]:"
+    echo "    --no-integrated-as  assemble with gcc instead of writing object files directly"
+    echo ""
+    echo "[Depend...]:"
+    echo "    -MD         write a makefile rule of the included headers to <file>.d"
+    echo "    -MF <file>  write the rule into <file>, implies -MD (single file only)"
+    echo ""
+    echo "[Cache...]:"
+    echo "    --header-cache=<cachedir>   cache lexed header files in <cachedir>"
+    echo "                                (default: \${WHEELCC_HEADER_CACHE_DIR} if set)"
+    echo "    --compile-cache=<cachedir>  cache compiled output files in <cachedir>"
+    echo "                                (default: \${WHEELCC_COMPILE_CACHE_DIR} if set)"
+    echo "    --compile-cache-size=<MiB>  evict least recently used entries above <MiB> (default: 512)"
+    echo ""
+    echo "[Server]:"
+    echo "    --server=<socket>  compile through a warm compiler server listening on <socket>,"
+    echo "                       and start it if it is not running"
+    echo "                       (default: \${WHEELCC_SERVER_SOCKET} if set, without starting it)"
+    echo ""
+    echo "[Report...]:"
+    echo "    --time-report       print time, memory and ir size of each phase as a table"
+    echo "    --time-report=json  print time, memory and ir size of each phase as json"
+    echo "    --trace=<file>      write a chrome trace of the compiler internals to <file>"
+    echo "    --stats             print optimization and stack fix counters as json"
+    echo ""
     echo "[Include...]:"
     echo "    -I<includedir>  add a list of paths to include path"
     echo ""
@@ -165,6 +201,8 @@ function parse_optimize_arg () {
         "-O0")
             OPTIM_L1_MASK=0
             OPTIM_L2_ENUM=0
+            IS_OMIT_FRAME_POINTER=0
+            IS_NO_PLT=0
             ;;
         "--fold-constants")
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 0))
@@ -178,12 +216,34 @@ function parse_optimize_arg () {
         "--eliminate-dead-stores")
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 3))
             ;;
+        "--eliminate-tail-calls")
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 4))
+            ;;
+        "--layout-blocks")
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 5))
+            ;;
+        "--eliminate-redundant-loads")
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 6))
+            ;;
+        "--unroll-loops")
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 7))
+            ;;
+        "--unroll-factor="*)
+            UNROLL_FACTOR="${ARG#*=}"
+            if [[ ! "${UNROLL_FACTOR}" =~ ^[1-9][0-9]*$ ]] || [ ${UNROLL_FACTOR} -gt 16 ]; then
+                raise_error "invalid unroll factor $(em "${UNROLL_FACTOR}")"
+            fi
+            ;;
         "--optimize") ;&
         "-O1")
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 0))
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 1))
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 2))
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 3))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 4))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 5))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 6))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 7))
             ;;
         "--no-allocation")
             OPTIM_L2_ENUM=0
@@ -191,6 +251,12 @@ function parse_optimize_arg () {
         "--no-coalescing")
             OPTIM_L2_ENUM=1
             ;;
+        "--omit-frame-pointer")
+            IS_OMIT_FRAME_POINTER=1
+            ;;
+        "--no-plt")
+            IS_NO_PLT=1
+            ;;
         "--allocate-register") ;&
         "-O2")
             OPTIM_L2_ENUM=2
@@ -200,6 +266,10 @@ function parse_optimize_arg () {
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 1))
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 2))
             OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 3))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 4))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 5))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 6))
+            OPTIM_L1_MASK=$((OPTIM_L1_MASK | 1 << 7))
             OPTIM_L2_ENUM=2
             ;;
         *)
@@ -208,6 +278,19 @@ function parse_optimize_arg () {
     return 0
 }
 
+function parse_jobs_arg () {
+    if [[ "${ARG}" != "-j"* ]]; then
+        return 1
+    fi
+    JOBS="${ARG:2}"
+    if [ -z "${JOBS}" ]; then
+        JOBS="$(nproc)"
+    elif [[ ! "${JOBS}" =~ ^[1-9][0-9]*$ ]]; then
+        raise_error "invalid number of jobs $(em "${JOBS}")"
+    fi
+    return 0
+}
+
 function parse_preproc_arg () {
     if [ ! "${ARG}" = "-E" ]; then
         return 1
@@ -230,6 +313,110 @@ function parse_link_arg () {
     return 0
 }
 
+function parse_assemble_arg () {
+    if [ "${ARG}" = "--no-integrated-as" ]; then
+        IS_INTEGRATED_AS=0
+    else
+        return 1
+    fi
+    return 0
+}
+
+function parse_depend_arg () {
+    case "${ARG}" in
+        "-MD")
+            IS_DEPEND=1
+            ;;
+        "-MF")
+            shift_arg
+            if [ ${?} -ne 0 ]; then
+                raise_error "no input files"
+            elif [[ "${ARG}" == *".${EXT_IN}" ]]; then
+                raise_error "missing filename after $(em "-MF")"
+            fi
+            IS_DEPEND=1
+            DEPEND_FILE="$(readlink -f ${ARG})"
+            ;;
+        *)
+            return 1
+    esac
+    return 0
+}
+
+function parse_cachedir_arg () {
+    if [ -z "${ARG}" ]; then
+        raise_error "missing directory after $(em "${1}")"
+    fi
+    mkdir -p ${ARG}
+    if [ ${?} -ne 0 ]; then
+        raise_error "cannot create $(em "${ARG}"): no such directory"
+    fi
+    ARG="$(readlink -f ${ARG})/"
+    return 0
+}
+
+function parse_cache_arg () {
+    case "${ARG}" in
+        "--header-cache="*)
+            ARG="${ARG:15}"
+            parse_cachedir_arg "--header-cache="
+            export WHEELCC_HEADER_CACHE_DIR="${ARG}"
+            ;;
+        "--compile-cache="*)
+            ARG="${ARG:16}"
+            parse_cachedir_arg "--compile-cache="
+            export WHEELCC_COMPILE_CACHE_DIR="${ARG}"
+            ;;
+        "--compile-cache-size="*)
+            ARG="${ARG:21}"
+            if [[ ! "${ARG}" =~ ^[0-9]+$ ]]; then
+                raise_error "invalid size $(em "${ARG}") after $(em "--compile-cache-size=")"
+            fi
+            export WHEELCC_COMPILE_CACHE_SIZE="${ARG}"
+            ;;
+        *)
+            return 1
+    esac
+    return 0
+}
+
+function parse_server_arg () {
+    if [[ "${ARG}" != "--server="* ]]; then
+        return 1
+    fi
+    ARG="${ARG:9}"
+    if [ -z "${ARG}" ]; then
+        raise_error "missing socket after $(em "--server=")"
+    fi
+    export WHEELCC_SERVER_SOCKET="$(readlink -f ${ARG})"
+    IS_SERVER=1
+    return 0
+}
+
+function parse_report_arg () {
+    case "${ARG}" in
+        "--time-report")
+            TIME_REPORT="table"
+            ;;
+        "--time-report=json")
+            TIME_REPORT="json"
+            ;;
+        "--trace="*)
+            ARG="${ARG:8}"
+            if [ -z "${ARG}" ]; then
+                raise_error "missing filename after $(em "--trace=")"
+            fi
+            TRACE_FILE="$(readlink -f ${ARG})"
+            ;;
+        "--stats")
+            IS_STATS=1
+            ;;
+        *)
+            return 1
+    esac
+    return 0
+}
+
 function parse_include_arg () {
     if [[ "${ARG}" != "-I"* ]]; then
         return 1
@@ -356,6 +543,14 @@ function parse_args () {
         fi
     done
 
+    parse_jobs_arg
+    if [ ${?} -eq 0 ]; then
+        shift_arg
+        if [ ${?} -ne 0 ]; then
+            raise_error "no input files"
+        fi
+    fi
+
     parse_preproc_arg
     if [ ${?} -eq 0 ]; then
         shift_arg
@@ -372,6 +567,58 @@ function parse_args () {
         fi
     fi
 
+    parse_assemble_arg
+    if [ ${?} -eq 0 ]; then
+        shift_arg
+        if [ ${?} -ne 0 ]; then
+            raise_error "no input files"
+        fi
+    fi
+
+    while :; do
+        parse_depend_arg
+        if [ ${?} -eq 0 ]; then
+            shift_arg
+            if [ ${?} -ne 0 ]; then
+                raise_error "no input files"
+            fi
+        else
+            break
+        fi
+    done
+
+    while :; do
+        parse_cache_arg
+        if [ ${?} -eq 0 ]; then
+            shift_arg
+            if [ ${?} -ne 0 ]; then
+                raise_error "no input files"
+            fi
+        else
+            break
+        fi
+    done
+
+    parse_server_arg
+    if [ ${?} -eq 0 ]; then
+        shift_arg
+        if [ ${?} -ne 0 ]; then
+            raise_error "no input files"
+        fi
+    fi
+
+    while :; do
+        parse_report_arg
+        if [ ${?} -eq 0 ]; then
+            shift_arg
+            if [ ${?} -ne 0 ]; then
+                raise_error "no input files"
+            fi
+        else
+            break
+        fi
+    done
+
     while :; do
         parse_include_arg
         if [ ${?} -eq 0 ]; then
@@ -448,23 +695,135 @@ function add_linklibs () {
     return 0
 }
 
+function omit_frame_pointer () {
+    if [ ${IS_OMIT_FRAME_POINTER} -eq 1 ]; then
+        export WHEELCC_OMIT_FRAME_POINTER=1
+    else
+        unset WHEELCC_OMIT_FRAME_POINTER
+    fi
+    return 0
+}
+
+function no_plt () {
+    if [ ${IS_NO_PLT} -eq 1 ]; then
+        export WHEELCC_NO_PLT=1
+    else
+        unset WHEELCC_NO_PLT
+    fi
+    return 0
+}
+
+function unroll_factor () {
+    if [ ${UNROLL_FACTOR} -gt 0 ]; then
+        export WHEELCC_UNROLL_FACTOR=${UNROLL_FACTOR}
+    else
+        unset WHEELCC_UNROLL_FACTOR
+    fi
+    return 0
+}
+
+function jobs () {
+    if [ ${JOBS} -gt 1 ]; then
+        export WHEELCC_JOBS=${JOBS}
+    else
+        unset WHEELCC_JOBS
+    fi
+    return 0
+}
+
+function report () {
+    if [ ! -z "${TIME_REPORT}" ]; then
+        export WHEELCC_TIME_REPORT="${TIME_REPORT}"
+    else
+        unset WHEELCC_TIME_REPORT
+    fi
+    if [ ! -z "${TRACE_FILE}" ]; then
+        export WHEELCC_TRACE_FILE="${TRACE_FILE}"
+    else
+        unset WHEELCC_TRACE_FILE
+    fi
+    if [ ${IS_STATS} -eq 1 ]; then
+        export WHEELCC_STATS=1
+    else
+        unset WHEELCC_STATS
+    fi
+    return 0
+}
+
 function preprocess () {
     if [ ${IS_PREPROC} -eq 1 ]; then
-        for FILE in ${FILES}; do
-            verbose "Preprocess -> ${FILE}.i"
-            ${CC} -E -P ${FILE}.c -o ${FILE}.i
-            if [ ${?} -ne 0 ]; then
-                raise_error "preprocessing failed"
+        export WHEELCC_PREPROCESS=1
+    else
+        unset WHEELCC_PREPROCESS
+    fi
+    return 0
+}
+
+# Object files are written by the compiler, unless the assembly is the output or is printed for debugging.
+function integrated_assemble () {
+    if [ ${IS_INTEGRATED_AS} -eq 1 ] && [ ${LINK_ENUM} -ne 1 ] && [ ${DEBUG_ENUM} -le 127 ]; then
+        export WHEELCC_OBJECT=1
+        EXT_OBJ="o"
+    else
+        unset WHEELCC_OBJECT
+        EXT_OBJ="${EXT_OUT}"
+    fi
+    return 0
+}
+
+# The rule target is the file produced from each source: the executable, the assembly or the object file.
+function depend () {
+    if [ ${IS_DEPEND} -eq 1 ]; then
+        if [ ! -z "${DEPEND_FILE}" ] && [ ${IS_FILE_2} -eq 1 ]; then
+            raise_error "cannot specify $(em "-MF") with multiple files"
+        fi
+    else
+        unset WHEELCC_DEPEND_FILE
+        unset WHEELCC_DEPEND_TARGET
+    fi
+    return 0
+}
+
+function depend_file () {
+    if [ ${IS_DEPEND} -eq 1 ]; then
+        if [ -z "${DEPEND_FILE}" ]; then
+            export WHEELCC_DEPEND_FILE="${FILE}.d"
+        else
+            export WHEELCC_DEPEND_FILE="${DEPEND_FILE}"
+        fi
+        case ${LINK_ENUM} in
+            0)
+                export WHEELCC_DEPEND_TARGET="${NAME_OUT}"
+                ;;
+            1)
+                export WHEELCC_DEPEND_TARGET="${FILE}.${EXT_OUT}"
+                ;;
+            *)
+                export WHEELCC_DEPEND_TARGET="${FILE}.o"
+        esac
+    fi
+    return 0
+}
+
+# The server exits by itself after some idle time, so it is started again on demand.
+function start_server () {
+    if [ ${IS_SERVER} -eq 1 ] && [ ! -S "${WHEELCC_SERVER_SOCKET}" ]; then
+        setsid ${PACKAGE_DIR}/${PACKAGE_NAME} --server ${WHEELCC_SERVER_SOCKET} > /dev/null 2>&1 < /dev/null &
+        for i in $(seq 1 100); do
+            if [ -S "${WHEELCC_SERVER_SOCKET}" ]; then
+                break
             fi
+            sleep 0.01
         done
-        EXT_IN="i"
+        verbose "Server     -> ${WHEELCC_SERVER_SOCKET}"
     fi
     return 0
 }
 
 function compile () {
     for FILE in ${FILES}; do
-        verbose "Compile    -> ${FILE}.${EXT_OUT}"
+        verbose "Compile    -> ${FILE}.${EXT_OBJ}"
+        depend_file
         SOURCE_DIR="$(dirname ${FILE})/"
         echo "${INCLUDE_DIRS}" | grep -q ${SOURCE_DIR}
         if [ ${?} -eq 0 ]; then
@@ -489,10 +848,10 @@ function link () {
     if [ ${DEBUG_ENUM} -le 127 ]; then
         case ${LINK_ENUM} in
             0)
-                FILES_OUT="${FILES}.${EXT_OUT}"
+                FILES_OUT="${FILES}.${EXT_OBJ}"
                 if [ ${IS_FILE_2} -eq 1 ]; then
                     FILES_OUT="$(echo "${FILES_OUT}" |\
-                        sed "s/ /.${EXT_OUT} /g")"
+                        sed "s/ /.${EXT_OBJ} /g")"
                 fi
                 ${CC} ${FILES_OUT} ${LINK_DIRS} ${LINK_LIBS} -o ${NAME_OUT}
                 if [ ${?} -ne 0 ]; then
@@ -503,6 +862,9 @@ function link () {
             1)
                 ;;
             2)
+                if [ "${EXT_OBJ}" = "o" ]; then
+                    return 0
+                fi
                 for FILE in ${FILES}; do
                     ${CC} -c ${FILE}.${EXT_OUT} ${LINK_DIRS} ${LINK_LIBS} -o ${FILE}.o
                     if [ ${?} -ne 0 ]; then
@@ -520,6 +882,10 @@ function link () {
 
 IS_VERBOSE=0
 IS_PREPROC=0
+IS_INTEGRATED_AS=1
+IS_DEPEND=0
+IS_SERVER=0
+IS_STATS=0
 IS_FILE_2=0
 
 DEBUG_ENUM=0
@@ -527,22 +893,38 @@ LINK_ENUM=0
 
 OPTIM_L1_MASK=0
 OPTIM_L2_ENUM=2
+IS_OMIT_FRAME_POINTER=0
+IS_NO_PLT=0
+UNROLL_FACTOR=0
+JOBS=1
 
 INCLUDE_DIRS=""
 LINK_DIRS=""
 LINK_LIBS=""
 NAME_OUT=""
+DEPEND_FILE=""
+TIME_REPORT=""
+TRACE_FILE=""
 FILES=""
 
 EXT_IN="c"
 EXT_OUT="s"
+EXT_OBJ="s"
 
 parse_args
 add_includedirs
 add_linkdirs
 add_linklibs
 
+omit_frame_pointer
+no_plt
+unroll_factor
+jobs
+report
 preprocess
+integrated_assemble
+depend
+start_server
 compile
 link
 
@@ -206,6 +206,7 @@ enum AST_T {
     TacUnary_t,
     TacBinary_t,
     TacCopy_t,
+    TacSelect_t,
     TacGetAddress_t,
     TacLoad_t,
     TacStore_t,
@@ -284,6 +285,7 @@ enum AST_T {
     AsmMov_t,
     AsmMovSx_t,
     AsmMovZeroExtend_t,
+    AsmMovdqu_t,
     AsmLea_t,
     AsmCvttsd2si_t,
     AsmCvtsi2sd_t,
@@ -293,12 +295,15 @@ enum AST_T {
     AsmIdiv_t,
     AsmDiv_t,
     AsmCdq_t,
+    AsmRepMovsb_t,
     AsmJmp_t,
     AsmJmpCC_t,
     AsmSetCC_t,
+    AsmCmov_t,
     AsmLabel_t,
     AsmPush_t,
     AsmCall_t,
+    AsmTailCall_t,
     AsmRet_t,
     AsmTopLevel_t,
     AsmFunction_t,
@@ -308,10 +313,15 @@ enum AST_T {
 };
 
 struct Ast {
+    Ast();
+    Ast(const Ast&);
     virtual ~Ast() = 0;
     virtual AST_T type() = 0;
 };
 
+void fold_ast_node_count();
+size_t get_ast_node_count();
+
 using TIdentifier = std::string;
 using TChar = int8_t;
 using TInt = int32_t;
@@ -342,6 +342,7 @@ struct AsmShr : AsmUnaryOp {
 // instruction = Mov(assembly_type, operand, operand)
 //             | MovSx(assembly_type, assembly_type, operand, operand)
 //             | MovZeroExtend(assembly_type, assembly_type, operand, operand)
+//             | Movdqu(operand, operand)
 //             | Lea(operand, operand)
 //             | Cvttsd2si(assembly_type, operand, operand)
 //             | Cvtsi2sd(assembly_type, operand, operand)
@@ -351,12 +352,15 @@ struct AsmShr : AsmUnaryOp {
 //             | Idiv(assembly_type, operand)
 //             | Div(assembly_type, operand)
 //             | Cdq(assembly_type)
+//             | RepMovsb
 //             | Jmp(identifier)
 //             | JmpCC(cond_code, identifier)
 //             | SetCC(cond_code, operand)
+//             | Cmov(cond_code, assembly_type, operand, operand)
 //             | Label(identifier)
 //             | Push(operand)
 //             | Call(identifier)
+//             | TailCall(identifier)
 //             | Ret
 struct AsmInstruction : Ast {
     AST_T type() override;
@@ -397,6 +401,15 @@ struct AsmMovZeroExtend : AsmInstruction {
     std::shared_ptr<AsmOperand> dst;
 };
 
+struct AsmMovdqu : AsmInstruction {
+    AST_T type() override;
+    AsmMovdqu() = default;
+    AsmMovdqu(std::shared_ptr<AsmOperand> src, std::shared_ptr<AsmOperand> dst);
+
+    std::shared_ptr<AsmOperand> src;
+    std::shared_ptr<AsmOperand> dst;
+};
+
 struct AsmLea : AsmInstruction {
     AST_T type() override;
     AsmLea() = default;
@@ -488,6 +501,10 @@ struct AsmCdq : AsmInstruction {
     std::shared_ptr<AssemblyType> assembly_type;
 };
 
+struct AsmRepMovsb : AsmInstruction {
+    AST_T type() override;
+};
+
 struct AsmJmp : AsmInstruction {
     AST_T type() override;
     AsmJmp() = default;
@@ -514,6 +531,18 @@ struct AsmSetCC : AsmInstruction {
     std::shared_ptr<AsmOperand> dst;
 };
 
+struct AsmCmov : AsmInstruction {
+    AST_T type() override;
+    AsmCmov() = default;
+    AsmCmov(std::unique_ptr<AsmCondCode> cond_code, std::shared_ptr<AssemblyType> assembly_type,
+        std::shared_ptr<AsmOperand> src, std::shared_ptr<AsmOperand> dst);
+
+    std::unique_ptr<AsmCondCode> cond_code;
+    std::shared_ptr<AssemblyType> assembly_type;
+    std::shared_ptr<AsmOperand> src;
+    std::shared_ptr<AsmOperand> dst;
+};
+
 struct AsmLabel : AsmInstruction {
     AST_T type() override;
     AsmLabel() = default;
@@ -538,13 +567,21 @@ struct AsmCall : AsmInstruction {
     TIdentifier name;
 };
 
+struct AsmTailCall : AsmInstruction {
+    AST_T type() override;
+    AsmTailCall() = default;
+    AsmTailCall(TIdentifier name);
+
+    TIdentifier name;
+};
+
 struct AsmRet : AsmInstruction {
     AST_T type() override;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-// top_level = Function(identifier, bool, bool, instruction*)
+// top_level = Function(identifier, bool, bool, bool, instruction*)
 //           | StaticVariable(identifier, bool, int, static_init*)
 //           | StaticConstant(identifier, int, static_init)
 struct AsmTopLevel : Ast {
@@ -554,12 +591,13 @@ struct AsmTopLevel : Ast {
 struct AsmFunction : AsmTopLevel {
     AST_T type() override;
     AsmFunction() = default;
-    AsmFunction(TIdentifier name, bool is_global, bool is_return_memory,
+    AsmFunction(TIdentifier name, bool is_global, bool is_return_memory, bool is_frame_pointer,
         std::vector<std::unique_ptr<AsmInstruction>> instructions);
 
     TIdentifier name;
     bool is_global;
     bool is_return_memory;
+    bool is_frame_pointer;
     std::vector<std::unique_ptr<AsmInstruction>> instructions;
 };
 
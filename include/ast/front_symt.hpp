@@ -29,6 +29,10 @@
 //      | Structure(identifier, bool)
 struct Type : Ast {
     AST_T type() override;
+    Type();
+
+    TLong scale;
+    TInt alignment;
 };
 
 struct Char : Type {
@@ -323,6 +327,8 @@ struct FrontEndContext {
     std::unordered_map<TIdentifier, std::unique_ptr<Symbol>> symbol_table;
     std::unordered_map<TIdentifier, TIdentifier> static_constant_table;
     std::unordered_map<TIdentifier, std::unique_ptr<StructTypedef>> struct_typedef_table;
+    // Types
+    std::unordered_map<TIdentifier, std::shared_ptr<Type>> type_table;
 };
 
 extern std::unique_ptr<FrontEndContext> frontend;
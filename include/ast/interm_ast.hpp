@@ -191,10 +191,11 @@ struct TacSubObject : TacExpResult {
 //             | TacDoubleToUInt(val, val)
 //             | TacIntToDouble(val, val)
 //             | TacUIntToDouble(val, val)
-//             | FunCall(identifier, val*, val?)
+//             | FunCall(identifier, val*, val?, bool)
 //             | Unary(unary_operator, val, val)
 //             | Binary(binary_operator, val, val, val)
 //             | Copy(val, val)
+//             | Select(val, val, val, val)
 //             | GetAddress(val, val)
 //             | Load(val, val)
 //             | Store(val, val)
@@ -284,12 +285,14 @@ struct TacUIntToDouble : TacInstruction {
 struct TacFunCall : TacInstruction {
     AST_T type() override;
     TacFunCall() = default;
-    TacFunCall(TIdentifier name, std::vector<std::shared_ptr<TacValue>> args, std::shared_ptr<TacValue> dst);
+    TacFunCall(TIdentifier name, std::vector<std::shared_ptr<TacValue>> args, std::shared_ptr<TacValue> dst,
+        bool is_tail_call);
 
     TIdentifier name;
     std::vector<std::shared_ptr<TacValue>> args;
     // Optional
     std::shared_ptr<TacValue> dst;
+    bool is_tail_call;
 };
 
 struct TacUnary : TacInstruction {
@@ -323,6 +326,18 @@ struct TacCopy : TacInstruction {
     std::shared_ptr<TacValue> dst;
 };
 
+struct TacSelect : TacInstruction {
+    AST_T type() override;
+    TacSelect() = default;
+    TacSelect(std::shared_ptr<TacValue> condition, std::shared_ptr<TacValue> src_true,
+        std::shared_ptr<TacValue> src_false, std::shared_ptr<TacValue> dst);
+
+    std::shared_ptr<TacValue> condition;
+    std::shared_ptr<TacValue> src_true;
+    std::shared_ptr<TacValue> src_false;
+    std::shared_ptr<TacValue> dst;
+};
+
 struct TacGetAddress : TacInstruction {
     AST_T type() override;
     TacGetAddress() = default;
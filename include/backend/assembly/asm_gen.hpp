@@ -21,6 +21,14 @@ enum STRUCT_8B_CLS {
     MEMORY
 };
 
+struct DoubleStaticConstant {
+    TIdentifier name;
+    TDouble value;
+    TULong binary;
+    TInt byte;
+    std::vector<std::shared_ptr<AsmData>> data_operands;
+};
+
 struct AsmGenContext {
     AsmGenContext();
 
@@ -29,8 +37,18 @@ struct AsmGenContext {
     std::unordered_map<TIdentifier, std::vector<STRUCT_8B_CLS>> struct_8b_cls_map;
     std::vector<std::unique_ptr<AsmInstruction>>* p_instructions;
     std::vector<std::unique_ptr<AsmTopLevel>>* p_static_constant_top_levels;
+    bool is_tail_call;
+    // Parallel jobs
+    std::unordered_map<TIdentifier, size_t> double_static_constant_map;
+    std::vector<DoubleStaticConstant>* p_double_static_constants;
+};
+
+struct AsmGenJobsContext {
+    TacProgram* p_node;
+    std::vector<std::unique_ptr<AsmTopLevel>> function_top_levels;
+    std::vector<std::vector<DoubleStaticConstant>> double_static_constants;
 };
 
-std::unique_ptr<AsmProgram> assembly_generation(std::unique_ptr<TacProgram> tac_ast);
+std::unique_ptr<AsmProgram> assembly_generation(std::unique_ptr<TacProgram> tac_ast, size_t jobs);
 
 #endif
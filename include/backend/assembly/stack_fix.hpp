@@ -16,19 +16,29 @@
 
 // Pseudo register replacement
 // Instruction fix up
+// Frame layout
 
 struct StackFixContext {
-    StackFixContext();
+    StackFixContext(bool is_omit_frame_pointer);
 
     // Pseudo register replacement
     TLong stack_bytes;
     std::unordered_map<TIdentifier, TLong> pseudo_stack_bytes_map;
     // Instruction fix up
     std::vector<std::unique_ptr<AsmInstruction>>* p_fix_instructions;
+    // Frame layout
+    bool is_omit_frame_pointer;
+    TLong frame_offset;
+    TLong push_bytes;
+};
+
+struct StackFixJobsContext {
+    AsmProgram* p_node;
+    bool is_omit_frame_pointer;
 };
 
 std::unique_ptr<AsmBinary> deallocate_stack_bytes(TLong byte);
 std::unique_ptr<AsmBinary> allocate_stack_bytes(TLong byte);
-void fix_stack(AsmProgram* node);
+void fix_stack(AsmProgram* node, bool is_omit_frame_pointer, size_t jobs);
 
 #endif
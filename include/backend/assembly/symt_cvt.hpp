@@ -13,11 +13,14 @@
 // Symbol table conversion
 
 struct SymtCvtContext {
+    SymtCvtContext(bool is_no_plt);
+
+    bool is_no_plt;
     const TIdentifier* p_symbol;
 };
 
 TInt generate_type_alignment(Type* type);
 std::shared_ptr<AssemblyType> convert_backend_assembly_type(const TIdentifier& name);
-void convert_symbol_table(AsmProgram* node);
+void convert_symbol_table(AsmProgram* node, bool is_no_plt);
 
 #endif
@@ -0,0 +1,74 @@
+#ifndef _BACKEND_EMITTER_ELF_CODE_HPP
+#define _BACKEND_EMITTER_ELF_CODE_HPP
+
+#include <array>
+#include <inttypes.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ast/ast.hpp"
+#include "ast/back_ast.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Elf object code emission
+
+enum ELF_SECTION_KIND {
+    text_section,
+    data_section,
+    bss_section,
+    rodata_section,
+    elf_section_kind_size
+};
+
+struct ElfRelocation {
+    uint64_t offset;
+    uint32_t relocation_type;
+    TIdentifier name;
+    int64_t addend;
+};
+
+struct ElfSection {
+    std::string bytes;
+    uint64_t size;
+    uint64_t alignment;
+    std::vector<ElfRelocation> relocations;
+};
+
+struct ElfSymbol {
+    ELF_SECTION_KIND section_kind;
+    uint64_t offset;
+    uint64_t size;
+    bool is_global;
+    bool is_function;
+    bool is_constant;
+};
+
+// A fragment is a run of encoded instructions ended by an optional branch, whose size is only known once every label
+// and function of .text is placed.
+struct ElfFragment {
+    std::string code;
+    std::vector<ElfRelocation> relocations;
+    TIdentifier target;
+    uint8_t cond_code;
+    bool is_branch;
+    bool is_near;
+};
+
+struct ElfCodeContext {
+    ElfCodeContext();
+
+    std::array<ElfSection, ELF_SECTION_KIND::elf_section_kind_size> sections;
+    std::vector<TIdentifier> symbol_names;
+    std::unordered_map<TIdentifier, ElfSymbol> symbol_map;
+    // Branch relaxation
+    std::vector<ElfFragment> fragments;
+    std::unordered_map<TIdentifier, std::pair<size_t, size_t>> label_map;
+    std::vector<std::pair<TIdentifier, size_t>> function_fragments;
+};
+
+void elf_code_emission(std::unique_ptr<AsmProgram> asm_ast, std::string&& filename);
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef _FRONTEND_INTERMEDIATE_NAMES_HPP
 #define _FRONTEND_INTERMEDIATE_NAMES_HPP
 
+#include <inttypes.h>
+
 #include "ast/ast.hpp"
 #include "ast/front_ast.hpp"
 
@@ -11,6 +13,7 @@
 enum LABEL_KIND {
     Land_false,
     Land_true,
+    Lblock,
     Lcomisd_nan,
     Ldouble,
     Ldo_while,
@@ -27,11 +30,15 @@ enum LABEL_KIND {
     Lsi2sd_after,
     Lsi2sd_out_of_range,
     Lstring,
+    Ltail_call,
     Lternary_else,
     Lternary_false,
+    Lunroll,
     Lwhile
 };
 
+void begin_label_shard(size_t shard);
+void end_label_shard();
 TIdentifier resolve_label_identifier(const TIdentifier& label);
 TIdentifier resolve_variable_identifier(const TIdentifier& variable);
 TIdentifier resolve_structure_tag(const TIdentifier& structure);
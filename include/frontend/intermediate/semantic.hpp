@@ -19,11 +19,29 @@
 // Loop labeling
 // Identifier resolution
 
+struct ScopedIdentifier {
+    size_t scope_depth;
+    TIdentifier name;
+};
+
+struct ScopedStructure {
+    size_t scope_depth;
+    Structure structure;
+};
+
+struct ScopeUndoMark {
+    size_t identifier_undo_size;
+    size_t structure_undo_size;
+};
+
 struct SemanticContext {
     // Type checking
     std::unordered_map<TIdentifier, size_t> external_linkage_scope_map;
-    std::vector<std::unordered_map<TIdentifier, TIdentifier>> scoped_identifier_maps;
-    std::vector<std::unordered_map<TIdentifier, Structure>> scoped_structure_type_maps;
+    std::unordered_map<TIdentifier, std::vector<ScopedIdentifier>> scoped_identifier_map;
+    std::unordered_map<TIdentifier, std::vector<ScopedStructure>> scoped_structure_type_map;
+    std::vector<std::pair<const TIdentifier, std::vector<ScopedIdentifier>>*> identifier_undo_log;
+    std::vector<std::vector<ScopedStructure>*> structure_undo_log;
+    std::vector<ScopeUndoMark> scope_undo_marks;
     std::unordered_map<TIdentifier, TIdentifier> goto_map;
     std::unordered_set<TIdentifier> label_set;
     // Loop labeling
@@ -0,0 +1,21 @@
+#ifndef _FRONTEND_INTERMEDIATE_TYPES_HPP
+#define _FRONTEND_INTERMEDIATE_TYPES_HPP
+
+#include <memory>
+
+#include "ast/ast.hpp"
+#include "ast/front_symt.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Types
+
+std::shared_ptr<Type> intern_scalar_type(AST_T type_t);
+void intern_scalar_types();
+std::shared_ptr<Type> intern_pointer_type(std::shared_ptr<Type> ref_type);
+std::shared_ptr<Type> intern_array_type(TLong size, std::shared_ptr<Type> elem_type);
+void intern_type(std::shared_ptr<Type>& type);
+TLong get_type_scale(Type* type);
+TInt get_type_alignment(Type* type);
+
+#endif
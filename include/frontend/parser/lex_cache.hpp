@@ -0,0 +1,27 @@
+#ifndef _FRONTEND_PARSER_LEX_CACHE_HPP
+#define _FRONTEND_PARSER_LEX_CACHE_HPP
+
+#include <string>
+#include <vector>
+
+#include "frontend/parser/lexer.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Header cache
+
+// Tokens of a single header file, with lines numbered from the start of that file. Nested includes are kept as
+// include_directive tokens, so that they are expanded again in the including translation unit.
+struct HeaderCache {
+    size_t line_count;
+    std::vector<Token> tokens;
+};
+
+bool load_header_cache(const std::string& cachedir, const std::string& filename, HeaderCache& header_cache);
+void store_header_cache(const std::string& cachedir, const std::string& filename, const HeaderCache& header_cache);
+void enable_memory_header_cache();
+bool is_memory_header_cache();
+bool load_memory_header_cache(const std::string& filename, HeaderCache& header_cache);
+void store_memory_header_cache(const std::string& filename, const HeaderCache& header_cache);
+
+#endif
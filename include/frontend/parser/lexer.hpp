@@ -9,6 +9,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -34,8 +35,31 @@ struct Token {
     size_t line;
 };
 
+struct MacroToken {
+    Token token;
+    std::vector<std::string> hideset;
+};
+
+struct Macro {
+    bool is_function;
+    std::vector<std::string> params;
+    std::vector<Token> tokens;
+};
+
+struct MacroCondition {
+    bool is_skipped;
+    bool is_taken;
+    bool is_else;
+};
+
+struct HeaderFile {
+    std::string filename;
+    std::string file_id;
+};
+
 struct LexerContext {
-    LexerContext(std::vector<Token>* p_tokens, std::vector<std::string>* p_includedirs);
+    LexerContext(std::vector<Token>* p_tokens, std::vector<std::string>* p_includedirs,
+        std::vector<std::string>* p_dependencies, std::string&& cachedir, bool is_preprocessed);
 
     TOKEN_KIND re_match_token_kind;
     std::string re_match_token;
@@ -43,15 +67,27 @@ struct LexerContext {
     std::string_view re_iterator_view_slice;
 #else
     std::string re_capture_groups[TOKEN_KIND_SIZE];
-    std::unique_ptr<const boost::regex> re_compiled_pattern;
+    const boost::regex* re_compiled_pattern;
 #endif
     std::vector<Token>* p_tokens;
+    std::vector<Token>* p_cache_tokens;
     std::vector<std::string>* p_includedirs;
     std::vector<std::string> stdlibdirs;
-    std::unordered_set<std::string> filename_include_set;
+    std::unordered_map<std::string, HeaderFile> header_file_map;
+    std::unordered_set<std::string> header_once_set;
+    std::vector<std::string> header_id_stack;
+    std::vector<std::string>* p_dependencies;
+    std::unordered_set<std::string> dependency_id_set;
+    std::string cachedir;
     size_t total_line_number;
+    // Preprocessor
+    bool is_preprocessed;
+    size_t macro_expand_index;
+    std::unordered_map<std::string, Macro> macro_table;
+    std::vector<MacroCondition> macro_conditions;
 };
 
-std::unique_ptr<std::vector<Token>> lexing(std::string& filename, std::vector<std::string>&& includedirs);
+std::unique_ptr<std::vector<Token>> lexing(std::string& filename, std::vector<std::string>&& includedirs,
+    std::vector<std::string>* p_dependencies, std::string&& cachedir, bool is_preprocessed);
 
 #endif
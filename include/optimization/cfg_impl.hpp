@@ -426,6 +426,7 @@ static bool is_transfer_instruction(size_t instruction_index,
         case AST_T::TacUnary_t:
         case AST_T::TacBinary_t:
         case AST_T::TacCopy_t:
+        case AST_T::TacSelect_t:
         case AST_T::TacGetAddress_t:
         case AST_T::TacLoad_t:
         case AST_T::TacStore_t:
@@ -484,7 +485,18 @@ static bool set_dfa_bak_instruction(size_t instruction_index, size_t& i) {
 
 #if __OPTIM_LEVEL__ == 1
 static bool copy_propagation_transfer_reaching_copies(TacInstruction* node, size_t next_instruction_index);
+static void eliminate_redundant_load_transfer_available_loads(TacInstruction* node, size_t next_instruction_index);
 static void eliminate_dead_store_transfer_live_values(TacInstruction* node, size_t next_instruction_index);
+
+static bool data_flow_analysis_forward_transfer(TacInstruction* node, size_t next_instruction_index) {
+    if (context->data_flow_analysis->is_load_elimination) {
+        eliminate_redundant_load_transfer_available_loads(node, next_instruction_index);
+        return true;
+    }
+    else {
+        return copy_propagation_transfer_reaching_copies(node, next_instruction_index);
+    }
+}
 #endif
 
 #if __OPTIM_LEVEL__ == 1
@@ -496,7 +508,7 @@ static size_t data_flow_analysis_forward_transfer_block(size_t instruction_index
                 GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, i) =
                     GET_DFA_INSTRUCTION_SET_MASK(instruction_index, i);
             }
-            if (!copy_propagation_transfer_reaching_copies(
+            if (!data_flow_analysis_forward_transfer(
                     GET_INSTRUCTION(instruction_index).get(), next_instruction_index)) {
                 for (size_t i = 0; i < context->data_flow_analysis->mask_size; ++i) {
                     GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, i) =
@@ -510,7 +522,7 @@ static size_t data_flow_analysis_forward_transfer_block(size_t instruction_index
         GET_DFA_INSTRUCTION_SET_MASK(context->data_flow_analysis->incoming_index, i) =
             GET_DFA_INSTRUCTION_SET_MASK(instruction_index, i);
     }
-    if (!copy_propagation_transfer_reaching_copies(
+    if (!data_flow_analysis_forward_transfer(
             GET_INSTRUCTION(instruction_index).get(), context->data_flow_analysis->incoming_index)) {
         for (size_t i = 0; i < context->data_flow_analysis->mask_size; ++i) {
             GET_DFA_INSTRUCTION_SET_MASK(context->data_flow_analysis->incoming_index, i) =
@@ -653,6 +665,7 @@ Lelse:
 
 #if __OPTIM_LEVEL__ == 1
 static void data_flow_analysis_forward_iterative_algorithm() {
+    TRACE_EVENT_BEGIN("data_flow_analysis_forward");
     size_t open_block_ids_size = context->control_flow_graph->blocks.size();
     for (size_t i = 0; i < open_block_ids_size; ++i) {
         size_t block_id = context->data_flow_analysis->open_block_ids[i];
@@ -684,10 +697,15 @@ static void data_flow_analysis_forward_iterative_algorithm() {
             }
         }
     }
+    TRACE_EVENT_ARG("set_size", context->data_flow_analysis->set_size);
+    TRACE_EVENT_ARG("blocks", context->control_flow_graph->blocks.size());
+    TRACE_EVENT_ARG("iterations", open_block_ids_size);
+    TRACE_EVENT_END("data_flow_analysis_forward");
 }
 #endif
 
 static void data_flow_analysis_backward_iterative_algorithm() {
+    TRACE_EVENT_BEGIN("data_flow_analysis_backward");
     size_t open_block_ids_size = context->control_flow_graph->blocks.size();
     for (size_t i = 0; i < open_block_ids_size; ++i) {
         size_t block_id = context->data_flow_analysis->open_block_ids[i];
@@ -719,6 +737,10 @@ static void data_flow_analysis_backward_iterative_algorithm() {
             }
         }
     }
+    TRACE_EVENT_ARG("set_size", context->data_flow_analysis->set_size);
+    TRACE_EVENT_ARG("blocks", context->control_flow_graph->blocks.size());
+    TRACE_EVENT_ARG("iterations", open_block_ids_size);
+    TRACE_EVENT_END("data_flow_analysis_backward");
 }
 
 #if __OPTIM_LEVEL__ == 1
@@ -767,6 +789,7 @@ static void data_flow_analysis_add_alias_value(TacValue* node) {
     }
 }
 
+static void alias_analysis_initialize();
 static bool is_same_value(TacValue* node_1, TacValue* node_2);
 
 static bool propagate_copies_add_data_index(TacCopy* node, size_t instruction_index, size_t block_id) {
@@ -789,6 +812,16 @@ static bool propagate_copies_add_data_index(TacCopy* node, size_t instruction_in
     }
 }
 
+static void eliminate_redundant_load_add_data_index(size_t instruction_index) {
+    if (context->data_flow_analysis->set_size < context->data_flow_analysis->data_index_map.size()) {
+        context->data_flow_analysis->data_index_map[context->data_flow_analysis->set_size] = instruction_index;
+    }
+    else {
+        context->data_flow_analysis->data_index_map.push_back(instruction_index);
+    }
+    context->data_flow_analysis->set_size++;
+}
+
 static void eliminate_dead_store_add_data_name(const TIdentifier& name) {
     if (context->control_flow_graph->identifier_id_map.find(name)
         == context->control_flow_graph->identifier_id_map.end()) {
@@ -806,7 +839,7 @@ static void eliminate_dead_store_add_data_value(TacValue* node) {
 
 static bool data_flow_analysis_initialize(
 #if __OPTIM_LEVEL__ == 1
-    bool is_dead_store_elimination, bool init_alias_set
+    bool is_dead_store_elimination, bool is_load_elimination, bool init_alias_set
 #endif
 ) {
     context->data_flow_analysis->set_size = 0;
@@ -830,12 +863,13 @@ static bool data_flow_analysis_initialize(
     size_t blocks_mask_sets_size = 0;
     size_t instructions_mask_sets_size = 0;
 #if __OPTIM_LEVEL__ == 1
-    bool is_copy_propagation = !is_dead_store_elimination;
+    bool is_copy_propagation = !is_dead_store_elimination && !is_load_elimination;
+    context->data_flow_analysis->is_load_elimination = is_load_elimination;
     if (is_dead_store_elimination) {
 #endif
         context->control_flow_graph->identifier_id_map.clear();
         context->data_flow_analysis->static_index = context->data_flow_analysis->incoming_index + 1;
-        context->data_flow_analysis->addressed_index = context->data_flow_analysis->static_index + 1;
+        context->data_flow_analysis->escaped_index = context->data_flow_analysis->static_index + 1;
 #if __OPTIM_LEVEL__ == 1
     }
     if (init_alias_set) {
@@ -853,7 +887,7 @@ static bool data_flow_analysis_initialize(
                     switch (node->type()) {
 #if __OPTIM_LEVEL__ == 1
                         case AST_T::TacReturn_t: {
-                            if (is_copy_propagation) {
+                            if (!is_dead_store_elimination) {
                                 goto Lcontinue;
                             }
                             TacReturn* p_node = static_cast<TacReturn*>(node);
@@ -954,12 +988,22 @@ static bool data_flow_analysis_initialize(
                                     goto Lcontinue;
                                 }
                             }
-                            else {
+                            else if (is_dead_store_elimination) {
                                 eliminate_dead_store_add_data_value(p_node->src.get());
                                 eliminate_dead_store_add_data_value(p_node->dst.get());
                             }
                             break;
                         }
+                        case AST_T::TacSelect_t: {
+                            if (is_dead_store_elimination) {
+                                TacSelect* p_node = static_cast<TacSelect*>(node);
+                                eliminate_dead_store_add_data_value(p_node->condition.get());
+                                eliminate_dead_store_add_data_value(p_node->src_true.get());
+                                eliminate_dead_store_add_data_value(p_node->src_false.get());
+                                eliminate_dead_store_add_data_value(p_node->dst.get());
+                            }
+                            break;
+                        }
                         case AST_T::TacGetAddress_t: {
                             TacGetAddress* p_node = static_cast<TacGetAddress*>(node);
                             if (is_dead_store_elimination) {
@@ -977,6 +1021,9 @@ static bool data_flow_analysis_initialize(
                                 eliminate_dead_store_add_data_value(p_node->src_ptr.get());
                                 eliminate_dead_store_add_data_value(p_node->dst.get());
                             }
+                            else if (is_load_elimination) {
+                                eliminate_redundant_load_add_data_index(instruction_index);
+                            }
                             break;
                         }
                         case AST_T::TacStore_t: {
@@ -985,6 +1032,9 @@ static bool data_flow_analysis_initialize(
                                 eliminate_dead_store_add_data_value(p_node->src.get());
                                 eliminate_dead_store_add_data_value(p_node->dst_ptr.get());
                             }
+                            else if (is_load_elimination) {
+                                eliminate_redundant_load_add_data_index(instruction_index);
+                            }
                             break;
                         }
                         case AST_T::TacAddPtr_t: {
@@ -994,6 +1044,9 @@ static bool data_flow_analysis_initialize(
                                 eliminate_dead_store_add_data_value(p_node->index.get());
                                 eliminate_dead_store_add_data_value(p_node->dst.get());
                             }
+                            else if (is_load_elimination) {
+                                eliminate_redundant_load_add_data_index(instruction_index);
+                            }
                             break;
                         }
                         case AST_T::TacCopyToOffset_t: {
@@ -1002,6 +1055,9 @@ static bool data_flow_analysis_initialize(
                                 eliminate_dead_store_add_data_name(p_node->dst_name);
                                 eliminate_dead_store_add_data_value(p_node->src.get());
                             }
+                            else if (is_load_elimination) {
+                                eliminate_redundant_load_add_data_index(instruction_index);
+                            }
                             break;
                         }
                         case AST_T::TacCopyFromOffset_t: {
@@ -1010,17 +1066,20 @@ static bool data_flow_analysis_initialize(
                                 eliminate_dead_store_add_data_name(p_node->src_name);
                                 eliminate_dead_store_add_data_value(p_node->dst.get());
                             }
+                            else if (is_load_elimination) {
+                                eliminate_redundant_load_add_data_index(instruction_index);
+                            }
                             break;
                         }
                         case AST_T::TacJumpIfZero_t: {
-                            if (is_copy_propagation) {
+                            if (!is_dead_store_elimination) {
                                 goto Lcontinue;
                             }
                             eliminate_dead_store_add_data_value(static_cast<TacJumpIfZero*>(node)->condition.get());
                             break;
                         }
                         case AST_T::TacJumpIfNotZero_t: {
-                            if (is_copy_propagation) {
+                            if (!is_dead_store_elimination) {
                                 goto Lcontinue;
                             }
                             eliminate_dead_store_add_data_value(static_cast<TacJumpIfNotZero*>(node)->condition.get());
@@ -1044,6 +1103,11 @@ static bool data_flow_analysis_initialize(
             context->control_flow_graph->reaching_code[block_id] = true;
         }
     }
+#if __OPTIM_LEVEL__ == 1
+    if (init_alias_set) {
+        alias_analysis_initialize();
+    }
+#endif
     if (context->data_flow_analysis->set_size == 0) {
         return false;
     }
@@ -1057,7 +1121,7 @@ static bool data_flow_analysis_initialize(
         context->data_flow_analysis->instruction_index_map[context->data_flow_analysis->static_index] =
             instructions_mask_sets_size;
         instructions_mask_sets_size++;
-        context->data_flow_analysis->instruction_index_map[context->data_flow_analysis->addressed_index] =
+        context->data_flow_analysis->instruction_index_map[context->data_flow_analysis->escaped_index] =
             instructions_mask_sets_size;
         instructions_mask_sets_size++;
 #if __OPTIM_LEVEL__ == 1
@@ -1075,7 +1139,7 @@ static bool data_flow_analysis_initialize(
     }
 
 #if __OPTIM_LEVEL__ == 1
-    if (is_copy_propagation) {
+    if (!is_dead_store_elimination) {
         size_t i = context->control_flow_graph->blocks.size();
         for (size_t successor_id : context->control_flow_graph->entry_successor_ids) {
             if (!context->control_flow_graph->reaching_code[successor_id]) {
@@ -1135,21 +1199,31 @@ static bool data_flow_analysis_initialize(
 
         for (i = 0; i < context->data_flow_analysis->mask_size; ++i) {
             GET_DFA_INSTRUCTION_SET_MASK(context->data_flow_analysis->static_index, i) = MASK_FALSE;
-            GET_DFA_INSTRUCTION_SET_MASK(context->data_flow_analysis->addressed_index, i) = MASK_FALSE;
+            GET_DFA_INSTRUCTION_SET_MASK(context->data_flow_analysis->escaped_index, i) = MASK_FALSE;
         }
+#if __OPTIM_LEVEL__ == 1
+        context->data_flow_analysis->aliased_names.clear();
+#endif
 
         for (const auto& name_id : context->control_flow_graph->identifier_id_map) {
             if (
 #if __OPTIM_LEVEL__ == 1
-                frontend->symbol_table[name_id.first]->attrs->type() == AST_T::StaticAttr_t
+                frontend->symbol_table.at(name_id.first)->attrs->type() == AST_T::StaticAttr_t
 #endif
             ) {
                 SET_DFA_INSTRUCTION_SET_AT(context->data_flow_analysis->static_index, name_id.second, true);
             }
-            if (context->data_flow_analysis->alias_set.find(name_id.first)
-                != context->data_flow_analysis->alias_set.end()) {
-                SET_DFA_INSTRUCTION_SET_AT(context->data_flow_analysis->addressed_index, name_id.second, true);
+            if (context->data_flow_analysis->escaped_set.find(name_id.first)
+                != context->data_flow_analysis->escaped_set.end()) {
+                SET_DFA_INSTRUCTION_SET_AT(context->data_flow_analysis->escaped_index, name_id.second, true);
+            }
+#if __OPTIM_LEVEL__ == 1
+            if (frontend->symbol_table.at(name_id.first)->attrs->type() == AST_T::StaticAttr_t
+                || context->data_flow_analysis->alias_set.find(name_id.first)
+                       != context->data_flow_analysis->alias_set.end()) {
+                context->data_flow_analysis->aliased_names.push_back(name_id.first);
             }
+#endif
         }
 
         std::fill(context->data_flow_analysis->blocks_mask_sets.begin(),
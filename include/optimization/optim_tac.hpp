@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "ast/ast.hpp"
+#include "ast/front_symt.hpp"
 #include "ast/interm_ast.hpp"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -19,8 +20,14 @@
 
 // Constant folding
 // Unreachable code elimination
+// Alias analysis
 // Copy propagation
+// Redundant load elimination
 // Dead store elimination
+// Tail call elimination
+// Block layout
+// Scalar replacement of aggregates
+// Loop unrolling
 
 struct ControlFlowBlock {
     size_t size;
@@ -50,12 +57,42 @@ struct DataFlowAnalysis {
     std::vector<uint64_t> blocks_mask_sets;
     std::vector<uint64_t> instructions_mask_sets;
     std::unordered_set<TIdentifier> alias_set;
+    // Alias analysis
+    std::unordered_set<TIdentifier> escaped_set;
+    std::unordered_map<TIdentifier, std::unordered_set<TIdentifier>> points_to_map;
     // Copy propagation
     std::vector<size_t> data_index_map;
     std::vector<std::unique_ptr<TacInstruction>> bak_instructions;
+    // Redundant load elimination
+    bool is_load_elimination;
     // Dead store elimination
     size_t static_index;
-    size_t addressed_index;
+    size_t escaped_index;
+    std::vector<TIdentifier> aliased_names;
+};
+
+struct AggregateMember {
+    TLong offset;
+    TLong size;
+    bool is_double;
+    std::shared_ptr<Type> member_type;
+    TIdentifier name;
+};
+
+struct AggregateReplacement {
+    bool is_escaped;
+    std::vector<AggregateMember> members;
+};
+
+struct UnrolledLoop {
+    size_t start_index;
+    size_t condition_index;
+    size_t continue_index;
+    size_t jump_index;
+    TLong step;
+    TLong bound_value;
+    bool is_constant_bound;
+    TacBinary* p_condition;
 };
 
 struct OptimTacContext {
@@ -64,14 +101,22 @@ struct OptimTacContext {
     // Constant folding
     // Unreachable code elimination
     // Copy propagation
+    // Redundant load elimination
     // Dead store elimination
+    // Tail call elimination
+    // Block layout
     bool is_fixed_point;
-    std::array<bool, 5> enabled_optimizations;
+    std::array<bool, 8> enabled_optimizations;
     std::unique_ptr<ControlFlowGraph> control_flow_graph;
     std::unique_ptr<DataFlowAnalysis> data_flow_analysis;
     std::vector<std::unique_ptr<TacInstruction>>* p_instructions;
 };
 
-void three_address_code_optimization(TacProgram* node, uint8_t optim_1_mask);
+struct OptimTacJobsContext {
+    TacProgram* p_node;
+    uint8_t optim_1_mask;
+};
+
+void three_address_code_optimization(TacProgram* node, uint8_t optim_1_mask, size_t unroll_factor, size_t jobs);
 
 #endif
@@ -0,0 +1,21 @@
+#ifndef _UTIL_COMP_CACHE_HPP
+#define _UTIL_COMP_CACHE_HPP
+
+#include <inttypes.h>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Compile cache
+
+struct CompileCacheKey {
+    uint64_t hash_1;
+    uint64_t hash_2;
+};
+
+bool get_compile_cache_key(const std::string& key, CompileCacheKey& cache_key);
+bool load_compile_cache(const std::string& cachedir, const CompileCacheKey& cache_key, const std::string& filename);
+void store_compile_cache(
+    const std::string& cachedir, const CompileCacheKey& cache_key, const std::string& filename, uint64_t max_size);
+
+#endif
@@ -13,6 +13,7 @@ void file_open_write(const std::string& filename);
 bool find_file(const std::string& filename);
 bool read_line(std::string& line);
 void write_line(std::string&& line);
+void write_bytes(std::string&& bytes);
 void file_close_read(size_t line_number);
 void file_close_write();
 
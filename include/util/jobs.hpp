@@ -0,0 +1,28 @@
+#ifndef _UTIL_JOBS_HPP
+#define _UTIL_JOBS_HPP
+
+#include <atomic>
+#include <inttypes.h>
+#include <mutex>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Jobs
+
+struct JobsContext {
+    JobsContext(size_t size, void (*init_job)(), void (*run_job)(size_t), void (*free_job)());
+
+    size_t size;
+    void (*init_job)();
+    void (*run_job)(size_t);
+    void (*free_job)();
+    std::atomic<size_t> next_index;
+    std::atomic<bool> is_failed;
+    std::mutex error_mutex;
+    std::string error_message;
+};
+
+void run_jobs(size_t jobs, size_t size, void (*init_job)(), void (*run_job)(size_t), void (*free_job)());
+
+#endif
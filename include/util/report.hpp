@@ -0,0 +1,46 @@
+#ifndef _UTIL_REPORT_HPP
+#define _UTIL_REPORT_HPP
+
+#include <inttypes.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Report
+
+struct PhaseReport {
+    std::string name;
+    double wall_time;
+    double cpu_time;
+    size_t peak_rss;
+    size_t alloc_count;
+    size_t alloc_bytes;
+    std::string ir_name;
+    size_t ir_size;
+    std::vector<std::pair<std::string, size_t>> ir_function_sizes;
+};
+
+struct ReportContext {
+    ReportContext(bool is_json);
+
+    bool is_json;
+    double wall_time;
+    double cpu_time;
+    size_t alloc_count;
+    size_t alloc_bytes;
+    std::vector<PhaseReport> phase_reports;
+};
+
+extern std::unique_ptr<ReportContext> report;
+#define INIT_REPORT_CONTEXT(X) report = std::make_unique<ReportContext>(X)
+#define FREE_REPORT_CONTEXT report.reset()
+
+void fold_alloc_counters();
+void begin_phase_report();
+PhaseReport* end_phase_report(std::string&& name);
+void print_report();
+
+#endif
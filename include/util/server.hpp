@@ -0,0 +1,14 @@
+#ifndef _UTIL_SERVER_HPP
+#define _UTIL_SERVER_HPP
+
+#include <string>
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Server
+
+int run_server(const std::string& socket_filename, void (*compile_request)(std::vector<std::string>&& args));
+bool run_client(const std::string& socket_filename, int argc, char** argv);
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef _UTIL_STATS_HPP
+#define _UTIL_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <inttypes.h>
+#include <memory>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Stats
+
+enum STATS_COUNTER {
+    folded_instructions,
+    folded_copies,
+    folded_jumps,
+    removed_unreachable_blocks,
+    removed_unreachable_jumps,
+    removed_unreachable_labels,
+    propagated_copy_operands,
+    removed_redundant_copies,
+    removed_dead_stores,
+    optimized_functions,
+    fixed_point_iterations,
+    eliminated_tail_recursions,
+    marked_tail_calls,
+    rotated_loops,
+    moved_return_blocks,
+    removed_layout_jumps,
+    threaded_layout_jumps,
+    replaced_aggregates,
+    eliminated_redundant_loads,
+    fully_unrolled_loops,
+    partially_unrolled_loops,
+    fixed_stack_functions,
+    allocated_pseudo_registers,
+    allocated_stack_bytes,
+    inserted_fix_instructions,
+    omitted_frame_pointers,
+    red_zone_functions,
+    stats_counter_size
+};
+
+struct StatsContext {
+    StatsContext();
+
+    std::array<std::atomic<size_t>, stats_counter_size> counters;
+};
+
+extern std::unique_ptr<StatsContext> stats;
+#define INIT_STATS_CONTEXT stats = std::make_unique<StatsContext>()
+#define FREE_STATS_CONTEXT stats.reset()
+
+// Counters cost a single branch on the stats context when stats are off, and are atomic as jobs share them.
+#define INCREMENT_STATS(X)    \
+    if (stats) {              \
+        stats->counters[X]++; \
+    }
+#define ADD_STATS(X, Y)          \
+    if (stats) {                 \
+        stats->counters[X] += Y; \
+    }
+
+void print_stats();
+
+#endif
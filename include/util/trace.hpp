@@ -0,0 +1,46 @@
+#ifndef _UTIL_TRACE_HPP
+#define _UTIL_TRACE_HPP
+
+#include <memory>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Trace
+
+struct TraceContext {
+    TraceContext(std::string&& filename);
+
+    std::string filename;
+    double start_time;
+    std::mutex mutex;
+    std::string trace_events;
+};
+
+extern std::unique_ptr<TraceContext> trace;
+#define INIT_TRACE_CONTEXT(X) trace = std::make_unique<TraceContext>(X)
+#define FREE_TRACE_CONTEXT trace.reset()
+
+// Events cost a single branch on the trace context when tracing is off.
+#define TRACE_EVENT_BEGIN(X)  \
+    if (trace) {              \
+        begin_trace_event(X); \
+    }
+#define TRACE_EVENT_ARG(X, Y) \
+    if (trace) {              \
+        add_trace_arg(X, Y);  \
+    }
+#define TRACE_EVENT_END(X)  \
+    if (trace) {            \
+        end_trace_event(X); \
+    }
+
+void begin_trace_event(const char* name);
+void add_trace_arg(const char* key, size_t value);
+void add_trace_arg(const char* key, const std::string& value);
+void end_trace_event(const char* name);
+void write_trace();
+
+#endif
@@ -18,8 +18,22 @@ struct MainContext {
     uint8_t debug_code;
     uint8_t optim_1_mask;
     uint8_t optim_2_code;
+    bool is_omit_frame_pointer;
+    bool is_no_plt;
+    size_t unroll_factor;
+    size_t jobs;
     std::string filename;
     std::vector<std::string> includedirs;
+    std::string header_cachedir;
+    std::string compile_cachedir;
+    uint64_t compile_cache_size;
+    std::string depend_filename;
+    std::string depend_target;
+    bool is_object;
+    bool is_preprocessed;
+    uint8_t report_code;
+    std::string trace_filename;
+    bool is_stats;
     std::vector<std::string> args;
 };
 
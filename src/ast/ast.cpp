@@ -1,3 +1,4 @@
+#include <atomic>
 #include <vector>
 
 #include "ast/ast.hpp"
@@ -6,7 +7,23 @@
 
 // Abstract syntax tree
 
-Ast::~Ast() {}
+// Counts the nodes alive, for the per-phase report. Counts are per thread, as a node can be freed on another thread
+// than the one that made it, and are folded into the total when a job thread ends.
+static thread_local size_t ast_node_count = 0;
+static std::atomic<size_t> folded_ast_node_count(0);
+
+Ast::Ast() { ast_node_count++; }
+
+Ast::Ast(const Ast&) { ast_node_count++; }
+
+Ast::~Ast() { ast_node_count--; }
+
+void fold_ast_node_count() {
+    folded_ast_node_count += ast_node_count;
+    ast_node_count = 0;
+}
+
+size_t get_ast_node_count() { return ast_node_count + folded_ast_node_count; }
 
 AST_T CConst::type() { return AST_T::CConst_t; }
 AST_T CConstInt::type() { return AST_T::CConstInt_t; }
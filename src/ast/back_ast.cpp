@@ -71,6 +71,7 @@ AST_T AsmInstruction::type() { return AST_T::AsmInstruction_t; }
 AST_T AsmMov::type() { return AST_T::AsmMov_t; }
 AST_T AsmMovSx::type() { return AST_T::AsmMovSx_t; }
 AST_T AsmMovZeroExtend::type() { return AST_T::AsmMovZeroExtend_t; }
+AST_T AsmMovdqu::type() { return AST_T::AsmMovdqu_t; }
 AST_T AsmLea::type() { return AST_T::AsmLea_t; }
 AST_T AsmCvttsd2si::type() { return AST_T::AsmCvttsd2si_t; }
 AST_T AsmCvtsi2sd::type() { return AST_T::AsmCvtsi2sd_t; }
@@ -80,12 +81,15 @@ AST_T AsmCmp::type() { return AST_T::AsmCmp_t; }
 AST_T AsmIdiv::type() { return AST_T::AsmIdiv_t; }
 AST_T AsmDiv::type() { return AST_T::AsmDiv_t; }
 AST_T AsmCdq::type() { return AST_T::AsmCdq_t; }
+AST_T AsmRepMovsb::type() { return AST_T::AsmRepMovsb_t; }
 AST_T AsmJmp::type() { return AST_T::AsmJmp_t; }
 AST_T AsmJmpCC::type() { return AST_T::AsmJmpCC_t; }
 AST_T AsmSetCC::type() { return AST_T::AsmSetCC_t; }
+AST_T AsmCmov::type() { return AST_T::AsmCmov_t; }
 AST_T AsmLabel::type() { return AST_T::AsmLabel_t; }
 AST_T AsmPush::type() { return AST_T::AsmPush_t; }
 AST_T AsmCall::type() { return AST_T::AsmCall_t; }
+AST_T AsmTailCall::type() { return AST_T::AsmTailCall_t; }
 AST_T AsmRet::type() { return AST_T::AsmRet_t; }
 AST_T AsmTopLevel::type() { return AST_T::AsmTopLevel_t; }
 AST_T AsmFunction::type() { return AST_T::AsmFunction_t; }
@@ -124,6 +128,9 @@ AsmMovZeroExtend::AsmMovZeroExtend(std::shared_ptr<AssemblyType> assembly_type_s
     assembly_type_src(std::move(assembly_type_src)),
     assembly_type_dst(std::move(assembly_type_dst)), src(std::move(src)), dst(std::move(dst)) {}
 
+AsmMovdqu::AsmMovdqu(std::shared_ptr<AsmOperand> src, std::shared_ptr<AsmOperand> dst) :
+    src(std::move(src)), dst(std::move(dst)) {}
+
 AsmLea::AsmLea(std::shared_ptr<AsmOperand> src, std::shared_ptr<AsmOperand> dst) :
     src(std::move(src)), dst(std::move(dst)) {}
 
@@ -168,16 +175,24 @@ AsmJmpCC::AsmJmpCC(TIdentifier target, std::unique_ptr<AsmCondCode> cond_code) :
 AsmSetCC::AsmSetCC(std::unique_ptr<AsmCondCode> cond_code, std::shared_ptr<AsmOperand> dst) :
     cond_code(std::move(cond_code)), dst(std::move(dst)) {}
 
+AsmCmov::AsmCmov(std::unique_ptr<AsmCondCode> cond_code, std::shared_ptr<AssemblyType> assembly_type,
+    std::shared_ptr<AsmOperand> src, std::shared_ptr<AsmOperand> dst) :
+    cond_code(std::move(cond_code)),
+    assembly_type(std::move(assembly_type)), src(std::move(src)), dst(std::move(dst)) {}
+
 AsmLabel::AsmLabel(TIdentifier name) : name(std::move(name)) {}
 
 AsmPush::AsmPush(std::shared_ptr<AsmOperand> src) : src(std::move(src)) {}
 
 AsmCall::AsmCall(TIdentifier name) : name(std::move(name)) {}
 
-AsmFunction::AsmFunction(TIdentifier name, bool is_global, bool is_return_memory,
+AsmTailCall::AsmTailCall(TIdentifier name) : name(std::move(name)) {}
+
+AsmFunction::AsmFunction(TIdentifier name, bool is_global, bool is_return_memory, bool is_frame_pointer,
     std::vector<std::unique_ptr<AsmInstruction>> instructions) :
     name(std::move(name)),
-    is_global(is_global), is_return_memory(is_return_memory), instructions(std::move(instructions)) {}
+    is_global(is_global), is_return_memory(is_return_memory), is_frame_pointer(is_frame_pointer),
+    instructions(std::move(instructions)) {}
 
 AsmStaticVariable::AsmStaticVariable(
     TIdentifier name, TInt alignment, bool is_global, std::vector<std::shared_ptr<StaticInit>> static_inits) :
@@ -22,7 +22,8 @@ ByteArray::ByteArray(TLong size, TInt alignment) : size(size), alignment(alignme
 BackendObj::BackendObj(bool is_static, bool is_constant, std::shared_ptr<AssemblyType> assembly_type) :
     is_static(is_static), is_constant(is_constant), assembly_type(std::move(assembly_type)) {}
 
-BackendFun::BackendFun(bool is_defined) : is_defined(is_defined) {}
+BackendFun::BackendFun(bool is_defined, bool is_local, bool is_got) :
+    is_defined(is_defined), is_local(is_local), is_got(is_got) {}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
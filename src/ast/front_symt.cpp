@@ -47,6 +47,8 @@ AST_T Symbol::type() { return AST_T::Symbol_t; }
 AST_T StructMember::type() { return AST_T::StructMember_t; }
 AST_T StructTypedef::type() { return AST_T::StructTypedef_t; }
 
+Type::Type() : scale(-1l), alignment(-1) {}
+
 FunType::FunType(std::vector<std::shared_ptr<Type>> param_types, std::shared_ptr<Type> ret_type) :
     param_types(std::move(param_types)), ret_type(std::move(ret_type)) {}
 
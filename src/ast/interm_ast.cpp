@@ -51,6 +51,7 @@ AST_T TacFunCall::type() { return AST_T::TacFunCall_t; }
 AST_T TacUnary::type() { return AST_T::TacUnary_t; }
 AST_T TacBinary::type() { return AST_T::TacBinary_t; }
 AST_T TacCopy::type() { return AST_T::TacCopy_t; }
+AST_T TacSelect::type() { return AST_T::TacSelect_t; }
 AST_T TacGetAddress::type() { return AST_T::TacGetAddress_t; }
 AST_T TacLoad::type() { return AST_T::TacLoad_t; }
 AST_T TacStore::type() { return AST_T::TacStore_t; }
@@ -100,8 +101,10 @@ TacIntToDouble::TacIntToDouble(std::shared_ptr<TacValue> src, std::shared_ptr<Ta
 TacUIntToDouble::TacUIntToDouble(std::shared_ptr<TacValue> src, std::shared_ptr<TacValue> dst) :
     src(std::move(src)), dst(std::move(dst)) {}
 
-TacFunCall::TacFunCall(TIdentifier name, std::vector<std::shared_ptr<TacValue>> args, std::shared_ptr<TacValue> dst) :
-    name(std::move(name)), args(std::move(args)), dst(std::move(dst)) {}
+TacFunCall::TacFunCall(
+    TIdentifier name, std::vector<std::shared_ptr<TacValue>> args, std::shared_ptr<TacValue> dst, bool is_tail_call) :
+    name(std::move(name)),
+    args(std::move(args)), dst(std::move(dst)), is_tail_call(is_tail_call) {}
 
 TacUnary::TacUnary(std::unique_ptr<TacUnaryOp> unary_op, std::shared_ptr<TacValue> src, std::shared_ptr<TacValue> dst) :
     unary_op(std::move(unary_op)), src(std::move(src)), dst(std::move(dst)) {}
@@ -114,6 +117,11 @@ TacBinary::TacBinary(std::unique_ptr<TacBinaryOp> binary_op, std::shared_ptr<Tac
 TacCopy::TacCopy(std::shared_ptr<TacValue> src, std::shared_ptr<TacValue> dst) :
     src(std::move(src)), dst(std::move(dst)) {}
 
+TacSelect::TacSelect(std::shared_ptr<TacValue> condition, std::shared_ptr<TacValue> src_true,
+    std::shared_ptr<TacValue> src_false, std::shared_ptr<TacValue> dst) :
+    condition(std::move(condition)),
+    src_true(std::move(src_true)), src_false(std::move(src_false)), dst(std::move(dst)) {}
+
 TacGetAddress::TacGetAddress(std::shared_ptr<TacValue> src, std::shared_ptr<TacValue> dst) :
     src(std::move(src)), dst(std::move(dst)) {}
 
@@ -2,8 +2,10 @@
 #include <string>
 #include <vector>
 
+#include "util/jobs.hpp"
 #include "util/str2t.hpp"
 #include "util/throw.hpp"
+#include "util/trace.hpp"
 
 #include "ast/ast.hpp"
 #include "ast/back_ast.hpp"
@@ -18,13 +20,15 @@
 #include "backend/assembly/stack_fix.hpp"
 #include "backend/assembly/symt_cvt.hpp"
 
-static std::unique_ptr<AsmGenContext> context;
+static thread_local std::unique_ptr<AsmGenContext> context;
+static std::unique_ptr<AsmGenJobsContext> jobs_context;
 
 AsmGenContext::AsmGenContext() :
     ARG_REGISTERS({REGISTER_KIND::Di, REGISTER_KIND::Si, REGISTER_KIND::Dx, REGISTER_KIND::Cx, REGISTER_KIND::R8,
         REGISTER_KIND::R9}),
     ARG_SSE_REGISTERS({REGISTER_KIND::Xmm0, REGISTER_KIND::Xmm1, REGISTER_KIND::Xmm2, REGISTER_KIND::Xmm3,
-        REGISTER_KIND::Xmm4, REGISTER_KIND::Xmm5, REGISTER_KIND::Xmm6, REGISTER_KIND::Xmm7}) {}
+        REGISTER_KIND::Xmm4, REGISTER_KIND::Xmm5, REGISTER_KIND::Xmm6, REGISTER_KIND::Xmm7}),
+    is_tail_call(false), p_double_static_constants(nullptr) {}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -70,7 +74,33 @@ static std::shared_ptr<AsmImm> generate_ulong_imm_operand(CConstULong* node) {
 static void generate_double_static_constant_top_level(
     const TIdentifier& identifier, TDouble value, TULong binary, TInt byte);
 
+// While functions are generated in parallel, the table of static constants is only read. A constant that is not in it
+// yet is kept with the function, and is added to the table once all the functions are generated.
+static std::shared_ptr<AsmData> generate_double_static_constant_job_operand(
+    TDouble value, TULong binary, TInt byte) {
+    TIdentifier static_constant_hash = std::to_string(binary);
+    if (frontend->static_constant_table.find(static_constant_hash) != frontend->static_constant_table.end()) {
+        TIdentifier static_constant_label = frontend->static_constant_table.at(static_constant_hash);
+        return std::make_shared<AsmData>(std::move(static_constant_label), 0l);
+    }
+    if (context->double_static_constant_map.find(static_constant_hash) == context->double_static_constant_map.end()) {
+        context->double_static_constant_map[static_constant_hash] = context->p_double_static_constants->size();
+        DoubleStaticConstant double_static_constant = {
+            represent_label_identifier(LABEL_KIND::Ldouble), value, binary, byte, {}};
+        context->p_double_static_constants->emplace_back(std::move(double_static_constant));
+    }
+    DoubleStaticConstant& double_static_constant =
+        (*context->p_double_static_constants)[context->double_static_constant_map[static_constant_hash]];
+    TIdentifier static_constant_label = double_static_constant.name;
+    std::shared_ptr<AsmData> data = std::make_shared<AsmData>(std::move(static_constant_label), 0l);
+    double_static_constant.data_operands.push_back(data);
+    return data;
+}
+
 static std::shared_ptr<AsmData> generate_double_static_constant_operand(TDouble value, TULong binary, TInt byte) {
+    if (context->p_double_static_constants) {
+        return generate_double_static_constant_job_operand(value, binary, byte);
+    }
     TIdentifier static_constant_label;
     {
         TIdentifier static_constant_hash = std::to_string(binary);
@@ -128,7 +158,7 @@ static std::shared_ptr<AsmPseudoMem> generate_pseudo_mem_operand(TacVariable* no
 }
 
 static std::shared_ptr<AsmOperand> generate_variable_operand(TacVariable* node) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Array_t:
         case AST_T::Structure_t:
             return generate_pseudo_mem_operand(node);
@@ -243,7 +273,7 @@ static bool is_constant_value_signed(TacConstant* node) {
 }
 
 static bool is_variable_value_signed(TacVariable* node) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Char_t:
         case AST_T::SChar_t:
         case AST_T::Int_t:
@@ -277,7 +307,7 @@ static bool is_constant_value_1byte(TacConstant* node) {
 }
 
 static bool is_variable_value_1byte(TacVariable* node) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Char_t:
         case AST_T::SChar_t:
         case AST_T::UChar_t:
@@ -309,7 +339,7 @@ static bool is_constant_value_4byte(TacConstant* node) {
 }
 
 static bool is_variable_value_4byte(TacVariable* node) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Int_t:
         case AST_T::UInt_t:
             return true;
@@ -332,7 +362,7 @@ static bool is_value_4byte(TacValue* node) {
 static bool is_constant_value_double(TacConstant* node) { return node->constant->type() == AST_T::CConstDouble_t; }
 
 static bool is_variable_value_double(TacVariable* node) {
-    return frontend->symbol_table[node->name]->type_t->type() == AST_T::Double_t;
+    return frontend->symbol_table.at(node->name)->type_t->type() == AST_T::Double_t;
 }
 
 static bool is_value_double(TacValue* node) {
@@ -347,7 +377,7 @@ static bool is_value_double(TacValue* node) {
 }
 
 static bool is_variable_value_structure(TacVariable* node) {
-    return frontend->symbol_table[node->name]->type_t->type() == AST_T::Structure_t;
+    return frontend->symbol_table.at(node->name)->type_t->type() == AST_T::Structure_t;
 }
 
 static bool is_value_structure(TacValue* node) {
@@ -395,7 +425,7 @@ static std::shared_ptr<AssemblyType> generate_assembly_type(TacValue* node) {
 }
 
 static std::shared_ptr<AssemblyType> generate_8byte_assembly_type(Structure* struct_type, TLong offset) {
-    TLong size = frontend->struct_typedef_table[struct_type->tag]->size - offset;
+    TLong size = frontend->struct_typedef_table.at(struct_type->tag)->size - offset;
     if (size >= 8l) {
         return std::make_shared<QuadWord>();
     }
@@ -413,7 +443,7 @@ static void generate_structure_type_classes(Structure* struct_type);
 
 static std::vector<STRUCT_8B_CLS> generate_structure_memory_type_classes(Structure* struct_type) {
     std::vector<STRUCT_8B_CLS> struct_8b_cls;
-    TLong size = frontend->struct_typedef_table[struct_type->tag]->size;
+    TLong size = frontend->struct_typedef_table.at(struct_type->tag)->size;
     while (size > 0l) {
         struct_8b_cls.push_back(STRUCT_8B_CLS::MEMORY);
         size -= 8l;
@@ -423,7 +453,8 @@ static std::vector<STRUCT_8B_CLS> generate_structure_memory_type_classes(Structu
 
 static std::vector<STRUCT_8B_CLS> generate_structure_one_reg_type_classes(Structure* struct_type) {
     std::vector<STRUCT_8B_CLS> struct_8b_cls {STRUCT_8B_CLS::SSE};
-    size_t members_front = struct_type->is_union ? frontend->struct_typedef_table[struct_type->tag]->members.size() : 1;
+    size_t members_front =
+        struct_type->is_union ? frontend->struct_typedef_table.at(struct_type->tag)->members.size() : 1;
     for (size_t i = 0; i < members_front; ++i) {
         if (struct_8b_cls[0] == STRUCT_8B_CLS::INTEGER) {
             break;
@@ -448,7 +479,8 @@ static std::vector<STRUCT_8B_CLS> generate_structure_one_reg_type_classes(Struct
 
 static std::vector<STRUCT_8B_CLS> generate_structure_two_regs_type_classes(Structure* struct_type) {
     std::vector<STRUCT_8B_CLS> struct_8b_cls {STRUCT_8B_CLS::SSE, STRUCT_8B_CLS::SSE};
-    size_t members_front = struct_type->is_union ? frontend->struct_typedef_table[struct_type->tag]->members.size() : 1;
+    size_t members_front =
+        struct_type->is_union ? frontend->struct_typedef_table.at(struct_type->tag)->members.size() : 1;
     for (size_t i = 0; i < members_front; ++i) {
         if (struct_8b_cls[0] == STRUCT_8B_CLS::INTEGER && struct_8b_cls[1] == STRUCT_8B_CLS::INTEGER) {
             break;
@@ -464,7 +496,7 @@ static std::vector<STRUCT_8B_CLS> generate_structure_two_regs_type_classes(Struc
             while (member_type->type() == AST_T::Array_t);
         }
         if (member_type->type() == AST_T::Structure_t) {
-            size *= frontend->struct_typedef_table[static_cast<Structure*>(member_type)->tag]->size;
+            size *= frontend->struct_typedef_table.at(static_cast<Structure*>(member_type)->tag)->size;
         }
         else {
             size *= generate_type_alignment(member_type);
@@ -528,10 +560,10 @@ static std::vector<STRUCT_8B_CLS> generate_structure_two_regs_type_classes(Struc
 static void generate_structure_type_classes(Structure* struct_type) {
     if (context->struct_8b_cls_map.find(struct_type->tag) == context->struct_8b_cls_map.end()) {
         std::vector<STRUCT_8B_CLS> struct_8b_cls;
-        if (frontend->struct_typedef_table[struct_type->tag]->size > 16l) {
+        if (frontend->struct_typedef_table.at(struct_type->tag)->size > 16l) {
             struct_8b_cls = generate_structure_memory_type_classes(struct_type);
         }
-        else if (frontend->struct_typedef_table[struct_type->tag]->size > 8l) {
+        else if (frontend->struct_typedef_table.at(struct_type->tag)->size > 8l) {
             struct_8b_cls = generate_structure_two_regs_type_classes(struct_type);
         }
         else {
@@ -609,7 +641,7 @@ static void generate_8byte_return_instructions(
 
 static void generate_return_structure_instructions(TacReturn* node) {
     TIdentifier name = static_cast<TacVariable*>(node->val.get())->name;
-    Structure* struct_type = static_cast<Structure*>(frontend->symbol_table[name]->type_t.get());
+    Structure* struct_type = static_cast<Structure*>(frontend->symbol_table.at(name)->type_t.get());
     generate_structure_type_classes(struct_type);
     if (context->struct_8b_cls_map[struct_type->tag][0] == STRUCT_8B_CLS::MEMORY) {
         {
@@ -619,7 +651,7 @@ static void generate_return_structure_instructions(TacReturn* node) {
             push_instruction(std::make_unique<AsmMov>(std::move(assembly_type_src), std::move(src), std::move(dst)));
         }
         {
-            TLong size = frontend->struct_typedef_table[struct_type->tag]->size;
+            TLong size = frontend->struct_typedef_table.at(struct_type->tag)->size;
             TLong offset = 0l;
             while (size > 0l) {
                 std::shared_ptr<AsmOperand> src = generate_operand(node->val.get());
@@ -681,6 +713,10 @@ static void generate_return_structure_instructions(TacReturn* node) {
 }
 
 static void generate_return_instructions(TacReturn* node) {
+    if (context->is_tail_call) {
+        context->is_tail_call = false;
+        return;
+    }
     if (node->val) {
         if (is_value_double(node->val.get())) {
             generate_return_double_instructions(node);
@@ -1135,7 +1171,7 @@ static TLong generate_arg_fun_call_instructions(TacFunCall* node, bool is_return
             size_t struct_reg_size = 7;
             size_t struct_sse_size = 9;
             TIdentifier name = static_cast<TacVariable*>(arg.get())->name;
-            Structure* struct_type = static_cast<Structure*>(frontend->symbol_table[name]->type_t.get());
+            Structure* struct_type = static_cast<Structure*>(frontend->symbol_table.at(name)->type_t.get());
             generate_structure_type_classes(struct_type);
             if (context->struct_8b_cls_map[struct_type->tag][0] != STRUCT_8B_CLS::MEMORY) {
                 struct_reg_size = 0;
@@ -1248,7 +1284,7 @@ static void generate_fun_call_instructions(TacFunCall* node) {
     {
         if (node->dst && is_value_structure(node->dst.get())) {
             TIdentifier name = static_cast<TacVariable*>(node->dst.get())->name;
-            Structure* struct_type = static_cast<Structure*>(frontend->symbol_table[name]->type_t.get());
+            Structure* struct_type = static_cast<Structure*>(frontend->symbol_table.at(name)->type_t.get());
             generate_structure_type_classes(struct_type);
             if (context->struct_8b_cls_map[struct_type->tag][0] == STRUCT_8B_CLS::MEMORY) {
                 is_return_memory = true;
@@ -1261,6 +1297,14 @@ static void generate_fun_call_instructions(TacFunCall* node) {
         }
         TLong stack_padding = generate_arg_fun_call_instructions(node, is_return_memory);
 
+        // A tail call jumps to the callee, which returns its result directly to the caller, and the following return
+        // is skipped. It stays a call when the callee reads arguments from the stack or returns its result in memory.
+        if (node->is_tail_call && !is_return_memory && stack_padding == 0l) {
+            TIdentifier name = node->name;
+            push_instruction(std::make_unique<AsmTailCall>(std::move(name)));
+            context->is_tail_call = true;
+            return;
+        }
         {
             TIdentifier name = node->name;
             push_instruction(std::make_unique<AsmCall>(std::move(name)));
@@ -1281,7 +1325,7 @@ static void generate_fun_call_instructions(TacFunCall* node) {
         else {
             bool reg_size = false;
             TIdentifier name = static_cast<TacVariable*>(node->dst.get())->name;
-            Structure* struct_type = static_cast<Structure*>(frontend->symbol_table[name]->type_t.get());
+            Structure* struct_type = static_cast<Structure*>(frontend->symbol_table.at(name)->type_t.get());
             switch (context->struct_8b_cls_map[struct_type->tag][0]) {
                 case STRUCT_8B_CLS::INTEGER: {
                     generate_8byte_return_fun_call_instructions(name, 0l, struct_type, REGISTER_KIND::Ax);
@@ -1647,33 +1691,109 @@ static void generate_binary_instructions(TacBinary* node) {
     }
 }
 
-static void generate_copy_structure_instructions(TacCopy* node) {
-    TIdentifier src_name = static_cast<TacVariable*>(node->src.get())->name;
-    TIdentifier dst_name = static_cast<TacVariable*>(node->dst.get())->name;
-    Structure* struct_type = static_cast<Structure*>(frontend->symbol_table[src_name]->type_t.get());
-    TLong size = frontend->struct_typedef_table[struct_type->tag]->size;
-    TLong offset = 0l;
-    while (size > 0l) {
-        std::shared_ptr<AsmOperand> src = std::make_shared<AsmPseudoMem>(src_name, offset);
-        std::shared_ptr<AsmOperand> dst = std::make_shared<AsmPseudoMem>(dst_name, offset);
-        std::shared_ptr<AssemblyType> assembly_type_src;
-        if (size >= 8l) {
-            assembly_type_src = std::make_shared<QuadWord>();
-            size -= 8l;
-            offset += 8l;
-        }
-        else if (size >= 4l) {
-            assembly_type_src = std::make_shared<LongWord>();
-            size -= 4l;
-            offset += 4l;
-        }
-        else {
-            assembly_type_src = std::make_shared<Byte>();
-            size--;
-            offset++;
+static std::shared_ptr<AsmOperand> generate_structure_offset_operand(AsmOperand* node, TLong offset) {
+    switch (node->type()) {
+        case AST_T::AsmPseudoMem_t: {
+            AsmPseudoMem* p_node = static_cast<AsmPseudoMem*>(node);
+            TIdentifier name = p_node->name;
+            TLong to_offset = p_node->offset + offset;
+            return std::make_shared<AsmPseudoMem>(std::move(name), std::move(to_offset));
+        }
+        case AST_T::AsmMemory_t: {
+            AsmMemory* p_node = static_cast<AsmMemory*>(node);
+            if (p_node->reg->type() != AST_T::AsmAx_t) {
+                RAISE_INTERNAL_ERROR;
+            }
+            return generate_memory(REGISTER_KIND::Ax, p_node->value + offset);
         }
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+static void generate_structure_chunk_instructions(
+    AsmOperand* src_base, AsmOperand* dst_base, TLong offset, TLong size) {
+    std::shared_ptr<AsmOperand> src = generate_structure_offset_operand(src_base, offset);
+    std::shared_ptr<AsmOperand> dst = generate_structure_offset_operand(dst_base, offset);
+    if (size == 16l) {
+        push_instruction(std::make_unique<AsmMovdqu>(std::move(src), std::move(dst)));
+        return;
+    }
+    std::shared_ptr<AssemblyType> assembly_type;
+    switch (size) {
+        case 8l:
+            assembly_type = std::make_shared<QuadWord>();
+            break;
+        case 4l:
+            assembly_type = std::make_shared<LongWord>();
+            break;
+        case 1l:
+            assembly_type = std::make_shared<Byte>();
+            break;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+    push_instruction(std::make_unique<AsmMov>(std::move(assembly_type), std::move(src), std::move(dst)));
+}
+
+static void generate_structure_rep_movsb_instructions(AsmOperand* src_base, AsmOperand* dst_base, TLong size) {
+    {
+        std::shared_ptr<AsmOperand> src = generate_structure_offset_operand(src_base, 0l);
+        std::shared_ptr<AsmOperand> dst = generate_register(REGISTER_KIND::Si);
+        push_instruction(std::make_unique<AsmLea>(std::move(src), std::move(dst)));
+    }
+    {
+        std::shared_ptr<AsmOperand> src = generate_structure_offset_operand(dst_base, 0l);
+        std::shared_ptr<AsmOperand> dst = generate_register(REGISTER_KIND::Di);
+        push_instruction(std::make_unique<AsmLea>(std::move(src), std::move(dst)));
+    }
+    {
+        TIdentifier value = std::to_string(size);
+        std::shared_ptr<AsmOperand> src = std::make_shared<AsmImm>(false, size > 2147483647l, std::move(value));
+        std::shared_ptr<AsmOperand> dst = generate_register(REGISTER_KIND::Cx);
+        std::shared_ptr<AssemblyType> assembly_type_src = std::make_shared<QuadWord>();
         push_instruction(std::make_unique<AsmMov>(std::move(assembly_type_src), std::move(src), std::move(dst)));
     }
+    push_instruction(std::make_unique<AsmRepMovsb>());
+}
+
+// Structures are copied with rep movsb above 256 bytes, and else with the widest moves that fit, up to 16 bytes
+// through an xmm register. The remaining bytes are then copied by one more move that overlaps the previous one.
+static void generate_structure_copy_instructions(AsmOperand* src_base, AsmOperand* dst_base, TLong size) {
+    if (size > 256l) {
+        generate_structure_rep_movsb_instructions(src_base, dst_base, size);
+        return;
+    }
+    TLong chunk_size;
+    if (size >= 16l) {
+        chunk_size = 16l;
+    }
+    else if (size >= 8l) {
+        chunk_size = 8l;
+    }
+    else if (size >= 4l) {
+        chunk_size = 4l;
+    }
+    else {
+        chunk_size = 1l;
+    }
+    TLong offset = 0l;
+    for (; offset + chunk_size <= size; offset += chunk_size) {
+        generate_structure_chunk_instructions(src_base, dst_base, offset, chunk_size);
+    }
+    if (offset < size) {
+        generate_structure_chunk_instructions(src_base, dst_base, size - chunk_size, chunk_size);
+    }
+}
+
+static void generate_copy_structure_instructions(TacCopy* node) {
+    TIdentifier src_name = static_cast<TacVariable*>(node->src.get())->name;
+    TIdentifier dst_name = static_cast<TacVariable*>(node->dst.get())->name;
+    Structure* struct_type = static_cast<Structure*>(frontend->symbol_table.at(src_name)->type_t.get());
+    TLong size = frontend->struct_typedef_table.at(struct_type->tag)->size;
+    std::shared_ptr<AsmOperand> src = std::make_shared<AsmPseudoMem>(std::move(src_name), 0l);
+    std::shared_ptr<AsmOperand> dst = std::make_shared<AsmPseudoMem>(std::move(dst_name), 0l);
+    generate_structure_copy_instructions(src.get(), dst.get(), size);
 }
 
 static void generate_copy_scalar_instructions(TacCopy* node) {
@@ -1692,13 +1812,42 @@ static void generate_copy_instructions(TacCopy* node) {
     }
 }
 
+// Doubles are only moved between memory operands, so that they are selected as quad words.
+static void generate_select_instructions(TacSelect* node) {
+    std::shared_ptr<AsmOperand> dst = generate_operand(node->dst.get());
+    std::shared_ptr<AssemblyType> assembly_type_dst;
+    if (is_value_double(node->dst.get())) {
+        assembly_type_dst = std::make_shared<QuadWord>();
+    }
+    else {
+        assembly_type_dst = generate_assembly_type(node->dst.get());
+    }
+    {
+        std::shared_ptr<AsmOperand> imm_zero = std::make_shared<AsmImm>(true, false, "0");
+        std::shared_ptr<AsmOperand> condition = generate_operand(node->condition.get());
+        std::shared_ptr<AssemblyType> assembly_type_cond = generate_assembly_type(node->condition.get());
+        push_instruction(
+            std::make_unique<AsmCmp>(std::move(assembly_type_cond), std::move(imm_zero), std::move(condition)));
+    }
+    {
+        std::shared_ptr<AsmOperand> src_false = generate_operand(node->src_false.get());
+        push_instruction(std::make_unique<AsmMov>(assembly_type_dst, std::move(src_false), dst));
+    }
+    {
+        std::shared_ptr<AsmOperand> src_true = generate_operand(node->src_true.get());
+        std::unique_ptr<AsmCondCode> cond_code_ne = std::make_unique<AsmNE>();
+        push_instruction(std::make_unique<AsmCmov>(
+            std::move(cond_code_ne), std::move(assembly_type_dst), std::move(src_true), std::move(dst)));
+    }
+}
+
 static void generate_get_address_instructions(TacGetAddress* node) {
     std::shared_ptr<AsmOperand> src;
     {
         if (node->src->type() == AST_T::TacVariable_t) {
             TIdentifier name = static_cast<TacVariable*>(node->src.get())->name;
             if (frontend->symbol_table.find(name) != frontend->symbol_table.end()
-                && frontend->symbol_table[name]->attrs->type() == AST_T::ConstantAttr_t) {
+                && frontend->symbol_table.at(name)->attrs->type() == AST_T::ConstantAttr_t) {
                 src = std::make_shared<AsmData>(std::move(name), 0l);
                 goto Lpass;
             }
@@ -1719,30 +1868,11 @@ static void generate_load_structure_instructions(TacLoad* node) {
     }
     {
         TIdentifier name = static_cast<TacVariable*>(node->dst.get())->name;
-        Structure* struct_type = static_cast<Structure*>(frontend->symbol_table[name]->type_t.get());
-        TLong size = frontend->struct_typedef_table[struct_type->tag]->size;
-        TLong offset = 0l;
-        while (size > 0l) {
-            std::shared_ptr<AsmOperand> src = generate_memory(REGISTER_KIND::Ax, offset);
-            std::shared_ptr<AsmOperand> dst = std::make_shared<AsmPseudoMem>(name, offset);
-            std::shared_ptr<AssemblyType> assembly_type_dst;
-            if (size >= 8l) {
-                assembly_type_dst = std::make_shared<QuadWord>();
-                size -= 8l;
-                offset += 8l;
-            }
-            else if (size >= 4l) {
-                assembly_type_dst = std::make_shared<LongWord>();
-                size -= 4l;
-                offset += 4l;
-            }
-            else {
-                assembly_type_dst = std::make_shared<Byte>();
-                size--;
-                offset++;
-            }
-            push_instruction(std::make_unique<AsmMov>(std::move(assembly_type_dst), std::move(src), std::move(dst)));
-        }
+        Structure* struct_type = static_cast<Structure*>(frontend->symbol_table.at(name)->type_t.get());
+        TLong size = frontend->struct_typedef_table.at(struct_type->tag)->size;
+        std::shared_ptr<AsmOperand> src = generate_memory(REGISTER_KIND::Ax, 0l);
+        std::shared_ptr<AsmOperand> dst = std::make_shared<AsmPseudoMem>(std::move(name), 0l);
+        generate_structure_copy_instructions(src.get(), dst.get(), size);
     }
 }
 
@@ -1779,30 +1909,11 @@ static void generate_store_structure_instructions(TacStore* node) {
     }
     {
         TIdentifier name = static_cast<TacVariable*>(node->src.get())->name;
-        Structure* struct_type = static_cast<Structure*>(frontend->symbol_table[name]->type_t.get());
-        TLong size = frontend->struct_typedef_table[struct_type->tag]->size;
-        TLong offset = 0l;
-        while (size > 0l) {
-            std::shared_ptr<AsmOperand> src = std::make_shared<AsmPseudoMem>(name, offset);
-            std::shared_ptr<AsmOperand> dst = generate_memory(REGISTER_KIND::Ax, offset);
-            std::shared_ptr<AssemblyType> assembly_type_dst;
-            if (size >= 8l) {
-                assembly_type_dst = std::make_shared<QuadWord>();
-                size -= 8l;
-                offset += 8l;
-            }
-            else if (size >= 4l) {
-                assembly_type_dst = std::make_shared<LongWord>();
-                size -= 4l;
-                offset += 4l;
-            }
-            else {
-                assembly_type_dst = std::make_shared<Byte>();
-                size--;
-                offset++;
-            }
-            push_instruction(std::make_unique<AsmMov>(std::move(assembly_type_dst), std::move(src), std::move(dst)));
-        }
+        Structure* struct_type = static_cast<Structure*>(frontend->symbol_table.at(name)->type_t.get());
+        TLong size = frontend->struct_typedef_table.at(struct_type->tag)->size;
+        std::shared_ptr<AsmOperand> src = std::make_shared<AsmPseudoMem>(std::move(name), 0l);
+        std::shared_ptr<AsmOperand> dst = generate_memory(REGISTER_KIND::Ax, 0l);
+        generate_structure_copy_instructions(src.get(), dst.get(), size);
     }
 }
 
@@ -1929,35 +2040,16 @@ static void generate_add_ptr_instructions(TacAddPtr* node) {
 
 static void generate_copy_to_offset_structure_instructions(TacCopyToOffset* node) {
     TIdentifier src_name = static_cast<TacVariable*>(node->src.get())->name;
-    Structure* struct_type = static_cast<Structure*>(frontend->symbol_table[src_name]->type_t.get());
-    TLong size = frontend->struct_typedef_table[struct_type->tag]->size;
-    TLong offset = 0l;
-    while (size > 0l) {
-        std::shared_ptr<AsmOperand> src = std::make_shared<AsmPseudoMem>(src_name, offset);
-        std::shared_ptr<AsmOperand> dst;
-        {
-            TIdentifier dst_name = node->dst_name;
-            TLong to_offset = offset + node->offset;
-            dst = std::make_shared<AsmPseudoMem>(std::move(dst_name), std::move(to_offset));
-        }
-        std::shared_ptr<AssemblyType> assembly_type_src;
-        if (size >= 8l) {
-            assembly_type_src = std::make_shared<QuadWord>();
-            size -= 8l;
-            offset += 8l;
-        }
-        else if (size >= 4l) {
-            assembly_type_src = std::make_shared<LongWord>();
-            size -= 4l;
-            offset += 4l;
-        }
-        else {
-            assembly_type_src = std::make_shared<Byte>();
-            size--;
-            offset++;
-        }
-        push_instruction(std::make_unique<AsmMov>(std::move(assembly_type_src), std::move(src), std::move(dst)));
+    Structure* struct_type = static_cast<Structure*>(frontend->symbol_table.at(src_name)->type_t.get());
+    TLong size = frontend->struct_typedef_table.at(struct_type->tag)->size;
+    std::shared_ptr<AsmOperand> src = std::make_shared<AsmPseudoMem>(std::move(src_name), 0l);
+    std::shared_ptr<AsmOperand> dst;
+    {
+        TIdentifier dst_name = node->dst_name;
+        TLong to_offset = node->offset;
+        dst = std::make_shared<AsmPseudoMem>(std::move(dst_name), std::move(to_offset));
     }
+    generate_structure_copy_instructions(src.get(), dst.get(), size);
 }
 
 static void generate_copy_to_offset_scalar_instructions(TacCopyToOffset* node) {
@@ -1983,35 +2075,16 @@ static void generate_copy_to_offset_instructions(TacCopyToOffset* node) {
 
 static void generate_copy_from_offset_structure_instructions(TacCopyFromOffset* node) {
     TIdentifier dst_name = static_cast<TacVariable*>(node->dst.get())->name;
-    Structure* struct_type = static_cast<Structure*>(frontend->symbol_table[dst_name]->type_t.get());
-    TLong size = frontend->struct_typedef_table[struct_type->tag]->size;
-    TLong offset = 0l;
-    while (size > 0l) {
-        std::shared_ptr<AsmOperand> src;
-        {
-            TIdentifier src_name = node->src_name;
-            TLong from_offset = offset + node->offset;
-            src = std::make_shared<AsmPseudoMem>(std::move(src_name), std::move(from_offset));
-        }
-        std::shared_ptr<AsmOperand> dst = std::make_shared<AsmPseudoMem>(dst_name, offset);
-        std::shared_ptr<AssemblyType> assembly_type_dst;
-        if (size >= 8l) {
-            assembly_type_dst = std::make_shared<QuadWord>();
-            size -= 8l;
-            offset += 8l;
-        }
-        else if (size >= 4l) {
-            assembly_type_dst = std::make_shared<LongWord>();
-            size -= 4l;
-            offset += 4l;
-        }
-        else {
-            assembly_type_dst = std::make_shared<Byte>();
-            size--;
-            offset++;
-        }
-        push_instruction(std::make_unique<AsmMov>(std::move(assembly_type_dst), std::move(src), std::move(dst)));
+    Structure* struct_type = static_cast<Structure*>(frontend->symbol_table.at(dst_name)->type_t.get());
+    TLong size = frontend->struct_typedef_table.at(struct_type->tag)->size;
+    std::shared_ptr<AsmOperand> src;
+    {
+        TIdentifier src_name = node->src_name;
+        TLong from_offset = node->offset;
+        src = std::make_shared<AsmPseudoMem>(std::move(src_name), std::move(from_offset));
     }
+    std::shared_ptr<AsmOperand> dst = std::make_shared<AsmPseudoMem>(std::move(dst_name), 0l);
+    generate_structure_copy_instructions(src.get(), dst.get(), size);
 }
 
 static void generate_copy_from_offset_scalar_instructions(TacCopyFromOffset* node) {
@@ -2182,6 +2255,9 @@ static void generate_instructions(TacInstruction* node) {
         case AST_T::TacCopy_t:
             generate_copy_instructions(static_cast<TacCopy*>(node));
             break;
+        case AST_T::TacSelect_t:
+            generate_select_instructions(static_cast<TacSelect*>(node));
+            break;
         case AST_T::TacGetAddress_t:
             generate_get_address_instructions(static_cast<TacGetAddress*>(node));
             break;
@@ -2218,12 +2294,14 @@ static void generate_instructions(TacInstruction* node) {
 }
 
 // instruction = Mov(assembly_type, operand, operand) | MovSx(assembly_type, assembly_type, operand, operand)
-//             | MovZeroExtend(assembly_type, assembly_type, operand, operand) | Lea(operand, operand)
-//             | Cvttsd2si(assembly_type, operand, operand) | Cvtsi2sd(assembly_type, operand, operand)
-//             | Unary(unary_operator, assembly_type, operand) | Binary(binary_operator, assembly_type, operand,
-//             operand) | Cmp(assembly_type, operand, operand) | Idiv(assembly_type, operand) | Div(assembly_type,
-//             operand) | Cdq(assembly_type) | Jmp(identifier) | JmpCC(cond_code, identifier) | SetCC(cond_code,
-//             operand) | Label(identifier) | Push(operand) | Call(identifier) | Ret
+//             | MovZeroExtend(assembly_type, assembly_type, operand, operand) | Movdqu(operand, operand)
+//             | Lea(operand, operand) | Cvttsd2si(assembly_type, operand, operand)
+//             | Cvtsi2sd(assembly_type, operand, operand) | Unary(unary_operator, assembly_type, operand)
+//             | Binary(binary_operator, assembly_type, operand, operand) | Cmp(assembly_type, operand, operand)
+//             | Idiv(assembly_type, operand) | Div(assembly_type, operand) | Cdq(assembly_type) | RepMovsb
+//             | Jmp(identifier) | JmpCC(cond_code, identifier) | SetCC(cond_code, operand)
+//             | Cmov(cond_code, assembly_type, operand, operand) | Label(identifier) | Push(operand)
+//             | Call(identifier) | TailCall(identifier) | Ret
 static void generate_list_instructions(const std::vector<std::unique_ptr<TacInstruction>>& list_node) {
     for (const auto& instruction : list_node) {
         if (instruction) {
@@ -2299,7 +2377,7 @@ static void generate_param_function_top_level(TacFunction* node, bool is_return_
     size_t sse_size = 0;
     TLong stack_bytes = 16l;
     for (const auto& param : node->params) {
-        if (frontend->symbol_table[param]->type_t->type() == AST_T::Double_t) {
+        if (frontend->symbol_table.at(param)->type_t->type() == AST_T::Double_t) {
             if (sse_size < 8) {
                 generate_reg_param_function_instructions(param, context->ARG_SSE_REGISTERS[sse_size]);
                 sse_size++;
@@ -2309,7 +2387,7 @@ static void generate_param_function_top_level(TacFunction* node, bool is_return_
                 stack_bytes += 8l;
             }
         }
-        else if (frontend->symbol_table[param]->type_t->type() != AST_T::Structure_t) {
+        else if (frontend->symbol_table.at(param)->type_t->type() != AST_T::Structure_t) {
             if (reg_size < 6) {
                 generate_reg_param_function_instructions(param, context->ARG_REGISTERS[reg_size]);
                 reg_size++;
@@ -2322,7 +2400,7 @@ static void generate_param_function_top_level(TacFunction* node, bool is_return_
         else {
             size_t struct_reg_size = 7;
             size_t struct_sse_size = 9;
-            Structure* struct_type = static_cast<Structure*>(frontend->symbol_table[param]->type_t.get());
+            Structure* struct_type = static_cast<Structure*>(frontend->symbol_table.at(param)->type_t.get());
             generate_structure_type_classes(struct_type);
             if (context->struct_8b_cls_map[struct_type->tag][0] != STRUCT_8B_CLS::MEMORY) {
                 struct_reg_size = 0;
@@ -2365,15 +2443,19 @@ static void generate_param_function_top_level(TacFunction* node, bool is_return_
 }
 
 static std::unique_ptr<AsmFunction> generate_function_top_level(TacFunction* node) {
+    TRACE_EVENT_BEGIN("assembly_generation");
+    TRACE_EVENT_ARG("function", node->name);
+    TRACE_EVENT_ARG("tac_instructions", node->body.size());
     TIdentifier name = node->name;
     bool is_global = node->is_global;
     bool is_return_memory = false;
+    bool is_frame_pointer = true;
 
     std::vector<std::unique_ptr<AsmInstruction>> body;
     {
         context->p_instructions = &body;
 
-        FunType* fun_type = static_cast<FunType*>(frontend->symbol_table[node->name]->type_t.get());
+        FunType* fun_type = static_cast<FunType*>(frontend->symbol_table.at(node->name)->type_t.get());
         if (fun_type->ret_type->type() == AST_T::Structure_t) {
             Structure* struct_type = static_cast<Structure*>(fun_type->ret_type.get());
             generate_structure_type_classes(struct_type);
@@ -2394,8 +2476,10 @@ static std::unique_ptr<AsmFunction> generate_function_top_level(TacFunction* nod
         context->p_instructions = nullptr;
     }
 
-    return std::make_unique<AsmFunction>(
-        std::move(name), std::move(is_global), std::move(is_return_memory), std::move(body));
+    TRACE_EVENT_ARG("asm_instructions", body.size());
+    TRACE_EVENT_END("assembly_generation");
+    return std::make_unique<AsmFunction>(std::move(name), std::move(is_global), std::move(is_return_memory),
+        std::move(is_frame_pointer), std::move(body));
 }
 
 static std::unique_ptr<AsmStaticVariable> generate_static_variable_top_level(TacStaticVariable* node) {
@@ -2427,8 +2511,8 @@ static std::unique_ptr<AsmStaticConstant> generate_static_constant_top_level(Tac
     return std::make_unique<AsmStaticConstant>(std::move(name), std::move(alignment), std::move(static_init));
 }
 
-// top_level = Function(identifier, bool, bool, instruction*) | StaticVariable(identifier, bool, int, static_init*)
-//           | StaticConstant(identifier, int, static_init)
+// top_level = Function(identifier, bool, bool, bool, instruction*)
+//           | StaticVariable(identifier, bool, int, static_init*) | StaticConstant(identifier, int, static_init)
 static std::unique_ptr<AsmTopLevel> generate_top_level(TacTopLevel* node) {
     switch (node->type()) {
         case AST_T::TacFunction_t:
@@ -2442,6 +2526,24 @@ static std::unique_ptr<AsmTopLevel> generate_top_level(TacTopLevel* node) {
     }
 }
 
+// Constants are merged in the order of the functions, and the ones already added by a previous function are renamed to
+// the label they were added with.
+static void merge_double_static_constants(std::vector<DoubleStaticConstant>& double_static_constants) {
+    for (auto& double_static_constant : double_static_constants) {
+        TIdentifier static_constant_hash = std::to_string(double_static_constant.binary);
+        if (frontend->static_constant_table.find(static_constant_hash) != frontend->static_constant_table.end()) {
+            for (const auto& data : double_static_constant.data_operands) {
+                data->name = frontend->static_constant_table[static_constant_hash];
+            }
+        }
+        else {
+            frontend->static_constant_table[static_constant_hash] = double_static_constant.name;
+            generate_double_static_constant_top_level(double_static_constant.name, double_static_constant.value,
+                double_static_constant.binary, double_static_constant.byte);
+        }
+    }
+}
+
 // AST = Program(top_level*, top_level*)
 static std::unique_ptr<AsmProgram> generate_program(TacProgram* node) {
     std::vector<std::unique_ptr<AsmTopLevel>> static_constant_top_levels;
@@ -2460,9 +2562,17 @@ static std::unique_ptr<AsmProgram> generate_program(TacProgram* node) {
             std::unique_ptr<AsmTopLevel> static_variable_top_level = generate_top_level(top_level.get());
             top_levels.push_back(std::move(static_variable_top_level));
         }
-        for (const auto& top_level : node->function_top_levels) {
-            std::unique_ptr<AsmTopLevel> function_top_level = generate_top_level(top_level.get());
-            top_levels.push_back(std::move(function_top_level));
+        if (jobs_context) {
+            for (size_t i = 0; i < jobs_context->function_top_levels.size(); ++i) {
+                merge_double_static_constants(jobs_context->double_static_constants[i]);
+                top_levels.push_back(std::move(jobs_context->function_top_levels[i]));
+            }
+        }
+        else {
+            for (const auto& top_level : node->function_top_levels) {
+                std::unique_ptr<AsmTopLevel> function_top_level = generate_top_level(top_level.get());
+                top_levels.push_back(std::move(function_top_level));
+            }
         }
         context->p_static_constant_top_levels = nullptr;
     }
@@ -2472,10 +2582,36 @@ static std::unique_ptr<AsmProgram> generate_program(TacProgram* node) {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-std::unique_ptr<AsmProgram> assembly_generation(std::unique_ptr<TacProgram> tac_ast) {
+// Functions are generated independently, so each job thread has its own context and takes whole functions, with labels
+// numbered within the function.
+static void init_generation_job() { context = std::make_unique<AsmGenContext>(); }
+
+static void generate_function_job(size_t function_index) {
+    begin_label_shard(function_index);
+    context->double_static_constant_map.clear();
+    context->p_double_static_constants = &jobs_context->double_static_constants[function_index];
+    jobs_context->function_top_levels[function_index] =
+        generate_top_level(jobs_context->p_node->function_top_levels[function_index].get());
+    context->p_double_static_constants = nullptr;
+    end_label_shard();
+}
+
+static void free_generation_job() { context.reset(); }
+
+std::unique_ptr<AsmProgram> assembly_generation(std::unique_ptr<TacProgram> tac_ast, size_t jobs) {
+    jobs_context.reset();
+    if (jobs > 1) {
+        jobs_context = std::make_unique<AsmGenJobsContext>();
+        jobs_context->p_node = tac_ast.get();
+        jobs_context->function_top_levels.resize(tac_ast->function_top_levels.size());
+        jobs_context->double_static_constants.resize(tac_ast->function_top_levels.size());
+        run_jobs(jobs, tac_ast->function_top_levels.size(), init_generation_job, generate_function_job,
+            free_generation_job);
+    }
     context = std::make_unique<AsmGenContext>();
     std::unique_ptr<AsmProgram> asm_ast = generate_program(tac_ast.get());
     context.reset();
+    jobs_context.reset();
 
     tac_ast.reset();
     if (!asm_ast) {
@@ -1,8 +1,12 @@
 #include <memory>
+#include <stdlib.h>
 #include <string>
 #include <vector>
 
+#include "util/jobs.hpp"
+#include "util/stats.hpp"
 #include "util/throw.hpp"
+#include "util/trace.hpp"
 
 #include "ast/ast.hpp"
 #include "ast/back_ast.hpp"
@@ -11,9 +15,11 @@
 #include "backend/assembly/registers.hpp"
 #include "backend/assembly/stack_fix.hpp"
 
-static std::unique_ptr<StackFixContext> context;
+static thread_local std::unique_ptr<StackFixContext> context;
+static std::unique_ptr<StackFixJobsContext> jobs_context;
 
-StackFixContext::StackFixContext() : stack_bytes(0l) {}
+StackFixContext::StackFixContext(bool is_omit_frame_pointer) :
+    stack_bytes(0l), is_omit_frame_pointer(is_omit_frame_pointer), frame_offset(0l), push_bytes(0l) {}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -88,13 +94,14 @@ static void allocate_offset_pseudo_mem_register(AssemblyType* assembly_type) {
 static std::shared_ptr<AsmOperand> replace_operand_pseudo_register(AsmPseudo* node) {
     if (context->pseudo_stack_bytes_map.find(node->name) == context->pseudo_stack_bytes_map.end()) {
 
-        BackendObj* backend_obj = static_cast<BackendObj*>(backend->backend_symbol_table[node->name].get());
+        BackendObj* backend_obj = static_cast<BackendObj*>(backend->backend_symbol_table.at(node->name).get());
         if (backend_obj->is_static) {
             return replace_pseudo_register_data(node);
         }
         else {
             allocate_offset_pseudo_register(backend_obj->assembly_type.get());
             context->pseudo_stack_bytes_map[node->name] = context->stack_bytes;
+            INCREMENT_STATS(STATS_COUNTER::allocated_pseudo_registers);
         }
     }
 
@@ -104,13 +111,14 @@ static std::shared_ptr<AsmOperand> replace_operand_pseudo_register(AsmPseudo* no
 static std::shared_ptr<AsmOperand> replace_operand_pseudo_mem_register(AsmPseudoMem* node) {
     if (context->pseudo_stack_bytes_map.find(node->name) == context->pseudo_stack_bytes_map.end()) {
 
-        BackendObj* backend_obj = static_cast<BackendObj*>(backend->backend_symbol_table[node->name].get());
+        BackendObj* backend_obj = static_cast<BackendObj*>(backend->backend_symbol_table.at(node->name).get());
         if (backend_obj->is_static) {
             return replace_pseudo_mem_register_data(node);
         }
         else {
             allocate_offset_pseudo_mem_register(backend_obj->assembly_type.get());
             context->pseudo_stack_bytes_map[node->name] = context->stack_bytes;
+            INCREMENT_STATS(STATS_COUNTER::allocated_pseudo_registers);
         }
     }
 
@@ -198,6 +206,33 @@ static void replace_mov_zero_extend_pseudo_registers(AsmMovZeroExtend* node) {
     }
 }
 
+static void replace_movdqu_pseudo_registers(AsmMovdqu* node) {
+    switch (node->src->type()) {
+        case AST_T::AsmPseudo_t: {
+            node->src = replace_operand_pseudo_register(static_cast<AsmPseudo*>(node->src.get()));
+            break;
+        }
+        case AST_T::AsmPseudoMem_t: {
+            node->src = replace_operand_pseudo_mem_register(static_cast<AsmPseudoMem*>(node->src.get()));
+            break;
+        }
+        default:
+            break;
+    }
+    switch (node->dst->type()) {
+        case AST_T::AsmPseudo_t: {
+            node->dst = replace_operand_pseudo_register(static_cast<AsmPseudo*>(node->dst.get()));
+            break;
+        }
+        case AST_T::AsmPseudoMem_t: {
+            node->dst = replace_operand_pseudo_mem_register(static_cast<AsmPseudoMem*>(node->dst.get()));
+            break;
+        }
+        default:
+            break;
+    }
+}
+
 static void replace_lea_pseudo_registers(AsmLea* node) {
     switch (node->src->type()) {
         case AST_T::AsmPseudo_t: {
@@ -393,6 +428,33 @@ static void replace_set_cc_pseudo_registers(AsmSetCC* node) {
     }
 }
 
+static void replace_cmov_pseudo_registers(AsmCmov* node) {
+    switch (node->src->type()) {
+        case AST_T::AsmPseudo_t: {
+            node->src = replace_operand_pseudo_register(static_cast<AsmPseudo*>(node->src.get()));
+            break;
+        }
+        case AST_T::AsmPseudoMem_t: {
+            node->src = replace_operand_pseudo_mem_register(static_cast<AsmPseudoMem*>(node->src.get()));
+            break;
+        }
+        default:
+            break;
+    }
+    switch (node->dst->type()) {
+        case AST_T::AsmPseudo_t: {
+            node->dst = replace_operand_pseudo_register(static_cast<AsmPseudo*>(node->dst.get()));
+            break;
+        }
+        case AST_T::AsmPseudoMem_t: {
+            node->dst = replace_operand_pseudo_mem_register(static_cast<AsmPseudoMem*>(node->dst.get()));
+            break;
+        }
+        default:
+            break;
+    }
+}
+
 static void replace_push_pseudo_registers(AsmPush* node) {
     switch (node->src->type()) {
         case AST_T::AsmPseudo_t: {
@@ -419,6 +481,9 @@ static void replace_pseudo_registers(AsmInstruction* node) {
         case AST_T::AsmMovZeroExtend_t:
             replace_mov_zero_extend_pseudo_registers(static_cast<AsmMovZeroExtend*>(node));
             break;
+        case AST_T::AsmMovdqu_t:
+            replace_movdqu_pseudo_registers(static_cast<AsmMovdqu*>(node));
+            break;
         case AST_T::AsmLea_t:
             replace_lea_pseudo_registers(static_cast<AsmLea*>(node));
             break;
@@ -446,6 +511,9 @@ static void replace_pseudo_registers(AsmInstruction* node) {
         case AST_T::AsmSetCC_t:
             replace_set_cc_pseudo_registers(static_cast<AsmSetCC*>(node));
             break;
+        case AST_T::AsmCmov_t:
+            replace_cmov_pseudo_registers(static_cast<AsmCmov*>(node));
+            break;
         case AST_T::AsmPush_t:
             replace_push_pseudo_registers(static_cast<AsmPush*>(node));
             break;
@@ -499,6 +567,7 @@ static void fix_allocate_stack_bytes() {
     if (context->stack_bytes > 0l) {
         align_offset_stack_bytes(16);
         (*context->p_fix_instructions)[0] = allocate_stack_bytes(context->stack_bytes);
+        ADD_STATS(STATS_COUNTER::allocated_stack_bytes, context->stack_bytes);
     }
 }
 
@@ -559,6 +628,20 @@ static void fix_mov_instruction(AsmMov* node) {
     }
 }
 
+static void fix_movdqu_from_addr_to_addr_instruction(AsmMovdqu* node) {
+    std::shared_ptr<AsmOperand> src = std::move(node->src);
+    std::shared_ptr<AsmOperand> dst = generate_register(REGISTER_KIND::Xmm14);
+    node->src = dst;
+    push_fix_instruction(std::make_unique<AsmMovdqu>(std::move(src), std::move(dst)));
+    swap_fix_instruction_back();
+}
+
+static void fix_movdqu_instruction(AsmMovdqu* node) {
+    if (is_type_addr(node->src.get()) && is_type_addr(node->dst.get())) {
+        fix_movdqu_from_addr_to_addr_instruction(node);
+    }
+}
+
 static void fix_mov_sx_from_imm_to_any_instruction(AsmMovSx* node) {
     std::shared_ptr<AsmOperand> src = std::move(node->src);
     std::shared_ptr<AsmOperand> dst = generate_register(REGISTER_KIND::R10);
@@ -869,6 +952,34 @@ static void fix_div_instruction(AsmDiv* node) {
     }
 }
 
+static void fix_cmov_from_imm_to_any_instruction(AsmCmov* node) {
+    std::shared_ptr<AsmOperand> src = std::move(node->src);
+    std::shared_ptr<AsmOperand> dst = generate_register(REGISTER_KIND::R10);
+    std::shared_ptr<AssemblyType> assembly_type = node->assembly_type;
+    node->src = dst;
+    push_fix_instruction(std::make_unique<AsmMov>(std::move(assembly_type), std::move(src), std::move(dst)));
+    swap_fix_instruction_back();
+}
+
+static void fix_cmov_from_any_to_addr_instruction(AsmCmov* node) {
+    std::shared_ptr<AsmOperand> src = std::move(node->dst);
+    std::shared_ptr<AsmOperand> dst = generate_register(REGISTER_KIND::R11);
+    std::shared_ptr<AssemblyType> assembly_type = node->assembly_type;
+    node->dst = dst;
+    push_fix_instruction(std::make_unique<AsmMov>(assembly_type, src, dst));
+    swap_fix_instruction_back();
+    push_fix_instruction(std::make_unique<AsmMov>(std::move(assembly_type), std::move(dst), std::move(src)));
+}
+
+static void fix_cmov_instruction(AsmCmov* node) {
+    if (is_type_imm(node->src.get())) {
+        fix_cmov_from_imm_to_any_instruction(node);
+    }
+    if (is_type_addr(node->dst.get())) {
+        fix_cmov_from_any_to_addr_instruction(node);
+    }
+}
+
 // TODO (p3, ch20)
 // static void fix_double_push_from_xmm_reg_to_any_instruction(AsmPush* node) {
 //     // subq $8, %rsp
@@ -905,6 +1016,9 @@ static void fix_instruction(AsmInstruction* node) {
         case AST_T::AsmMovZeroExtend_t:
             fix_mov_zero_extend_instruction(static_cast<AsmMovZeroExtend*>(node));
             break;
+        case AST_T::AsmMovdqu_t:
+            fix_movdqu_instruction(static_cast<AsmMovdqu*>(node));
+            break;
         case AST_T::AsmLea_t:
             fix_lea_instruction(static_cast<AsmLea*>(node));
             break;
@@ -926,6 +1040,9 @@ static void fix_instruction(AsmInstruction* node) {
         case AST_T::AsmDiv_t:
             fix_div_instruction(static_cast<AsmDiv*>(node));
             break;
+        case AST_T::AsmCmov_t:
+            fix_cmov_instruction(static_cast<AsmCmov*>(node));
+            break;
         case AST_T::AsmPush_t:
             fix_push_instruction(static_cast<AsmPush*>(node));
             break;
@@ -934,7 +1051,216 @@ static void fix_instruction(AsmInstruction* node) {
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Frame layout
+
+// Without a frame pointer, the locals keep their addresses relative to the return address, but are addressed from RSP.
+// A leaf function whose locals fit in the red zone below RSP does not move RSP at all, and any other function
+// allocates the 8 bytes that the saved RBP used to take on top of its locals. Tail calls leave the frame like returns.
+// Pushes and stack adjustments around calls move RSP in between, so that the bytes they take are added to the offsets
+// until they are deallocated.
+
+static TLong get_stack_bytes_imm(AsmOperand* node) {
+    return static_cast<TLong>(strtol(static_cast<AsmImm*>(node)->value.c_str(), nullptr, 10));
+}
+
+static void rebase_frame_operand(std::shared_ptr<AsmOperand>& node) {
+    if (node->type() == AST_T::AsmMemory_t) {
+        AsmMemory* p_node = static_cast<AsmMemory*>(node.get());
+        if (p_node->reg->type() == AST_T::AsmBp_t) {
+            TLong value = p_node->value + context->frame_offset + context->push_bytes;
+            node = generate_memory(REGISTER_KIND::Sp, std::move(value));
+        }
+    }
+}
+
+static void rebase_mov_frame_operands(AsmMov* node) {
+    rebase_frame_operand(node->src);
+    rebase_frame_operand(node->dst);
+}
+
+static void rebase_mov_sx_frame_operands(AsmMovSx* node) {
+    rebase_frame_operand(node->src);
+    rebase_frame_operand(node->dst);
+}
+
+static void rebase_mov_zero_extend_frame_operands(AsmMovZeroExtend* node) {
+    rebase_frame_operand(node->src);
+    rebase_frame_operand(node->dst);
+}
+
+static void rebase_movdqu_frame_operands(AsmMovdqu* node) {
+    rebase_frame_operand(node->src);
+    rebase_frame_operand(node->dst);
+}
+
+static void rebase_lea_frame_operands(AsmLea* node) {
+    rebase_frame_operand(node->src);
+    rebase_frame_operand(node->dst);
+}
+
+static void rebase_cvttsd2si_frame_operands(AsmCvttsd2si* node) {
+    rebase_frame_operand(node->src);
+    rebase_frame_operand(node->dst);
+}
+
+static void rebase_cvtsi2sd_frame_operands(AsmCvtsi2sd* node) {
+    rebase_frame_operand(node->src);
+    rebase_frame_operand(node->dst);
+}
+
+static void rebase_unary_frame_operands(AsmUnary* node) { rebase_frame_operand(node->dst); }
+
+static void rebase_binary_frame_operands(AsmBinary* node) {
+    rebase_frame_operand(node->src);
+    rebase_frame_operand(node->dst);
+    if (node->dst->type() == AST_T::AsmRegister_t && node->src->type() == AST_T::AsmImm_t
+        && static_cast<AsmRegister*>(node->dst.get())->reg->type() == AST_T::AsmSp_t) {
+        switch (node->binary_op->type()) {
+            case AST_T::AsmSub_t:
+                context->push_bytes += get_stack_bytes_imm(node->src.get());
+                break;
+            case AST_T::AsmAdd_t:
+                context->push_bytes -= get_stack_bytes_imm(node->src.get());
+                break;
+            default:
+                RAISE_INTERNAL_ERROR;
+        }
+    }
+}
+
+static void rebase_cmp_frame_operands(AsmCmp* node) {
+    rebase_frame_operand(node->src);
+    rebase_frame_operand(node->dst);
+}
+
+static void rebase_idiv_frame_operands(AsmIdiv* node) { rebase_frame_operand(node->src); }
+
+static void rebase_div_frame_operands(AsmDiv* node) { rebase_frame_operand(node->src); }
+
+static void rebase_set_cc_frame_operands(AsmSetCC* node) { rebase_frame_operand(node->dst); }
+
+static void rebase_cmov_frame_operands(AsmCmov* node) {
+    rebase_frame_operand(node->src);
+    rebase_frame_operand(node->dst);
+}
+
+// The address of a pushed memory operand is computed before RSP is decremented.
+static void rebase_push_frame_operands(AsmPush* node) {
+    rebase_frame_operand(node->src);
+    context->push_bytes += 8l;
+}
+
+static void rebase_frame_operands(AsmInstruction* node) {
+    switch (node->type()) {
+        case AST_T::AsmMov_t:
+            rebase_mov_frame_operands(static_cast<AsmMov*>(node));
+            break;
+        case AST_T::AsmMovSx_t:
+            rebase_mov_sx_frame_operands(static_cast<AsmMovSx*>(node));
+            break;
+        case AST_T::AsmMovZeroExtend_t:
+            rebase_mov_zero_extend_frame_operands(static_cast<AsmMovZeroExtend*>(node));
+            break;
+        case AST_T::AsmMovdqu_t:
+            rebase_movdqu_frame_operands(static_cast<AsmMovdqu*>(node));
+            break;
+        case AST_T::AsmLea_t:
+            rebase_lea_frame_operands(static_cast<AsmLea*>(node));
+            break;
+        case AST_T::AsmCvttsd2si_t:
+            rebase_cvttsd2si_frame_operands(static_cast<AsmCvttsd2si*>(node));
+            break;
+        case AST_T::AsmCvtsi2sd_t:
+            rebase_cvtsi2sd_frame_operands(static_cast<AsmCvtsi2sd*>(node));
+            break;
+        case AST_T::AsmUnary_t:
+            rebase_unary_frame_operands(static_cast<AsmUnary*>(node));
+            break;
+        case AST_T::AsmBinary_t:
+            rebase_binary_frame_operands(static_cast<AsmBinary*>(node));
+            break;
+        case AST_T::AsmCmp_t:
+            rebase_cmp_frame_operands(static_cast<AsmCmp*>(node));
+            break;
+        case AST_T::AsmIdiv_t:
+            rebase_idiv_frame_operands(static_cast<AsmIdiv*>(node));
+            break;
+        case AST_T::AsmDiv_t:
+            rebase_div_frame_operands(static_cast<AsmDiv*>(node));
+            break;
+        case AST_T::AsmSetCC_t:
+            rebase_set_cc_frame_operands(static_cast<AsmSetCC*>(node));
+            break;
+        case AST_T::AsmCmov_t:
+            rebase_cmov_frame_operands(static_cast<AsmCmov*>(node));
+            break;
+        case AST_T::AsmPush_t:
+            rebase_push_frame_operands(static_cast<AsmPush*>(node));
+            break;
+        default:
+            break;
+    }
+}
+
+static bool is_leaf_function(const std::vector<std::unique_ptr<AsmInstruction>>& instructions) {
+    for (size_t i = 1; i < instructions.size(); ++i) {
+        if (instructions[i]->type() == AST_T::AsmCall_t) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void omit_frame_pointer(AsmFunction* node) {
+    TLong frame_bytes;
+    if (context->stack_bytes <= 120l && is_leaf_function(node->instructions)) {
+        frame_bytes = 0l;
+        context->frame_offset = -8l;
+        INCREMENT_STATS(STATS_COUNTER::red_zone_functions);
+    }
+    else {
+        align_offset_stack_bytes(16);
+        frame_bytes = context->stack_bytes + 8l;
+        context->frame_offset = context->stack_bytes;
+    }
+    ADD_STATS(STATS_COUNTER::allocated_stack_bytes, context->stack_bytes);
+    INCREMENT_STATS(STATS_COUNTER::omitted_frame_pointers);
+
+    std::vector<std::unique_ptr<AsmInstruction>> instructions = std::move(node->instructions);
+    node->instructions.clear();
+    node->instructions.reserve(instructions.size());
+    node->instructions.emplace_back();
+    if (frame_bytes > 0l) {
+        node->instructions[0] = allocate_stack_bytes(frame_bytes);
+    }
+
+    context->push_bytes = 0l;
+    for (size_t i = 1; i < instructions.size(); ++i) {
+        rebase_frame_operands(instructions[i].get());
+        if (frame_bytes > 0l
+            && (instructions[i]->type() == AST_T::AsmRet_t || instructions[i]->type() == AST_T::AsmTailCall_t)) {
+            node->instructions.push_back(deallocate_stack_bytes(frame_bytes));
+        }
+        node->instructions.push_back(std::move(instructions[i]));
+    }
+    node->is_frame_pointer = false;
+}
+
+static void fix_frame_layout(AsmFunction* node) {
+    if (context->is_omit_frame_pointer) {
+        omit_frame_pointer(node);
+    }
+    else {
+        fix_allocate_stack_bytes();
+    }
+}
+
 static void fix_function_top_level(AsmFunction* node) {
+    TRACE_EVENT_BEGIN("fix_stack");
+    TRACE_EVENT_ARG("function", node->name);
+    TRACE_EVENT_ARG("instructions", node->instructions.size());
     std::vector<std::unique_ptr<AsmInstruction>> instructions = std::move(node->instructions);
 
     node->instructions.clear();
@@ -950,8 +1276,12 @@ static void fix_function_top_level(AsmFunction* node) {
         replace_pseudo_registers(context->p_fix_instructions->back().get());
         fix_instruction(context->p_fix_instructions->back().get());
     }
-    fix_allocate_stack_bytes();
+    fix_frame_layout(node);
     context->p_fix_instructions = nullptr;
+    INCREMENT_STATS(STATS_COUNTER::fixed_stack_functions);
+    ADD_STATS(STATS_COUNTER::inserted_fix_instructions, node->instructions.size() - instructions.size() - 1);
+    TRACE_EVENT_ARG("fixed_instructions", node->instructions.size());
+    TRACE_EVENT_END("fix_stack");
 }
 
 static void fix_top_level(AsmTopLevel* node) {
@@ -974,8 +1304,25 @@ static void fix_program(AsmProgram* node) {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void fix_stack(AsmProgram* node) {
-    context = std::make_unique<StackFixContext>();
+// Functions are fixed independently, so each job thread has its own context and takes whole top levels.
+static void init_fix_job() { context = std::make_unique<StackFixContext>(jobs_context->is_omit_frame_pointer); }
+
+static void fix_top_level_job(size_t top_level_index) {
+    fix_top_level(jobs_context->p_node->top_levels[top_level_index].get());
+}
+
+static void free_fix_job() { context.reset(); }
+
+void fix_stack(AsmProgram* node, bool is_omit_frame_pointer, size_t jobs) {
+    if (jobs > 1) {
+        jobs_context = std::make_unique<StackFixJobsContext>();
+        jobs_context->p_node = node;
+        jobs_context->is_omit_frame_pointer = is_omit_frame_pointer;
+        run_jobs(jobs, node->top_levels.size(), init_fix_job, fix_top_level_job, free_fix_job);
+        jobs_context.reset();
+        return;
+    }
+    context = std::make_unique<StackFixContext>(is_omit_frame_pointer);
     fix_program(node);
     context.reset();
 }
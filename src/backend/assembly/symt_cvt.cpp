@@ -7,76 +7,33 @@
 #include "ast/back_symt.hpp"
 #include "ast/front_symt.hpp"
 
+#include "frontend/intermediate/types.hpp"
+
 #include "backend/assembly/symt_cvt.hpp"
 
 static std::unique_ptr<SymtCvtContext> context;
 
+SymtCvtContext::SymtCvtContext(bool is_no_plt) : is_no_plt(is_no_plt), p_symbol(nullptr) {}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 // Symbol table conversion
 
-static TInt generate_scalar_type_alignment(Type* type) {
-    switch (type->type()) {
-        case AST_T::Char_t:
-        case AST_T::SChar_t:
-        case AST_T::UChar_t:
-            return 1;
-        case AST_T::Int_t:
-        case AST_T::UInt_t:
-            return 4;
-        case AST_T::Long_t:
-        case AST_T::Double_t:
-        case AST_T::ULong_t:
-        case AST_T::Pointer_t:
-            return 8;
-        default:
-            RAISE_INTERNAL_ERROR;
-    }
-}
-
-TInt generate_type_alignment(Type* type);
-
 static TInt generate_array_aggregate_type_alignment(Array* arr_type, TLong& size) {
-    size = arr_type->size;
-    while (arr_type->elem_type->type() == AST_T::Array_t) {
-        arr_type = static_cast<Array*>(arr_type->elem_type.get());
-        size *= arr_type->size;
-    }
-    TInt alignment;
-    {
-        alignment = generate_type_alignment(arr_type->elem_type.get());
-        if (arr_type->elem_type->type() == AST_T::Structure_t) {
-            Structure* struct_type = static_cast<Structure*>(arr_type->elem_type.get());
-            size *= frontend->struct_typedef_table[struct_type->tag]->size;
-        }
-        else {
-            size *= alignment;
-        }
-        if (size >= 16l) {
-            alignment = 16;
-        }
+    size = get_type_scale(arr_type);
+    TInt alignment = get_type_alignment(arr_type);
+    if (size >= 16l) {
+        alignment = 16;
     }
     return alignment;
 }
 
-static TInt generate_array_aggregate_type_alignment(Array* arr_type) {
-    TLong size;
-    return generate_array_aggregate_type_alignment(arr_type, size);
-}
-
-static TInt generate_structure_aggregate_type_alignment(Structure* struct_type) {
-    return frontend->struct_typedef_table[struct_type->tag]->alignment;
-}
-
 TInt generate_type_alignment(Type* type) {
-    switch (type->type()) {
-        case AST_T::Array_t:
-            return generate_array_aggregate_type_alignment(static_cast<Array*>(type));
-        case AST_T::Structure_t:
-            return generate_structure_aggregate_type_alignment(static_cast<Structure*>(type));
-        default:
-            return generate_scalar_type_alignment(type);
+    if (type->type() == AST_T::Array_t) {
+        TLong size;
+        return generate_array_aggregate_type_alignment(static_cast<Array*>(type), size);
     }
+    return get_type_alignment(type);
 }
 
 static std::shared_ptr<ByteArray> convert_array_aggregate_assembly_type(Array* arr_type) {
@@ -89,8 +46,8 @@ static std::shared_ptr<ByteArray> convert_structure_aggregate_assembly_type(Stru
     TLong size;
     TInt alignment;
     if (frontend->struct_typedef_table.find(struct_type->tag) != frontend->struct_typedef_table.end()) {
-        size = frontend->struct_typedef_table[struct_type->tag]->size;
-        alignment = frontend->struct_typedef_table[struct_type->tag]->alignment;
+        size = get_type_scale(struct_type);
+        alignment = get_type_alignment(struct_type);
     }
     else {
         size = -1l;
@@ -163,9 +120,13 @@ static void convert_top_level(AsmTopLevel* node) {
     }
 }
 
+// Functions with internal linkage that are defined in this translation unit are called directly, and the other ones
+// are called through the plt, or through their got entry without a plt.
 static void convert_fun_type(FunAttr* node) {
     bool is_defined = node->is_defined;
-    convert_backend_symbol(std::make_unique<BackendFun>(std::move(is_defined)));
+    bool is_local = node->is_defined && !node->is_global;
+    bool is_got = context->is_no_plt && !is_local;
+    convert_backend_symbol(std::make_unique<BackendFun>(std::move(is_defined), std::move(is_local), std::move(is_got)));
 }
 
 static void convert_obj_type(IdentifierAttr* node) {
@@ -196,8 +157,8 @@ static void convert_program(AsmProgram* node) {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void convert_symbol_table(AsmProgram* node) {
-    context = std::make_unique<SymtCvtContext>();
+void convert_symbol_table(AsmProgram* node, bool is_no_plt) {
+    context = std::make_unique<SymtCvtContext>(is_no_plt);
     convert_program(node);
     context.reset();
 }
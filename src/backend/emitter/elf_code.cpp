@@ -0,0 +1,1438 @@
+#include <elf.h>
+#include <inttypes.h>
+#include <memory>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "util/fileio.hpp"
+#include "util/throw.hpp"
+
+#include "ast/ast.hpp"
+#include "ast/back_ast.hpp"
+#include "ast/back_symt.hpp"
+#include "ast/front_symt.hpp"
+
+#include "backend/emitter/elf_code.hpp"
+
+static std::unique_ptr<ElfCodeContext> context;
+
+ElfCodeContext::ElfCodeContext() {
+    for (auto& section : sections) {
+        section.size = 0;
+        section.alignment = 1;
+    }
+    sections[ELF_SECTION_KIND::text_section].alignment = 16;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Elf object code emission
+
+static bool is_int8(int64_t value) { return value >= -128l && value <= 127l; }
+
+static bool is_int32(int64_t value) { return value >= -2147483648l && value <= 2147483647l; }
+
+static void append_bytes(std::string& bytes, const void* data, size_t size) {
+    bytes.append(static_cast<const char*>(data), size);
+}
+
+static void append_uint(std::string& bytes, uint64_t value, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        bytes += static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+static void align_bytes(std::string& bytes, uint64_t alignment) {
+    while (bytes.size() % alignment != 0) {
+        bytes += '\0';
+    }
+}
+
+static std::string& get_code() { return context->fragments.back().code; }
+
+static void push_code(uint64_t value, size_t size) { append_uint(get_code(), value, size); }
+
+// The value of an immediate is printed as either a signed or an unsigned 64-bit integer.
+static int64_t get_imm_value(AsmImm* node) {
+    if (node->value[0] == '-') {
+        return static_cast<int64_t>(strtoll(node->value.c_str(), nullptr, 10));
+    }
+    return static_cast<int64_t>(strtoull(node->value.c_str(), nullptr, 10));
+}
+
+// Reg(AX)    -> 0
+// Reg(CX)    -> 1
+// Reg(DX)    -> 2
+// Reg(SP)    -> 4
+// Reg(BP)    -> 5
+// Reg(SI)    -> 6
+// Reg(DI)    -> 7
+// Reg(R8)    -> 8
+// Reg(R9)    -> 9
+// Reg(R10)   -> 10
+// Reg(R11)   -> 11
+// Reg(XMM<n>) -> n
+static uint8_t get_register_code(AsmReg* node) {
+    switch (node->type()) {
+        case AST_T::AsmAx_t:
+        case AST_T::AsmXMM0_t:
+            return 0;
+        case AST_T::AsmCx_t:
+        case AST_T::AsmXMM1_t:
+            return 1;
+        case AST_T::AsmDx_t:
+        case AST_T::AsmXMM2_t:
+            return 2;
+        case AST_T::AsmXMM3_t:
+            return 3;
+        case AST_T::AsmSp_t:
+        case AST_T::AsmXMM4_t:
+            return 4;
+        case AST_T::AsmBp_t:
+        case AST_T::AsmXMM5_t:
+            return 5;
+        case AST_T::AsmSi_t:
+        case AST_T::AsmXMM6_t:
+            return 6;
+        case AST_T::AsmDi_t:
+        case AST_T::AsmXMM7_t:
+            return 7;
+        case AST_T::AsmR8_t:
+            return 8;
+        case AST_T::AsmR9_t:
+            return 9;
+        case AST_T::AsmR10_t:
+            return 10;
+        case AST_T::AsmR11_t:
+            return 11;
+        case AST_T::AsmXMM14_t:
+            return 14;
+        case AST_T::AsmXMM15_t:
+            return 15;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+static uint8_t get_operand_register_code(AsmOperand* node) {
+    if (node->type() != AST_T::AsmRegister_t) {
+        RAISE_INTERNAL_ERROR;
+    }
+    return get_register_code(static_cast<AsmRegister*>(node)->reg.get());
+}
+
+// E  -> 0x4
+// NE -> 0x5
+// L  -> 0xc
+// LE -> 0xe
+// G  -> 0xf
+// GE -> 0xd
+// B  -> 0x2
+// BE -> 0x6
+// A  -> 0x7
+// AE -> 0x3
+// P  -> 0xa
+static uint8_t get_condition_code(AsmCondCode* node) {
+    switch (node->type()) {
+        case AST_T::AsmE_t:
+            return 0x4;
+        case AST_T::AsmNE_t:
+            return 0x5;
+        case AST_T::AsmL_t:
+            return 0xc;
+        case AST_T::AsmLE_t:
+            return 0xe;
+        case AST_T::AsmG_t:
+            return 0xf;
+        case AST_T::AsmGE_t:
+            return 0xd;
+        case AST_T::AsmB_t:
+            return 0x2;
+        case AST_T::AsmBE_t:
+            return 0x6;
+        case AST_T::AsmA_t:
+            return 0x7;
+        case AST_T::AsmAE_t:
+            return 0x3;
+        case AST_T::AsmP_t:
+            return 0xa;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+// Byte     -> 1
+// LongWord -> 4
+// QuadWord -> 8
+// Double   -> 8
+static TInt get_type_size(AssemblyType* node) {
+    switch (node->type()) {
+        case AST_T::Byte_t:
+            return 1;
+        case AST_T::LongWord_t:
+            return 4;
+        case AST_T::QuadWord_t:
+        case AST_T::BackendDouble_t:
+            return 8;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Instruction encoding
+
+// Byte registers 4 to 7 are spl, bpl, sil and dil only with a rex prefix, otherwise they are ah, ch, dh and bh.
+static void encode_rex_prefix(bool is_quad, uint8_t reg, bool is_reg_byte, AsmOperand* node, bool is_rm_byte) {
+    uint8_t rex = is_quad ? 0x48 : 0x40;
+    bool is_rex = is_quad || (is_reg_byte && reg >= 4);
+    rex |= (reg >> 3) << 2;
+    switch (node->type()) {
+        case AST_T::AsmRegister_t: {
+            uint8_t rm = get_register_code(static_cast<AsmRegister*>(node)->reg.get());
+            rex |= rm >> 3;
+            is_rex = is_rex || (is_rm_byte && rm >= 4);
+            break;
+        }
+        case AST_T::AsmMemory_t:
+            rex |= get_register_code(static_cast<AsmMemory*>(node)->reg.get()) >> 3;
+            break;
+        case AST_T::AsmIndexed_t: {
+            AsmIndexed* p_node = static_cast<AsmIndexed*>(node);
+            rex |= (get_register_code(p_node->reg_index.get()) >> 3) << 1;
+            rex |= get_register_code(p_node->reg_base.get()) >> 3;
+            break;
+        }
+        case AST_T::AsmData_t:
+            break;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+    if (is_rex || rex != 0x40) {
+        push_code(rex, 1);
+    }
+}
+
+// Memory(int, reg) -> mod | reg | rm [sib] [disp8 | disp32]
+static void encode_memory_modrm(uint8_t reg, AsmMemory* node) {
+    uint8_t rm = get_register_code(node->reg.get()) & 7;
+    if (!is_int32(node->value)) {
+        RAISE_INTERNAL_ERROR;
+    }
+    uint8_t mod = (node->value == 0l && rm != 5) ? 0 : (is_int8(node->value) ? 1 : 2);
+    push_code((mod << 6) | ((reg & 7) << 3) | rm, 1);
+    if (rm == 4) {
+        push_code(0x24, 1);
+    }
+    if (mod == 1) {
+        push_code(static_cast<uint64_t>(node->value), 1);
+    }
+    else if (mod == 2) {
+        push_code(static_cast<uint64_t>(node->value), 4);
+    }
+}
+
+// Indexed(reg1, reg2, int) -> mod | reg | 100 scale | index | base [disp8]
+static void encode_indexed_modrm(uint8_t reg, AsmIndexed* node) {
+    uint8_t base = get_register_code(node->reg_base.get()) & 7;
+    uint8_t index = get_register_code(node->reg_index.get()) & 7;
+    uint8_t scale;
+    switch (node->scale) {
+        case 1l:
+            scale = 0;
+            break;
+        case 2l:
+            scale = 1;
+            break;
+        case 4l:
+            scale = 2;
+            break;
+        case 8l:
+            scale = 3;
+            break;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+    uint8_t mod = base == 5 ? 1 : 0;
+    push_code((mod << 6) | ((reg & 7) << 3) | 4, 1);
+    push_code((scale << 6) | (index << 3) | base, 1);
+    if (mod == 1) {
+        push_code(0, 1);
+    }
+}
+
+// Data(identifier, int) -> 00 | reg | 101 disp32, relative to the end of the instruction, which ends imm_size bytes
+// after the displacement.
+static void encode_data_modrm(uint8_t reg, AsmData* node, size_t imm_size) {
+    push_code(((reg & 7) << 3) | 5, 1);
+    {
+        ElfRelocation relocation = {get_code().size(), R_X86_64_PC32, node->name,
+            static_cast<int64_t>(node->offset) - 4l - static_cast<int64_t>(imm_size)};
+        context->fragments.back().relocations.emplace_back(std::move(relocation));
+    }
+    push_code(0, 4);
+}
+
+static void encode_modrm(uint8_t reg, AsmOperand* node, size_t imm_size) {
+    switch (node->type()) {
+        case AST_T::AsmRegister_t:
+            push_code(0xc0 | ((reg & 7) << 3) | (get_operand_register_code(node) & 7), 1);
+            break;
+        case AST_T::AsmMemory_t:
+            encode_memory_modrm(reg, static_cast<AsmMemory*>(node));
+            break;
+        case AST_T::AsmIndexed_t:
+            encode_indexed_modrm(reg, static_cast<AsmIndexed*>(node));
+            break;
+        case AST_T::AsmData_t:
+            encode_data_modrm(reg, static_cast<AsmData*>(node), imm_size);
+            break;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+// [prefix] [rex] [0f] opcode modrm [sib] [disp], where reg is either a register or an opcode extension.
+static void encode_rm_instruction(uint8_t prefix, bool is_quad, uint16_t opcode, uint8_t reg, bool is_reg_byte,
+    AsmOperand* node, bool is_rm_byte, size_t imm_size) {
+    if (prefix != 0) {
+        push_code(prefix, 1);
+    }
+    encode_rex_prefix(is_quad, reg, is_reg_byte, node, is_rm_byte);
+    if (opcode > 0xff) {
+        push_code(opcode >> 8, 1);
+    }
+    push_code(opcode & 0xff, 1);
+    encode_modrm(reg, node, imm_size);
+}
+
+static void encode_rm_instruction(bool is_quad, uint16_t opcode, uint8_t reg, AsmOperand* node, size_t imm_size) {
+    encode_rm_instruction(0, is_quad, opcode, reg, false, node, false, imm_size);
+}
+
+// [rex] opcode + reg
+static void encode_reg_instruction(bool is_quad, uint8_t opcode, uint8_t reg, bool is_byte) {
+    if (is_quad || reg >= 8 || (is_byte && reg >= 4)) {
+        push_code((is_quad ? 0x48 : 0x40) | (reg >> 3), 1);
+    }
+    push_code(opcode + (reg & 7), 1);
+}
+
+static bool is_register_operand(AsmOperand* node) { return node->type() == AST_T::AsmRegister_t; }
+
+static bool is_imm_operand(AsmOperand* node) { return node->type() == AST_T::AsmImm_t; }
+
+// Immediates are truncated to the operand size, and quad word immediates are sign extended from 32 bits.
+static int64_t get_imm_operand(AsmOperand* node, TInt byte) {
+    int64_t value = get_imm_value(static_cast<AsmImm*>(node));
+    switch (byte) {
+        case 1:
+            return static_cast<int8_t>(value);
+        case 4:
+            return static_cast<int32_t>(value);
+        case 8: {
+            if (!is_int32(value)) {
+                RAISE_INTERNAL_ERROR;
+            }
+            return value;
+        }
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+// Integer operations that have the r/m, reg, reg, r/m and r/m, imm forms of add, or, and, sub, xor and cmp.
+static void encode_alu_instruction(uint8_t extension, TInt byte, AsmOperand* src, AsmOperand* dst) {
+    bool is_byte = byte == 1;
+    bool is_quad = byte == 8;
+    uint8_t opcode = extension << 3;
+    if (is_imm_operand(src)) {
+        int64_t value = get_imm_operand(src, byte);
+        if (is_byte) {
+            encode_rm_instruction(0, false, 0x80, extension, false, dst, true, 1);
+            push_code(static_cast<uint64_t>(value), 1);
+        }
+        else if (is_int8(value)) {
+            encode_rm_instruction(is_quad, 0x83, extension, dst, 1);
+            push_code(static_cast<uint64_t>(value), 1);
+        }
+        else {
+            encode_rm_instruction(is_quad, 0x81, extension, dst, 4);
+            push_code(static_cast<uint64_t>(value), 4);
+        }
+    }
+    else if (is_register_operand(src)) {
+        encode_rm_instruction(
+            0, is_quad, opcode + (is_byte ? 0 : 1), get_operand_register_code(src), is_byte, dst, is_byte, 0);
+    }
+    else {
+        encode_rm_instruction(
+            0, is_quad, opcode + (is_byte ? 2 : 3), get_operand_register_code(dst), is_byte, src, is_byte, 0);
+    }
+}
+
+// Mov<d>(src, reg) -> f2 0f 10 /r
+// Mov<d>(reg, dst) -> f2 0f 11 /r
+static void encode_double_mov_instructions(AsmMov* node) {
+    if (is_register_operand(node->dst.get())) {
+        encode_rm_instruction(
+            0xf2, false, 0x0f10, get_operand_register_code(node->dst.get()), false, node->src.get(), false, 0);
+    }
+    else {
+        encode_rm_instruction(
+            0xf2, false, 0x0f11, get_operand_register_code(node->src.get()), false, node->dst.get(), false, 0);
+    }
+}
+
+// Mov<b>(imm, reg)  -> b0+r ib
+// Mov<b>(imm, dst)  -> c6 /0 ib
+// Mov<b>(reg, dst)  -> 88 /r
+// Mov<b>(src, reg)  -> 8a /r
+// Mov<l>(imm, reg)  -> b8+r id
+// Mov<q>(imm, reg)  -> rex.w b8+r io (if imm does not fit in 32 bits)
+// Mov<lq>(imm, dst) -> [rex.w] c7 /0 id
+// Mov<lq>(reg, dst) -> [rex.w] 89 /r
+// Mov<lq>(src, reg) -> [rex.w] 8b /r
+static void encode_mov_instructions(AsmMov* node) {
+    TInt byte = get_type_size(node->assembly_type.get());
+    if (node->assembly_type->type() == AST_T::BackendDouble_t) {
+        encode_double_mov_instructions(node);
+        return;
+    }
+    bool is_byte = byte == 1;
+    bool is_quad = byte == 8;
+    if (is_imm_operand(node->src.get())) {
+        int64_t value = get_imm_value(static_cast<AsmImm*>(node->src.get()));
+        if (is_byte && is_register_operand(node->dst.get())) {
+            encode_reg_instruction(false, 0xb0, get_operand_register_code(node->dst.get()), true);
+            push_code(static_cast<uint64_t>(value), 1);
+        }
+        else if (is_byte) {
+            encode_rm_instruction(0, false, 0xc6, 0, false, node->dst.get(), true, 1);
+            push_code(static_cast<uint64_t>(value), 1);
+        }
+        else if (is_register_operand(node->dst.get()) && (!is_quad || !is_int32(value))) {
+            encode_reg_instruction(is_quad, 0xb8, get_operand_register_code(node->dst.get()), false);
+            push_code(static_cast<uint64_t>(value), byte);
+        }
+        else {
+            value = get_imm_operand(node->src.get(), byte);
+            encode_rm_instruction(is_quad, 0xc7, 0, node->dst.get(), 4);
+            push_code(static_cast<uint64_t>(value), 4);
+        }
+    }
+    else if (is_register_operand(node->src.get())) {
+        encode_rm_instruction(0, is_quad, is_byte ? 0x88 : 0x89, get_operand_register_code(node->src.get()), is_byte,
+            node->dst.get(), is_byte, 0);
+    }
+    else {
+        encode_rm_instruction(0, is_quad, is_byte ? 0x8a : 0x8b, get_operand_register_code(node->dst.get()), is_byte,
+            node->src.get(), is_byte, 0);
+    }
+}
+
+// Movdqu(src, reg) -> f3 0f 6f /r
+// Movdqu(reg, dst) -> f3 0f 7f /r
+static void encode_movdqu_instructions(AsmMovdqu* node) {
+    if (is_register_operand(node->dst.get())) {
+        encode_rm_instruction(
+            0xf3, false, 0x0f6f, get_operand_register_code(node->dst.get()), false, node->src.get(), false, 0);
+    }
+    else {
+        encode_rm_instruction(
+            0xf3, false, 0x0f7f, get_operand_register_code(node->src.get()), false, node->dst.get(), false, 0);
+    }
+}
+
+// MovSx<b,l>(src, reg) -> 0f be /r
+// MovSx<b,q>(src, reg) -> rex.w 0f be /r
+// MovSx<l,q>(src, reg) -> rex.w 63 /r
+static void encode_mov_sx_instructions(AsmMovSx* node) {
+    bool is_quad = node->assembly_type_dst->type() == AST_T::QuadWord_t;
+    uint8_t reg = get_operand_register_code(node->dst.get());
+    switch (node->assembly_type_src->type()) {
+        case AST_T::Byte_t:
+            encode_rm_instruction(0, is_quad, 0x0fbe, reg, false, node->src.get(), true, 0);
+            break;
+        case AST_T::LongWord_t: {
+            if (!is_quad) {
+                RAISE_INTERNAL_ERROR;
+            }
+            encode_rm_instruction(true, 0x63, reg, node->src.get(), 0);
+            break;
+        }
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+// MovZeroExtend<b,l>(src, reg) -> 0f b6 /r
+// MovZeroExtend<b,q>(src, reg) -> rex.w 0f b6 /r
+static void encode_mov_zero_extend_instructions(AsmMovZeroExtend* node) {
+    bool is_quad = node->assembly_type_dst->type() == AST_T::QuadWord_t;
+    encode_rm_instruction(
+        0, is_quad, 0x0fb6, get_operand_register_code(node->dst.get()), false, node->src.get(), true, 0);
+}
+
+// Lea(src, reg) -> rex.w 8d /r
+static void encode_lea_instructions(AsmLea* node) {
+    encode_rm_instruction(true, 0x8d, get_operand_register_code(node->dst.get()), node->src.get(), 0);
+}
+
+// Cvttsd2si(t, src, reg) -> f2 [rex.w] 0f 2c /r
+static void encode_cvttsd2si_instructions(AsmCvttsd2si* node) {
+    bool is_quad = node->assembly_type->type() == AST_T::QuadWord_t;
+    encode_rm_instruction(
+        0xf2, is_quad, 0x0f2c, get_operand_register_code(node->dst.get()), false, node->src.get(), false, 0);
+}
+
+// Cvtsi2sd(t, src, reg) -> f2 [rex.w] 0f 2a /r
+static void encode_cvtsi2sd_instructions(AsmCvtsi2sd* node) {
+    bool is_quad = node->assembly_type->type() == AST_T::QuadWord_t;
+    encode_rm_instruction(
+        0xf2, is_quad, 0x0f2a, get_operand_register_code(node->dst.get()), false, node->src.get(), false, 0);
+}
+
+// Not(t, dst) -> [rex.w] f6|f7 /2
+// Neg(t, dst) -> [rex.w] f6|f7 /3
+// Shr(t, dst) -> [rex.w] d0|d1 /5
+static void encode_unary_instructions(AsmUnary* node) {
+    TInt byte = get_type_size(node->assembly_type.get());
+    bool is_byte = byte == 1;
+    if (node->assembly_type->type() == AST_T::BackendDouble_t) {
+        RAISE_INTERNAL_ERROR;
+    }
+    switch (node->unary_op->type()) {
+        case AST_T::AsmNot_t:
+            encode_rm_instruction(0, byte == 8, is_byte ? 0xf6 : 0xf7, 2, false, node->dst.get(), is_byte, 0);
+            break;
+        case AST_T::AsmNeg_t:
+            encode_rm_instruction(0, byte == 8, is_byte ? 0xf6 : 0xf7, 3, false, node->dst.get(), is_byte, 0);
+            break;
+        case AST_T::AsmShr_t:
+            encode_rm_instruction(0, byte == 8, is_byte ? 0xd0 : 0xd1, 5, false, node->dst.get(), is_byte, 0);
+            break;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+// Add<d>(src, reg)       -> f2 0f 58 /r
+// Sub<d>(src, reg)       -> f2 0f 5c /r
+// Mult<d>(src, reg)      -> f2 0f 59 /r
+// DivDouble<d>(src, reg) -> f2 0f 5e /r
+// BitXor<d>(src, reg)    -> 66 0f 57 /r
+static void encode_double_binary_instructions(AsmBinary* node) {
+    uint8_t prefix = 0xf2;
+    uint16_t opcode;
+    switch (node->binary_op->type()) {
+        case AST_T::AsmAdd_t:
+            opcode = 0x0f58;
+            break;
+        case AST_T::AsmSub_t:
+            opcode = 0x0f5c;
+            break;
+        case AST_T::AsmMult_t:
+            opcode = 0x0f59;
+            break;
+        case AST_T::AsmDivDouble_t:
+            opcode = 0x0f5e;
+            break;
+        case AST_T::AsmBitXor_t: {
+            prefix = 0x66;
+            opcode = 0x0f57;
+            break;
+        }
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+    encode_rm_instruction(
+        prefix, false, opcode, get_operand_register_code(node->dst.get()), false, node->src.get(), false, 0);
+}
+
+// Mult<lq>(imm, reg) -> [rex.w] 6b /r ib | 69 /r id
+// Mult<lq>(src, reg) -> [rex.w] 0f af /r
+static void encode_imul_instructions(AsmBinary* node, TInt byte) {
+    bool is_quad = byte == 8;
+    if (byte == 1) {
+        RAISE_INTERNAL_ERROR;
+    }
+    uint8_t reg = get_operand_register_code(node->dst.get());
+    if (is_imm_operand(node->src.get())) {
+        int64_t value = get_imm_operand(node->src.get(), byte);
+        if (is_int8(value)) {
+            encode_rm_instruction(is_quad, 0x6b, reg, node->dst.get(), 1);
+            push_code(static_cast<uint64_t>(value), 1);
+        }
+        else {
+            encode_rm_instruction(is_quad, 0x69, reg, node->dst.get(), 4);
+            push_code(static_cast<uint64_t>(value), 4);
+        }
+    }
+    else {
+        encode_rm_instruction(is_quad, 0x0faf, reg, node->src.get(), 0);
+    }
+}
+
+// Shx(1, dst)   -> [rex.w] d0|d1 /n
+// Shx(imm, dst) -> [rex.w] c0|c1 /n ib
+// Shx(cl, dst)  -> [rex.w] d2|d3 /n
+static void encode_shift_instructions(AsmBinary* node, uint8_t extension, TInt byte) {
+    bool is_byte = byte == 1;
+    if (is_imm_operand(node->src.get())) {
+        int64_t value = get_imm_value(static_cast<AsmImm*>(node->src.get()));
+        if (value == 1l) {
+            encode_rm_instruction(0, byte == 8, is_byte ? 0xd0 : 0xd1, extension, false, node->dst.get(), is_byte, 0);
+            return;
+        }
+        encode_rm_instruction(0, byte == 8, is_byte ? 0xc0 : 0xc1, extension, false, node->dst.get(), is_byte, 1);
+        push_code(static_cast<uint64_t>(value), 1);
+    }
+    else if (get_operand_register_code(node->src.get()) == 1) {
+        encode_rm_instruction(0, byte == 8, is_byte ? 0xd2 : 0xd3, extension, false, node->dst.get(), is_byte, 0);
+    }
+    else {
+        RAISE_INTERNAL_ERROR;
+    }
+}
+
+// Add(t, src, dst)              -> /0
+// BitOr(t, src, dst)            -> /1
+// BitAnd(t, src, dst)           -> /4
+// Sub(t, src, dst)              -> /5
+// BitXor(t, src, dst)           -> /6
+// Mult(t, src, dst)             -> imul
+// BitShiftLeft(t, src, dst)     -> /4
+// BitShiftRight(t, src, dst)    -> /5
+// BitShrArithmetic(t, src, dst) -> /7
+static void encode_binary_instructions(AsmBinary* node) {
+    if (node->assembly_type->type() == AST_T::BackendDouble_t) {
+        encode_double_binary_instructions(node);
+        return;
+    }
+    TInt byte = get_type_size(node->assembly_type.get());
+    switch (node->binary_op->type()) {
+        case AST_T::AsmAdd_t:
+            encode_alu_instruction(0, byte, node->src.get(), node->dst.get());
+            break;
+        case AST_T::AsmBitOr_t:
+            encode_alu_instruction(1, byte, node->src.get(), node->dst.get());
+            break;
+        case AST_T::AsmBitAnd_t:
+            encode_alu_instruction(4, byte, node->src.get(), node->dst.get());
+            break;
+        case AST_T::AsmSub_t:
+            encode_alu_instruction(5, byte, node->src.get(), node->dst.get());
+            break;
+        case AST_T::AsmBitXor_t:
+            encode_alu_instruction(6, byte, node->src.get(), node->dst.get());
+            break;
+        case AST_T::AsmMult_t:
+            encode_imul_instructions(node, byte);
+            break;
+        case AST_T::AsmBitShiftLeft_t:
+            encode_shift_instructions(node, 4, byte);
+            break;
+        case AST_T::AsmBitShiftRight_t:
+            encode_shift_instructions(node, 5, byte);
+            break;
+        case AST_T::AsmBitShrArithmetic_t:
+            encode_shift_instructions(node, 7, byte);
+            break;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+// Cmp<i>(t, src, dst) -> /7
+// Cmp<d>(src, reg)    -> 66 0f 2f /r
+static void encode_cmp_instructions(AsmCmp* node) {
+    if (node->assembly_type->type() == AST_T::BackendDouble_t) {
+        encode_rm_instruction(
+            0x66, false, 0x0f2f, get_operand_register_code(node->dst.get()), false, node->src.get(), false, 0);
+    }
+    else {
+        encode_alu_instruction(7, get_type_size(node->assembly_type.get()), node->src.get(), node->dst.get());
+    }
+}
+
+// Idiv(t, src) -> [rex.w] f6|f7 /7
+static void encode_idiv_instructions(AsmIdiv* node) {
+    TInt byte = get_type_size(node->assembly_type.get());
+    encode_rm_instruction(0, byte == 8, byte == 1 ? 0xf6 : 0xf7, 7, false, node->src.get(), byte == 1, 0);
+}
+
+// Div(t, src) -> [rex.w] f6|f7 /6
+static void encode_div_instructions(AsmDiv* node) {
+    TInt byte = get_type_size(node->assembly_type.get());
+    encode_rm_instruction(0, byte == 8, byte == 1 ? 0xf6 : 0xf7, 6, false, node->src.get(), byte == 1, 0);
+}
+
+// Cdq<l> -> 99
+// Cdq<q> -> rex.w 99
+static void encode_cdq_instructions(AsmCdq* node) {
+    switch (node->assembly_type->type()) {
+        case AST_T::LongWord_t:
+            push_code(0x99, 1);
+            break;
+        case AST_T::QuadWord_t:
+            push_code(0x9948, 2);
+            break;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+// RepMovsb -> f3 a4
+static void encode_rep_movsb_instructions() { push_code(0xa4f3, 2); }
+
+// Branches end the current fragment, and are encoded once the function is laid out.
+static void encode_branch_instructions(const TIdentifier& target, uint8_t cond_code, bool is_branch) {
+    context->fragments.back().target = target;
+    context->fragments.back().cond_code = cond_code;
+    context->fragments.back().is_branch = is_branch;
+    context->fragments.back().is_near = false;
+    context->fragments.emplace_back();
+    context->fragments.back().is_branch = false;
+}
+
+// SetCC(cond_code, dst) -> 0f 90+cc /0
+static void encode_set_cc_instructions(AsmSetCC* node) {
+    encode_rm_instruction(
+        0, false, 0x0f90 + get_condition_code(node->cond_code.get()), 0, false, node->dst.get(), true, 0);
+}
+
+// Cmov<lq>(cond_code, src, reg) -> [rex.w] 0f 40+cc /r
+static void encode_cmov_instructions(AsmCmov* node) {
+    TInt byte = get_type_size(node->assembly_type.get());
+    if (byte == 1) {
+        RAISE_INTERNAL_ERROR;
+    }
+    encode_rm_instruction(byte == 8, 0x0f40 + get_condition_code(node->cond_code.get()),
+        get_operand_register_code(node->dst.get()), node->src.get(), 0);
+}
+
+static void encode_label_instructions(AsmLabel* node) {
+    context->label_map[node->name] = {context->fragments.size() - 1, get_code().size()};
+}
+
+// Push(imm) -> 6a ib | 68 id
+// Push(reg) -> [rex.b] 50+r
+// Push(src) -> ff /6
+static void encode_push_instructions(AsmPush* node) {
+    switch (node->src->type()) {
+        case AST_T::AsmImm_t: {
+            int64_t value = get_imm_operand(node->src.get(), 8);
+            if (is_int8(value)) {
+                push_code(0x6a, 1);
+                push_code(static_cast<uint64_t>(value), 1);
+            }
+            else {
+                push_code(0x68, 1);
+                push_code(static_cast<uint64_t>(value), 4);
+            }
+            break;
+        }
+        case AST_T::AsmRegister_t:
+            encode_reg_instruction(false, 0x50, get_operand_register_code(node->src.get()), false);
+            break;
+        default:
+            encode_rm_instruction(false, 0xff, 6, node->src.get(), 0);
+            break;
+    }
+}
+
+// Functions with internal linkage are relocated through the plt too, but are resolved in place. Functions called
+// through the got take the modrm form of the opcode with a rip relative operand.
+static void encode_fun_operand(const TIdentifier& name, uint64_t opcode, uint64_t modrm) {
+    bool is_got = backend->backend_symbol_table.find(name) != backend->backend_symbol_table.end()
+                  && backend->backend_symbol_table[name]->type() == AST_T::BackendFun_t
+                  && static_cast<BackendFun*>(backend->backend_symbol_table[name].get())->is_got;
+    if (is_got) {
+        push_code(0xff, 1);
+        push_code(modrm, 1);
+    }
+    else {
+        push_code(opcode, 1);
+    }
+    {
+        uint32_t relocation_type = is_got ? R_X86_64_GOTPCRELX : R_X86_64_PLT32;
+        ElfRelocation relocation = {get_code().size(), relocation_type, name, -4l};
+        context->fragments.back().relocations.emplace_back(std::move(relocation));
+    }
+    push_code(0, 4);
+}
+
+// Call(name) -> e8 cd, relocated through the plt
+//            -> ff 15 cd, relocated through the got
+static void encode_call_instructions(AsmCall* node) { encode_fun_operand(node->name, 0xe8, 0x15); }
+
+// Functions with internal linkage are placed in .text with the other functions, so that jumps to them are relaxed like
+// branches, as the gnu assembler does.
+static bool is_local_fun_operand(const TIdentifier& name) {
+    return backend->backend_symbol_table.find(name) != backend->backend_symbol_table.end()
+           && backend->backend_symbol_table[name]->type() == AST_T::BackendFun_t
+           && static_cast<BackendFun*>(backend->backend_symbol_table[name].get())->is_local;
+}
+
+// TailCall(name) -> movq %rbp, %rsp (if frame pointer)
+//                   popq %rbp (if frame pointer)
+//                   eb cb | e9 cd, with internal linkage
+//                   e9 cd, relocated through the plt
+//                   ff 25 cd, relocated through the got
+static void encode_tail_call_instructions(AsmTailCall* node, bool is_frame_pointer) {
+    if (is_frame_pointer) {
+        push_code(0xec8948, 3);
+        push_code(0x5d, 1);
+    }
+    if (is_local_fun_operand(node->name)) {
+        encode_branch_instructions(node->name, 0, true);
+        return;
+    }
+    encode_fun_operand(node->name, 0xe9, 0x25);
+}
+
+// Ret -> movq %rbp, %rsp (if frame pointer)
+//        popq %rbp (if frame pointer)
+//        ret
+static void encode_ret_instructions(bool is_frame_pointer) {
+    if (is_frame_pointer) {
+        push_code(0xec8948, 3);
+        push_code(0x5d, 1);
+    }
+    push_code(0xc3, 1);
+}
+
+static void encode_instructions(AsmInstruction* node, bool is_frame_pointer) {
+    switch (node->type()) {
+        case AST_T::AsmMov_t:
+            encode_mov_instructions(static_cast<AsmMov*>(node));
+            break;
+        case AST_T::AsmMovSx_t:
+            encode_mov_sx_instructions(static_cast<AsmMovSx*>(node));
+            break;
+        case AST_T::AsmMovZeroExtend_t:
+            encode_mov_zero_extend_instructions(static_cast<AsmMovZeroExtend*>(node));
+            break;
+        case AST_T::AsmMovdqu_t:
+            encode_movdqu_instructions(static_cast<AsmMovdqu*>(node));
+            break;
+        case AST_T::AsmLea_t:
+            encode_lea_instructions(static_cast<AsmLea*>(node));
+            break;
+        case AST_T::AsmCvttsd2si_t:
+            encode_cvttsd2si_instructions(static_cast<AsmCvttsd2si*>(node));
+            break;
+        case AST_T::AsmCvtsi2sd_t:
+            encode_cvtsi2sd_instructions(static_cast<AsmCvtsi2sd*>(node));
+            break;
+        case AST_T::AsmUnary_t:
+            encode_unary_instructions(static_cast<AsmUnary*>(node));
+            break;
+        case AST_T::AsmBinary_t:
+            encode_binary_instructions(static_cast<AsmBinary*>(node));
+            break;
+        case AST_T::AsmCmp_t:
+            encode_cmp_instructions(static_cast<AsmCmp*>(node));
+            break;
+        case AST_T::AsmIdiv_t:
+            encode_idiv_instructions(static_cast<AsmIdiv*>(node));
+            break;
+        case AST_T::AsmDiv_t:
+            encode_div_instructions(static_cast<AsmDiv*>(node));
+            break;
+        case AST_T::AsmCdq_t:
+            encode_cdq_instructions(static_cast<AsmCdq*>(node));
+            break;
+        case AST_T::AsmRepMovsb_t:
+            encode_rep_movsb_instructions();
+            break;
+        case AST_T::AsmJmp_t:
+            encode_branch_instructions(static_cast<AsmJmp*>(node)->target, 0, true);
+            break;
+        case AST_T::AsmJmpCC_t: {
+            AsmJmpCC* p_node = static_cast<AsmJmpCC*>(node);
+            encode_branch_instructions(p_node->target, get_condition_code(p_node->cond_code.get()), true);
+            break;
+        }
+        case AST_T::AsmSetCC_t:
+            encode_set_cc_instructions(static_cast<AsmSetCC*>(node));
+            break;
+        case AST_T::AsmCmov_t:
+            encode_cmov_instructions(static_cast<AsmCmov*>(node));
+            break;
+        case AST_T::AsmLabel_t:
+            encode_label_instructions(static_cast<AsmLabel*>(node));
+            break;
+        case AST_T::AsmPush_t:
+            encode_push_instructions(static_cast<AsmPush*>(node));
+            break;
+        case AST_T::AsmCall_t:
+            encode_call_instructions(static_cast<AsmCall*>(node));
+            break;
+        case AST_T::AsmTailCall_t:
+            encode_tail_call_instructions(static_cast<AsmTailCall*>(node), is_frame_pointer);
+            break;
+        case AST_T::AsmRet_t:
+            encode_ret_instructions(is_frame_pointer);
+            break;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Branch relaxation
+
+// Jmp   -> eb cb | e9 cd
+// JmpCC -> 70+cc cb | 0f 80+cc cd
+static size_t get_branch_size(const ElfFragment& fragment) {
+    if (!fragment.is_branch) {
+        return 0;
+    }
+    else if (!fragment.is_near) {
+        return 2;
+    }
+    return fragment.cond_code == 0 ? 5 : 6;
+}
+
+static uint64_t get_label_address(const std::vector<uint64_t>& addresses, const TIdentifier& target) {
+    if (context->label_map.find(target) == context->label_map.end()) {
+        RAISE_INTERNAL_ERROR;
+    }
+    const std::pair<size_t, size_t>& label = context->label_map[target];
+    return addresses[label.first] + label.second;
+}
+
+// Every branch of .text starts short, and those whose target is out of reach are made near until none is. Branches only
+// grow, so this reaches a fixed point.
+static void relax_branches(std::vector<uint64_t>& addresses) {
+    addresses.resize(context->fragments.size());
+    bool is_relaxed;
+    do {
+        is_relaxed = true;
+        uint64_t address = 0;
+        for (size_t i = 0; i < context->fragments.size(); ++i) {
+            addresses[i] = address;
+            address += context->fragments[i].code.size() + get_branch_size(context->fragments[i]);
+        }
+        for (size_t i = 0; i < context->fragments.size(); ++i) {
+            ElfFragment& fragment = context->fragments[i];
+            if (fragment.is_branch && !fragment.is_near) {
+                int64_t displacement = static_cast<int64_t>(get_label_address(addresses, fragment.target))
+                                       - static_cast<int64_t>(addresses[i] + fragment.code.size() + 2);
+                if (!is_int8(displacement)) {
+                    fragment.is_near = true;
+                    is_relaxed = false;
+                }
+            }
+        }
+    }
+    while (!is_relaxed);
+}
+
+static void emit_branch(const ElfFragment& fragment, uint64_t address, uint64_t target_address, std::string& bytes) {
+    uint64_t next_address = address + get_branch_size(fragment);
+    int64_t displacement = static_cast<int64_t>(target_address) - static_cast<int64_t>(next_address);
+    bool is_jmp = fragment.cond_code == 0;
+    if (!fragment.is_near) {
+        bytes += static_cast<char>(is_jmp ? 0xeb : 0x70 + fragment.cond_code);
+        append_uint(bytes, static_cast<uint64_t>(displacement), 1);
+    }
+    else {
+        if (is_jmp) {
+            bytes += static_cast<char>(0xe9);
+        }
+        else {
+            bytes += static_cast<char>(0x0f);
+            bytes += static_cast<char>(0x80 + fragment.cond_code);
+        }
+        append_uint(bytes, static_cast<uint64_t>(displacement), 4);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Sections
+
+static void define_symbol(
+    const TIdentifier& name, ELF_SECTION_KIND section_kind, bool is_global, bool is_function, bool is_constant) {
+    ElfSection& section = context->sections[section_kind];
+    ElfSymbol symbol = {section_kind, section.size, 0, is_global, is_function, is_constant};
+    context->symbol_names.push_back(name);
+    context->symbol_map[name] = std::move(symbol);
+}
+
+static void align_section(ELF_SECTION_KIND section_kind, TInt alignment) {
+    ElfSection& section = context->sections[section_kind];
+    uint64_t byte = alignment > 1 ? static_cast<uint64_t>(alignment) : 1;
+    if (byte > section.alignment) {
+        section.alignment = byte;
+    }
+    section.size = (section.size + byte - 1) / byte * byte;
+    if (section_kind != ELF_SECTION_KIND::bss_section) {
+        section.bytes.resize(section.size, '\0');
+    }
+}
+
+static void emit_section_bytes(ELF_SECTION_KIND section_kind, std::string&& bytes) {
+    ElfSection& section = context->sections[section_kind];
+    section.size += bytes.size();
+    section.bytes += bytes;
+}
+
+// Function(name, global, return_memory, frame_pointer, instructions) -> pushq %rbp (if frame pointer)
+//                                                                       movq %rsp, %rbp (if frame pointer)
+//                                                                       <instructions>
+// Functions are only encoded here, and placed once the branches of every function are relaxed.
+static void emit_function_top_level(AsmFunction* node) {
+    define_symbol(node->name, ELF_SECTION_KIND::text_section, node->is_global, true, false);
+
+    context->fragments.emplace_back();
+    context->fragments.back().is_branch = false;
+    context->label_map[node->name] = {context->fragments.size() - 1, 0};
+    context->function_fragments.emplace_back(node->name, context->fragments.size() - 1);
+    if (node->is_frame_pointer) {
+        push_code(0x55, 1);
+        push_code(0xe58948, 3);
+    }
+    for (size_t i = node->instructions[0] ? 0 : 1; i < node->instructions.size(); ++i) {
+        encode_instructions(node->instructions[i].get(), node->is_frame_pointer);
+    }
+}
+
+static void emit_text_fragments() {
+    ElfSection& section = context->sections[ELF_SECTION_KIND::text_section];
+    std::vector<uint64_t> addresses;
+    relax_branches(addresses);
+    for (size_t i = 0; i < context->fragments.size(); ++i) {
+        ElfFragment& fragment = context->fragments[i];
+        for (auto& relocation : fragment.relocations) {
+            relocation.offset += section.size + addresses[i];
+            section.relocations.emplace_back(std::move(relocation));
+        }
+        section.bytes += fragment.code;
+        if (fragment.is_branch) {
+            emit_branch(fragment, addresses[i] + fragment.code.size(), get_label_address(addresses, fragment.target),
+                section.bytes);
+        }
+    }
+    for (size_t i = context->function_fragments.size(); i-- > 0;) {
+        size_t fragment_index = context->function_fragments[i].second;
+        uint64_t end_address = i + 1 < context->function_fragments.size() ?
+                                   addresses[context->function_fragments[i + 1].second] :
+                                   section.bytes.size() - section.size;
+        ElfSymbol& symbol = context->symbol_map[context->function_fragments[i].first];
+        symbol.offset = section.size + addresses[fragment_index];
+        symbol.size = end_address - addresses[fragment_index];
+    }
+    section.size = section.bytes.size();
+    context->fragments.clear();
+    context->label_map.clear();
+    context->function_fragments.clear();
+}
+
+// CharInit(i)    -> i (1 byte)
+// IntInit(i)     -> i (4 bytes)
+// LongInit(i)    -> i (8 bytes)
+// DoubleInit(d)  -> binary of d (8 bytes)
+// UCharInit(i)   -> i (1 byte)
+// UIntInit(i)    -> i (4 bytes)
+// ULongInit(i)   -> i (8 bytes)
+// ZeroInit(n)    -> n zero bytes
+// StringInit(s)  -> bytes of s [0]
+// PointerInit(l) -> address of l (8 bytes)
+static void emit_init_static_variable_top_level(ELF_SECTION_KIND section_kind, StaticInit* node) {
+    ElfSection& section = context->sections[section_kind];
+    if (section_kind == ELF_SECTION_KIND::bss_section) {
+        if (node->type() != AST_T::ZeroInit_t) {
+            RAISE_INTERNAL_ERROR;
+        }
+        section.size += static_cast<uint64_t>(static_cast<ZeroInit*>(node)->byte);
+        return;
+    }
+    std::string bytes;
+    switch (node->type()) {
+        case AST_T::CharInit_t:
+            append_uint(bytes, static_cast<uint64_t>(static_cast<CharInit*>(node)->value), 1);
+            break;
+        case AST_T::IntInit_t:
+            append_uint(bytes, static_cast<uint64_t>(static_cast<IntInit*>(node)->value), 4);
+            break;
+        case AST_T::LongInit_t:
+            append_uint(bytes, static_cast<uint64_t>(static_cast<LongInit*>(node)->value), 8);
+            break;
+        case AST_T::DoubleInit_t:
+            append_uint(bytes, static_cast<DoubleInit*>(node)->binary, 8);
+            break;
+        case AST_T::UCharInit_t:
+            append_uint(bytes, static_cast<UCharInit*>(node)->value, 1);
+            break;
+        case AST_T::UIntInit_t:
+            append_uint(bytes, static_cast<UIntInit*>(node)->value, 4);
+            break;
+        case AST_T::ULongInit_t:
+            append_uint(bytes, static_cast<ULongInit*>(node)->value, 8);
+            break;
+        case AST_T::ZeroInit_t:
+            bytes.resize(static_cast<size_t>(static_cast<ZeroInit*>(node)->byte), '\0');
+            break;
+        case AST_T::StringInit_t: {
+            StringInit* p_node = static_cast<StringInit*>(node);
+            for (TChar value : p_node->literal->value) {
+                bytes += static_cast<char>(value);
+            }
+            if (p_node->is_null_terminated) {
+                bytes += '\0';
+            }
+            break;
+        }
+        case AST_T::PointerInit_t: {
+            ElfRelocation relocation = {section.size, R_X86_64_64, static_cast<PointerInit*>(node)->name, 0l};
+            section.relocations.emplace_back(std::move(relocation));
+            append_uint(bytes, 0, 8);
+            break;
+        }
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+    emit_section_bytes(section_kind, std::move(bytes));
+}
+
+// StaticVariable(name, global, align, init*) -> <name>: <init_list> in .bss if zero initialized, else in .data
+static void emit_static_variable_top_level(AsmStaticVariable* node) {
+    ELF_SECTION_KIND section_kind =
+        node->static_inits.size() == 1 && node->static_inits[0]->type() == AST_T::ZeroInit_t ?
+            ELF_SECTION_KIND::bss_section :
+            ELF_SECTION_KIND::data_section;
+    align_section(section_kind, node->alignment);
+    define_symbol(node->name, section_kind, node->is_global, false, false);
+    uint64_t offset = context->sections[section_kind].size;
+    for (const auto& static_init : node->static_inits) {
+        emit_init_static_variable_top_level(section_kind, static_init.get());
+    }
+    context->symbol_map[node->name].size = context->sections[section_kind].size - offset;
+}
+
+// StaticConstant(name, align, init) -> .L<name>: <init> in .rodata
+static void emit_static_constant_top_level(AsmStaticConstant* node) {
+    align_section(ELF_SECTION_KIND::rodata_section, node->alignment);
+    define_symbol(node->name, ELF_SECTION_KIND::rodata_section, false, false, true);
+    uint64_t offset = context->sections[ELF_SECTION_KIND::rodata_section].size;
+    emit_init_static_variable_top_level(ELF_SECTION_KIND::rodata_section, node->static_init.get());
+    context->symbol_map[node->name].size = context->sections[ELF_SECTION_KIND::rodata_section].size - offset;
+}
+
+static void emit_top_level(AsmTopLevel* node) {
+    switch (node->type()) {
+        case AST_T::AsmFunction_t:
+            emit_function_top_level(static_cast<AsmFunction*>(node));
+            break;
+        case AST_T::AsmStaticVariable_t:
+            emit_static_variable_top_level(static_cast<AsmStaticVariable*>(node));
+            break;
+        case AST_T::AsmStaticConstant_t:
+            emit_static_constant_top_level(static_cast<AsmStaticConstant*>(node));
+            break;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+// Calls and tail calls to functions with internal linkage are resolved in place, as their displacement within .text
+// is known.
+static void resolve_text_relocations() {
+    ElfSection& section = context->sections[ELF_SECTION_KIND::text_section];
+    std::vector<ElfRelocation> relocations;
+    for (auto& relocation : section.relocations) {
+        if (relocation.relocation_type == R_X86_64_PLT32
+            && context->symbol_map.find(relocation.name) != context->symbol_map.end()) {
+            const ElfSymbol& symbol = context->symbol_map[relocation.name];
+            if (!symbol.is_global && symbol.section_kind == ELF_SECTION_KIND::text_section) {
+                int64_t displacement = static_cast<int64_t>(symbol.offset) + relocation.addend
+                                       - static_cast<int64_t>(relocation.offset);
+                std::string bytes;
+                append_uint(bytes, static_cast<uint64_t>(displacement), 4);
+                section.bytes.replace(relocation.offset, 4, bytes);
+                continue;
+            }
+        }
+        relocations.emplace_back(std::move(relocation));
+    }
+    section.relocations = std::move(relocations);
+}
+
+// Static constants and variables are laid out first, so that the relocations of the instructions have a target.
+static void emit_program(AsmProgram* node) {
+    for (const auto& top_level : node->static_constant_top_levels) {
+        emit_top_level(top_level.get());
+    }
+    for (const auto& top_level : node->top_levels) {
+        if (top_level->type() != AST_T::AsmFunction_t) {
+            emit_top_level(top_level.get());
+        }
+    }
+    for (const auto& top_level : node->top_levels) {
+        if (top_level->type() == AST_T::AsmFunction_t) {
+            emit_top_level(top_level.get());
+        }
+    }
+    emit_text_fragments();
+    resolve_text_relocations();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Elf file
+
+enum ELF_SECTION_HEADER {
+    null_header,
+    text_header,
+    rela_text_header,
+    data_header,
+    rela_data_header,
+    bss_header,
+    rodata_header,
+    note_gnu_stack_header,
+    symtab_header,
+    strtab_header,
+    shstrtab_header,
+    elf_section_header_size
+};
+
+struct ElfSymbolTable {
+    std::vector<Elf64_Sym> symbols;
+    std::string strings;
+    std::unordered_map<TIdentifier, uint32_t> symbol_index_map;
+    uint32_t local_size;
+};
+
+static uint32_t append_string(std::string& strings, const std::string& name) {
+    uint32_t offset = static_cast<uint32_t>(strings.size());
+    strings += name;
+    strings += '\0';
+    return offset;
+}
+
+// text_section -> text_header
+// data_section -> data_header
+// ...
+static uint16_t get_section_header_index(ELF_SECTION_KIND section_kind) {
+    switch (section_kind) {
+        case ELF_SECTION_KIND::text_section:
+            return ELF_SECTION_HEADER::text_header;
+        case ELF_SECTION_KIND::data_section:
+            return ELF_SECTION_HEADER::data_header;
+        case ELF_SECTION_KIND::bss_section:
+            return ELF_SECTION_HEADER::bss_header;
+        case ELF_SECTION_KIND::rodata_section:
+            return ELF_SECTION_HEADER::rodata_header;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+static void push_symbol(ElfSymbolTable& symbol_table, const TIdentifier& name, unsigned char info,
+    uint16_t section_index, uint64_t value, uint64_t size) {
+    Elf64_Sym symbol;
+    memset(&symbol, 0, sizeof(Elf64_Sym));
+    symbol.st_name = name.empty() ? 0 : append_string(symbol_table.strings, name);
+    symbol.st_info = info;
+    symbol.st_shndx = section_index;
+    symbol.st_value = value;
+    symbol.st_size = size;
+    if (!name.empty()) {
+        symbol_table.symbol_index_map[name] = static_cast<uint32_t>(symbol_table.symbols.size());
+    }
+    symbol_table.symbols.push_back(symbol);
+}
+
+static void push_defined_symbol(ElfSymbolTable& symbol_table, const TIdentifier& name, const ElfSymbol& symbol) {
+    unsigned char info = ELF64_ST_INFO(
+        symbol.is_global ? STB_GLOBAL : STB_LOCAL, symbol.is_function ? STT_FUNC : STT_OBJECT);
+    push_symbol(
+        symbol_table, name, info, get_section_header_index(symbol.section_kind), symbol.offset, symbol.size);
+}
+
+// Symbols that are referenced but not defined are undefined globals, in the order they are first referenced.
+static void push_undefined_symbols(ElfSymbolTable& symbol_table, const std::vector<ElfRelocation>& relocations) {
+    for (const auto& relocation : relocations) {
+        if (context->symbol_map.find(relocation.name) == context->symbol_map.end()
+            && symbol_table.symbol_index_map.find(relocation.name) == symbol_table.symbol_index_map.end()) {
+            push_symbol(symbol_table, relocation.name, ELF64_ST_INFO(STB_GLOBAL, STT_NOTYPE), SHN_UNDEF, 0, 0);
+        }
+    }
+}
+
+// Locals come first: the null symbol, a symbol for each section, then the local symbols except for the static
+// constants, which are only referenced through the symbol of their section.
+static void build_symbol_table(ElfSymbolTable& symbol_table) {
+    symbol_table.strings = "";
+    symbol_table.strings += '\0';
+    push_symbol(symbol_table, "", 0, SHN_UNDEF, 0, 0);
+    for (size_t i = 0; i < ELF_SECTION_KIND::elf_section_kind_size; ++i) {
+        push_symbol(symbol_table, "", ELF64_ST_INFO(STB_LOCAL, STT_SECTION),
+            get_section_header_index(static_cast<ELF_SECTION_KIND>(i)), 0, 0);
+    }
+    for (const auto& name : context->symbol_names) {
+        const ElfSymbol& symbol = context->symbol_map[name];
+        if (!symbol.is_global && !symbol.is_constant) {
+            push_defined_symbol(symbol_table, name, symbol);
+        }
+    }
+    symbol_table.local_size = static_cast<uint32_t>(symbol_table.symbols.size());
+    for (const auto& name : context->symbol_names) {
+        const ElfSymbol& symbol = context->symbol_map[name];
+        if (symbol.is_global) {
+            push_defined_symbol(symbol_table, name, symbol);
+        }
+    }
+    push_undefined_symbols(symbol_table, context->sections[ELF_SECTION_KIND::text_section].relocations);
+    push_undefined_symbols(symbol_table, context->sections[ELF_SECTION_KIND::data_section].relocations);
+}
+
+// Relocations to local symbols are made relative to the symbol of their section, like the gnu assembler does.
+static std::string get_relocation_bytes(
+    const ElfSymbolTable& symbol_table, const std::vector<ElfRelocation>& relocations) {
+    std::string bytes;
+    for (const auto& relocation : relocations) {
+        Elf64_Rela rela;
+        uint32_t symbol_index;
+        int64_t addend = relocation.addend;
+        if (context->symbol_map.find(relocation.name) != context->symbol_map.end()
+            && !context->symbol_map[relocation.name].is_global) {
+            const ElfSymbol& symbol = context->symbol_map[relocation.name];
+            symbol_index = 1 + static_cast<uint32_t>(symbol.section_kind);
+            addend += static_cast<int64_t>(symbol.offset);
+        }
+        else {
+            symbol_index = symbol_table.symbol_index_map.at(relocation.name);
+        }
+        rela.r_offset = relocation.offset;
+        rela.r_info = ELF64_R_INFO(symbol_index, relocation.relocation_type);
+        rela.r_addend = addend;
+        append_bytes(bytes, &rela, sizeof(Elf64_Rela));
+    }
+    return bytes;
+}
+
+static void set_section_header(Elf64_Shdr& section_header, uint32_t name, uint32_t type, uint64_t flags,
+    uint64_t alignment, uint64_t entry_size) {
+    memset(&section_header, 0, sizeof(Elf64_Shdr));
+    section_header.sh_name = name;
+    section_header.sh_type = type;
+    section_header.sh_flags = flags;
+    section_header.sh_addralign = alignment;
+    section_header.sh_entsize = entry_size;
+}
+
+// Appends the contents of a section to the file, and records where it is in its header.
+static void append_section(std::string& bytes, Elf64_Shdr& section_header, const std::string& contents) {
+    align_bytes(bytes, section_header.sh_addralign > 0 ? section_header.sh_addralign : 1);
+    section_header.sh_offset = bytes.size();
+    section_header.sh_size = contents.size();
+    bytes += contents;
+}
+
+// Elf header | .text | .rela.text | .data | .rela.data | .rodata | .symtab | .strtab | .shstrtab | section headers
+static void write_elf_file() {
+    ElfSymbolTable symbol_table;
+    build_symbol_table(symbol_table);
+
+    std::string shstrtab = "";
+    shstrtab += '\0';
+    std::array<Elf64_Shdr, ELF_SECTION_HEADER::elf_section_header_size> section_headers;
+    set_section_header(section_headers[ELF_SECTION_HEADER::null_header], 0, SHT_NULL, 0, 0, 0);
+    set_section_header(section_headers[ELF_SECTION_HEADER::text_header], append_string(shstrtab, ".text"),
+        SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, context->sections[ELF_SECTION_KIND::text_section].alignment, 0);
+    set_section_header(section_headers[ELF_SECTION_HEADER::rela_text_header], append_string(shstrtab, ".rela.text"),
+        SHT_RELA, SHF_INFO_LINK, 8, sizeof(Elf64_Rela));
+    set_section_header(section_headers[ELF_SECTION_HEADER::data_header], append_string(shstrtab, ".data"),
+        SHT_PROGBITS, SHF_ALLOC | SHF_WRITE, context->sections[ELF_SECTION_KIND::data_section].alignment, 0);
+    set_section_header(section_headers[ELF_SECTION_HEADER::rela_data_header], append_string(shstrtab, ".rela.data"),
+        SHT_RELA, SHF_INFO_LINK, 8, sizeof(Elf64_Rela));
+    set_section_header(section_headers[ELF_SECTION_HEADER::bss_header], append_string(shstrtab, ".bss"), SHT_NOBITS,
+        SHF_ALLOC | SHF_WRITE, context->sections[ELF_SECTION_KIND::bss_section].alignment, 0);
+    set_section_header(section_headers[ELF_SECTION_HEADER::rodata_header], append_string(shstrtab, ".rodata"),
+        SHT_PROGBITS, SHF_ALLOC, context->sections[ELF_SECTION_KIND::rodata_section].alignment, 0);
+    set_section_header(section_headers[ELF_SECTION_HEADER::note_gnu_stack_header],
+        append_string(shstrtab, ".note.GNU-stack"), SHT_PROGBITS, 0, 1, 0);
+    set_section_header(section_headers[ELF_SECTION_HEADER::symtab_header], append_string(shstrtab, ".symtab"),
+        SHT_SYMTAB, 0, 8, sizeof(Elf64_Sym));
+    set_section_header(
+        section_headers[ELF_SECTION_HEADER::strtab_header], append_string(shstrtab, ".strtab"), SHT_STRTAB, 0, 1, 0);
+    uint32_t shstrtab_name = append_string(shstrtab, ".shstrtab");
+    set_section_header(section_headers[ELF_SECTION_HEADER::shstrtab_header], shstrtab_name, SHT_STRTAB, 0, 1, 0);
+
+    section_headers[ELF_SECTION_HEADER::rela_text_header].sh_link = ELF_SECTION_HEADER::symtab_header;
+    section_headers[ELF_SECTION_HEADER::rela_text_header].sh_info = ELF_SECTION_HEADER::text_header;
+    section_headers[ELF_SECTION_HEADER::rela_data_header].sh_link = ELF_SECTION_HEADER::symtab_header;
+    section_headers[ELF_SECTION_HEADER::rela_data_header].sh_info = ELF_SECTION_HEADER::data_header;
+    section_headers[ELF_SECTION_HEADER::symtab_header].sh_link = ELF_SECTION_HEADER::strtab_header;
+    section_headers[ELF_SECTION_HEADER::symtab_header].sh_info = symbol_table.local_size;
+
+    std::string bytes(sizeof(Elf64_Ehdr), '\0');
+    append_section(bytes, section_headers[ELF_SECTION_HEADER::text_header],
+        context->sections[ELF_SECTION_KIND::text_section].bytes);
+    append_section(bytes, section_headers[ELF_SECTION_HEADER::rela_text_header],
+        get_relocation_bytes(symbol_table, context->sections[ELF_SECTION_KIND::text_section].relocations));
+    append_section(bytes, section_headers[ELF_SECTION_HEADER::data_header],
+        context->sections[ELF_SECTION_KIND::data_section].bytes);
+    append_section(bytes, section_headers[ELF_SECTION_HEADER::rela_data_header],
+        get_relocation_bytes(symbol_table, context->sections[ELF_SECTION_KIND::data_section].relocations));
+    section_headers[ELF_SECTION_HEADER::bss_header].sh_offset = bytes.size();
+    section_headers[ELF_SECTION_HEADER::bss_header].sh_size = context->sections[ELF_SECTION_KIND::bss_section].size;
+    append_section(bytes, section_headers[ELF_SECTION_HEADER::rodata_header],
+        context->sections[ELF_SECTION_KIND::rodata_section].bytes);
+    section_headers[ELF_SECTION_HEADER::note_gnu_stack_header].sh_offset = bytes.size();
+    {
+        std::string symtab;
+        for (const auto& symbol : symbol_table.symbols) {
+            append_bytes(symtab, &symbol, sizeof(Elf64_Sym));
+        }
+        append_section(bytes, section_headers[ELF_SECTION_HEADER::symtab_header], symtab);
+    }
+    append_section(bytes, section_headers[ELF_SECTION_HEADER::strtab_header], symbol_table.strings);
+    append_section(bytes, section_headers[ELF_SECTION_HEADER::shstrtab_header], shstrtab);
+
+    align_bytes(bytes, 8);
+    {
+        Elf64_Ehdr elf_header;
+        memset(&elf_header, 0, sizeof(Elf64_Ehdr));
+        memcpy(elf_header.e_ident, ELFMAG, SELFMAG);
+        elf_header.e_ident[EI_CLASS] = ELFCLASS64;
+        elf_header.e_ident[EI_DATA] = ELFDATA2LSB;
+        elf_header.e_ident[EI_VERSION] = EV_CURRENT;
+        elf_header.e_ident[EI_OSABI] = ELFOSABI_NONE;
+        elf_header.e_type = ET_REL;
+        elf_header.e_machine = EM_X86_64;
+        elf_header.e_version = EV_CURRENT;
+        elf_header.e_shoff = bytes.size();
+        elf_header.e_ehsize = sizeof(Elf64_Ehdr);
+        elf_header.e_shentsize = sizeof(Elf64_Shdr);
+        elf_header.e_shnum = ELF_SECTION_HEADER::elf_section_header_size;
+        elf_header.e_shstrndx = ELF_SECTION_HEADER::shstrtab_header;
+        memcpy(&bytes[0], &elf_header, sizeof(Elf64_Ehdr));
+    }
+    for (const auto& section_header : section_headers) {
+        append_bytes(bytes, &section_header, sizeof(Elf64_Shdr));
+    }
+    write_bytes(std::move(bytes));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void elf_code_emission(std::unique_ptr<AsmProgram> asm_ast, std::string&& filename) {
+    context = std::make_unique<ElfCodeContext>();
+    emit_program(asm_ast.get());
+    asm_ast.reset();
+
+    file_open_write(filename);
+    write_elf_file();
+    file_close_write();
+    context.reset();
+}
@@ -464,6 +464,14 @@ static void emit_mov_zero_extend_instructions(AsmMovZeroExtend* node) {
     emit(std::move(instruction), 2);
 }
 
+static void emit_movdqu_instructions(AsmMovdqu* node) {
+    std::string instruction = "movdqu ";
+    instruction += emit_operand(node->src.get(), 8);
+    instruction += ", ";
+    instruction += emit_operand(node->dst.get(), 8);
+    emit(std::move(instruction), 2);
+}
+
 static void emit_lea_instructions(AsmLea* node) {
     std::string instruction = "leaq ";
     instruction += emit_operand(node->src.get(), 8);
@@ -572,6 +580,8 @@ static void emit_cdq_instructions(AsmCdq* node) {
     }
 }
 
+static void emit_rep_movsb_instructions() { emit("rep movsb", 2); }
+
 static void emit_jmp_instructions(AsmJmp* node) {
     std::string instruction = "jmp .L";
     instruction += emit_identifier(node->target);
@@ -594,6 +604,20 @@ static void emit_set_cc_instructions(AsmSetCC* node) {
     emit(std::move(instruction), 2);
 }
 
+static void emit_cmov_instructions(AsmCmov* node) {
+    std::string instruction = "cmov";
+    instruction += emit_condition_code(node->cond_code.get());
+    instruction += emit_type_instruction_suffix(node->assembly_type.get());
+    instruction += " ";
+    {
+        TInt byte = emit_type_alignment_bytes(node->assembly_type.get());
+        instruction += emit_operand(node->src.get(), byte);
+        instruction += ", ";
+        instruction += emit_operand(node->dst.get(), byte);
+    }
+    emit(std::move(instruction), 2);
+}
+
 static void emit_label_instructions(AsmLabel* node) {
     std::string instruction = ".L";
     instruction += emit_identifier(node->name);
@@ -607,16 +631,50 @@ static void emit_push_instructions(AsmPush* node) {
     emit(std::move(instruction), 2);
 }
 
+// Fun(true, true, false) -> $ <label>
+// Fun(_, false, true)     -> $ *<label>@GOTPCREL(%rip)
+// Fun(_, false, false)    -> $ <label>@PLT
+static std::string emit_fun_operand(const TIdentifier& name) {
+    BackendFun* backend_fun =
+        backend->backend_symbol_table.find(name) != backend->backend_symbol_table.end()
+                && backend->backend_symbol_table[name]->type() == AST_T::BackendFun_t ?
+            static_cast<BackendFun*>(backend->backend_symbol_table[name].get()) :
+            nullptr;
+    if (backend_fun && backend_fun->is_local) {
+        return emit_identifier(name);
+    }
+    else if (backend_fun && backend_fun->is_got) {
+        std::string operand = "*";
+        operand += emit_identifier(name);
+        operand += "@GOTPCREL(%rip)";
+        return operand;
+    }
+    std::string operand = emit_identifier(name);
+    operand += "@PLT";
+    return operand;
+}
+
 static void emit_call_instructions(AsmCall* node) {
     std::string instruction = "call ";
-    instruction += emit_identifier(node->name);
-    instruction += "@PLT";
+    instruction += emit_fun_operand(node->name);
+    emit(std::move(instruction), 2);
+}
+
+static void emit_tail_call_instructions(AsmTailCall* node, bool is_frame_pointer) {
+    if (is_frame_pointer) {
+        emit("movq %rbp, %rsp", 1);
+        emit("popq %rbp", 1);
+    }
+    std::string instruction = "jmp ";
+    instruction += emit_fun_operand(node->name);
     emit(std::move(instruction), 2);
 }
 
-static void emit_ret_instructions() {
-    emit("movq %rbp, %rsp", 1);
-    emit("popq %rbp", 1);
+static void emit_ret_instructions(bool is_frame_pointer) {
+    if (is_frame_pointer) {
+        emit("movq %rbp, %rsp", 1);
+        emit("popq %rbp", 1);
+    }
     emit("ret", 1);
 }
 
@@ -639,11 +697,14 @@ static void emit_ret_instructions() {
 // SetCC(cond_code, operand)             -> $ set<cond_code> <operand>
 // Label(label)                          -> $ .L<label>:
 // Push(operand)                         -> $ pushq <operand>
-// Call(label)                           -> $ call <label>@PLT
-// Ret                                   -> $ movq %rbp, %rsp
-//                                          $ popq %rbp
+// Call(label)                           -> $ call <fun>
+// TailCall(label)                       -> $ movq %rbp, %rsp (if frame pointer)
+//                                          $ popq %rbp (if frame pointer)
+//                                          $ jmp <fun>
+// Ret                                   -> $ movq %rbp, %rsp (if frame pointer)
+//                                          $ popq %rbp (if frame pointer)
 //                                          $ ret
-static void emit_instructions(AsmInstruction* node) {
+static void emit_instructions(AsmInstruction* node, bool is_frame_pointer) {
     switch (node->type()) {
         case AST_T::AsmMov_t:
             emit_mov_instructions(static_cast<AsmMov*>(node));
@@ -654,6 +715,9 @@ static void emit_instructions(AsmInstruction* node) {
         case AST_T::AsmMovZeroExtend_t:
             emit_mov_zero_extend_instructions(static_cast<AsmMovZeroExtend*>(node));
             break;
+        case AST_T::AsmMovdqu_t:
+            emit_movdqu_instructions(static_cast<AsmMovdqu*>(node));
+            break;
         case AST_T::AsmLea_t:
             emit_lea_instructions(static_cast<AsmLea*>(node));
             break;
@@ -681,6 +745,9 @@ static void emit_instructions(AsmInstruction* node) {
         case AST_T::AsmCdq_t:
             emit_cdq_instructions(static_cast<AsmCdq*>(node));
             break;
+        case AST_T::AsmRepMovsb_t:
+            emit_rep_movsb_instructions();
+            break;
         case AST_T::AsmJmp_t:
             emit_jmp_instructions(static_cast<AsmJmp*>(node));
             break;
@@ -690,6 +757,9 @@ static void emit_instructions(AsmInstruction* node) {
         case AST_T::AsmSetCC_t:
             emit_set_cc_instructions(static_cast<AsmSetCC*>(node));
             break;
+        case AST_T::AsmCmov_t:
+            emit_cmov_instructions(static_cast<AsmCmov*>(node));
+            break;
         case AST_T::AsmLabel_t:
             emit_label_instructions(static_cast<AsmLabel*>(node));
             break;
@@ -699,17 +769,21 @@ static void emit_instructions(AsmInstruction* node) {
         case AST_T::AsmCall_t:
             emit_call_instructions(static_cast<AsmCall*>(node));
             break;
+        case AST_T::AsmTailCall_t:
+            emit_tail_call_instructions(static_cast<AsmTailCall*>(node), is_frame_pointer);
+            break;
         case AST_T::AsmRet_t:
-            emit_ret_instructions();
+            emit_ret_instructions(is_frame_pointer);
             break;
         default:
             RAISE_INTERNAL_ERROR;
     }
 }
 
-static void emit_list_instructions(const std::vector<std::unique_ptr<AsmInstruction>>& list_node) {
+static void emit_list_instructions(
+    const std::vector<std::unique_ptr<AsmInstruction>>& list_node, bool is_frame_pointer) {
     for (size_t i = list_node[0] ? 0 : 1; i < list_node.size(); ++i) {
-        emit_instructions(list_node[i].get());
+        emit_instructions(list_node[i].get(), is_frame_pointer);
     }
 }
 
@@ -731,12 +805,12 @@ static void emit_global_directive_top_level(const std::string& name, bool is_glo
     }
 }
 
-// Function(name, global, return_memory, instructions) -> $     <global-directive>
-//                                                        $     .text
-//                                                        $ <name>:
-//                                                        $     pushq %rbp
-//                                                        $     movq %rsp, %rbp
-//                                                        $     <instructions>
+// Function(name, global, return_memory, frame_pointer, instructions) -> $     <global-directive>
+//                                                                       $     .text
+//                                                                       $ <name>:
+//                                                                       $     pushq %rbp (if frame pointer)
+//                                                                       $     movq %rsp, %rbp (if frame pointer)
+//                                                                       $     <instructions>
 static void emit_function_top_level(AsmFunction* node) {
     const std::string& name = emit_identifier(node->name);
     emit_global_directive_top_level(name, node->is_global);
@@ -746,9 +820,11 @@ static void emit_function_top_level(AsmFunction* node) {
         directive += ":";
         emit(std::move(directive), 0);
     }
-    emit("pushq %rbp", 1);
-    emit("movq %rsp, %rbp", 1);
-    emit_list_instructions(node->instructions);
+    if (node->is_frame_pointer) {
+        emit("pushq %rbp", 1);
+        emit("movq %rsp, %rbp", 1);
+    }
+    emit_list_instructions(node->instructions, node->is_frame_pointer);
 }
 
 // CharInit(i)                         -> .byte <i>
@@ -873,9 +949,9 @@ static void emit_static_constant_top_level(AsmStaticConstant* node) {
     emit_init_static_variable_top_level(node->static_init.get());
 }
 
-// Function(name, global, return_memory, instructions) -> $ <function-top-level-directives>
-// StaticVariable(name, global, align, init*)          -> $ <static-variable-top-level-directives>
-// StaticConstant(name, align, init)                   -> $ <static-constant-top-level-directives>
+// Function(name, global, return_memory, frame_pointer, instructions) -> $ <function-top-level-directives>
+// StaticVariable(name, global, align, init*)                         -> $ <static-variable-top-level-directives>
+// StaticConstant(name, align, init)                                  -> $ <static-constant-top-level-directives>
 static void emit_top_level(AsmTopLevel* node) {
     emit("", 0);
     switch (node->type()) {
@@ -1,3 +1,4 @@
+#include <inttypes.h>
 #include <string>
 
 #include "util/throw.hpp"
@@ -12,6 +13,20 @@
 
 // Names
 
+// Labels made while functions are generated in parallel are numbered within their function and suffixed by its index,
+// instead of taking the next shared label number, so that they do not depend on the order that the jobs run in.
+static thread_local bool is_label_shard = false;
+static thread_local size_t label_shard = 0;
+static thread_local uint32_t label_shard_counter = 0;
+
+void begin_label_shard(size_t shard) {
+    is_label_shard = true;
+    label_shard = shard;
+    label_shard_counter = 0;
+}
+
+void end_label_shard() { is_label_shard = false; }
+
 TIdentifier resolve_label_identifier(const TIdentifier& label) {
     TIdentifier name = label;
     name += ".";
@@ -47,6 +62,10 @@ TIdentifier represent_label_identifier(LABEL_KIND label_kind) {
             name = "and_true";
             break;
         }
+        case LABEL_KIND::Lblock: {
+            name = "block";
+            break;
+        }
         case LABEL_KIND::Lcomisd_nan: {
             name = "comisd_nan";
             break;
@@ -111,6 +130,10 @@ TIdentifier represent_label_identifier(LABEL_KIND label_kind) {
             name = "string";
             break;
         }
+        case LABEL_KIND::Ltail_call: {
+            name = "tail_call";
+            break;
+        }
         case LABEL_KIND::Lternary_else: {
             name = "ternary_else";
             break;
@@ -119,6 +142,10 @@ TIdentifier represent_label_identifier(LABEL_KIND label_kind) {
             name = "ternary_false";
             break;
         }
+        case LABEL_KIND::Lunroll: {
+            name = "unroll";
+            break;
+        }
         case LABEL_KIND::Lwhile: {
             name = "while";
             break;
@@ -127,6 +154,13 @@ TIdentifier represent_label_identifier(LABEL_KIND label_kind) {
             RAISE_INTERNAL_ERROR;
     }
     name += ".";
+    if (is_label_shard) {
+        name += std::to_string(label_shard_counter);
+        name += ".";
+        name += std::to_string(label_shard);
+        label_shard_counter++;
+        return name;
+    }
     name += std::to_string(frontend->label_counter);
     frontend->label_counter++;
     return name;
@@ -14,6 +14,7 @@
 
 #include "frontend/intermediate/names.hpp"
 #include "frontend/intermediate/semantic.hpp"
+#include "frontend/intermediate/types.hpp"
 
 static std::unique_ptr<SemanticContext> context;
 
@@ -41,7 +42,10 @@ static bool is_structure_same_type(Structure* struct_type_1, Structure* struct_t
 }
 
 static bool is_same_type(Type* type_1, Type* type_2) {
-    if (type_1->type() == type_2->type()) {
+    if (type_1 == type_2) {
+        return true;
+    }
+    else if (type_1->type() == type_2->type()) {
         switch (type_1->type()) {
             case AST_T::Pointer_t:
                 return is_pointer_same_type(static_cast<Pointer*>(type_1), static_cast<Pointer*>(type_2));
@@ -59,7 +63,10 @@ static bool is_same_type(Type* type_1, Type* type_2) {
 }
 
 static bool is_same_fun_type(FunType* fun_type_1, FunType* fun_type_2) {
-    if (fun_type_1->param_types.size() != fun_type_2->param_types.size()) {
+    if (fun_type_1 == fun_type_2) {
+        return true;
+    }
+    else if (fun_type_1->param_types.size() != fun_type_2->param_types.size()) {
         return false;
     }
     else if (!is_same_type(fun_type_1->ret_type.get(), fun_type_2->ret_type.get())) {
@@ -241,70 +248,17 @@ static TInt get_scalar_type_size(Type* type) {
     }
 }
 
-static TLong get_type_scale(Type* type);
-
-static TLong get_array_aggregate_type_scale(Array* arr_type) {
-    TLong size = arr_type->size;
-    while (arr_type->elem_type->type() == AST_T::Array_t) {
-        arr_type = static_cast<Array*>(arr_type->elem_type.get());
-        size *= arr_type->size;
-    }
-    return get_type_scale(arr_type->elem_type.get()) * size;
-}
-
-static TLong get_structure_aggregate_type_scale(Structure* struct_type) {
-    if (frontend->struct_typedef_table.find(struct_type->tag) == frontend->struct_typedef_table.end()) {
-        RAISE_INTERNAL_ERROR;
-    }
-    return frontend->struct_typedef_table[struct_type->tag]->size;
-}
-
-static TLong get_type_scale(Type* type) {
-    switch (type->type()) {
-        case AST_T::Array_t:
-            return get_array_aggregate_type_scale(static_cast<Array*>(type));
-        case AST_T::Structure_t:
-            return get_structure_aggregate_type_scale(static_cast<Structure*>(type));
-        default:
-            return get_scalar_type_size(type);
-    }
-}
-
-static TInt get_type_alignment(Type* type);
-
-static TInt get_array_aggregate_type_alignment(Array* arr_type) {
-    return get_type_alignment(arr_type->elem_type.get());
-}
-
-static TInt get_structure_aggregate_type_alignment(Structure* struct_type) {
-    if (frontend->struct_typedef_table.find(struct_type->tag) == frontend->struct_typedef_table.end()) {
-        RAISE_INTERNAL_ERROR;
-    }
-    return frontend->struct_typedef_table[struct_type->tag]->alignment;
-}
-
-static TInt get_type_alignment(Type* type) {
-    switch (type->type()) {
-        case AST_T::Array_t:
-            return get_array_aggregate_type_alignment(static_cast<Array*>(type));
-        case AST_T::Structure_t:
-            return get_structure_aggregate_type_alignment(static_cast<Structure*>(type));
-        default:
-            return get_scalar_type_size(type);
-    }
-}
-
 static std::shared_ptr<Type> get_joint_type(CExp* node_1, CExp* node_2) {
     if (is_type_character(node_1->exp_type.get())) {
         std::shared_ptr<Type> exp_type = std::move(node_1->exp_type);
-        node_1->exp_type = std::make_shared<Int>();
+        node_1->exp_type = intern_scalar_type(AST_T::Int_t);
         std::shared_ptr<Type> joint_type = get_joint_type(node_1, node_2);
         node_1->exp_type = std::move(exp_type);
         return joint_type;
     }
     else if (is_type_character(node_2->exp_type.get())) {
         std::shared_ptr<Type> exp_type_2 = std::move(node_2->exp_type);
-        node_2->exp_type = std::make_shared<Int>();
+        node_2->exp_type = intern_scalar_type(AST_T::Int_t);
         std::shared_ptr<Type> joint_type = get_joint_type(node_1, node_2);
         node_2->exp_type = std::move(exp_type_2);
         return joint_type;
@@ -313,7 +267,7 @@ static std::shared_ptr<Type> get_joint_type(CExp* node_1, CExp* node_2) {
         return node_1->exp_type;
     }
     else if (node_1->exp_type->type() == AST_T::Double_t || node_2->exp_type->type() == AST_T::Double_t) {
-        return std::make_shared<Double>();
+        return intern_scalar_type(AST_T::Double_t);
     }
 
     TInt type_size_1 = get_scalar_type_size(node_1->exp_type.get());
@@ -542,25 +496,25 @@ static void resolve_struct_type(Type* type);
 static void checktype_constant_expression(CConstant* node) {
     switch (node->constant->type()) {
         case AST_T::CConstChar_t:
-            node->exp_type = std::make_shared<Char>();
+            node->exp_type = intern_scalar_type(AST_T::Char_t);
             break;
         case AST_T::CConstInt_t:
-            node->exp_type = std::make_shared<Int>();
+            node->exp_type = intern_scalar_type(AST_T::Int_t);
             break;
         case AST_T::CConstLong_t:
-            node->exp_type = std::make_shared<Long>();
+            node->exp_type = intern_scalar_type(AST_T::Long_t);
             break;
         case AST_T::CConstDouble_t:
-            node->exp_type = std::make_shared<Double>();
+            node->exp_type = intern_scalar_type(AST_T::Double_t);
             break;
         case AST_T::CConstUChar_t:
-            node->exp_type = std::make_shared<UChar>();
+            node->exp_type = intern_scalar_type(AST_T::UChar_t);
             break;
         case AST_T::CConstUInt_t:
-            node->exp_type = std::make_shared<UInt>();
+            node->exp_type = intern_scalar_type(AST_T::UInt_t);
             break;
         case AST_T::CConstULong_t:
-            node->exp_type = std::make_shared<ULong>();
+            node->exp_type = intern_scalar_type(AST_T::ULong_t);
             break;
         default:
             RAISE_INTERNAL_ERROR;
@@ -569,8 +523,8 @@ static void checktype_constant_expression(CConstant* node) {
 
 static void checktype_string_expression(CString* node) {
     TLong size = static_cast<TLong>(node->literal->value.size()) + 1l;
-    std::shared_ptr<Type> elem_type = std::make_shared<Char>();
-    node->exp_type = std::make_shared<Array>(std::move(size), std::move(elem_type));
+    std::shared_ptr<Type> elem_type = intern_scalar_type(AST_T::Char_t);
+    node->exp_type = intern_array_type(std::move(size), std::move(elem_type));
 }
 
 static void checktype_var_expression(CVar* node) {
@@ -584,6 +538,7 @@ static void checktype_var_expression(CVar* node) {
 static void checktype_cast_expression(CCast* node) {
     errors->line_buffer = node->line;
     resolve_struct_type(node->target_type.get());
+    intern_type(node->target_type);
     if (node->target_type->type() != AST_T::Void_t
         && ((node->exp->exp_type->type() == AST_T::Double_t && node->target_type->type() == AST_T::Pointer_t)
             || (node->exp->exp_type->type() == AST_T::Pointer_t && node->target_type->type() == AST_T::Double_t)
@@ -644,7 +599,7 @@ static void checktype_unary_complement_expression(CUnary* node) {
         case AST_T::Char_t:
         case AST_T::SChar_t:
         case AST_T::UChar_t: {
-            std::shared_ptr<Type> promote_type = std::make_shared<Int>();
+            std::shared_ptr<Type> promote_type = intern_scalar_type(AST_T::Int_t);
             node->exp = cast_expression(std::move(node->exp), promote_type);
             break;
         }
@@ -665,7 +620,7 @@ static void checktype_unary_negate_expression(CUnary* node) {
         case AST_T::Char_t:
         case AST_T::SChar_t:
         case AST_T::UChar_t: {
-            std::shared_ptr<Type> promote_type = std::make_shared<Int>();
+            std::shared_ptr<Type> promote_type = intern_scalar_type(AST_T::Int_t);
             node->exp = cast_expression(std::move(node->exp), promote_type);
             break;
         }
@@ -682,7 +637,7 @@ static void checktype_unary_not_expression(CUnary* node) {
             node->line);
     }
 
-    node->exp_type = std::make_shared<Int>();
+    node->exp_type = intern_scalar_type(AST_T::Int_t);
 }
 
 static void checktype_unary_expression(CUnary* node) {
@@ -709,7 +664,7 @@ static void checktype_binary_arithmetic_add_expression(CBinary* node) {
     else if (node->exp_left->exp_type->type() == AST_T::Pointer_t
              && is_type_complete(static_cast<Pointer*>(node->exp_left->exp_type.get())->ref_type.get())
              && is_type_integer(node->exp_right->exp_type.get())) {
-        common_type = std::make_shared<Long>();
+        common_type = intern_scalar_type(AST_T::Long_t);
         if (!is_same_type(node->exp_right->exp_type.get(), common_type.get())) {
             node->exp_right = cast_expression(std::move(node->exp_right), common_type);
         }
@@ -718,7 +673,7 @@ static void checktype_binary_arithmetic_add_expression(CBinary* node) {
     }
     else if (is_type_integer(node->exp_left->exp_type.get()) && node->exp_right->exp_type->type() == AST_T::Pointer_t
              && is_type_complete(static_cast<Pointer*>(node->exp_right->exp_type.get())->ref_type.get())) {
-        common_type = std::make_shared<Long>();
+        common_type = intern_scalar_type(AST_T::Long_t);
         if (!is_same_type(node->exp_left->exp_type.get(), common_type.get())) {
             node->exp_left = cast_expression(std::move(node->exp_left), common_type);
         }
@@ -750,7 +705,7 @@ static void checktype_binary_arithmetic_subtract_expression(CBinary* node) {
     else if (node->exp_left->exp_type->type() == AST_T::Pointer_t
              && is_type_complete(static_cast<Pointer*>(node->exp_left->exp_type.get())->ref_type.get())) {
         if (is_type_integer(node->exp_right->exp_type.get())) {
-            common_type = std::make_shared<Long>();
+            common_type = intern_scalar_type(AST_T::Long_t);
             if (!is_same_type(node->exp_right->exp_type.get(), common_type.get())) {
                 node->exp_right = cast_expression(std::move(node->exp_right), common_type);
             }
@@ -760,7 +715,7 @@ static void checktype_binary_arithmetic_subtract_expression(CBinary* node) {
         else if (is_same_type(node->exp_left->exp_type.get(), node->exp_right->exp_type.get())
                  && !(node->exp_left->type() == AST_T::CConstant_t
                       && is_constant_null_pointer(static_cast<CConstant*>(node->exp_left.get())))) {
-            common_type = std::make_shared<Long>();
+            common_type = intern_scalar_type(AST_T::Long_t);
             node->exp_type = std::move(common_type);
             return;
         }
@@ -842,7 +797,7 @@ static void checktype_binary_arithmetic_bitshift_expression(CBinary* node) {
     }
 
     else if (is_type_character(node->exp_left->exp_type.get())) {
-        std::shared_ptr<Type> left_type = std::make_shared<Int>();
+        std::shared_ptr<Type> left_type = intern_scalar_type(AST_T::Int_t);
         node->exp_left = cast_expression(std::move(node->exp_left), left_type);
     }
     if (!is_same_type(node->exp_left->exp_type.get(), node->exp_right->exp_type.get())) {
@@ -872,7 +827,7 @@ static void checktype_binary_logical_expression(CBinary* node) {
             node->line);
     }
 
-    node->exp_type = std::make_shared<Int>();
+    node->exp_type = intern_scalar_type(AST_T::Int_t);
 }
 
 static void checktype_binary_comparison_equality_expression(CBinary* node) {
@@ -898,7 +853,7 @@ static void checktype_binary_comparison_equality_expression(CBinary* node) {
     if (!is_same_type(node->exp_right->exp_type.get(), common_type.get())) {
         node->exp_right = cast_expression(std::move(node->exp_right), common_type);
     }
-    node->exp_type = std::make_shared<Int>();
+    node->exp_type = intern_scalar_type(AST_T::Int_t);
 }
 
 static void checktype_binary_comparison_relational_expression(CBinary* node) {
@@ -923,7 +878,7 @@ static void checktype_binary_comparison_relational_expression(CBinary* node) {
     if (!is_same_type(node->exp_right->exp_type.get(), common_type.get())) {
         node->exp_right = cast_expression(std::move(node->exp_right), common_type);
     }
-    node->exp_type = std::make_shared<Int>();
+    node->exp_type = intern_scalar_type(AST_T::Int_t);
 }
 
 static void checktype_binary_expression(CBinary* node) {
@@ -1087,7 +1042,7 @@ static void checktype_addrof_expression(CAddrOf* node) {
         RAISE_RUNTIME_ERROR_AT_LINE(GET_ERROR_MESSAGE(ERROR_MESSAGE_SEMANTIC::address_of_rvalue), node->line);
     }
     std::shared_ptr<Type> ref_type = node->exp->exp_type;
-    node->exp_type = std::make_shared<Pointer>(std::move(ref_type));
+    node->exp_type = intern_pointer_type(std::move(ref_type));
 }
 
 static void checktype_subscript_expression(CSubscript* node) {
@@ -1095,7 +1050,7 @@ static void checktype_subscript_expression(CSubscript* node) {
     if (node->primary_exp->exp_type->type() == AST_T::Pointer_t
         && is_type_complete(static_cast<Pointer*>(node->primary_exp->exp_type.get())->ref_type.get())
         && is_type_integer(node->subscript_exp->exp_type.get())) {
-        std::shared_ptr<Type> subscript_type = std::make_shared<Long>();
+        std::shared_ptr<Type> subscript_type = intern_scalar_type(AST_T::Long_t);
         if (!is_same_type(node->subscript_exp->exp_type.get(), subscript_type.get())) {
             node->subscript_exp = cast_expression(std::move(node->subscript_exp), subscript_type);
         }
@@ -1104,7 +1059,7 @@ static void checktype_subscript_expression(CSubscript* node) {
     else if (is_type_integer(node->primary_exp->exp_type.get())
              && node->subscript_exp->exp_type->type() == AST_T::Pointer_t
              && is_type_complete(static_cast<Pointer*>(node->subscript_exp->exp_type.get())->ref_type.get())) {
-        std::shared_ptr<Type> primary_type = std::make_shared<Long>();
+        std::shared_ptr<Type> primary_type = intern_scalar_type(AST_T::Long_t);
         if (!is_same_type(node->primary_exp->exp_type.get(), primary_type.get())) {
             node->primary_exp = cast_expression(std::move(node->primary_exp), primary_type);
         }
@@ -1125,19 +1080,20 @@ static void checktype_sizeof_expression(CSizeOf* node) {
                                         get_type_hr(node->exp->exp_type.get())),
             node->line);
     }
-    node->exp_type = std::make_shared<ULong>();
+    node->exp_type = intern_scalar_type(AST_T::ULong_t);
 }
 
 static void checktype_sizeoft_expression(CSizeOfT* node) {
     errors->line_buffer = node->line;
     resolve_struct_type(node->target_type.get());
+    intern_type(node->target_type);
     if (!is_type_complete(node->target_type.get())) {
         RAISE_RUNTIME_ERROR_AT_LINE(GET_ERROR_MESSAGE(ERROR_MESSAGE_SEMANTIC::get_size_of_incomplete_type,
                                         get_type_hr(node->target_type.get())),
             node->line);
     }
     is_valid_type(node->target_type.get());
-    node->exp_type = std::make_shared<ULong>();
+    node->exp_type = intern_scalar_type(AST_T::ULong_t);
 }
 
 static void checktype_dot_expression(CDot* node) {
@@ -1191,7 +1147,7 @@ static std::unique_ptr<CExp> checktype_scalar_typed_expression(std::unique_ptr<C
 static std::unique_ptr<CAddrOf> checktype_array_aggregate_typed_expression(std::unique_ptr<CExp>&& node) {
     {
         std::shared_ptr<Type> ref_type = static_cast<Array*>(node->exp_type.get())->elem_type;
-        node->exp_type = std::make_shared<Pointer>(std::move(ref_type));
+        node->exp_type = intern_pointer_type(std::move(ref_type));
     }
     size_t line = node->line;
     std::unique_ptr<CAddrOf> addrof = std::make_unique<CAddrOf>(std::move(node), std::move(line));
@@ -1286,7 +1242,7 @@ static void checktype_switch_statement(CSwitch* node) {
         case AST_T::Char_t:
         case AST_T::SChar_t:
         case AST_T::UChar_t: {
-            std::shared_ptr<Type> promote_type = std::make_shared<Int>();
+            std::shared_ptr<Type> promote_type = intern_scalar_type(AST_T::Int_t);
             node->match = cast_expression(std::move(node->match), promote_type);
             break;
         }
@@ -1530,6 +1486,7 @@ static void checktype_return_function_declaration(CFunctionDeclaration* node) {
     FunType* fun_type = static_cast<FunType*>(node->fun_type.get());
     errors->line_buffer = node->line;
     resolve_struct_type(fun_type->ret_type.get());
+    intern_type(fun_type->ret_type);
     is_valid_type(fun_type->ret_type.get());
 
     switch (fun_type->ret_type->type()) {
@@ -1562,9 +1519,10 @@ static void checktype_params_function_declaration(CFunctionDeclaration* node) {
                 node->line);
         }
         is_valid_type(fun_type->param_types[i].get());
+        intern_type(fun_type->param_types[i]);
         if (fun_type->param_types[i]->type() == AST_T::Array_t) {
             std::shared_ptr<Type> ref_type = static_cast<Array*>(fun_type->param_types[i].get())->elem_type;
-            fun_type->param_types[i] = std::make_shared<Pointer>(std::move(ref_type));
+            fun_type->param_types[i] = intern_pointer_type(std::move(ref_type));
         }
 
         if (node->body) {
@@ -1588,6 +1546,7 @@ static void checktype_function_declaration(CFunctionDeclaration* node) {
     if (node->fun_type->type() == AST_T::Void_t) {
         RAISE_INTERNAL_ERROR;
     }
+    intern_type(node->fun_type);
 
     bool is_defined = context->function_definition_set.find(node->name) != context->function_definition_set.end();
     bool is_global = !(node->storage_class && node->storage_class->type() == AST_T::CStatic_t);
@@ -1783,8 +1742,8 @@ static void checktype_string_initializer_pointer_static_init(CString* node, Poin
             std::shared_ptr<Type> constant_type;
             {
                 TLong size = static_cast<TLong>(node->literal->value.size()) + 1l;
-                std::shared_ptr<Type> elem_type = std::make_shared<Char>();
-                constant_type = std::make_shared<Array>(std::move(size), std::move(elem_type));
+                std::shared_ptr<Type> elem_type = intern_scalar_type(AST_T::Char_t);
+                constant_type = intern_array_type(std::move(size), std::move(elem_type));
             }
             std::unique_ptr<IdentifierAttr> constant_attrs;
             {
@@ -1917,6 +1876,7 @@ static std::shared_ptr<Initial> checktype_initializer_initial(CInitializer* node
 static void checktype_file_scope_variable_declaration(CVariableDeclaration* node) {
     errors->line_buffer = node->line;
     resolve_struct_type(node->var_type.get());
+    intern_type(node->var_type);
     if (node->var_type->type() == AST_T::Void_t) {
         RAISE_RUNTIME_ERROR_AT_LINE(
             GET_ERROR_MESSAGE(ERROR_MESSAGE_SEMANTIC::variable_declared_with_type_void, get_name_hr(node->name)),
@@ -2057,6 +2017,7 @@ static void checktype_automatic_block_scope_variable_declaration(CVariableDeclar
 static void checktype_block_scope_variable_declaration(CVariableDeclaration* node) {
     errors->line_buffer = node->line;
     resolve_struct_type(node->var_type.get());
+    intern_type(node->var_type);
     if (node->var_type->type() == AST_T::Void_t) {
         RAISE_RUNTIME_ERROR_AT_LINE(
             GET_ERROR_MESSAGE(ERROR_MESSAGE_SEMANTIC::variable_declared_with_type_void, get_name_hr(node->name)),
@@ -2096,6 +2057,7 @@ static void checktype_members_structure_declaration(CStructDeclaration* node) {
         }
         errors->line_buffer = node->members[i]->line;
         resolve_struct_type(node->members[i].get()->member_type.get());
+        intern_type(node->members[i].get()->member_type);
         if (!is_type_complete(node->members[i].get()->member_type.get())) {
             RAISE_RUNTIME_ERROR_AT_LINE(
                 GET_ERROR_MESSAGE(ERROR_MESSAGE_SEMANTIC::member_declared_with_incomplete_type,
@@ -2240,24 +2202,84 @@ static void deannotate_lookup() { context->break_loop_labels.pop_back(); }
 
 // Identifier resolution
 
-static size_t current_scope_depth() { return context->scoped_identifier_maps.size(); }
+// Every name maps to a stack of its bindings, innermost last, so that resolving a name takes a single lookup. Bindings
+// pushed in a scope are recorded in an undo log, and exiting the scope pops exactly those bindings.
+
+static size_t current_scope_depth() { return context->scope_undo_marks.size(); }
 
 static bool is_file_scope() { return current_scope_depth() == 1; }
 
 static void enter_scope() {
-    context->scoped_identifier_maps.emplace_back();
-    context->scoped_structure_type_maps.emplace_back();
+    context->scope_undo_marks.push_back({context->identifier_undo_log.size(), context->structure_undo_log.size()});
 }
 
 static void exit_scope() {
-    for (const auto& identifier : context->scoped_identifier_maps.back()) {
-        if (context->external_linkage_scope_map.find(identifier.first) != context->external_linkage_scope_map.end()
-            && context->external_linkage_scope_map[identifier.first] == current_scope_depth()) {
-            context->external_linkage_scope_map.erase(identifier.first);
+    ScopeUndoMark& undo_mark = context->scope_undo_marks.back();
+    while (context->identifier_undo_log.size() > undo_mark.identifier_undo_size) {
+        const TIdentifier& identifier = context->identifier_undo_log.back()->first;
+        auto external_linkage_scope = context->external_linkage_scope_map.find(identifier);
+        if (external_linkage_scope != context->external_linkage_scope_map.end()
+            && external_linkage_scope->second == current_scope_depth()) {
+            context->external_linkage_scope_map.erase(external_linkage_scope);
         }
+        context->identifier_undo_log.back()->second.pop_back();
+        context->identifier_undo_log.pop_back();
     }
-    context->scoped_identifier_maps.pop_back();
-    context->scoped_structure_type_maps.pop_back();
+    while (context->structure_undo_log.size() > undo_mark.structure_undo_size) {
+        context->structure_undo_log.back()->pop_back();
+        context->structure_undo_log.pop_back();
+    }
+    context->scope_undo_marks.pop_back();
+}
+
+static TIdentifier* find_scoped_identifier(const TIdentifier& name) {
+    auto scoped_identifiers = context->scoped_identifier_map.find(name);
+    if (scoped_identifiers == context->scoped_identifier_map.end() || scoped_identifiers->second.empty()) {
+        return nullptr;
+    }
+    return &scoped_identifiers->second.back().name;
+}
+
+static bool is_identifier_in_current_scope(const TIdentifier& name) {
+    auto scoped_identifiers = context->scoped_identifier_map.find(name);
+    return scoped_identifiers != context->scoped_identifier_map.end() && !scoped_identifiers->second.empty()
+           && scoped_identifiers->second.back().scope_depth == current_scope_depth();
+}
+
+static const TIdentifier& bind_scoped_identifier(const TIdentifier& name, TIdentifier&& scoped_name) {
+    auto& scoped_identifiers = *context->scoped_identifier_map.try_emplace(name).first;
+    if (!scoped_identifiers.second.empty() && scoped_identifiers.second.back().scope_depth == current_scope_depth()) {
+        scoped_identifiers.second.back().name = std::move(scoped_name);
+    }
+    else {
+        scoped_identifiers.second.push_back({current_scope_depth(), std::move(scoped_name)});
+        context->identifier_undo_log.push_back(&scoped_identifiers);
+    }
+    return scoped_identifiers.second.back().name;
+}
+
+static Structure* find_scoped_structure(const TIdentifier& tag) {
+    auto scoped_structures = context->scoped_structure_type_map.find(tag);
+    if (scoped_structures == context->scoped_structure_type_map.end() || scoped_structures->second.empty()) {
+        return nullptr;
+    }
+    return &scoped_structures->second.back().structure;
+}
+
+static Structure* find_current_scope_structure(const TIdentifier& tag) {
+    auto scoped_structures = context->scoped_structure_type_map.find(tag);
+    if (scoped_structures == context->scoped_structure_type_map.end() || scoped_structures->second.empty()
+        || scoped_structures->second.back().scope_depth != current_scope_depth()) {
+        return nullptr;
+    }
+    return &scoped_structures->second.back().structure;
+}
+
+static const TIdentifier& bind_scoped_structure(const TIdentifier& tag, TIdentifier&& scoped_tag, bool is_union) {
+    std::vector<ScopedStructure>& scoped_structures = context->scoped_structure_type_map[tag];
+    scoped_structures.push_back({current_scope_depth(), Structure(std::move(scoped_tag), is_union)});
+    context->structure_undo_log.push_back(&scoped_structures);
+    return scoped_structures.back().structure.tag;
 }
 
 static void resolve_label(CFunctionDeclaration* node) {
@@ -2285,18 +2307,16 @@ static void resolve_structure_struct_type(Structure* struct_type) {
             return;
         }
     }
-    for (size_t i = current_scope_depth(); i-- > 0;) {
-        if (context->scoped_structure_type_maps[i].find(struct_type->tag)
-            != context->scoped_structure_type_maps[i].end()) {
-            if (context->scoped_structure_type_maps[i][struct_type->tag].is_union != struct_type->is_union) {
-                RAISE_RUNTIME_ERROR_AT_LINE(
-                    GET_ERROR_MESSAGE(ERROR_MESSAGE_SEMANTIC::structure_conflicts_with_previously_declared,
-                        get_type_hr(struct_type), get_struct_name_hr(struct_type->tag, !struct_type->is_union)),
-                    errors->line_buffer);
-            }
-            struct_type->tag = context->scoped_structure_type_maps[i][struct_type->tag].tag;
-            return;
+    Structure* scoped_struct_type = find_scoped_structure(struct_type->tag);
+    if (scoped_struct_type) {
+        if (scoped_struct_type->is_union != struct_type->is_union) {
+            RAISE_RUNTIME_ERROR_AT_LINE(
+                GET_ERROR_MESSAGE(ERROR_MESSAGE_SEMANTIC::structure_conflicts_with_previously_declared,
+                    get_type_hr(struct_type), get_struct_name_hr(struct_type->tag, !struct_type->is_union)),
+                errors->line_buffer);
         }
+        struct_type->tag = scoped_struct_type->tag;
+        return;
     }
     RAISE_RUNTIME_ERROR_AT_LINE(
         GET_ERROR_MESSAGE(ERROR_MESSAGE_SEMANTIC::structure_not_defined_in_scope, get_type_hr(struct_type)),
@@ -2329,15 +2349,15 @@ static void resolve_constant_expression(CConstant* node) { checktype_constant_ex
 static void resolve_string_expression(CString* node) { checktype_string_expression(node); }
 
 static void resolve_var_expression(CVar* node) {
-    for (size_t i = current_scope_depth(); i-- > 0;) {
-        if (context->scoped_identifier_maps[i].find(node->name) != context->scoped_identifier_maps[i].end()) {
-            node->name = context->scoped_identifier_maps[i][node->name];
-            goto Lelse;
+    {
+        TIdentifier* name = find_scoped_identifier(node->name);
+        if (!name) {
+            RAISE_RUNTIME_ERROR_AT_LINE(
+                GET_ERROR_MESSAGE(ERROR_MESSAGE_SEMANTIC::variable_not_declared_in_scope, get_name_hr(node->name)),
+                node->line);
         }
+        node->name = *name;
     }
-    RAISE_RUNTIME_ERROR_AT_LINE(
-        GET_ERROR_MESSAGE(ERROR_MESSAGE_SEMANTIC::variable_not_declared_in_scope, get_name_hr(node->name)), node->line);
-Lelse:
 
     checktype_var_expression(node);
 }
@@ -2374,15 +2394,15 @@ static void resolve_conditional_expression(CConditional* node) {
 }
 
 static void resolve_function_call_expression(CFunctionCall* node) {
-    for (size_t i = current_scope_depth(); i-- > 0;) {
-        if (context->scoped_identifier_maps[i].find(node->name) != context->scoped_identifier_maps[i].end()) {
-            node->name = context->scoped_identifier_maps[i][node->name];
-            goto Lelse;
+    {
+        TIdentifier* name = find_scoped_identifier(node->name);
+        if (!name) {
+            RAISE_RUNTIME_ERROR_AT_LINE(
+                GET_ERROR_MESSAGE(ERROR_MESSAGE_SEMANTIC::function_not_declared_in_scope, get_name_hr(node->name)),
+                node->line);
         }
+        node->name = *name;
     }
-    RAISE_RUNTIME_ERROR_AT_LINE(
-        GET_ERROR_MESSAGE(ERROR_MESSAGE_SEMANTIC::function_not_declared_in_scope, get_name_hr(node->name)), node->line);
-Lelse:
 
     for (size_t i = 0; i < node->args.size(); ++i) {
         node->args[i] = resolve_typed_expression(std::move(node->args[i]));
@@ -2775,13 +2795,12 @@ static void resolve_initializer(CInitializer* node, std::shared_ptr<Type>& init_
 
 static void resolve_params_function_declaration(CFunctionDeclaration* node) {
     for (auto& param : node->params) {
-        if (context->scoped_identifier_maps.back().find(param) != context->scoped_identifier_maps.back().end()) {
+        if (is_identifier_in_current_scope(param)) {
             RAISE_RUNTIME_ERROR_AT_LINE(
                 GET_ERROR_MESSAGE(ERROR_MESSAGE_SEMANTIC::variable_redeclared_in_scope, get_name_hr(param)),
                 node->line);
         }
-        context->scoped_identifier_maps.back()[param] = resolve_variable_identifier(param);
-        param = context->scoped_identifier_maps.back()[param];
+        param = bind_scoped_identifier(param, resolve_variable_identifier(param));
     }
     checktype_params_function_declaration(node);
 }
@@ -2801,7 +2820,7 @@ static void resolve_function_declaration(CFunctionDeclaration* node) {
     }
 
     if (context->external_linkage_scope_map.find(node->name) == context->external_linkage_scope_map.end()) {
-        if (context->scoped_identifier_maps.back().find(node->name) != context->scoped_identifier_maps.back().end()) {
+        if (is_identifier_in_current_scope(node->name)) {
             RAISE_RUNTIME_ERROR_AT_LINE(
                 GET_ERROR_MESSAGE(ERROR_MESSAGE_SEMANTIC::function_redeclared_in_scope, get_name_hr(node->name)),
                 node->line);
@@ -2809,7 +2828,7 @@ static void resolve_function_declaration(CFunctionDeclaration* node) {
         context->external_linkage_scope_map[node->name] = current_scope_depth();
     }
 
-    context->scoped_identifier_maps.back()[node->name] = node->name;
+    bind_scoped_identifier(node->name, TIdentifier(node->name));
     checktype_return_function_declaration(node);
 
     enter_scope();
@@ -2829,7 +2848,7 @@ static void resolve_file_scope_variable_declaration(CVariableDeclaration* node)
         context->external_linkage_scope_map[node->name] = current_scope_depth();
     }
 
-    context->scoped_identifier_maps.back()[node->name] = node->name;
+    bind_scoped_identifier(node->name, TIdentifier(node->name));
     if (is_file_scope()) {
         checktype_file_scope_variable_declaration(node);
     }
@@ -2839,7 +2858,7 @@ static void resolve_file_scope_variable_declaration(CVariableDeclaration* node)
 }
 
 static void resolve_block_scope_variable_declaration(CVariableDeclaration* node) {
-    if (context->scoped_identifier_maps.back().find(node->name) != context->scoped_identifier_maps.back().end()
+    if (is_identifier_in_current_scope(node->name)
         && !(context->external_linkage_scope_map.find(node->name) != context->external_linkage_scope_map.end()
              && (node->storage_class && node->storage_class->type() == AST_T::CExtern_t))) {
         RAISE_RUNTIME_ERROR_AT_LINE(
@@ -2851,8 +2870,7 @@ static void resolve_block_scope_variable_declaration(CVariableDeclaration* node)
         return;
     }
 
-    context->scoped_identifier_maps.back()[node->name] = resolve_variable_identifier(node->name);
-    node->name = context->scoped_identifier_maps.back()[node->name];
+    node->name = bind_scoped_identifier(node->name, resolve_variable_identifier(node->name));
     checktype_block_scope_variable_declaration(node);
 
     if (node->init && !node->storage_class) {
@@ -2865,9 +2883,9 @@ static void resolve_members_structure_declaration(CStructDeclaration* node) {
 }
 
 static void resolve_structure_declaration(CStructDeclaration* node) {
-    if (context->scoped_structure_type_maps.back().find(node->tag)
-        != context->scoped_structure_type_maps.back().end()) {
-        node->tag = context->scoped_structure_type_maps.back()[node->tag].tag;
+    Structure* scoped_struct_type = find_current_scope_structure(node->tag);
+    if (scoped_struct_type) {
+        node->tag = scoped_struct_type->tag;
         if (node->is_union) {
             if (context->union_definition_set.find(node->tag) == context->union_definition_set.end()) {
                 RAISE_RUNTIME_ERROR_AT_LINE(
@@ -2886,8 +2904,7 @@ static void resolve_structure_declaration(CStructDeclaration* node) {
         }
     }
     else {
-        context->scoped_structure_type_maps.back()[node->tag] = {resolve_structure_tag(node->tag), node->is_union};
-        node->tag = context->scoped_structure_type_maps.back()[node->tag].tag;
+        node->tag = bind_scoped_structure(node->tag, resolve_structure_tag(node->tag), node->is_union);
         if (node->is_union) {
             context->union_definition_set.insert(node->tag);
         }
@@ -2955,6 +2972,7 @@ static void resolve_identifiers(CProgram* node) {
 
 void analyze_semantic(CProgram* node) {
     context = std::make_unique<SemanticContext>();
+    intern_scalar_types();
     resolve_identifiers(node);
     context.reset();
 }
@@ -13,6 +13,7 @@
 
 #include "frontend/intermediate/names.hpp"
 #include "frontend/intermediate/tac_repr.hpp"
+#include "frontend/intermediate/types.hpp"
 
 static std::unique_ptr<TacReprContext> context;
 
@@ -101,7 +102,7 @@ static std::shared_ptr<TacValue> represent_plain_inner_value(CExp* node) {
 }
 
 static std::shared_ptr<TacValue> represent_pointer_inner_value(CExp* node) {
-    std::shared_ptr<Type> inner_type = std::make_shared<Long>();
+    std::shared_ptr<Type> inner_type = intern_scalar_type(AST_T::Long_t);
     return represent_inner_exp_value(node, std::move(inner_type));
 }
 
@@ -143,8 +144,8 @@ static std::unique_ptr<TacPlainOperand> represent_exp_result_string_instructions
             std::shared_ptr<Type> constant_type;
             {
                 TLong size = static_cast<TLong>(node->literal->value.size()) + 1l;
-                std::shared_ptr<Type> elem_type = std::make_shared<Char>();
-                constant_type = std::make_shared<Array>(std::move(size), std::move(elem_type));
+                std::shared_ptr<Type> elem_type = intern_scalar_type(AST_T::Char_t);
+                constant_type = intern_array_type(std::move(size), std::move(elem_type));
             }
             std::unique_ptr<IdentifierAttr> constant_attrs;
             {
@@ -201,32 +202,6 @@ static TInt get_scalar_type_size(Type* type) {
     }
 }
 
-static TLong get_type_scale(Type* type);
-
-static TLong get_array_aggregate_type_scale(Array* arr_type) {
-    TLong size = arr_type->size;
-    while (arr_type->elem_type->type() == AST_T::Array_t) {
-        arr_type = static_cast<Array*>(arr_type->elem_type.get());
-        size *= arr_type->size;
-    }
-    return get_type_scale(arr_type->elem_type.get()) * size;
-}
-
-static TLong get_structure_aggregate_type_scale(Structure* struct_type) {
-    return frontend->struct_typedef_table[struct_type->tag]->size;
-}
-
-static TLong get_type_scale(Type* type) {
-    switch (type->type()) {
-        case AST_T::Array_t:
-            return get_array_aggregate_type_scale(static_cast<Array*>(type));
-        case AST_T::Structure_t:
-            return get_structure_aggregate_type_scale(static_cast<Structure*>(type));
-        default:
-            return get_scalar_type_size(type);
-    }
-}
-
 static std::unique_ptr<TacPlainOperand> represent_complete_exp_result_cast_instructions(CCast* node) {
     std::shared_ptr<TacValue> src = represent_exp_instructions(node->exp.get());
     if (node->target_type->type() == node->exp->exp_type->type()) {
@@ -608,6 +583,16 @@ static std::unique_ptr<TacPlainOperand> represent_complete_exp_result_conditiona
     return std::make_unique<TacPlainOperand>(std::move(dst));
 }
 
+static std::unique_ptr<TacPlainOperand> represent_select_exp_result_conditional_instructions(CConditional* node) {
+    std::shared_ptr<TacValue> dst = represent_plain_inner_value(node);
+    std::shared_ptr<TacValue> condition = represent_exp_instructions(node->condition.get());
+    std::shared_ptr<TacValue> src_true = represent_exp_instructions(node->exp_middle.get());
+    std::shared_ptr<TacValue> src_false = represent_exp_instructions(node->exp_right.get());
+    push_instruction(
+        std::make_unique<TacSelect>(std::move(condition), std::move(src_true), std::move(src_false), dst));
+    return std::make_unique<TacPlainOperand>(std::move(dst));
+}
+
 static std::unique_ptr<TacPlainOperand> represent_void_exp_result_conditional_instructions(CConditional* node) {
     TIdentifier target_else = represent_label_identifier(LABEL_KIND::Lternary_else);
     TIdentifier target_false = represent_label_identifier(LABEL_KIND::Lternary_false);
@@ -624,10 +609,49 @@ static std::unique_ptr<TacPlainOperand> represent_void_exp_result_conditional_in
     return std::make_unique<TacPlainOperand>(std::move(dst));
 }
 
+static bool is_type_select(Type* type) {
+    switch (type->type()) {
+        case AST_T::Int_t:
+        case AST_T::Long_t:
+        case AST_T::Double_t:
+        case AST_T::UInt_t:
+        case AST_T::ULong_t:
+        case AST_T::Pointer_t:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool is_exp_select_operand(CExp* node) {
+    switch (node->type()) {
+        case AST_T::CConstant_t:
+            return true;
+        case AST_T::CVar_t:
+            return node->exp_type->type() != AST_T::Array_t && node->exp_type->type() != AST_T::Structure_t;
+        case AST_T::CCast_t: {
+            CCast* p_node = static_cast<CCast*>(node);
+            return p_node->target_type->type() != AST_T::Double_t
+                   && p_node->exp->exp_type->type() != AST_T::Double_t && is_exp_select_operand(p_node->exp.get());
+        }
+        default:
+            return false;
+    }
+}
+
+// Both arms of a select are evaluated, so that they must be cheap and free of side effects and traps.
+static bool is_exp_select_conditional(CConditional* node) {
+    return is_type_select(node->exp_type.get()) && node->condition->exp_type->type() != AST_T::Double_t
+           && is_exp_select_operand(node->exp_middle.get()) && is_exp_select_operand(node->exp_right.get());
+}
+
 static std::unique_ptr<TacPlainOperand> represent_exp_result_conditional_instructions(CConditional* node) {
     if (node->exp_middle->exp_type->type() == AST_T::Void_t) {
         return represent_void_exp_result_conditional_instructions(node);
     }
+    else if (is_exp_select_conditional(node)) {
+        return represent_select_exp_result_conditional_instructions(node);
+    }
     else {
         return represent_complete_exp_result_conditional_instructions(node);
     }
@@ -645,7 +669,7 @@ static std::unique_ptr<TacPlainOperand> represent_exp_result_fun_call_instructio
     if (node->exp_type->type() != AST_T::Void_t) {
         dst = represent_plain_inner_value(node);
     }
-    push_instruction(std::make_unique<TacFunCall>(std::move(name), std::move(args), dst));
+    push_instruction(std::make_unique<TacFunCall>(std::move(name), std::move(args), dst, false));
     return std::make_unique<TacPlainOperand>(std::move(dst));
 }
 
@@ -1339,7 +1363,7 @@ static void represent_declaration_instructions(CDeclaration* node) {
 
 // instruction = Return(val?) | SignExtend(val, val) | Truncate(val, val) | ZeroExtend(val, val)
 //             | TacDoubleToInt(val, val) | TacDoubleToUInt(val, val) | TacIntToDouble(val, val)
-//             | TacUIntToDouble(val, val) | FunCall(identifier, val*, val?) | Unary(unary_operator, val, val)
+//             | TacUIntToDouble(val, val) | FunCall(identifier, val*, val?, bool) | Unary(unary_operator, val, val)
 //             | Binary(binary_operator, val, val, val) | Copy(val, val) | GetAddress(val, val) | Load(val, val)
 //             | Store(val, val) | AddPtr(int, val, val, val) | CopyToOffset(identifier, int, val)
 //             | CopyFromOffset(identifier, int, val) | Jump(identifier) | JumpIfZero(val, identifier)
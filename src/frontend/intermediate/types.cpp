@@ -0,0 +1,273 @@
+#include <inttypes.h>
+#include <memory>
+#include <string>
+
+#include "util/throw.hpp"
+
+#include "ast/ast.hpp"
+#include "ast/front_symt.hpp"
+
+#include "frontend/intermediate/types.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Types
+
+// Every distinct type is stored exactly once in the type table, so that types can be compared by pointer. A derived
+// type is keyed on its kind and on the addresses of its (already interned) nested types, which stay valid for as long
+// as the table owns them. Structure types are keyed on their resolved tag only.
+
+static void append_type_key(TIdentifier& key, Type* type) {
+    key += std::to_string(reinterpret_cast<uintptr_t>(type));
+    key += ";";
+}
+
+static TIdentifier get_scalar_type_key(AST_T type_t) { return std::to_string(static_cast<int>(type_t)); }
+
+static TIdentifier get_pointer_type_key(Type* ref_type) {
+    TIdentifier key = "*";
+    append_type_key(key, ref_type);
+    return key;
+}
+
+static TIdentifier get_array_type_key(TLong size, Type* elem_type) {
+    TIdentifier key = "[";
+    key += std::to_string(size);
+    key += "]";
+    append_type_key(key, elem_type);
+    return key;
+}
+
+static TIdentifier get_fun_type_key(FunType* fun_type) {
+    TIdentifier key = "(";
+    for (const auto& param_type : fun_type->param_types) {
+        append_type_key(key, param_type.get());
+    }
+    key += ")";
+    append_type_key(key, fun_type->ret_type.get());
+    return key;
+}
+
+static TIdentifier get_structure_type_key(Structure* struct_type) {
+    TIdentifier key = "$";
+    key += struct_type->tag;
+    return key;
+}
+
+static TInt get_scalar_type_size(Type* type) {
+    switch (type->type()) {
+        case AST_T::Char_t:
+        case AST_T::SChar_t:
+        case AST_T::UChar_t:
+            return 1;
+        case AST_T::Int_t:
+        case AST_T::UInt_t:
+            return 4;
+        case AST_T::Long_t:
+        case AST_T::Double_t:
+        case AST_T::ULong_t:
+        case AST_T::Pointer_t:
+            return 8;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+// Scalar and pointer types are sized when they are interned, so that functions optimized on parallel jobs only read
+// their size and alignment.
+static void init_scalar_type_scale(Type* type) {
+    if (type->type() != AST_T::Void_t) {
+        type->scale = static_cast<TLong>(get_scalar_type_size(type));
+        type->alignment = get_scalar_type_size(type);
+    }
+}
+
+static std::shared_ptr<Type> make_scalar_type(AST_T type_t) {
+    switch (type_t) {
+        case AST_T::Char_t:
+            return std::make_shared<Char>();
+        case AST_T::SChar_t:
+            return std::make_shared<SChar>();
+        case AST_T::UChar_t:
+            return std::make_shared<UChar>();
+        case AST_T::Int_t:
+            return std::make_shared<Int>();
+        case AST_T::Long_t:
+            return std::make_shared<Long>();
+        case AST_T::UInt_t:
+            return std::make_shared<UInt>();
+        case AST_T::ULong_t:
+            return std::make_shared<ULong>();
+        case AST_T::Double_t:
+            return std::make_shared<Double>();
+        case AST_T::Void_t:
+            return std::make_shared<Void>();
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+std::shared_ptr<Type> intern_scalar_type(AST_T type_t) {
+    TIdentifier key = get_scalar_type_key(type_t);
+    auto type = frontend->type_table.find(key);
+    if (type != frontend->type_table.end()) {
+        return type->second;
+    }
+    std::shared_ptr<Type> scalar_type = make_scalar_type(type_t);
+    init_scalar_type_scale(scalar_type.get());
+    frontend->type_table.emplace(std::move(key), scalar_type);
+    return scalar_type;
+}
+
+// Every scalar type is interned before the program is analyzed, so that the type table is never written while
+// functions are optimized on parallel jobs.
+void intern_scalar_types() {
+    intern_scalar_type(AST_T::Char_t);
+    intern_scalar_type(AST_T::SChar_t);
+    intern_scalar_type(AST_T::UChar_t);
+    intern_scalar_type(AST_T::Int_t);
+    intern_scalar_type(AST_T::Long_t);
+    intern_scalar_type(AST_T::UInt_t);
+    intern_scalar_type(AST_T::ULong_t);
+    intern_scalar_type(AST_T::Double_t);
+    intern_scalar_type(AST_T::Void_t);
+}
+
+std::shared_ptr<Type> intern_pointer_type(std::shared_ptr<Type> ref_type) {
+    TIdentifier key = get_pointer_type_key(ref_type.get());
+    auto type = frontend->type_table.find(key);
+    if (type != frontend->type_table.end()) {
+        return type->second;
+    }
+    std::shared_ptr<Type> ptr_type = std::make_shared<Pointer>(std::move(ref_type));
+    init_scalar_type_scale(ptr_type.get());
+    frontend->type_table.emplace(std::move(key), ptr_type);
+    return ptr_type;
+}
+
+std::shared_ptr<Type> intern_array_type(TLong size, std::shared_ptr<Type> elem_type) {
+    TIdentifier key = get_array_type_key(size, elem_type.get());
+    auto type = frontend->type_table.find(key);
+    if (type != frontend->type_table.end()) {
+        return type->second;
+    }
+    std::shared_ptr<Type> arr_type = std::make_shared<Array>(std::move(size), std::move(elem_type));
+    frontend->type_table.emplace(std::move(key), arr_type);
+    return arr_type;
+}
+
+static void intern_derived_type(std::shared_ptr<Type>& type, TIdentifier&& key) {
+    auto interned_type = frontend->type_table.find(key);
+    if (interned_type != frontend->type_table.end()) {
+        type = interned_type->second;
+    }
+    else {
+        frontend->type_table.emplace(std::move(key), type);
+    }
+}
+
+static void intern_fun_type_node(std::shared_ptr<Type>& type) {
+    FunType* fun_type = static_cast<FunType*>(type.get());
+    for (auto& param_type : fun_type->param_types) {
+        intern_type(param_type);
+    }
+    intern_type(fun_type->ret_type);
+    intern_derived_type(type, get_fun_type_key(fun_type));
+}
+
+static void intern_pointer_type_node(std::shared_ptr<Type>& type) {
+    Pointer* ptr_type = static_cast<Pointer*>(type.get());
+    intern_type(ptr_type->ref_type);
+    init_scalar_type_scale(ptr_type);
+    intern_derived_type(type, get_pointer_type_key(ptr_type->ref_type.get()));
+}
+
+static void intern_array_type_node(std::shared_ptr<Type>& type) {
+    Array* arr_type = static_cast<Array*>(type.get());
+    intern_type(arr_type->elem_type);
+    intern_derived_type(type, get_array_type_key(arr_type->size, arr_type->elem_type.get()));
+}
+
+static void intern_structure_type_node(std::shared_ptr<Type>& type) {
+    intern_derived_type(type, get_structure_type_key(static_cast<Structure*>(type.get())));
+}
+
+// Types built by the parser are only interned once their structure tags are resolved, as resolution renames tags in
+// place. Interned types must never be modified afterwards.
+void intern_type(std::shared_ptr<Type>& type) {
+    switch (type->type()) {
+        case AST_T::FunType_t:
+            intern_fun_type_node(type);
+            break;
+        case AST_T::Pointer_t:
+            intern_pointer_type_node(type);
+            break;
+        case AST_T::Array_t:
+            intern_array_type_node(type);
+            break;
+        case AST_T::Structure_t:
+            intern_structure_type_node(type);
+            break;
+        default:
+            type = intern_scalar_type(type->type());
+            break;
+    }
+}
+
+static StructTypedef* get_structure_typedef(Structure* struct_type) {
+    auto struct_typedef = frontend->struct_typedef_table.find(struct_type->tag);
+    if (struct_typedef == frontend->struct_typedef_table.end()) {
+        RAISE_INTERNAL_ERROR;
+    }
+    return struct_typedef->second.get();
+}
+
+static TLong get_array_aggregate_type_scale(Array* arr_type) {
+    return get_type_scale(arr_type->elem_type.get()) * arr_type->size;
+}
+
+static TLong get_structure_aggregate_type_scale(Structure* struct_type) {
+    return get_structure_typedef(struct_type)->size;
+}
+
+TLong get_type_scale(Type* type) {
+    if (type->scale == -1l) {
+        switch (type->type()) {
+            case AST_T::Array_t:
+                type->scale = get_array_aggregate_type_scale(static_cast<Array*>(type));
+                break;
+            case AST_T::Structure_t:
+                type->scale = get_structure_aggregate_type_scale(static_cast<Structure*>(type));
+                break;
+            default:
+                type->scale = get_scalar_type_size(type);
+                break;
+        }
+    }
+    return type->scale;
+}
+
+static TInt get_array_aggregate_type_alignment(Array* arr_type) {
+    return get_type_alignment(arr_type->elem_type.get());
+}
+
+static TInt get_structure_aggregate_type_alignment(Structure* struct_type) {
+    return get_structure_typedef(struct_type)->alignment;
+}
+
+TInt get_type_alignment(Type* type) {
+    if (type->alignment == -1) {
+        switch (type->type()) {
+            case AST_T::Array_t:
+                type->alignment = get_array_aggregate_type_alignment(static_cast<Array*>(type));
+                break;
+            case AST_T::Structure_t:
+                type->alignment = get_structure_aggregate_type_alignment(static_cast<Structure*>(type));
+                break;
+            default:
+                type->alignment = get_scalar_type_size(type);
+                break;
+        }
+    }
+    return type->alignment;
+}
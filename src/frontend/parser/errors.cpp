@@ -103,6 +103,10 @@ std::string get_token_kind_hr(TOKEN_KIND token_kind) {
             return ",";
         case TOKEN_KIND::structop_member:
             return ".";
+        case TOKEN_KIND::preprocessor_stringify:
+            return "#";
+        case TOKEN_KIND::preprocessor_paste:
+            return "##";
         case TOKEN_KIND::key_char:
             return "char";
         case TOKEN_KIND::key_int:
@@ -461,6 +465,34 @@ std::string get_what_message(ERROR_MESSAGE_LEXER message) {
             what_message += " directive search";
             return what_message;
         }
+        case ERROR_MESSAGE_LEXER::invalid_preprocessor_directive:
+            return "found invalid preprocessor directive %s";
+        case ERROR_MESSAGE_LEXER::error_preprocessor_directive:
+            return "found error directive %s";
+        case ERROR_MESSAGE_LEXER::conditional_directive_without_if:
+            return "found conditional directive %s without matching #if";
+        case ERROR_MESSAGE_LEXER::unterminated_conditional_directive:
+            return "found unterminated conditional directive, but expected %s before end of file";
+        case ERROR_MESSAGE_LEXER::invalid_conditional_expression:
+            return "cannot evaluate expression in conditional directive %s";
+        case ERROR_MESSAGE_LEXER::macro_name_not_an_identifier:
+            return "macro name %s is not an identifier";
+        case ERROR_MESSAGE_LEXER::invalid_macro_parameter_list:
+            return "found invalid parameter list in definition of macro %s";
+        case ERROR_MESSAGE_LEXER::stringify_not_followed_by_macro_parameter:
+            return "operator %s is not followed by a parameter in definition of macro %s";
+        case ERROR_MESSAGE_LEXER::paste_at_either_end_of_macro:
+            return "operator %s cannot appear at either end of definition of macro %s";
+        case ERROR_MESSAGE_LEXER::invalid_paste_of_tokens:
+            return "pasting tokens %s and %s does not give a valid token";
+        case ERROR_MESSAGE_LEXER::unterminated_macro_argument_list:
+            return "found unterminated argument list invoking macro %s";
+        case ERROR_MESSAGE_LEXER::macro_argument_count_mismatch:
+            return "macro %s requires %s arguments, but %s were given";
+        case ERROR_MESSAGE_LEXER::include_nested_too_deeply:
+            return "found header file %s nested more than %s includes deep";
+        case ERROR_MESSAGE_LEXER::conditional_expression_overflow:
+            return "operator %s overflows in conditional directive %s";
         default:
             RAISE_INTERNAL_ERROR;
     }
@@ -0,0 +1,286 @@
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
+
+#include "frontend/parser/lex_cache.hpp"
+#include "frontend/parser/lexer.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Header cache
+
+// A cache file is named after the hash of the header path and is laid out as:
+// magic | compiler mtime | compiler size | mtime | size | content hash | path | line count | token count
+// | (kind | line | length | token)...
+// It is only reused by the same compiler binary, as token kinds are stored by value, while the header path and size
+// still match, and either its mtime or its content hash matches.
+
+static const char HEADER_CACHE_MAGIC[8] = {'w', 'c', 'c', 't', 'o', 'k', '0', '2'};
+
+struct HeaderFileKey {
+    uint64_t mtime;
+    uint64_t size;
+};
+
+struct HeaderCacheView {
+    const char* it;
+    const char* end;
+};
+
+struct MemoryHeaderCache {
+    HeaderFileKey file_key;
+    HeaderCache header_cache;
+};
+
+// Only a long-lived process, like the compile server, keeps lexed headers in memory across compilations.
+static bool is_memory_cache_enabled = false;
+static std::unordered_map<std::string, MemoryHeaderCache> memory_header_cache_map;
+
+static bool get_header_file_key(const std::string& filename, HeaderFileKey& file_key) {
+    struct stat file_stat;
+    if (stat(filename.c_str(), &file_stat) == -1) {
+        return false;
+    }
+#ifdef __APPLE__
+    file_key.mtime = static_cast<uint64_t>(file_stat.st_mtimespec.tv_sec) * 1000000000ul
+                     + static_cast<uint64_t>(file_stat.st_mtimespec.tv_nsec);
+#else
+    file_key.mtime = static_cast<uint64_t>(file_stat.st_mtim.tv_sec) * 1000000000ul
+                     + static_cast<uint64_t>(file_stat.st_mtim.tv_nsec);
+#endif
+    file_key.size = static_cast<uint64_t>(file_stat.st_size);
+    return true;
+}
+
+static bool get_header_content_hash(const std::string& filename, uint64_t& content_hash) {
+    FILE* file_descriptor = fopen(filename.c_str(), "rb");
+    if (!file_descriptor) {
+        return false;
+    }
+    std::string content;
+    {
+        char buffer[4096];
+        size_t len;
+        while ((len = fread(buffer, sizeof(char), sizeof(buffer), file_descriptor)) > 0) {
+            content.append(buffer, len);
+        }
+    }
+    fclose(file_descriptor);
+    content_hash = static_cast<uint64_t>(std::hash<std::string> {}(content));
+    return true;
+}
+
+static std::string get_cache_filename(const std::string& cachedir, const std::string& filename) {
+    std::string cache_filename = cachedir;
+    if (cache_filename.back() != '/') {
+        cache_filename += '/';
+    }
+    char filename_hash[17];
+    snprintf(filename_hash, sizeof(filename_hash), "%016" PRIx64,
+        static_cast<uint64_t>(std::hash<std::string> {}(filename)));
+    cache_filename += filename_hash;
+    cache_filename += ".tok";
+    return cache_filename;
+}
+
+template <typename TInteger> static void append_integer(std::string& buffer, TInteger value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(TInteger));
+}
+
+static void append_string(std::string& buffer, const std::string& value) {
+    append_integer<uint32_t>(buffer, static_cast<uint32_t>(value.size()));
+    buffer += value;
+}
+
+template <typename TInteger> static bool read_integer(HeaderCacheView& view, TInteger& value) {
+    if (static_cast<size_t>(view.end - view.it) < sizeof(TInteger)) {
+        return false;
+    }
+    memcpy(&value, view.it, sizeof(TInteger));
+    view.it += sizeof(TInteger);
+    return true;
+}
+
+static bool read_string(HeaderCacheView& view, std::string& value) {
+    uint32_t len;
+    if (!read_integer<uint32_t>(view, len) || static_cast<size_t>(view.end - view.it) < len) {
+        return false;
+    }
+    value.assign(view.it, len);
+    view.it += len;
+    return true;
+}
+
+static bool read_header_cache_key(HeaderCacheView& view, const std::string& filename) {
+    if (static_cast<size_t>(view.end - view.it) < sizeof(HEADER_CACHE_MAGIC)
+        || memcmp(view.it, HEADER_CACHE_MAGIC, sizeof(HEADER_CACHE_MAGIC)) != 0) {
+        return false;
+    }
+    view.it += sizeof(HEADER_CACHE_MAGIC);
+
+    HeaderFileKey compiler_key;
+    HeaderFileKey cache_compiler_key;
+    if (!get_header_file_key("/proc/self/exe", compiler_key)
+        || !read_integer<uint64_t>(view, cache_compiler_key.mtime)
+        || !read_integer<uint64_t>(view, cache_compiler_key.size) || cache_compiler_key.mtime != compiler_key.mtime
+        || cache_compiler_key.size != compiler_key.size) {
+        return false;
+    }
+
+    HeaderFileKey file_key;
+    HeaderFileKey cache_key;
+    uint64_t content_hash;
+    std::string cache_filename;
+    if (!get_header_file_key(filename, file_key) || !read_integer<uint64_t>(view, cache_key.mtime)
+        || !read_integer<uint64_t>(view, cache_key.size) || !read_integer<uint64_t>(view, content_hash)
+        || !read_string(view, cache_filename)) {
+        return false;
+    }
+    else if (cache_filename.compare(filename) != 0 || cache_key.size != file_key.size) {
+        return false;
+    }
+    else if (cache_key.mtime != file_key.mtime) {
+        uint64_t file_content_hash;
+        if (!get_header_content_hash(filename, file_content_hash) || file_content_hash != content_hash) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool read_header_cache(HeaderCacheView& view, const std::string& filename, HeaderCache& header_cache) {
+    if (!read_header_cache_key(view, filename)) {
+        return false;
+    }
+
+    uint64_t line_count;
+    uint64_t token_count;
+    if (!read_integer<uint64_t>(view, line_count) || !read_integer<uint64_t>(view, token_count)) {
+        return false;
+    }
+    header_cache.line_count = static_cast<size_t>(line_count);
+    header_cache.tokens.reserve(static_cast<size_t>(token_count));
+    for (uint64_t i = 0; i < token_count; ++i) {
+        uint32_t token_kind;
+        uint32_t line;
+        Token token;
+        if (!read_integer<uint32_t>(view, token_kind) || token_kind > static_cast<uint32_t>(TOKEN_KIND::error)
+            || !read_integer<uint32_t>(view, line) || !read_string(view, token.token)) {
+            return false;
+        }
+        token.token_kind = static_cast<TOKEN_KIND>(token_kind);
+        token.line = static_cast<size_t>(line);
+        header_cache.tokens.emplace_back(std::move(token));
+    }
+    return view.it == view.end;
+}
+
+bool load_header_cache(const std::string& cachedir, const std::string& filename, HeaderCache& header_cache) {
+    int file_descriptor = open(get_cache_filename(cachedir, filename).c_str(), O_RDONLY);
+    if (file_descriptor == -1) {
+        return false;
+    }
+    struct stat cache_stat;
+    if (fstat(file_descriptor, &cache_stat) == -1 || cache_stat.st_size <= 0) {
+        close(file_descriptor);
+        return false;
+    }
+    size_t len = static_cast<size_t>(cache_stat.st_size);
+    void* buffer = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    close(file_descriptor);
+    if (buffer == MAP_FAILED) {
+        return false;
+    }
+
+    HeaderCacheView view = {static_cast<const char*>(buffer), static_cast<const char*>(buffer) + len};
+    bool is_loaded = read_header_cache(view, filename, header_cache);
+    munmap(buffer, len);
+    if (!is_loaded) {
+        header_cache.tokens.clear();
+    }
+    return is_loaded;
+}
+
+// Caching is best effort: any failure to write the cache file leaves the compilation unaffected.
+void store_header_cache(const std::string& cachedir, const std::string& filename, const HeaderCache& header_cache) {
+    HeaderFileKey compiler_key;
+    HeaderFileKey file_key;
+    uint64_t content_hash;
+    if (!get_header_file_key("/proc/self/exe", compiler_key) || !get_header_file_key(filename, file_key)
+        || !get_header_content_hash(filename, content_hash)) {
+        return;
+    }
+
+    std::string buffer(HEADER_CACHE_MAGIC, sizeof(HEADER_CACHE_MAGIC));
+    append_integer<uint64_t>(buffer, compiler_key.mtime);
+    append_integer<uint64_t>(buffer, compiler_key.size);
+    append_integer<uint64_t>(buffer, file_key.mtime);
+    append_integer<uint64_t>(buffer, file_key.size);
+    append_integer<uint64_t>(buffer, content_hash);
+    append_string(buffer, filename);
+    append_integer<uint64_t>(buffer, static_cast<uint64_t>(header_cache.line_count));
+    append_integer<uint64_t>(buffer, static_cast<uint64_t>(header_cache.tokens.size()));
+    for (const auto& token : header_cache.tokens) {
+        append_integer<uint32_t>(buffer, static_cast<uint32_t>(token.token_kind));
+        append_integer<uint32_t>(buffer, static_cast<uint32_t>(token.line));
+        append_string(buffer, token.token);
+    }
+
+    mkdir(cachedir.c_str(), 0755);
+    std::string cache_filename = get_cache_filename(cachedir, filename);
+    std::string temp_filename = cache_filename;
+    temp_filename += ".";
+    temp_filename += std::to_string(getpid());
+    FILE* file_descriptor = fopen(temp_filename.c_str(), "wb");
+    if (!file_descriptor) {
+        return;
+    }
+    bool is_written = fwrite(buffer.c_str(), sizeof(char), buffer.size(), file_descriptor) == buffer.size();
+    is_written = fclose(file_descriptor) == 0 && is_written;
+    if (!is_written || rename(temp_filename.c_str(), cache_filename.c_str()) != 0) {
+        remove(temp_filename.c_str());
+    }
+}
+
+void enable_memory_header_cache() { is_memory_cache_enabled = true; }
+
+bool is_memory_header_cache() { return is_memory_cache_enabled; }
+
+// An entry is reused while the header mtime and size still match, and the tokens are copied out of it because the
+// lexer consumes them.
+bool load_memory_header_cache(const std::string& filename, HeaderCache& header_cache) {
+    if (!is_memory_cache_enabled) {
+        return false;
+    }
+    auto memory_header_cache = memory_header_cache_map.find(filename);
+    if (memory_header_cache == memory_header_cache_map.end()) {
+        return false;
+    }
+    HeaderFileKey file_key;
+    if (!get_header_file_key(filename, file_key) || file_key.mtime != memory_header_cache->second.file_key.mtime
+        || file_key.size != memory_header_cache->second.file_key.size) {
+        memory_header_cache_map.erase(memory_header_cache);
+        return false;
+    }
+    header_cache = memory_header_cache->second.header_cache;
+    return true;
+}
+
+void store_memory_header_cache(const std::string& filename, const HeaderCache& header_cache) {
+    if (!is_memory_cache_enabled) {
+        return;
+    }
+    MemoryHeaderCache memory_header_cache;
+    if (!get_header_file_key(filename, memory_header_cache.file_key)) {
+        return;
+    }
+    memory_header_cache.header_cache = header_cache;
+    memory_header_cache_map[filename] = std::move(memory_header_cache);
+}
@@ -1,11 +1,17 @@
+#include <ctype.h>
+#include <inttypes.h>
 #include <memory>
+#include <stdlib.h>
 #include <string>
+#include <sys/stat.h>
+#include <unordered_map>
 #include <vector>
 
 #include "util/fileio.hpp"
 #include "util/throw.hpp"
 
 #include "frontend/parser/errors.hpp"
+#include "frontend/parser/lex_cache.hpp"
 #include "frontend/parser/lexer.hpp"
 
 #ifdef __WITH_CTRE__
@@ -17,13 +23,18 @@
 
 static std::unique_ptr<LexerContext> context;
 
-LexerContext::LexerContext(std::vector<Token>* p_tokens, std::vector<std::string>* p_includedirs) :
-    p_tokens(p_tokens), p_includedirs(p_includedirs), stdlibdirs({
+constexpr size_t MAX_INCLUDE_DEPTH = 200;
+
+LexerContext::LexerContext(std::vector<Token>* p_tokens, std::vector<std::string>* p_includedirs,
+    std::vector<std::string>* p_dependencies, std::string&& cachedir, bool is_preprocessed) :
+    p_tokens(p_tokens), p_cache_tokens(nullptr), p_includedirs(p_includedirs),
+    stdlibdirs({
 #ifdef __GNUC__
-                                                          "/usr/include/", "/usr/local/include/"
+        "/usr/include/", "/usr/local/include/"
 #endif
-                                                      }),
-    total_line_number(0) {
+    }),
+    p_dependencies(p_dependencies), cachedir(std::move(cachedir)), total_line_number(0),
+    is_preprocessed(is_preprocessed), macro_expand_index(0) {
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -31,6 +42,10 @@ LexerContext::LexerContext(std::vector<Token>* p_tokens, std::vector<std::string
 // Lexer
 
 static void tokenize_header(std::string include_match, size_t tokenize_header);
+static bool is_macro_skipped();
+static bool preprocess_line(std::string& line, size_t& line_number);
+static void expand_macro_pending_tokens(size_t line_number);
+static void define_builtin_macros();
 
 #ifdef __WITH_CTRE__
 #define RE_MATCH_TOKEN(X, Y)                                                                  \
@@ -153,15 +168,24 @@ static void
 
     RE_MATCH_TOKEN(R"(#\s*include\s*[<"][^>"]+\.h[>"])", TOKEN_KIND::include_directive)
     RE_MATCH_TOKEN(R"(#\s*[_acdefgilmnoprstuwx]+\b)", TOKEN_KIND::preprocessor_directive)
+    RE_MATCH_TOKEN(R"(##)", TOKEN_KIND::preprocessor_paste)
+    RE_MATCH_TOKEN(R"(#)", TOKEN_KIND::preprocessor_stringify)
 
     RE_MATCH_TOKEN(R"(.)", TOKEN_KIND::error)
 }
 
-static void tokenize_file() {
+static size_t tokenize_file() {
     std::string line;
     bool is_comment = false;
-    for (size_t line_number = 1; read_line(line); ++line_number) {
+    size_t line_number = 1;
+    size_t macro_conditions_size = context->macro_conditions.size();
+    for (; read_line(line); ++line_number) {
         context->total_line_number++;
+        if (context->is_preprocessed) {
+            if (is_comment ? is_macro_skipped() : preprocess_line(line, line_number)) {
+                continue;
+            }
+        }
 
 #ifdef __WITH_CTRE__
         const std::string_view re_iterator_view(line);
@@ -204,6 +228,8 @@ static void tokenize_file() {
                 switch (context->re_match_token_kind) {
                     case TOKEN_KIND::error:
                     case TOKEN_KIND::comment_multilineend:
+                    case TOKEN_KIND::preprocessor_stringify:
+                    case TOKEN_KIND::preprocessor_paste:
                         raise_runtime_error_at_line(
                             GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::invalid_token, context->re_match_token),
                             line_number);
@@ -217,6 +243,10 @@ static void tokenize_file() {
 #ifdef __WITH_CTRE__
                         i += context->re_match_token.size();
 #endif
+                        if (context->p_cache_tokens) {
+                            Token token = {context->re_match_token_kind, context->re_match_token, line_number};
+                            context->p_cache_tokens->emplace_back(std::move(token));
+                        }
                         tokenize_header(context->re_match_token, line_number);
 #ifdef __WITH_CTRE__
                         context->re_match_token.clear();
@@ -236,80 +266,1135 @@ static void tokenize_file() {
             Lpass:;
             }
 
+            if (context->p_cache_tokens) {
+                Token token = {context->re_match_token_kind, context->re_match_token, line_number};
+                context->p_cache_tokens->emplace_back(std::move(token));
+            }
             Token token = {context->re_match_token_kind, context->re_match_token, context->total_line_number};
             context->p_tokens->emplace_back(std::move(token));
         }
     }
+    if (context->is_preprocessed && context->macro_conditions.size() != macro_conditions_size) {
+        raise_runtime_error_at_line(
+            GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::unterminated_conditional_directive, "#endif"), line_number - 1);
+    }
+    return line_number - 1;
 }
 
-static bool find_header(std::vector<std::string>& dirnames, std::string& filename) {
-    for (auto dirname : dirnames) {
-        dirname += filename;
-        if (find_file(dirname)) {
-            filename = std::move(dirname);
+// Headers are identified by device and inode, so that different spellings of the same file are only included once.
+static bool find_header(
+    const std::vector<std::string>& dirnames, const std::string& filename, HeaderFile& header_file) {
+    for (const auto& dirname : dirnames) {
+        std::string header_filename = dirname;
+        header_filename += filename;
+        struct stat file_stat;
+        if (stat(header_filename.c_str(), &file_stat) == 0 && !S_ISDIR(file_stat.st_mode)) {
+            header_file.filename = std::move(header_filename);
+            header_file.file_id = std::to_string(static_cast<uint64_t>(file_stat.st_dev));
+            header_file.file_id += ":";
+            header_file.file_id += std::to_string(static_cast<uint64_t>(file_stat.st_ino));
             return true;
         }
     }
     return false;
 }
 
-static void tokenize_header(std::string filename, size_t line_number) {
-    if (filename.back() == '>') {
-        filename = filename.substr(filename.find('<') + 1);
-        filename.pop_back();
-        if (context->filename_include_set.find(filename) != context->filename_include_set.end()) {
-            return;
-        }
-        context->filename_include_set.insert(filename);
-        if (!find_header(context->stdlibdirs, filename)) {
-            if (!find_header(*context->p_includedirs, filename)) {
-                raise_runtime_error_at_line(
-                    GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::failed_to_include_header_file, filename), line_number);
-            }
-        }
+// Include directories are probed once per spelled header name and translation unit.
+static const HeaderFile& resolve_header(std::string filename, size_t line_number) {
+    bool is_system_header = filename.back() == '>';
+    filename = filename.substr(filename.find(is_system_header ? '<' : '"'));
+    auto header_file = context->header_file_map.find(filename);
+    if (header_file != context->header_file_map.end()) {
+        return header_file->second;
     }
-    else {
-        filename = filename.substr(filename.find('"') + 1);
-        filename.pop_back();
-        if (context->filename_include_set.find(filename) != context->filename_include_set.end()) {
-            return;
+
+    std::string include_filename = filename.substr(1, filename.size() - 2);
+    HeaderFile resolved_header_file;
+    if (!((is_system_header && find_header(context->stdlibdirs, include_filename, resolved_header_file))
+            || find_header(*context->p_includedirs, include_filename, resolved_header_file))) {
+        raise_runtime_error_at_line(
+            GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::failed_to_include_header_file, include_filename), line_number);
+    }
+    return context->header_file_map.emplace(std::move(filename), std::move(resolved_header_file)).first->second;
+}
+
+// Replays the cached tokens of a header as if it was lexed again: line numbers are offset by the lines already read in
+// the translation unit, and nested includes are expanded in place.
+static void tokenize_cached_file(HeaderCache& header_cache) {
+    size_t line_number = 0;
+    for (auto& token : header_cache.tokens) {
+        context->total_line_number += token.line - line_number;
+        line_number = token.line;
+        if (token.token_kind == TOKEN_KIND::include_directive) {
+            tokenize_header(std::move(token.token), line_number);
         }
-        context->filename_include_set.insert(filename);
-        if (!find_header(*context->p_includedirs, filename)) {
-            raise_runtime_error_at_line(
-                GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::failed_to_include_header_file, filename), line_number);
+        else {
+            token.line = context->total_line_number;
+            context->p_tokens->emplace_back(std::move(token));
         }
     }
+    context->total_line_number += header_cache.line_count - line_number;
+}
+
+static void tokenize_header_file(const std::string& filename) {
+    if (context->is_preprocessed || (context->cachedir.empty() && !is_memory_header_cache())) {
+        tokenize_file();
+        return;
+    }
+
+    HeaderCache header_cache;
+    if (load_memory_header_cache(filename, header_cache)) {
+        tokenize_cached_file(header_cache);
+        return;
+    }
+    else if (!context->cachedir.empty() && load_header_cache(context->cachedir, filename, header_cache)) {
+        store_memory_header_cache(filename, header_cache);
+        tokenize_cached_file(header_cache);
+        return;
+    }
+    std::vector<Token>* p_cache_tokens = context->p_cache_tokens;
+    context->p_cache_tokens = &header_cache.tokens;
+    header_cache.line_count = tokenize_file();
+    context->p_cache_tokens = p_cache_tokens;
+    if (!context->cachedir.empty()) {
+        store_header_cache(context->cachedir, filename, header_cache);
+    }
+    store_memory_header_cache(filename, header_cache);
+}
+
+// Without macro expansion every header is included at most once, otherwise only those marked with #pragma once are.
+// Every header opened is recorded once as a dependency, with the path it was opened with.
+static void tokenize_header(std::string filename, size_t line_number) {
+    const HeaderFile& header_file = resolve_header(std::move(filename), line_number);
+    if (context->header_once_set.find(header_file.file_id) != context->header_once_set.end()) {
+        return;
+    }
+    else if (!context->is_preprocessed) {
+        context->header_once_set.insert(header_file.file_id);
+    }
+    else if (context->header_id_stack.size() >= MAX_INCLUDE_DEPTH) {
+        raise_runtime_error_at_line(GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::include_nested_too_deeply,
+                                        header_file.filename, std::to_string(MAX_INCLUDE_DEPTH)),
+            line_number);
+    }
+    filename = header_file.filename;
+    context->header_id_stack.push_back(header_file.file_id);
+    if (context->p_dependencies && context->dependency_id_set.insert(header_file.file_id).second) {
+        context->p_dependencies->push_back(filename);
+    }
 
     std::string include_filename = errors->file_open_lines.back().filename;
     file_open_read(filename);
     {
-        FileOpenLine file_open_line = {1, context->total_line_number + 1, std::move(filename)};
+        FileOpenLine file_open_line = {1, context->total_line_number + 1, filename};
         errors->file_open_lines.emplace_back(std::move(file_open_line));
     }
-    tokenize_file();
+    tokenize_header_file(filename);
     file_close_read(line_number);
     {
         FileOpenLine file_open_line = {line_number + 1, context->total_line_number + 1, std::move(include_filename)};
         errors->file_open_lines.emplace_back(std::move(file_open_line));
     }
+    context->header_id_stack.pop_back();
 }
 
-static void tokenize_source() {
 #ifndef __WITH_CTRE__
+static std::string get_re_pattern() {
     std::string re_pattern("");
     re_build_token_pattern(re_pattern);
     re_pattern.pop_back();
-    context->re_compiled_pattern = std::make_unique<const boost::regex>(std::move(re_pattern));
+    return re_pattern;
+}
+
+// The pattern is compiled once per process, so that a compile server reuses it across requests. Its capture groups
+// are only named while it is built, so they are kept along with it and copied to every new context.
+static const boost::regex* get_re_compiled_pattern() {
+    static const boost::regex re_compiled_pattern(get_re_pattern());
+    static const std::vector<std::string> re_capture_groups(
+        context->re_capture_groups, context->re_capture_groups + TOKEN_KIND_SIZE);
+    for (size_t i = 0; i < TOKEN_KIND_SIZE; ++i) {
+        context->re_capture_groups[i] = re_capture_groups[i];
+    }
+    return &re_compiled_pattern;
+}
 #endif
-    tokenize_file();
+
+static void tokenize_source() {
+#ifndef __WITH_CTRE__
+    context->re_compiled_pattern = get_re_compiled_pattern();
+#endif
+    if (context->is_preprocessed) {
+        define_builtin_macros();
+    }
+    size_t line_number = tokenize_file();
+    if (context->is_preprocessed) {
+        expand_macro_pending_tokens(line_number);
+    }
 }
 
 static void strip_filename_extension(std::string& filename) { filename = filename.substr(0, filename.size() - 2); }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-std::unique_ptr<std::vector<Token>> lexing(std::string& filename, std::vector<std::string>&& includedirs) {
+// Preprocessor
+
+// Macros are expanded on tokens, with the hide set algorithm from Prosser's notes: each token carries the names of the
+// macros it was expanded from, which are never expanded again for that token. Tokens of plain lines are buffered
+// unexpanded in the output, and are expanded all at once before the next directive changes the macro table.
+
+static bool is_macro_skipped() {
+    return !context->macro_conditions.empty() && context->macro_conditions.back().is_skipped;
+}
+
+static size_t skip_directive_space(const std::string& line, size_t i) {
+    while (i < line.size() && isspace(static_cast<unsigned char>(line[i]))) {
+        i++;
+    }
+    return i;
+}
+
+static size_t skip_directive_identifier(const std::string& line, size_t i) {
+    if (i < line.size() && (isalpha(static_cast<unsigned char>(line[i])) || line[i] == '_')) {
+        for (i++; i < line.size() && (isalnum(static_cast<unsigned char>(line[i])) || line[i] == '_'); i++) {
+        }
+    }
+    return i;
+}
+
+static std::string get_directive_text(const std::string& line, size_t i) {
+    i = skip_directive_space(line, i);
+    size_t j = line.size();
+    while (j > i && isspace(static_cast<unsigned char>(line[j - 1]))) {
+        j--;
+    }
+    return line.substr(i, j - i);
+}
+
+static bool is_token_kind_keyword(TOKEN_KIND token_kind) {
+    return token_kind >= TOKEN_KIND::key_char && token_kind <= TOKEN_KIND::key_extern;
+}
+
+static void re_match_directive_token(
+#ifdef __WITH_CTRE__
+    std::string_view re_iterator_view_slice
+#else
+    const boost::smatch& re_match
+#endif
+) {
+#ifdef __WITH_CTRE__
+    context->re_iterator_view_slice = re_iterator_view_slice;
+    re_match_current_token();
+#else
+    for (size_t i = TOKEN_KIND_SIZE; i-- > 0;) {
+        if (re_match[context->re_capture_groups[i]].matched) {
+            context->re_match_token_kind = static_cast<TOKEN_KIND>(i);
+            context->re_match_token = re_match.get_last_closed_paren();
+            break;
+        }
+    }
+#endif
+}
+
+// Tokens of a directive are lexed as usual, except that # and ## are kept as operators, and a # that was lexed
+// together with its operand as a directive is split again.
+static std::vector<Token> tokenize_directive(const std::string& text, size_t line_number) {
+    std::vector<Token> tokens;
+    bool is_comment = false;
+#ifdef __WITH_CTRE__
+    const std::string_view re_iterator_view(text);
+    for (size_t i = 0; i < text.size(); i += context->re_match_token.size()) {
+        re_match_directive_token(re_iterator_view.substr(i));
+#else
+    boost::sregex_iterator re_iterator_end;
+    for (boost::sregex_iterator re_iterator_begin =
+             boost::sregex_iterator(text.begin(), text.end(), *context->re_compiled_pattern);
+         re_iterator_begin != re_iterator_end; re_iterator_begin++) {
+        re_match_directive_token(*re_iterator_begin);
+#endif
+        if (is_comment) {
+            if (context->re_match_token_kind == TOKEN_KIND::comment_multilineend) {
+                is_comment = false;
+            }
+            continue;
+        }
+        switch (context->re_match_token_kind) {
+            case TOKEN_KIND::error:
+            case TOKEN_KIND::comment_multilineend:
+            case TOKEN_KIND::include_directive:
+                raise_runtime_error_at_line(
+                    GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::invalid_token, context->re_match_token), line_number);
+            case TOKEN_KIND::skip:
+                continue;
+            case TOKEN_KIND::comment_multilinestart:
+                is_comment = true;
+                continue;
+            case TOKEN_KIND::comment_singleline:
+                return tokens;
+            case TOKEN_KIND::preprocessor_directive: {
+                Token token = {TOKEN_KIND::preprocessor_stringify, "#", context->total_line_number};
+                tokens.emplace_back(std::move(token));
+                std::string name = context->re_match_token.substr(skip_directive_space(context->re_match_token, 1));
+                token = {TOKEN_KIND::identifier, std::move(name), context->total_line_number};
+                tokens.emplace_back(std::move(token));
+                continue;
+            }
+            default:
+                break;
+        }
+        Token token = {context->re_match_token_kind, context->re_match_token, context->total_line_number};
+        tokens.emplace_back(std::move(token));
+    }
+    return tokens;
+}
+
+static void paste_macro_token(Token& token, const Token& paste_token, size_t line_number) {
+    std::string text = token.token;
+    text += paste_token.token;
+#ifdef __WITH_CTRE__
+    re_match_directive_token(std::string_view(text));
+#else
+    boost::smatch re_match;
+    if (!boost::regex_search(text, re_match, *context->re_compiled_pattern, boost::match_continuous)) {
+        raise_runtime_error_at_line(
+            GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::invalid_paste_of_tokens, token.token, paste_token.token),
+            line_number);
+    }
+    re_match_directive_token(re_match);
+#endif
+    switch (context->re_match_token_kind) {
+        case TOKEN_KIND::skip:
+        case TOKEN_KIND::comment_singleline:
+        case TOKEN_KIND::comment_multilinestart:
+        case TOKEN_KIND::comment_multilineend:
+        case TOKEN_KIND::include_directive:
+        case TOKEN_KIND::preprocessor_directive:
+        case TOKEN_KIND::error:
+            break;
+        default: {
+            if (context->re_match_token.size() == text.size()) {
+                token.token_kind = context->re_match_token_kind;
+                token.token = std::move(text);
+                return;
+            }
+            break;
+        }
+    }
+    raise_runtime_error_at_line(
+        GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::invalid_paste_of_tokens, token.token, paste_token.token), line_number);
+}
+
+static MacroToken stringify_macro_arg(const std::vector<MacroToken>& arg) {
+    std::string text = "\"";
+    for (size_t i = 0; i < arg.size(); ++i) {
+        if (i > 0) {
+            text += " ";
+        }
+        if (arg[i].token.token_kind == TOKEN_KIND::string_literal
+            || arg[i].token.token_kind == TOKEN_KIND::char_constant) {
+            for (char c : arg[i].token.token) {
+                if (c == '"' || c == '\\') {
+                    text += '\\';
+                }
+                text += c;
+            }
+        }
+        else {
+            text += arg[i].token.token;
+        }
+    }
+    text += "\"";
+    return {{TOKEN_KIND::string_literal, std::move(text), 0}, {}};
+}
+
+static size_t get_macro_param_index(const Macro& macro, const Token& token) {
+    if (macro.is_function && token.token_kind == TOKEN_KIND::identifier) {
+        for (size_t i = 0; i < macro.params.size(); ++i) {
+            if (macro.params[i].compare(token.token) == 0) {
+                return i;
+            }
+        }
+    }
+    return macro.params.size();
+}
+
+static bool is_macro_in_hideset(const std::vector<std::string>& hideset, const std::string& name) {
+    for (const auto& hidename : hideset) {
+        if (hidename.compare(name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void expand_macro_tokens(
+    std::vector<MacroToken>& macro_stack, std::vector<MacroToken>& macro_tokens, size_t line_number);
+
+static std::vector<MacroToken> expand_macro_arg(const std::vector<MacroToken>& arg, size_t line_number) {
+    std::vector<MacroToken> macro_stack(arg.rbegin(), arg.rend());
+    std::vector<MacroToken> macro_tokens;
+    expand_macro_tokens(macro_stack, macro_tokens, line_number);
+    return macro_tokens;
+}
+
+static std::vector<MacroToken> substitute_macro(
+    const Macro& macro, const std::vector<std::vector<MacroToken>>& args, size_t line_number) {
+    std::vector<MacroToken> macro_tokens;
+    bool is_placemarker = false;
+    for (size_t i = 0; i < macro.tokens.size(); ++i) {
+        const Token& token = macro.tokens[i];
+        if (macro.is_function && token.token_kind == TOKEN_KIND::preprocessor_stringify) {
+            macro_tokens.push_back(stringify_macro_arg(args[get_macro_param_index(macro, macro.tokens[++i])]));
+            is_placemarker = false;
+            continue;
+        }
+        else if (token.token_kind == TOKEN_KIND::preprocessor_paste) {
+            const Token& paste_token = macro.tokens[++i];
+            size_t param_index = get_macro_param_index(macro, paste_token);
+            if (param_index < macro.params.size()) {
+                const std::vector<MacroToken>& arg = args[param_index];
+                size_t j = 0;
+                if (!arg.empty() && !is_placemarker && !macro_tokens.empty()) {
+                    paste_macro_token(macro_tokens.back().token, arg[0].token, line_number);
+                    j++;
+                }
+                macro_tokens.insert(macro_tokens.end(), arg.begin() + j, arg.end());
+                is_placemarker = is_placemarker && arg.empty();
+            }
+            else if (!is_placemarker && !macro_tokens.empty()) {
+                paste_macro_token(macro_tokens.back().token, paste_token, line_number);
+            }
+            else {
+                macro_tokens.push_back({paste_token, {}});
+                is_placemarker = false;
+            }
+            continue;
+        }
+
+        size_t param_index = get_macro_param_index(macro, token);
+        if (param_index < macro.params.size()) {
+            const std::vector<MacroToken>& arg = args[param_index];
+            if (i + 1 < macro.tokens.size() && macro.tokens[i + 1].token_kind == TOKEN_KIND::preprocessor_paste) {
+                macro_tokens.insert(macro_tokens.end(), arg.begin(), arg.end());
+            }
+            else {
+                std::vector<MacroToken> expanded_arg = expand_macro_arg(arg, line_number);
+                macro_tokens.insert(macro_tokens.end(), std::make_move_iterator(expanded_arg.begin()),
+                    std::make_move_iterator(expanded_arg.end()));
+            }
+            is_placemarker = arg.empty();
+        }
+        else {
+            macro_tokens.push_back({token, {}});
+            is_placemarker = false;
+        }
+    }
+    return macro_tokens;
+}
+
+static void read_macro_args(std::vector<MacroToken>& macro_stack, const std::string& name, const Macro& macro,
+    std::vector<std::vector<MacroToken>>& args, std::vector<std::string>& hideset, size_t line_number) {
+    macro_stack.pop_back();
+    args.emplace_back();
+    size_t depth = 0;
+    while (true) {
+        if (macro_stack.empty()) {
+            raise_runtime_error_at_line(
+                GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::unterminated_macro_argument_list, name), line_number);
+        }
+        MacroToken macro_token = std::move(macro_stack.back());
+        macro_stack.pop_back();
+        switch (macro_token.token.token_kind) {
+            case TOKEN_KIND::parenthesis_open:
+                depth++;
+                break;
+            case TOKEN_KIND::parenthesis_close: {
+                if (depth == 0) {
+                    std::vector<std::string> close_hideset;
+                    for (auto& hidename : hideset) {
+                        if (is_macro_in_hideset(macro_token.hideset, hidename)) {
+                            close_hideset.emplace_back(std::move(hidename));
+                        }
+                    }
+                    hideset = std::move(close_hideset);
+                    goto Lbreak;
+                }
+                depth--;
+                break;
+            }
+            case TOKEN_KIND::separator_comma: {
+                if (depth == 0) {
+                    args.emplace_back();
+                    continue;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+        args.back().emplace_back(std::move(macro_token));
+    }
+Lbreak:
+
+    if (macro.params.empty() && args.size() == 1 && args[0].empty()) {
+        args.clear();
+    }
+    if (args.size() != macro.params.size()) {
+        raise_runtime_error_at_line(GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::macro_argument_count_mismatch, name,
+                                        std::to_string(macro.params.size()), std::to_string(args.size())),
+            line_number);
+    }
+}
+
+// The macro stack holds the tokens left to expand in reverse order, so that a replacement list is rescanned together
+// with the tokens that follow it.
+static void expand_macro_tokens(
+    std::vector<MacroToken>& macro_stack, std::vector<MacroToken>& macro_tokens, size_t line_number) {
+    while (!macro_stack.empty()) {
+        MacroToken macro_token = std::move(macro_stack.back());
+        macro_stack.pop_back();
+        if (macro_token.token.token_kind != TOKEN_KIND::identifier) {
+            macro_tokens.emplace_back(std::move(macro_token));
+            continue;
+        }
+        auto macro = context->macro_table.find(macro_token.token.token);
+        if (macro == context->macro_table.end() || is_macro_in_hideset(macro_token.hideset, macro->first)
+            || (macro->second.is_function
+                && (macro_stack.empty()
+                    || macro_stack.back().token.token_kind != TOKEN_KIND::parenthesis_open))) {
+            macro_tokens.emplace_back(std::move(macro_token));
+            continue;
+        }
+
+        std::vector<std::string> hideset = std::move(macro_token.hideset);
+        std::vector<std::vector<MacroToken>> args;
+        if (macro->second.is_function) {
+            read_macro_args(macro_stack, macro->first, macro->second, args, hideset, line_number);
+        }
+        hideset.push_back(macro->first);
+        std::vector<MacroToken> replacement_tokens = substitute_macro(macro->second, args, line_number);
+        for (size_t i = replacement_tokens.size(); i-- > 0;) {
+            replacement_tokens[i].token.line = macro_token.token.line;
+            for (const auto& hidename : hideset) {
+                if (!is_macro_in_hideset(replacement_tokens[i].hideset, hidename)) {
+                    replacement_tokens[i].hideset.push_back(hidename);
+                }
+            }
+            macro_stack.emplace_back(std::move(replacement_tokens[i]));
+        }
+    }
+}
+
+static void expand_macro_pending_tokens(size_t line_number) {
+    std::vector<Token>& tokens = *context->p_tokens;
+    if (context->macro_expand_index == tokens.size()) {
+        return;
+    }
+
+    std::vector<MacroToken> macro_stack;
+    macro_stack.reserve(tokens.size() - context->macro_expand_index);
+    for (size_t i = tokens.size(); i-- > context->macro_expand_index;) {
+        macro_stack.push_back({std::move(tokens[i]), {}});
+    }
+    tokens.resize(context->macro_expand_index);
+
+    std::vector<MacroToken> macro_tokens;
+    expand_macro_tokens(macro_stack, macro_tokens, line_number);
+    for (auto& macro_token : macro_tokens) {
+        if (macro_token.token.token_kind == TOKEN_KIND::preprocessor_stringify
+            || macro_token.token.token_kind == TOKEN_KIND::preprocessor_paste) {
+            raise_runtime_error_at_line(
+                GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::invalid_token, macro_token.token.token), line_number);
+        }
+        tokens.emplace_back(std::move(macro_token.token));
+    }
+    context->macro_expand_index = tokens.size();
+}
+
+static void define_builtin_macro(std::string name, TOKEN_KIND token_kind, std::string value) {
+    Macro macro = {false, {}, {{token_kind, std::move(value), 0}}};
+    context->macro_table[std::move(name)] = std::move(macro);
+}
+
+static void define_builtin_macros() {
+    define_builtin_macro("__STDC__", TOKEN_KIND::constant, "1");
+    define_builtin_macro("__STDC_HOSTED__", TOKEN_KIND::constant, "1");
+    define_builtin_macro("__STDC_VERSION__", TOKEN_KIND::long_constant, "201710L");
+    define_builtin_macro("__x86_64__", TOKEN_KIND::constant, "1");
+    define_builtin_macro("__LP64__", TOKEN_KIND::constant, "1");
+#ifdef __linux__
+    define_builtin_macro("__linux__", TOKEN_KIND::constant, "1");
+#endif
+#ifdef __APPLE__
+    define_builtin_macro("__APPLE__", TOKEN_KIND::constant, "1");
+#endif
+}
+
+static void define_macro(const std::string& line, size_t i, size_t line_number) {
+    i = skip_directive_space(line, i);
+    size_t j = skip_directive_identifier(line, i);
+    if (i == j) {
+        raise_runtime_error_at_line(
+            GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::macro_name_not_an_identifier, get_directive_text(line, i)),
+            line_number);
+    }
+    std::string name = line.substr(i, j - i);
+
+    Macro macro;
+    macro.is_function = j < line.size() && line[j] == '(';
+    if (macro.is_function) {
+        j = skip_directive_space(line, j + 1);
+        if (j < line.size() && line[j] == ')') {
+            j++;
+        }
+        else {
+            while (true) {
+                i = j;
+                j = skip_directive_identifier(line, i);
+                if (i == j) {
+                    raise_runtime_error_at_line(
+                        GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::invalid_macro_parameter_list, name), line_number);
+                }
+                macro.params.push_back(line.substr(i, j - i));
+                j = skip_directive_space(line, j);
+                if (j < line.size() && line[j] == ',') {
+                    j = skip_directive_space(line, j + 1);
+                }
+                else if (j < line.size() && line[j] == ')') {
+                    j++;
+                    break;
+                }
+                else {
+                    raise_runtime_error_at_line(
+                        GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::invalid_macro_parameter_list, name), line_number);
+                }
+            }
+        }
+    }
+
+    macro.tokens = tokenize_directive(line.substr(j), line_number);
+    if (!macro.tokens.empty()
+        && (macro.tokens.front().token_kind == TOKEN_KIND::preprocessor_paste
+            || macro.tokens.back().token_kind == TOKEN_KIND::preprocessor_paste)) {
+        raise_runtime_error_at_line(
+            GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::paste_at_either_end_of_macro, "##", name), line_number);
+    }
+    if (macro.is_function) {
+        for (size_t k = 0; k < macro.tokens.size(); ++k) {
+            if (macro.tokens[k].token_kind == TOKEN_KIND::preprocessor_stringify
+                && (k + 1 == macro.tokens.size()
+                    || get_macro_param_index(macro, macro.tokens[k + 1]) == macro.params.size())) {
+                raise_runtime_error_at_line(
+                    GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::stringify_not_followed_by_macro_parameter, "#", name),
+                    line_number);
+            }
+        }
+    }
+    context->macro_table[std::move(name)] = std::move(macro);
+}
+
+static std::string get_directive_macro_name(const std::string& line, size_t i, size_t line_number) {
+    i = skip_directive_space(line, i);
+    size_t j = skip_directive_identifier(line, i);
+    if (i == j) {
+        raise_runtime_error_at_line(
+            GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::macro_name_not_an_identifier, get_directive_text(line, i)),
+            line_number);
+    }
+    return line.substr(i, j - i);
+}
+
+static void undefine_macro(const std::string& line, size_t i, size_t line_number) {
+    context->macro_table.erase(get_directive_macro_name(line, i, line_number));
+}
+
+static void include_macro_header(const std::string& line, size_t i, size_t line_number) {
+    std::string text = get_directive_text(line, i);
+    if (text.size() > 2
+        && ((text.front() == '<' && text.back() == '>') || (text.front() == '"' && text.back() == '"'))) {
+        tokenize_header(std::move(text), line_number);
+        return;
+    }
+    raise_runtime_error_at_line(
+        GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::failed_to_include_header_file, text), line_number);
+}
+
+// Values of conditional expressions have the type intmax_t or uintmax_t, and are computed on unsigned 64 bits integers,
+// so that signed arithmetic wraps around.
+struct MacroValue {
+    uint64_t value;
+    bool is_unsigned;
+};
+
+struct MacroExpression {
+    const std::vector<MacroToken>* p_tokens;
+    size_t index;
+    const char* directive;
+    size_t line_number;
+};
+
+[[noreturn]] static void raise_macro_expression_error(MacroExpression& expression) {
+    raise_runtime_error_at_line(
+        GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::invalid_conditional_expression, expression.directive),
+        expression.line_number);
+}
+
+static TOKEN_KIND peek_macro_expression(MacroExpression& expression) {
+    if (expression.index < expression.p_tokens->size()) {
+        return (*expression.p_tokens)[expression.index].token.token_kind;
+    }
+    return TOKEN_KIND::error;
+}
+
+static int32_t get_macro_binop_precedence(TOKEN_KIND token_kind) {
+    switch (token_kind) {
+        case TOKEN_KIND::binop_multiplication:
+        case TOKEN_KIND::binop_division:
+        case TOKEN_KIND::binop_remainder:
+            return 50;
+        case TOKEN_KIND::binop_addition:
+        case TOKEN_KIND::unop_negation:
+            return 45;
+        case TOKEN_KIND::binop_bitshiftleft:
+        case TOKEN_KIND::binop_bitshiftright:
+            return 40;
+        case TOKEN_KIND::binop_lessthan:
+        case TOKEN_KIND::binop_lessthanorequal:
+        case TOKEN_KIND::binop_greaterthan:
+        case TOKEN_KIND::binop_greaterthanorequal:
+            return 35;
+        case TOKEN_KIND::binop_equalto:
+        case TOKEN_KIND::binop_notequal:
+            return 30;
+        case TOKEN_KIND::binop_bitand:
+            return 25;
+        case TOKEN_KIND::binop_bitxor:
+            return 20;
+        case TOKEN_KIND::binop_bitor:
+            return 15;
+        case TOKEN_KIND::binop_and:
+            return 10;
+        case TOKEN_KIND::binop_or:
+            return 5;
+        case TOKEN_KIND::ternary_if:
+            return 3;
+        default:
+            return -1;
+    }
+}
+
+static int64_t eval_macro_char_constant(const std::string& token) {
+    if (token[1] != '\\') {
+        return static_cast<int64_t>(static_cast<signed char>(token[1]));
+    }
+    switch (token[2]) {
+        case 'a':
+            return 7;
+        case 'b':
+            return 8;
+        case 'f':
+            return 12;
+        case 'n':
+            return 10;
+        case 'r':
+            return 13;
+        case 't':
+            return 9;
+        case 'v':
+            return 11;
+        default:
+            return static_cast<int64_t>(static_cast<signed char>(token[2]));
+    }
+}
+
+static MacroValue eval_macro_expression(MacroExpression& expression, int32_t min_precedence);
+
+static MacroValue eval_macro_factor(MacroExpression& expression) {
+    TOKEN_KIND token_kind = peek_macro_expression(expression);
+    if (token_kind == TOKEN_KIND::error) {
+        raise_macro_expression_error(expression);
+    }
+    const Token& token = (*expression.p_tokens)[expression.index++].token;
+    switch (token_kind) {
+        case TOKEN_KIND::constant:
+        case TOKEN_KIND::long_constant:
+        case TOKEN_KIND::unsigned_constant:
+        case TOKEN_KIND::unsigned_long_constant: {
+            uint64_t value = strtoull(token.token.c_str(), nullptr, 10);
+            return {value, token_kind == TOKEN_KIND::unsigned_constant
+                               || token_kind == TOKEN_KIND::unsigned_long_constant || value > 9223372036854775807ul};
+        }
+        case TOKEN_KIND::char_constant:
+            return {static_cast<uint64_t>(eval_macro_char_constant(token.token)), false};
+        case TOKEN_KIND::identifier:
+            return {0ul, false};
+        case TOKEN_KIND::unop_negation: {
+            MacroValue value = eval_macro_factor(expression);
+            value.value = 0ul - value.value;
+            return value;
+        }
+        case TOKEN_KIND::binop_addition:
+            return eval_macro_factor(expression);
+        case TOKEN_KIND::unop_complement: {
+            MacroValue value = eval_macro_factor(expression);
+            value.value = ~value.value;
+            return value;
+        }
+        case TOKEN_KIND::unop_not:
+            return {eval_macro_factor(expression).value == 0ul, false};
+        case TOKEN_KIND::parenthesis_open: {
+            MacroValue value = eval_macro_expression(expression, 0);
+            if (peek_macro_expression(expression) != TOKEN_KIND::parenthesis_close) {
+                raise_macro_expression_error(expression);
+            }
+            expression.index++;
+            return value;
+        }
+        default: {
+            if (is_token_kind_keyword(token_kind)) {
+                return {0ul, false};
+            }
+            raise_macro_expression_error(expression);
+        }
+    }
+}
+
+static bool is_macro_value_less(uint64_t left, uint64_t right, bool is_unsigned) {
+    return is_unsigned ? left < right : static_cast<int64_t>(left) < static_cast<int64_t>(right);
+}
+
+// Shifts follow gcc: a negative count shifts the other way, and a count of 64 or more shifts out every bit.
+static MacroValue eval_macro_shift_expression(MacroValue left, MacroValue right, bool is_left) {
+    uint64_t count = right.value;
+    if (!right.is_unsigned && static_cast<int64_t>(count) < 0) {
+        count = 0ul - count;
+        is_left = !is_left;
+    }
+    bool is_negative = !left.is_unsigned && static_cast<int64_t>(left.value) < 0;
+    if (count >= 64ul) {
+        left.value = !is_left && is_negative ? ~0ul : 0ul;
+    }
+    else if (is_left) {
+        left.value <<= count;
+    }
+    else if (is_negative) {
+        left.value = ~(~left.value >> count);
+    }
+    else {
+        left.value >>= count;
+    }
+    return left;
+}
+
+static MacroValue eval_macro_binary_expression(MacroExpression& expression, TOKEN_KIND token_kind, MacroValue left,
+    MacroValue right) {
+    bool is_unsigned = left.is_unsigned || right.is_unsigned;
+    switch (token_kind) {
+        case TOKEN_KIND::binop_multiplication:
+            return {left.value * right.value, is_unsigned};
+        case TOKEN_KIND::binop_division:
+        case TOKEN_KIND::binop_remainder: {
+            if (right.value == 0ul) {
+                raise_macro_expression_error(expression);
+            }
+            else if (is_unsigned) {
+                return {token_kind == TOKEN_KIND::binop_division ? left.value / right.value : left.value % right.value,
+                    true};
+            }
+            else if (left.value == 9223372036854775808ul && right.value == ~0ul) {
+                raise_runtime_error_at_line(
+                    GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::conditional_expression_overflow,
+                        token_kind == TOKEN_KIND::binop_division ? "/" : "%", expression.directive),
+                    expression.line_number);
+            }
+            int64_t value = token_kind == TOKEN_KIND::binop_division ?
+                                static_cast<int64_t>(left.value) / static_cast<int64_t>(right.value) :
+                                static_cast<int64_t>(left.value) % static_cast<int64_t>(right.value);
+            return {static_cast<uint64_t>(value), false};
+        }
+        case TOKEN_KIND::binop_addition:
+            return {left.value + right.value, is_unsigned};
+        case TOKEN_KIND::unop_negation:
+            return {left.value - right.value, is_unsigned};
+        case TOKEN_KIND::binop_bitshiftleft:
+            return eval_macro_shift_expression(left, right, true);
+        case TOKEN_KIND::binop_bitshiftright:
+            return eval_macro_shift_expression(left, right, false);
+        case TOKEN_KIND::binop_lessthan:
+            return {is_macro_value_less(left.value, right.value, is_unsigned), false};
+        case TOKEN_KIND::binop_lessthanorequal:
+            return {!is_macro_value_less(right.value, left.value, is_unsigned), false};
+        case TOKEN_KIND::binop_greaterthan:
+            return {is_macro_value_less(right.value, left.value, is_unsigned), false};
+        case TOKEN_KIND::binop_greaterthanorequal:
+            return {!is_macro_value_less(left.value, right.value, is_unsigned), false};
+        case TOKEN_KIND::binop_equalto:
+            return {left.value == right.value, false};
+        case TOKEN_KIND::binop_notequal:
+            return {left.value != right.value, false};
+        case TOKEN_KIND::binop_bitand:
+            return {left.value & right.value, is_unsigned};
+        case TOKEN_KIND::binop_bitxor:
+            return {left.value ^ right.value, is_unsigned};
+        case TOKEN_KIND::binop_bitor:
+            return {left.value | right.value, is_unsigned};
+        case TOKEN_KIND::binop_and:
+            return {left.value != 0ul && right.value != 0ul, false};
+        case TOKEN_KIND::binop_or:
+            return {left.value != 0ul || right.value != 0ul, false};
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+static MacroValue eval_macro_expression(MacroExpression& expression, int32_t min_precedence) {
+    MacroValue left = eval_macro_factor(expression);
+    while (true) {
+        TOKEN_KIND token_kind = peek_macro_expression(expression);
+        int32_t precedence = get_macro_binop_precedence(token_kind);
+        if (precedence < min_precedence) {
+            break;
+        }
+        expression.index++;
+        if (token_kind == TOKEN_KIND::ternary_if) {
+            MacroValue middle = eval_macro_expression(expression, 0);
+            if (peek_macro_expression(expression) != TOKEN_KIND::ternary_else) {
+                raise_macro_expression_error(expression);
+            }
+            expression.index++;
+            MacroValue right = eval_macro_expression(expression, precedence);
+            left = {left.value != 0ul ? middle.value : right.value, middle.is_unsigned || right.is_unsigned};
+        }
+        else {
+            MacroValue right = eval_macro_expression(expression, precedence + 1);
+            left = eval_macro_binary_expression(expression, token_kind, left, right);
+        }
+    }
+    return left;
+}
+
+// The defined operator is evaluated before the expression is macro expanded.
+static bool eval_macro_condition(const std::string& line, size_t i, const char* directive, size_t line_number) {
+    std::vector<Token> tokens = tokenize_directive(line.substr(i), line_number);
+    std::vector<MacroToken> macro_stack;
+    macro_stack.reserve(tokens.size());
+    for (size_t j = tokens.size(); j-- > 0;) {
+        macro_stack.push_back({std::move(tokens[j]), {}});
+    }
+
+    std::vector<MacroToken> macro_tokens;
+    while (!macro_stack.empty()) {
+        MacroToken macro_token = std::move(macro_stack.back());
+        macro_stack.pop_back();
+        if (macro_token.token.token_kind == TOKEN_KIND::identifier && macro_token.token.token.compare("defined") == 0) {
+            bool is_parenthesized =
+                !macro_stack.empty() && macro_stack.back().token.token_kind == TOKEN_KIND::parenthesis_open;
+            if (is_parenthesized) {
+                macro_stack.pop_back();
+            }
+            if (macro_stack.empty() || macro_stack.back().token.token_kind != TOKEN_KIND::identifier) {
+                raise_runtime_error_at_line(
+                    GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::invalid_conditional_expression, directive), line_number);
+            }
+            bool is_defined = context->macro_table.find(macro_stack.back().token.token) != context->macro_table.end();
+            macro_stack.pop_back();
+            if (is_parenthesized) {
+                if (macro_stack.empty() || macro_stack.back().token.token_kind != TOKEN_KIND::parenthesis_close) {
+                    raise_runtime_error_at_line(
+                        GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::invalid_conditional_expression, directive),
+                        line_number);
+                }
+                macro_stack.pop_back();
+            }
+            macro_token.token = {TOKEN_KIND::constant, is_defined ? "1" : "0", macro_token.token.line};
+        }
+        macro_tokens.emplace_back(std::move(macro_token));
+    }
+
+    macro_stack.assign(std::make_move_iterator(macro_tokens.rbegin()), std::make_move_iterator(macro_tokens.rend()));
+    macro_tokens.clear();
+    expand_macro_tokens(macro_stack, macro_tokens, line_number);
+    MacroExpression expression = {&macro_tokens, 0, directive, line_number};
+    bool is_true = eval_macro_expression(expression, 0).value != 0ul;
+    if (expression.index != macro_tokens.size()) {
+        raise_macro_expression_error(expression);
+    }
+    return is_true;
+}
+
+static void push_macro_condition(bool is_true) {
+    if (is_macro_skipped()) {
+        context->macro_conditions.push_back({true, true, false});
+    }
+    else {
+        context->macro_conditions.push_back({!is_true, is_true, false});
+    }
+}
+
+static MacroCondition& get_macro_condition(const char* directive, size_t line_number) {
+    if (context->macro_conditions.empty() || context->macro_conditions.back().is_else) {
+        raise_runtime_error_at_line(
+            GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::conditional_directive_without_if, directive), line_number);
+    }
+    return context->macro_conditions.back();
+}
+
+static void preprocess_directive(const std::string& line, size_t i, size_t line_number) {
+    i = skip_directive_space(line, i);
+    size_t j = skip_directive_identifier(line, i);
+    std::string directive = line.substr(i, j - i);
+
+    if (directive.compare("if") == 0) {
+        push_macro_condition(!is_macro_skipped() && eval_macro_condition(line, j, "#if", line_number));
+    }
+    else if (directive.compare("ifdef") == 0 || directive.compare("ifndef") == 0) {
+        bool is_true = false;
+        if (!is_macro_skipped()) {
+            is_true = context->macro_table.find(get_directive_macro_name(line, j, line_number))
+                      != context->macro_table.end();
+            if (directive.compare("ifndef") == 0) {
+                is_true = !is_true;
+            }
+        }
+        push_macro_condition(is_true);
+    }
+    else if (directive.compare("elif") == 0) {
+        MacroCondition& macro_condition = get_macro_condition("#elif", line_number);
+        if (macro_condition.is_taken) {
+            macro_condition.is_skipped = true;
+        }
+        else {
+            macro_condition.is_taken = eval_macro_condition(line, j, "#elif", line_number);
+            macro_condition.is_skipped = !macro_condition.is_taken;
+        }
+    }
+    else if (directive.compare("else") == 0) {
+        MacroCondition& macro_condition = get_macro_condition("#else", line_number);
+        macro_condition.is_skipped = macro_condition.is_taken;
+        macro_condition.is_taken = true;
+        macro_condition.is_else = true;
+    }
+    else if (directive.compare("endif") == 0) {
+        if (context->macro_conditions.empty()) {
+            raise_runtime_error_at_line(
+                GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::conditional_directive_without_if, "#endif"), line_number);
+        }
+        context->macro_conditions.pop_back();
+    }
+    else if (is_macro_skipped()) {
+        return;
+    }
+    else if (directive.compare("define") == 0) {
+        define_macro(line, j, line_number);
+    }
+    else if (directive.compare("undef") == 0) {
+        undefine_macro(line, j, line_number);
+    }
+    else if (directive.compare("include") == 0) {
+        include_macro_header(line, j, line_number);
+    }
+    else if (directive.compare("error") == 0) {
+        raise_runtime_error_at_line(
+            GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::error_preprocessor_directive, get_directive_text(line, j)),
+            line_number);
+    }
+    else if (directive.compare("pragma") == 0) {
+        if (get_directive_text(line, j).compare("once") == 0 && !context->header_id_stack.empty()) {
+            context->header_once_set.insert(context->header_id_stack.back());
+        }
+    }
+    else if (!(directive.empty() || directive.compare("line") == 0
+                 || directive.compare("warning") == 0)) {
+        raise_runtime_error_at_line(
+            GET_ERROR_MESSAGE(ERROR_MESSAGE_LEXER::invalid_preprocessor_directive, get_directive_text(line, i)),
+            line_number);
+    }
+}
+
+static void join_continued_lines(std::string& line, size_t& line_number) {
+    while (true) {
+        size_t i = line.size();
+        while (i > 0 && (line[i - 1] == '\n' || line[i - 1] == '\r')) {
+            i--;
+        }
+        if (i == 0 || line[i - 1] != '\\') {
+            break;
+        }
+        line.resize(i - 1);
+        std::string next_line;
+        if (!read_line(next_line)) {
+            break;
+        }
+        line += next_line;
+        line_number++;
+        context->total_line_number++;
+    }
+}
+
+static bool is_directive_comment_open(const std::string& line) {
+    bool is_comment = false;
+    char quote = '\0';
+    for (size_t i = 0; i < line.size(); ++i) {
+        if (is_comment) {
+            if (line[i] == '*' && i + 1 < line.size() && line[i + 1] == '/') {
+                is_comment = false;
+                i++;
+            }
+        }
+        else if (quote != '\0') {
+            if (line[i] == '\\') {
+                i++;
+            }
+            else if (line[i] == quote) {
+                quote = '\0';
+            }
+        }
+        else if (line[i] == '"' || line[i] == '\'') {
+            quote = line[i];
+        }
+        else if (line[i] == '/' && i + 1 < line.size()) {
+            if (line[i + 1] == '/') {
+                return false;
+            }
+            else if (line[i + 1] == '*') {
+                is_comment = true;
+                i++;
+            }
+        }
+    }
+    return is_comment;
+}
+
+// Comments are replaced by a space before directives are processed, so a comment opened on a directive line joins the
+// lines up to its end to the directive.
+static void join_commented_lines(std::string& line, size_t& line_number) {
+    while (is_directive_comment_open(line)) {
+        std::string next_line;
+        if (!read_line(next_line)) {
+            break;
+        }
+        line += next_line;
+        line_number++;
+        context->total_line_number++;
+    }
+}
+
+// Returns whether the line was consumed by the preprocessor, either as a directive or as skipped text.
+static bool preprocess_line(std::string& line, size_t& line_number) {
+    join_continued_lines(line, line_number);
+    size_t i = skip_directive_space(line, 0);
+    if (i == line.size() || line[i] != '#') {
+        return is_macro_skipped();
+    }
+    join_commented_lines(line, line_number);
+    expand_macro_pending_tokens(line_number);
+    preprocess_directive(line, i + 1, line_number);
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+std::unique_ptr<std::vector<Token>> lexing(std::string& filename, std::vector<std::string>&& includedirs,
+    std::vector<std::string>* p_dependencies, std::string&& cachedir, bool is_preprocessed) {
     file_open_read(filename);
     {
         FileOpenLine file_open_line = {1, 1, filename};
@@ -317,7 +1402,8 @@ std::unique_ptr<std::vector<Token>> lexing(std::string& filename, std::vector<st
     }
 
     std::vector<Token> tokens;
-    context = std::make_unique<LexerContext>(&tokens, &includedirs);
+    context = std::make_unique<LexerContext>(
+        &tokens, &includedirs, p_dependencies, std::move(cachedir), is_preprocessed);
     tokenize_source();
     context.reset();
 
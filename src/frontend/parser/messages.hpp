@@ -8,7 +8,21 @@
 enum ERROR_MESSAGE_LEXER {
     unhandled_lexer_error = 300,
     invalid_token,
-    failed_to_include_header_file
+    failed_to_include_header_file,
+    invalid_preprocessor_directive,
+    error_preprocessor_directive,
+    conditional_directive_without_if,
+    unterminated_conditional_directive,
+    invalid_conditional_expression,
+    macro_name_not_an_identifier,
+    invalid_macro_parameter_list,
+    stringify_not_followed_by_macro_parameter,
+    paste_at_either_end_of_macro,
+    invalid_paste_of_tokens,
+    unterminated_macro_argument_list,
+    macro_argument_count_mismatch,
+    include_nested_too_deeply,
+    conditional_expression_overflow
 };
 
 enum ERROR_MESSAGE_PARSER {
@@ -96,6 +96,8 @@ enum TOKEN_KIND {
 
     include_directive,
     preprocessor_directive,
+    preprocessor_stringify,
+    preprocessor_paste,
 
     error
 };
@@ -4,10 +4,18 @@
 #include <inttypes.h>
 #include <iostream>
 #include <memory>
+#include <stdexcept>
+#include <stdlib.h>
 #include <string>
 #include <vector>
 
+#include "util/comp_cache.hpp"
+#include "util/fileio.hpp"
+#include "util/report.hpp"
+#include "util/server.hpp"
+#include "util/stats.hpp"
 #include "util/throw.hpp"
+#include "util/trace.hpp"
 #include "util/util.hpp"
 
 #include "ast/ast.hpp"
@@ -18,6 +26,7 @@
 #include "ast/interm_ast.hpp"
 
 #include "frontend/parser/errors.hpp"
+#include "frontend/parser/lex_cache.hpp"
 #include "frontend/parser/lexer.hpp"
 #include "frontend/parser/parser.hpp"
 
@@ -28,6 +37,7 @@
 #include "backend/assembly/stack_fix.hpp"
 #include "backend/assembly/symt_cvt.hpp"
 
+#include "backend/emitter/elf_code.hpp"
 #include "backend/emitter/gas_code.hpp"
 
 #include "optimization/optim_tac.hpp"
@@ -92,6 +102,141 @@ static void debug_asm_code() {
 }
 #endif
 
+static void report_phase(std::string&& name) {
+    end_phase_report(std::move(name));
+    begin_phase_report();
+}
+
+static void report_ir_phase(std::string&& name, std::string&& ir_name, size_t ir_size) {
+    PhaseReport* phase_report = end_phase_report(std::move(name));
+    if (phase_report) {
+        phase_report->ir_name = std::move(ir_name);
+        phase_report->ir_size = ir_size;
+    }
+    begin_phase_report();
+}
+
+static void report_tac_phase(std::string&& name, TacProgram* node) {
+    PhaseReport* phase_report = end_phase_report(std::move(name));
+    if (phase_report) {
+        phase_report->ir_name = "tac instructions";
+        for (const auto& top_level : node->function_top_levels) {
+            TacFunction* function = static_cast<TacFunction*>(top_level.get());
+            size_t ir_function_size = 0;
+            for (const auto& instruction : function->body) {
+                if (instruction) {
+                    ir_function_size++;
+                }
+            }
+            phase_report->ir_size += ir_function_size;
+            phase_report->ir_function_sizes.emplace_back(function->name, ir_function_size);
+        }
+    }
+    begin_phase_report();
+}
+
+static void report_asm_phase(std::string&& name, AsmProgram* node) {
+    PhaseReport* phase_report = end_phase_report(std::move(name));
+    if (phase_report) {
+        phase_report->ir_name = "asm instructions";
+        for (const auto& top_level : node->top_levels) {
+            if (top_level->type() == AST_T::AsmFunction_t) {
+                AsmFunction* function = static_cast<AsmFunction*>(top_level.get());
+                size_t ir_function_size = 0;
+                for (const auto& instruction : function->instructions) {
+                    if (instruction) {
+                        ir_function_size++;
+                    }
+                }
+                phase_report->ir_size += ir_function_size;
+                phase_report->ir_function_sizes.emplace_back(function->name, ir_function_size);
+            }
+        }
+    }
+    begin_phase_report();
+}
+
+// The key holds everything the emitted code depends on: the output format, whether labels are numbered by function for
+// parallel jobs, the optimization options and the kind and text of every token, but not the line numbers, so that a
+// change to comments or blank lines still hits the cache.
+static std::string get_compile_cache_key(const std::vector<Token>& tokens) {
+    std::string key = context->is_object ? "o," : "s,";
+    key += context->jobs > 1 ? "j," : ",";
+    key += std::to_string(context->optim_1_mask);
+    key += ",";
+    key += std::to_string(context->unroll_factor);
+    key += ",";
+    key += std::to_string(context->optim_2_code);
+    key += context->is_omit_frame_pointer ? ",f" : ",";
+    key += context->is_no_plt ? ",p;" : ";";
+    for (const auto& token : tokens) {
+        key += std::to_string(token.token_kind);
+        key += ",";
+        key += std::to_string(token.token.size());
+        key += ",";
+        key += token.token;
+    }
+    return key;
+}
+
+// Escapes the characters that make would otherwise read as separators, variables or comments.
+static std::string get_make_filename(const std::string& filename) {
+    std::string make_filename;
+    for (char c : filename) {
+        switch (c) {
+            case ' ':
+            case '#':
+                make_filename += '\\';
+                break;
+            case '$':
+                make_filename += '$';
+                break;
+            default:
+                break;
+        }
+        make_filename += c;
+    }
+    return make_filename;
+}
+
+// The first dependency is the source file, the others are the headers in the order they were opened. Each header also
+// gets an empty rule, so that make does not fail when a header is removed.
+static void write_dependencies(const std::vector<std::string>& dependencies) {
+    file_open_write(context->depend_filename);
+    {
+        std::string line = get_make_filename(context->depend_target);
+        line += ":";
+        for (const auto& dependency : dependencies) {
+            line += " \\";
+            write_line(std::move(line));
+            line = "  ";
+            line += get_make_filename(dependency);
+        }
+        write_line(std::move(line));
+    }
+    for (size_t i = 1; i < dependencies.size(); ++i) {
+        std::string line = "";
+        write_line(std::move(line));
+        line = get_make_filename(dependencies[i]);
+        line += ":";
+        write_line(std::move(line));
+    }
+    file_close_write();
+}
+
+static void free_compile() {
+    print_report();
+    FREE_REPORT_CONTEXT;
+
+    print_stats();
+    FREE_STATS_CONTEXT;
+
+    write_trace();
+    FREE_TRACE_CONTEXT;
+
+    FREE_UTIL_CONTEXT;
+}
+
 static void compile() {
     if (context->debug_code > 0
 #ifdef __NDEBUG__
@@ -103,11 +248,32 @@ static void compile() {
 
     INIT_UTIL_CONTEXT;
 
+    if (context->report_code > 0) {
+        INIT_REPORT_CONTEXT(context->report_code == 2);
+        begin_phase_report();
+    }
+    if (!context->trace_filename.empty()) {
+        INIT_TRACE_CONTEXT(std::move(context->trace_filename));
+    }
+    if (context->is_stats) {
+        INIT_STATS_CONTEXT;
+    }
+
     INIT_ERRORS_CONTEXT;
 
+    std::vector<std::string> dependencies;
+    if (!context->depend_filename.empty()) {
+        dependencies.push_back(context->filename);
+    }
+
     verbose("-- Lexing ... ", false);
-    std::unique_ptr<std::vector<Token>> tokens = lexing(context->filename, std::move(context->includedirs));
+    TRACE_EVENT_BEGIN("Lexing");
+    std::unique_ptr<std::vector<Token>> tokens = lexing(context->filename, std::move(context->includedirs),
+        context->depend_filename.empty() ? nullptr : &dependencies, std::move(context->header_cachedir),
+        context->is_preprocessed);
     verbose("OK", true);
+    TRACE_EVENT_END("Lexing");
+    report_ir_phase("Lexing", "tokens", tokens->size());
 #ifndef __NDEBUG__
     if (context->debug_code == 255) {
         debug_tokens(*tokens);
@@ -115,9 +281,27 @@ static void compile() {
     }
 #endif
 
+    CompileCacheKey compile_cache_key;
+    bool is_compile_cached = !context->compile_cachedir.empty()
+                             && get_compile_cache_key(get_compile_cache_key(*tokens), compile_cache_key);
+    if (is_compile_cached && load_compile_cache(context->compile_cachedir, compile_cache_key,
+                                 context->filename + (context->is_object ? ".o" : ".s"))) {
+        verbose("-- Compile cache hit", true);
+        report_phase("Compile cache");
+        FREE_ERRORS_CONTEXT;
+        if (!dependencies.empty()) {
+            write_dependencies(dependencies);
+        }
+        free_compile();
+        return;
+    }
+
     verbose("-- Parsing ... ", false);
+    TRACE_EVENT_BEGIN("Parsing");
     std::unique_ptr<CProgram> c_ast = parsing(std::move(tokens));
     verbose("OK", true);
+    TRACE_EVENT_END("Parsing");
+    report_ir_phase("Parsing", "ast nodes", get_ast_node_count());
 #ifndef __NDEBUG__
     if (context->debug_code == 254) {
         debug_ast(c_ast.get(), "C AST");
@@ -128,8 +312,11 @@ static void compile() {
     INIT_FRONT_END_CONTEXT;
 
     verbose("-- Semantic analysis ... ", false);
+    TRACE_EVENT_BEGIN("Semantic analysis");
     analyze_semantic(c_ast.get());
     verbose("OK", true);
+    TRACE_EVENT_END("Semantic analysis");
+    report_ir_phase("Semantic analysis", "ast nodes", get_ast_node_count());
 #ifndef __NDEBUG__
     if (context->debug_code == 253) {
         debug_ast(c_ast.get(), "C AST");
@@ -143,11 +330,18 @@ static void compile() {
     FREE_ERRORS_CONTEXT;
 
     verbose("-- TAC representation ... ", false);
+    TRACE_EVENT_BEGIN("TAC representation");
     std::unique_ptr<TacProgram> tac_ast = three_address_code_representation(std::move(c_ast));
+    TRACE_EVENT_END("TAC representation");
+    report_tac_phase("TAC representation", tac_ast.get());
     if (context->optim_1_mask > 0) {
         verbose("OK", true);
         verbose("-- Level 1 optimization ... ", false);
-        three_address_code_optimization(tac_ast.get(), context->optim_1_mask);
+        TRACE_EVENT_BEGIN("Level 1 optimization");
+        three_address_code_optimization(
+            tac_ast.get(), context->optim_1_mask, context->unroll_factor, context->jobs);
+        TRACE_EVENT_END("Level 1 optimization");
+        report_tac_phase("Level 1 optimization", tac_ast.get());
     }
     verbose("OK", true);
 #ifndef __NDEBUG__
@@ -163,14 +357,26 @@ static void compile() {
     INIT_BACK_END_CONTEXT;
 
     verbose("-- Assembly generation ... ", false);
-    std::unique_ptr<AsmProgram> asm_ast = assembly_generation(std::move(tac_ast));
+    TRACE_EVENT_BEGIN("Assembly generation");
+    std::unique_ptr<AsmProgram> asm_ast = assembly_generation(std::move(tac_ast), context->jobs);
+    TRACE_EVENT_END("Assembly generation");
+    report_asm_phase("Assembly generation", asm_ast.get());
     if (context->optim_2_code > 0) {
         verbose("OK", true);
         verbose("-- Level 2 optimization ... ", false);
+        TRACE_EVENT_BEGIN("Level 2 optimization");
         register_allocation(asm_ast.get(), context->optim_2_code);
+        TRACE_EVENT_END("Level 2 optimization");
+        report_asm_phase("Level 2 optimization", asm_ast.get());
     }
-    convert_symbol_table(asm_ast.get());
-    fix_stack(asm_ast.get());
+    TRACE_EVENT_BEGIN("Symbol table conversion");
+    convert_symbol_table(asm_ast.get(), context->is_no_plt);
+    TRACE_EVENT_END("Symbol table conversion");
+    report_phase("Symbol table conversion");
+    TRACE_EVENT_BEGIN("Stack fix");
+    fix_stack(asm_ast.get(), context->is_omit_frame_pointer, context->jobs);
+    TRACE_EVENT_END("Stack fix");
+    report_asm_phase("Stack fix", asm_ast.get());
     verbose("OK", true);
 #ifndef __NDEBUG__
     if (context->debug_code == 251) {
@@ -186,9 +392,21 @@ static void compile() {
     FREE_FRONT_END_CONTEXT;
 
     verbose("-- Code emission ... ", false);
-    context->filename += ".s";
-    gas_code_emission(std::move(asm_ast), std::move(context->filename));
+    context->filename += context->is_object ? ".o" : ".s";
+    TRACE_EVENT_BEGIN("Code emission");
+    if (context->is_object) {
+        elf_code_emission(std::move(asm_ast), std::string(context->filename));
+    }
+    else {
+        gas_code_emission(std::move(asm_ast), std::string(context->filename));
+    }
+    if (is_compile_cached) {
+        store_compile_cache(
+            context->compile_cachedir, compile_cache_key, context->filename, context->compile_cache_size);
+    }
+    TRACE_EVENT_END("Code emission");
     verbose("OK", true);
+    report_phase("Code emission");
 #ifndef __NDEBUG__
     if (context->debug_code == 250) {
         debug_asm_code();
@@ -198,7 +416,10 @@ static void compile() {
 
     FREE_BACK_END_CONTEXT;
 
-    FREE_UTIL_CONTEXT;
+    if (!dependencies.empty()) {
+        write_dependencies(dependencies);
+    }
+    free_compile();
 }
 
 static void shift_args(std::string& arg) {
@@ -235,7 +456,7 @@ static void arg_parse() {
     if (arg.empty()) {
         raise_argument_error(GET_ERROR_MESSAGE(ERROR_MESSAGE_ARGUMENT::no_optim_1_mask_in_argument));
     }
-    else if (arg_parse_uint8(arg, context->optim_1_mask) || context->optim_1_mask > 15) {
+    else if (arg_parse_uint8(arg, context->optim_1_mask)) {
         raise_argument_error(GET_ERROR_MESSAGE(ERROR_MESSAGE_ARGUMENT::invalid_optim_1_mask_in_argument, arg));
     }
 
@@ -264,14 +485,134 @@ static void arg_parse() {
     }
     while (!arg.empty());
 
+    {
+        const char* header_cachedir = getenv("WHEELCC_HEADER_CACHE_DIR");
+        if (header_cachedir) {
+            context->header_cachedir = header_cachedir;
+        }
+    }
+    {
+        const char* compile_cachedir = getenv("WHEELCC_COMPILE_CACHE_DIR");
+        if (compile_cachedir) {
+            context->compile_cachedir = compile_cachedir;
+            const char* compile_cache_size = getenv("WHEELCC_COMPILE_CACHE_SIZE");
+            if (compile_cache_size) {
+                context->compile_cache_size = strtoull(compile_cache_size, nullptr, 10) * 1024ul * 1024ul;
+            }
+        }
+    }
+    {
+        const char* depend_filename = getenv("WHEELCC_DEPEND_FILE");
+        if (depend_filename) {
+            context->depend_filename = depend_filename;
+            const char* depend_target = getenv("WHEELCC_DEPEND_TARGET");
+            if (depend_target) {
+                context->depend_target = depend_target;
+            }
+            else {
+                context->depend_target = context->filename.substr(0, context->filename.size() - 2);
+                context->depend_target += ".o";
+            }
+        }
+    }
+    {
+        const char* jobs = getenv("WHEELCC_JOBS");
+        if (jobs) {
+            context->jobs = static_cast<size_t>(strtoull(jobs, nullptr, 10));
+            if (context->jobs == 0) {
+                context->jobs = 1;
+            }
+        }
+    }
+    {
+        const char* unroll_factor = getenv("WHEELCC_UNROLL_FACTOR");
+        if (unroll_factor) {
+            context->unroll_factor = static_cast<size_t>(strtoull(unroll_factor, nullptr, 10));
+            if (context->unroll_factor == 0) {
+                context->unroll_factor = 1;
+            }
+        }
+    }
+    {
+        const char* is_omit_frame_pointer = getenv("WHEELCC_OMIT_FRAME_POINTER");
+        context->is_omit_frame_pointer = is_omit_frame_pointer && is_omit_frame_pointer[0] == '1';
+    }
+    {
+        const char* is_no_plt = getenv("WHEELCC_NO_PLT");
+        context->is_no_plt = is_no_plt && is_no_plt[0] == '1';
+    }
+    {
+        const char* is_object = getenv("WHEELCC_OBJECT");
+        context->is_object = is_object && is_object[0] == '1';
+    }
+    {
+        const char* is_preprocessed = getenv("WHEELCC_PREPROCESS");
+        context->is_preprocessed = is_preprocessed && is_preprocessed[0] == '1';
+    }
+    {
+        const char* report_format = getenv("WHEELCC_TIME_REPORT");
+        if (report_format) {
+            context->report_code = std::string(report_format).compare("json") == 0 ? 2 : 1;
+        }
+    }
+    {
+        const char* trace_filename = getenv("WHEELCC_TRACE_FILE");
+        if (trace_filename) {
+            context->trace_filename = trace_filename;
+        }
+    }
+    {
+        const char* is_stats = getenv("WHEELCC_STATS");
+        context->is_stats = is_stats && is_stats[0] == '1';
+    }
+
     arg = "";
     context->args.clear();
     std::vector<std::string>().swap(context->args);
 }
 
+// A compile server runs many requests in the same process, so that a failed request must not leave any global context
+// behind for the next one.
+static void compile_request(std::vector<std::string>&& args) {
+    context = std::make_unique<MainContext>();
+    context->args.reserve(args.size());
+    for (size_t i = args.size(); i-- > 0;) {
+        context->args.emplace_back(std::move(args[i]));
+    }
+
+    try {
+        arg_parse();
+        compile();
+    }
+    catch (const std::runtime_error&) {
+        FREE_ERRORS_CONTEXT;
+        FREE_FRONT_END_CONTEXT;
+        FREE_BACK_END_CONTEXT;
+        FREE_REPORT_CONTEXT;
+        FREE_STATS_CONTEXT;
+        FREE_TRACE_CONTEXT;
+        FREE_UTIL_CONTEXT;
+        context.reset();
+        throw;
+    }
+
+    context.reset();
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 int main(int argc, char** argv) {
+    if (argc == 3 && std::string(argv[1]).compare("--server") == 0) {
+        enable_memory_header_cache();
+        return run_server(argv[2], &compile_request);
+    }
+    {
+        const char* server_socket = getenv("WHEELCC_SERVER_SOCKET");
+        if (server_socket && run_client(server_socket, argc, argv)) {
+            return 0;
+        }
+    }
+
     context = std::make_unique<MainContext>();
     {
         size_t i = static_cast<size_t>(argc);
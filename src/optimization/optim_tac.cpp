@@ -4,17 +4,24 @@
 #include <unordered_set>
 #include <vector>
 
+#include "util/jobs.hpp"
+#include "util/stats.hpp"
 #include "util/str2t.hpp"
 #include "util/throw.hpp"
+#include "util/trace.hpp"
 
 #include "ast/ast.hpp"
 #include "ast/front_ast.hpp"
 #include "ast/front_symt.hpp"
 #include "ast/interm_ast.hpp"
 
+#include "frontend/intermediate/names.hpp"
+#include "frontend/intermediate/types.hpp"
+
 #include "optimization/optim_tac.hpp"
 
-static std::unique_ptr<OptimTacContext> context;
+static thread_local std::unique_ptr<OptimTacContext> context;
+static std::unique_ptr<OptimTacJobsContext> jobs_context;
 
 OptimTacContext::OptimTacContext(uint8_t optim_1_mask) :
     is_fixed_point(true),
@@ -23,7 +30,12 @@ OptimTacContext::OptimTacContext(uint8_t optim_1_mask) :
         (optim_1_mask & (static_cast<uint8_t>(1u) << 1)) > 0, // Enable copy propagation
         (optim_1_mask & (static_cast<uint8_t>(1u) << 2)) > 0, // Enable unreachable code elimination
         (optim_1_mask & (static_cast<uint8_t>(1u) << 3)) > 0, // Enable dead store elimination
-        (optim_1_mask & ~(static_cast<uint8_t>(1u) << 0)) > 0 // Optimize with control flow graph
+        (optim_1_mask & (static_cast<uint8_t>(1u) << 4)) > 0, // Enable tail call elimination
+        (optim_1_mask & (static_cast<uint8_t>(1u) << 5)) > 0, // Enable block layout
+        (optim_1_mask & (static_cast<uint8_t>(1u) << 6)) > 0, // Enable redundant load elimination
+        (optim_1_mask & ((static_cast<uint8_t>(1u) << 1) | (static_cast<uint8_t>(1u) << 2)
+                            | (static_cast<uint8_t>(1u) << 3) | (static_cast<uint8_t>(1u) << 6)))
+            > 0 // Optimize with control flow graph
     }) {}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -52,7 +64,7 @@ static void set_instruction(std::unique_ptr<TacInstruction>&& instruction, size_
 // Constant folding
 
 static std::shared_ptr<CConst> fold_constants_sign_extend_char_constant(TacVariable* node, CConstChar* constant) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Int_t: {
             TInt value = static_cast<TInt>(constant->value);
             return std::make_shared<CConstInt>(std::move(value));
@@ -76,7 +88,7 @@ static std::shared_ptr<CConst> fold_constants_sign_extend_char_constant(TacVaria
 }
 
 static std::shared_ptr<CConst> fold_constants_sign_extend_int_constant(TacVariable* node, CConstInt* constant) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Long_t:
         case AST_T::Pointer_t: {
             TLong value = static_cast<TLong>(constant->value);
@@ -117,11 +129,12 @@ static void fold_constants_sign_extend_instructions(TacSignExtend* node, size_t
             static_cast<TacVariable*>(node->dst.get()), static_cast<TacConstant*>(node->src.get())->constant.get());
         std::shared_ptr<TacValue> dst = node->dst;
         set_instruction(std::make_unique<TacCopy>(std::move(src), std::move(dst)), instruction_index);
+        INCREMENT_STATS(STATS_COUNTER::folded_instructions);
     }
 }
 
 static std::shared_ptr<CConst> fold_constants_truncate_int_constant(TacVariable* node, CConstInt* constant) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Char_t:
         case AST_T::SChar_t: {
             TChar value = static_cast<TChar>(constant->value);
@@ -137,7 +150,7 @@ static std::shared_ptr<CConst> fold_constants_truncate_int_constant(TacVariable*
 }
 
 static std::shared_ptr<CConst> fold_constants_truncate_long_constant(TacVariable* node, CConstLong* constant) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Char_t:
         case AST_T::SChar_t: {
             TChar value = static_cast<TChar>(constant->value);
@@ -161,7 +174,7 @@ static std::shared_ptr<CConst> fold_constants_truncate_long_constant(TacVariable
 }
 
 static std::shared_ptr<CConst> fold_constants_truncate_uint_constant(TacVariable* node, CConstUInt* constant) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Char_t:
         case AST_T::SChar_t: {
             TChar value = static_cast<TChar>(constant->value);
@@ -177,7 +190,7 @@ static std::shared_ptr<CConst> fold_constants_truncate_uint_constant(TacVariable
 }
 
 static std::shared_ptr<CConst> fold_constants_truncate_ulong_constant(TacVariable* node, CConstULong* constant) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Char_t:
         case AST_T::SChar_t: {
             TChar value = static_cast<TChar>(constant->value);
@@ -234,11 +247,12 @@ static void fold_constants_truncate_instructions(TacTruncate* node, size_t instr
             static_cast<TacVariable*>(node->dst.get()), static_cast<TacConstant*>(node->src.get())->constant.get());
         std::shared_ptr<TacValue> dst = node->dst;
         set_instruction(std::make_unique<TacCopy>(std::move(src), std::move(dst)), instruction_index);
+        INCREMENT_STATS(STATS_COUNTER::folded_instructions);
     }
 }
 
 static std::shared_ptr<CConst> fold_constants_zero_extend_uchar_constant(TacVariable* node, CConstUChar* constant) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Int_t: {
             TInt value = static_cast<TInt>(constant->value);
             return std::make_shared<CConstInt>(std::move(value));
@@ -262,7 +276,7 @@ static std::shared_ptr<CConst> fold_constants_zero_extend_uchar_constant(TacVari
 }
 
 static std::shared_ptr<CConst> fold_constants_zero_extend_uint_constant(TacVariable* node, CConstUInt* constant) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Long_t:
         case AST_T::Pointer_t: {
             TLong value = static_cast<TLong>(constant->value);
@@ -303,6 +317,7 @@ static void fold_constants_zero_extend_instructions(TacZeroExtend* node, size_t
             static_cast<TacVariable*>(node->dst.get()), static_cast<TacConstant*>(node->src.get())->constant.get());
         std::shared_ptr<TacValue> dst = node->dst;
         set_instruction(std::make_unique<TacCopy>(std::move(src), std::move(dst)), instruction_index);
+        INCREMENT_STATS(STATS_COUNTER::folded_instructions);
     }
 }
 
@@ -312,7 +327,7 @@ static std::shared_ptr<TacConstant> fold_constants_double_to_signed_constant_val
         RAISE_INTERNAL_ERROR;
     }
     std::shared_ptr<CConst> fold_constant;
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Char_t:
         case AST_T::SChar_t: {
             TChar value = static_cast<TChar>(static_cast<CConstDouble*>(constant)->value);
@@ -344,6 +359,7 @@ static void fold_constants_double_to_signed_instructions(TacDoubleToInt* node, s
             static_cast<TacVariable*>(node->dst.get()), static_cast<TacConstant*>(node->src.get())->constant.get());
         std::shared_ptr<TacValue> dst = node->dst;
         set_instruction(std::make_unique<TacCopy>(std::move(src), std::move(dst)), instruction_index);
+        INCREMENT_STATS(STATS_COUNTER::folded_instructions);
     }
 }
 
@@ -353,7 +369,7 @@ static std::shared_ptr<TacConstant> fold_constants_double_to_unsigned_constant_v
         RAISE_INTERNAL_ERROR;
     }
     std::shared_ptr<CConst> fold_constant;
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::UChar_t: {
             TUChar value = static_cast<TUChar>(static_cast<CConstDouble*>(constant)->value);
             fold_constant = std::make_shared<CConstUChar>(std::move(value));
@@ -384,12 +400,13 @@ static void fold_constants_double_to_unsigned_instructions(TacDoubleToUInt* node
             static_cast<TacVariable*>(node->dst.get()), static_cast<TacConstant*>(node->src.get())->constant.get());
         std::shared_ptr<TacValue> dst = node->dst;
         set_instruction(std::make_unique<TacCopy>(std::move(src), std::move(dst)), instruction_index);
+        INCREMENT_STATS(STATS_COUNTER::folded_instructions);
     }
 }
 
 static std::shared_ptr<TacConstant> fold_constants_signed_to_double_constant_value(
     TacVariable* node, CConst* constant) {
-    if (frontend->symbol_table[node->name]->type_t->type() != AST_T::Double_t) {
+    if (frontend->symbol_table.at(node->name)->type_t->type() != AST_T::Double_t) {
         RAISE_INTERNAL_ERROR;
     }
     std::shared_ptr<CConst> fold_constant;
@@ -424,12 +441,13 @@ static void fold_constants_signed_to_double_instructions(TacIntToDouble* node, s
             static_cast<TacVariable*>(node->dst.get()), static_cast<TacConstant*>(node->src.get())->constant.get());
         std::shared_ptr<TacValue> dst = node->dst;
         set_instruction(std::make_unique<TacCopy>(std::move(src), std::move(dst)), instruction_index);
+        INCREMENT_STATS(STATS_COUNTER::folded_instructions);
     }
 }
 
 static std::shared_ptr<TacConstant> fold_constants_unsigned_to_double_constant_value(
     TacVariable* node, CConst* constant) {
-    if (frontend->symbol_table[node->name]->type_t->type() != AST_T::Double_t) {
+    if (frontend->symbol_table.at(node->name)->type_t->type() != AST_T::Double_t) {
         RAISE_INTERNAL_ERROR;
     }
     std::shared_ptr<CConst> fold_constant;
@@ -464,6 +482,7 @@ static void fold_constants_unsigned_to_double_instructions(TacUIntToDouble* node
             static_cast<TacVariable*>(node->dst.get()), static_cast<TacConstant*>(node->src.get())->constant.get());
         std::shared_ptr<TacValue> dst = node->dst;
         set_instruction(std::make_unique<TacCopy>(std::move(src), std::move(dst)), instruction_index);
+        INCREMENT_STATS(STATS_COUNTER::folded_instructions);
     }
 }
 
@@ -623,6 +642,7 @@ static void fold_constants_unary_instructions(TacUnary* node, size_t instruction
             node->unary_op.get(), static_cast<TacConstant*>(node->src.get())->constant.get());
         std::shared_ptr<TacValue> dst = node->dst;
         set_instruction(std::make_unique<TacCopy>(std::move(src), std::move(dst)), instruction_index);
+        INCREMENT_STATS(STATS_COUNTER::folded_instructions);
     }
 }
 
@@ -1011,11 +1031,12 @@ static void fold_constants_binary_instructions(TacBinary* node, size_t instructi
             static_cast<TacConstant*>(node->src2.get())->constant.get());
         std::shared_ptr<TacValue> dst = node->dst;
         set_instruction(std::make_unique<TacCopy>(std::move(src), std::move(dst)), instruction_index);
+        INCREMENT_STATS(STATS_COUNTER::folded_instructions);
     }
 }
 
 static std::shared_ptr<CConst> fold_constants_copy_char_constant(TacVariable* node, CConstChar* constant) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Char_t:
         case AST_T::SChar_t:
             return nullptr;
@@ -1029,7 +1050,7 @@ static std::shared_ptr<CConst> fold_constants_copy_char_constant(TacVariable* no
 }
 
 static std::shared_ptr<CConst> fold_constants_copy_int_constant(TacVariable* node, CConstInt* constant) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Int_t:
             return nullptr;
         case AST_T::UInt_t: {
@@ -1042,7 +1063,7 @@ static std::shared_ptr<CConst> fold_constants_copy_int_constant(TacVariable* nod
 }
 
 static std::shared_ptr<CConst> fold_constants_copy_long_constant(TacVariable* node, CConstLong* constant) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Long_t:
         case AST_T::Pointer_t:
             return nullptr;
@@ -1060,7 +1081,7 @@ static std::shared_ptr<CConst> fold_constants_copy_long_constant(TacVariable* no
 }
 
 static std::shared_ptr<CConst> fold_constants_copy_double_constant(TacVariable* node, CConstDouble* constant) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Long_t: {
             TLong value = static_cast<TLong>(constant->value);
             return std::make_shared<CConstLong>(std::move(value));
@@ -1077,7 +1098,7 @@ static std::shared_ptr<CConst> fold_constants_copy_double_constant(TacVariable*
 }
 
 static std::shared_ptr<CConst> fold_constants_copy_uchar_constant(TacVariable* node, CConstUChar* constant) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Char_t:
         case AST_T::SChar_t: {
             TChar value = static_cast<TChar>(constant->value);
@@ -1091,7 +1112,7 @@ static std::shared_ptr<CConst> fold_constants_copy_uchar_constant(TacVariable* n
 }
 
 static std::shared_ptr<CConst> fold_constants_copy_uint_constant(TacVariable* node, CConstUInt* constant) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Int_t: {
             TInt value = static_cast<TInt>(constant->value);
             return std::make_shared<CConstInt>(std::move(value));
@@ -1104,7 +1125,7 @@ static std::shared_ptr<CConst> fold_constants_copy_uint_constant(TacVariable* no
 }
 
 static std::shared_ptr<CConst> fold_constants_copy_ulong_constant(TacVariable* node, CConstULong* constant) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
         case AST_T::Long_t: {
             TLong value = static_cast<TLong>(constant->value);
             return std::make_shared<CConstLong>(std::move(value));
@@ -1173,6 +1194,7 @@ static void fold_constants_copy_instructions(TacCopy* node) {
         if (src) {
             node->src = src;
             context->is_fixed_point = false;
+            INCREMENT_STATS(STATS_COUNTER::folded_copies);
         }
     }
 }
@@ -1200,6 +1222,7 @@ static bool fold_constants_is_zero_constant_value(CConst* constant) {
 
 static void fold_constants_jump_if_zero_instructions(TacJumpIfZero* node, size_t instruction_index) {
     if (node->condition->type() == AST_T::TacConstant_t) {
+        INCREMENT_STATS(STATS_COUNTER::folded_jumps);
         if (fold_constants_is_zero_constant_value(static_cast<TacConstant*>(node->condition.get())->constant.get())) {
             TIdentifier target = node->target;
             set_instruction(std::make_unique<TacJump>(std::move(target)), instruction_index);
@@ -1212,6 +1235,7 @@ static void fold_constants_jump_if_zero_instructions(TacJumpIfZero* node, size_t
 
 static void fold_constants_jump_if_not_zero_instructions(TacJumpIfNotZero* node, size_t instruction_index) {
     if (node->condition->type() == AST_T::TacConstant_t) {
+        INCREMENT_STATS(STATS_COUNTER::folded_jumps);
         if (fold_constants_is_zero_constant_value(static_cast<TacConstant*>(node->condition.get())->constant.get())) {
             set_instruction(nullptr, instruction_index);
         }
@@ -1222,6 +1246,21 @@ static void fold_constants_jump_if_not_zero_instructions(TacJumpIfNotZero* node,
     }
 }
 
+static void fold_constants_select_instructions(TacSelect* node, size_t instruction_index) {
+    if (node->condition->type() == AST_T::TacConstant_t) {
+        std::shared_ptr<TacValue> src;
+        if (fold_constants_is_zero_constant_value(static_cast<TacConstant*>(node->condition.get())->constant.get())) {
+            src = node->src_false;
+        }
+        else {
+            src = node->src_true;
+        }
+        std::shared_ptr<TacValue> dst = node->dst;
+        set_instruction(std::make_unique<TacCopy>(std::move(src), std::move(dst)), instruction_index);
+        INCREMENT_STATS(STATS_COUNTER::folded_instructions);
+    }
+}
+
 static void fold_constants_instructions(TacInstruction* node, size_t instruction_index) {
     switch (node->type()) {
         case AST_T::TacSignExtend_t:
@@ -1254,6 +1293,9 @@ static void fold_constants_instructions(TacInstruction* node, size_t instruction
         case AST_T::TacCopy_t:
             fold_constants_copy_instructions(static_cast<TacCopy*>(node));
             break;
+        case AST_T::TacSelect_t:
+            fold_constants_select_instructions(static_cast<TacSelect*>(node), instruction_index);
+            break;
         case AST_T::TacJumpIfZero_t:
             fold_constants_jump_if_zero_instructions(static_cast<TacJumpIfZero*>(node), instruction_index);
             break;
@@ -1301,6 +1343,7 @@ static void eliminate_unreachable_code_empty_block(size_t block_id) {
     }
     GET_CFG_BLOCK(block_id).size = 0;
     control_flow_graph_remove_empty_block(block_id, false);
+    INCREMENT_STATS(STATS_COUNTER::removed_unreachable_blocks);
     GET_CFG_BLOCK(block_id).successor_ids.clear();
     GET_CFG_BLOCK(block_id).predecessor_ids.clear();
 }
@@ -1312,6 +1355,7 @@ static void eliminate_unreachable_code_jump_instructions(size_t block_id) {
         case AST_T::TacJumpIfZero_t:
         case AST_T::TacJumpIfNotZero_t:
             control_flow_graph_remove_block_instruction(GET_CFG_BLOCK(block_id).instructions_back_index, block_id);
+            INCREMENT_STATS(STATS_COUNTER::removed_unreachable_jumps);
             break;
         default:
             break;
@@ -1331,6 +1375,7 @@ static void eliminate_unreachable_code_label_instructions(size_t block_id) {
         RAISE_INTERNAL_ERROR;
     }
     control_flow_graph_remove_block_instruction(GET_CFG_BLOCK(block_id).instructions_front_index, block_id);
+    INCREMENT_STATS(STATS_COUNTER::removed_unreachable_labels);
 }
 
 static void eliminate_unreachable_code_label_block(size_t block_id, size_t previous_block_id) {
@@ -1394,198 +1439,606 @@ static void eliminate_unreachable_code_control_flow_graph() {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-// Copy propagation
+// Alias analysis
+
+// Points-to sets are flow insensitive and only hold the variables whose address is taken in the function. A value
+// that is not only defined by addresses, copies, pointer additions and selects of them is unknown, as are the
+// parameters, the static variables and the variables whose address is taken. A variable escapes when its address is
+// used any other way, and an unknown pointer may then point to it, as to any static variable.
 
-static bool is_static_value(TacValue* node) {
-    return node->type() == AST_T::TacVariable_t
-           && frontend->symbol_table[static_cast<TacVariable*>(node)->name]->attrs->type() == AST_T::StaticAttr_t;
+static bool is_static_name(const TIdentifier& name) {
+    return frontend->symbol_table.at(name)->attrs->type() == AST_T::StaticAttr_t;
 }
 
-static bool is_addressed_value(TacValue* node) {
-    return node->type() == AST_T::TacVariable_t
-           && context->data_flow_analysis->alias_set.find(static_cast<TacVariable*>(node)->name)
-                  != context->data_flow_analysis->alias_set.end();
+static bool is_addressed_name(const TIdentifier& name) {
+    return context->data_flow_analysis->alias_set.find(name) != context->data_flow_analysis->alias_set.end();
 }
 
-static bool is_aliased_value(TacValue* node) { return is_static_value(node) || is_addressed_value(node); }
+static bool is_escaped_name(const TIdentifier& name) {
+    return context->data_flow_analysis->escaped_set.find(name) != context->data_flow_analysis->escaped_set.end();
+}
 
-static bool is_constant_value_signed(TacConstant* node) {
-    switch (node->constant->type()) {
-        case AST_T::CConstChar_t:
-        case AST_T::CConstInt_t:
-        case AST_T::CConstLong_t:
-            return true;
-        default:
-            return false;
+static void alias_analysis_add_points_to_value(TacValue* node) {
+    if (node->type() != AST_T::TacVariable_t) {
+        RAISE_INTERNAL_ERROR;
+    }
+    const TIdentifier& name = static_cast<TacVariable*>(node)->name;
+    if (!is_static_name(name) && !is_addressed_name(name)) {
+        context->data_flow_analysis->points_to_map[name];
     }
 }
 
-static bool is_variable_value_signed(TacVariable* node) {
-    switch (frontend->symbol_table[node->name]->type_t->type()) {
-        case AST_T::Char_t:
-        case AST_T::SChar_t:
-        case AST_T::Int_t:
-        case AST_T::Long_t:
-            return true;
-        default:
-            return false;
+static void alias_analysis_add_unknown_value(TacValue* node, std::vector<TIdentifier>& unknown_names) {
+    if (node && node->type() == AST_T::TacVariable_t) {
+        unknown_names.push_back(static_cast<TacVariable*>(node)->name);
     }
 }
 
-static bool is_value_signed(TacValue* node) {
+static void alias_analysis_add_instructions(TacInstruction* node, std::vector<TIdentifier>& unknown_names) {
     switch (node->type()) {
-        case AST_T::TacConstant_t:
-            return is_constant_value_signed(static_cast<TacConstant*>(node));
-        case AST_T::TacVariable_t:
-            return is_variable_value_signed(static_cast<TacVariable*>(node));
+        case AST_T::TacSignExtend_t:
+            alias_analysis_add_unknown_value(static_cast<TacSignExtend*>(node)->dst.get(), unknown_names);
+            break;
+        case AST_T::TacTruncate_t:
+            alias_analysis_add_unknown_value(static_cast<TacTruncate*>(node)->dst.get(), unknown_names);
+            break;
+        case AST_T::TacZeroExtend_t:
+            alias_analysis_add_unknown_value(static_cast<TacZeroExtend*>(node)->dst.get(), unknown_names);
+            break;
+        case AST_T::TacDoubleToInt_t:
+            alias_analysis_add_unknown_value(static_cast<TacDoubleToInt*>(node)->dst.get(), unknown_names);
+            break;
+        case AST_T::TacDoubleToUInt_t:
+            alias_analysis_add_unknown_value(static_cast<TacDoubleToUInt*>(node)->dst.get(), unknown_names);
+            break;
+        case AST_T::TacIntToDouble_t:
+            alias_analysis_add_unknown_value(static_cast<TacIntToDouble*>(node)->dst.get(), unknown_names);
+            break;
+        case AST_T::TacUIntToDouble_t:
+            alias_analysis_add_unknown_value(static_cast<TacUIntToDouble*>(node)->dst.get(), unknown_names);
+            break;
+        case AST_T::TacFunCall_t:
+            alias_analysis_add_unknown_value(static_cast<TacFunCall*>(node)->dst.get(), unknown_names);
+            break;
+        case AST_T::TacUnary_t:
+            alias_analysis_add_unknown_value(static_cast<TacUnary*>(node)->dst.get(), unknown_names);
+            break;
+        case AST_T::TacBinary_t:
+            alias_analysis_add_unknown_value(static_cast<TacBinary*>(node)->dst.get(), unknown_names);
+            break;
+        case AST_T::TacCopy_t:
+            alias_analysis_add_points_to_value(static_cast<TacCopy*>(node)->dst.get());
+            break;
+        case AST_T::TacSelect_t:
+            alias_analysis_add_points_to_value(static_cast<TacSelect*>(node)->dst.get());
+            break;
+        case AST_T::TacGetAddress_t:
+            alias_analysis_add_points_to_value(static_cast<TacGetAddress*>(node)->dst.get());
+            break;
+        case AST_T::TacLoad_t:
+            alias_analysis_add_unknown_value(static_cast<TacLoad*>(node)->dst.get(), unknown_names);
+            break;
+        case AST_T::TacAddPtr_t:
+            alias_analysis_add_points_to_value(static_cast<TacAddPtr*>(node)->dst.get());
+            break;
+        case AST_T::TacCopyFromOffset_t:
+            alias_analysis_add_unknown_value(static_cast<TacCopyFromOffset*>(node)->dst.get(), unknown_names);
+            break;
         default:
-            RAISE_INTERNAL_ERROR;
+            break;
     }
 }
 
-static bool is_constant_null_pointer(TacConstant* node) {
-    switch (node->constant->type()) {
-        case AST_T::CConstInt_t:
-            return static_cast<CConstInt*>(node->constant.get())->value == 0;
-        case AST_T::CConstLong_t:
-            return static_cast<CConstLong*>(node->constant.get())->value == 0l;
-        case AST_T::CConstUInt_t:
-            return static_cast<CConstUInt*>(node->constant.get())->value == 0u;
-        case AST_T::CConstULong_t:
-            return static_cast<CConstULong*>(node->constant.get())->value == 0ul;
-        default:
-            return false;
+static std::unordered_set<TIdentifier>* get_alias_points_to_set(TacValue* node) {
+    if (node->type() == AST_T::TacVariable_t) {
+        auto points_to = context->data_flow_analysis->points_to_map.find(static_cast<TacVariable*>(node)->name);
+        if (points_to != context->data_flow_analysis->points_to_map.end()) {
+            return &points_to->second;
+        }
     }
+    return nullptr;
 }
 
-static bool is_double_constant_same_value(CConstDouble* constant_1, CConstDouble* constant_2) {
-    if (constant_1->value == constant_2->value) {
-        if (constant_1->value != 0.0) {
-            return true;
+// Returns false if the source is unknown, in which case the destination becomes unknown too.
+static bool alias_analysis_transfer_points_to_value(
+    TacValue* node, std::unordered_set<TIdentifier>& points_to_set, bool& is_changed) {
+    if (node->type() == AST_T::TacVariable_t) {
+        std::unordered_set<TIdentifier>* src_set = get_alias_points_to_set(node);
+        if (!src_set) {
+            return false;
         }
-        else {
-            return double_to_binary(constant_1->value) == double_to_binary(constant_2->value);
+        else if (src_set != &points_to_set) {
+            size_t size = points_to_set.size();
+            points_to_set.insert(src_set->begin(), src_set->end());
+            if (points_to_set.size() > size) {
+                is_changed = true;
+            }
         }
     }
-    else if (constant_1->value != constant_1->value && constant_2->value != constant_2->value) {
-        return true;
-    }
-    else {
-        return false;
-    }
+    return true;
 }
 
-static bool is_constant_same_value(TacConstant* node_1, TacConstant* node_2) {
-    if (node_1->constant->type() == node_2->constant->type()) {
-        switch (node_1->constant->type()) {
-            case AST_T::CConstChar_t:
-                return static_cast<CConstChar*>(node_1->constant.get())->value
-                       == static_cast<CConstChar*>(node_2->constant.get())->value;
-            case AST_T::CConstInt_t:
-                return static_cast<CConstInt*>(node_1->constant.get())->value
-                       == static_cast<CConstInt*>(node_2->constant.get())->value;
-            case AST_T::CConstLong_t:
-                return static_cast<CConstLong*>(node_1->constant.get())->value
-                       == static_cast<CConstLong*>(node_2->constant.get())->value;
-            case AST_T::CConstDouble_t:
-                return is_double_constant_same_value(static_cast<CConstDouble*>(node_1->constant.get()),
-                    static_cast<CConstDouble*>(node_2->constant.get()));
-            case AST_T::CConstUChar_t:
-                return static_cast<CConstUChar*>(node_1->constant.get())->value
-                       == static_cast<CConstUChar*>(node_2->constant.get())->value;
-            case AST_T::CConstUInt_t:
-                return static_cast<CConstUInt*>(node_1->constant.get())->value
-                       == static_cast<CConstUInt*>(node_2->constant.get())->value;
-            case AST_T::CConstULong_t:
-                return static_cast<CConstULong*>(node_1->constant.get())->value
-                       == static_cast<CConstULong*>(node_2->constant.get())->value;
-            default:
+static void alias_analysis_transfer_instructions(TacInstruction* node, bool& is_changed) {
+    TacValue* dst;
+    switch (node->type()) {
+        case AST_T::TacCopy_t:
+            dst = static_cast<TacCopy*>(node)->dst.get();
+            break;
+        case AST_T::TacSelect_t:
+            dst = static_cast<TacSelect*>(node)->dst.get();
+            break;
+        case AST_T::TacGetAddress_t:
+            dst = static_cast<TacGetAddress*>(node)->dst.get();
+            break;
+        case AST_T::TacAddPtr_t:
+            dst = static_cast<TacAddPtr*>(node)->dst.get();
+            break;
+        default:
+            return;
+    }
+    std::unordered_set<TIdentifier>* points_to_set = get_alias_points_to_set(dst);
+    if (!points_to_set) {
+        return;
+    }
+    bool is_known = true;
+    switch (node->type()) {
+        case AST_T::TacCopy_t:
+            is_known = alias_analysis_transfer_points_to_value(
+                static_cast<TacCopy*>(node)->src.get(), *points_to_set, is_changed);
+            break;
+        case AST_T::TacSelect_t: {
+            TacSelect* p_node = static_cast<TacSelect*>(node);
+            is_known = alias_analysis_transfer_points_to_value(p_node->src_true.get(), *points_to_set, is_changed)
+                       && alias_analysis_transfer_points_to_value(
+                           p_node->src_false.get(), *points_to_set, is_changed);
+            break;
+        }
+        case AST_T::TacGetAddress_t: {
+            TacValue* src = static_cast<TacGetAddress*>(node)->src.get();
+            if (src->type() != AST_T::TacVariable_t) {
                 RAISE_INTERNAL_ERROR;
+            }
+            if (points_to_set->insert(static_cast<TacVariable*>(src)->name).second) {
+                is_changed = true;
+            }
+            break;
         }
+        case AST_T::TacAddPtr_t:
+            is_known = alias_analysis_transfer_points_to_value(
+                static_cast<TacAddPtr*>(node)->src_ptr.get(), *points_to_set, is_changed);
+            break;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+    if (!is_known) {
+        context->data_flow_analysis->points_to_map.erase(static_cast<TacVariable*>(dst)->name);
+        is_changed = true;
     }
-    return false;
-}
-
-static bool is_variable_same_value(TacVariable* node_1, TacVariable* node_2) {
-    return node_1->name.compare(node_2->name) == 0;
 }
 
-static bool is_same_value(TacValue* node_1, TacValue* node_2) {
-    if (node_1->type() == node_2->type()) {
-        switch (node_1->type()) {
-            case AST_T::TacConstant_t:
-                return is_constant_same_value(static_cast<TacConstant*>(node_1), static_cast<TacConstant*>(node_2));
-            case AST_T::TacVariable_t:
-                return is_variable_same_value(static_cast<TacVariable*>(node_1), static_cast<TacVariable*>(node_2));
-            default:
-                RAISE_INTERNAL_ERROR;
+static void alias_analysis_escape_value(TacValue* node) {
+    if (node) {
+        std::unordered_set<TIdentifier>* points_to_set = get_alias_points_to_set(node);
+        if (points_to_set) {
+            context->data_flow_analysis->escaped_set.insert(points_to_set->begin(), points_to_set->end());
         }
     }
-    return false;
 }
 
-static bool is_name_same_value(TacValue* node, const TIdentifier& name) {
+static bool is_alias_compare_binary_op(TacBinaryOp* node) {
     switch (node->type()) {
-        case AST_T::TacConstant_t:
-            return false;
-        case AST_T::TacVariable_t:
-            return static_cast<TacVariable*>(node)->name.compare(name) == 0;
+        case AST_T::TacEqual_t:
+        case AST_T::TacNotEqual_t:
+        case AST_T::TacLessThan_t:
+        case AST_T::TacLessOrEqual_t:
+        case AST_T::TacGreaterThan_t:
+        case AST_T::TacGreaterOrEqual_t:
+            return true;
         default:
-            RAISE_INTERNAL_ERROR;
-    }
-}
-
-static bool is_copy_signedness(TacCopy* node) {
-    return is_value_signed(node->src.get()) == is_value_signed(node->dst.get());
-}
-
-static bool is_copy_null_pointer(TacCopy* node) {
-    if (node->src->type() == AST_T::TacConstant_t && node->dst->type() == AST_T::TacVariable_t
-        && frontend->symbol_table[static_cast<TacVariable*>(node->dst.get())->name]->type_t->type()
-               == AST_T::Pointer_t) {
-        return is_constant_null_pointer(static_cast<TacConstant*>(node->src.get()));
-    }
-    else {
-        return false;
+            return false;
     }
 }
 
-static void copy_propagation_transfer_dst_value_reaching_copies(TacValue* node, size_t next_instruction_index) {
-    if (node->type() != AST_T::TacVariable_t) {
-        RAISE_INTERNAL_ERROR;
-    }
-    size_t i = 0;
-    for (size_t j = 0; j < context->data_flow_analysis->mask_size; ++j) {
-        if (GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, j) == MASK_FALSE) {
-            i += 64;
-            continue;
+// Addresses are not escaped by loads, stores and comparisons through them, nor by the definitions that keep their
+// destination known.
+static void alias_analysis_escape_instructions(TacInstruction* node) {
+    switch (node->type()) {
+        case AST_T::TacReturn_t:
+            alias_analysis_escape_value(static_cast<TacReturn*>(node)->val.get());
+            break;
+        case AST_T::TacSignExtend_t:
+            alias_analysis_escape_value(static_cast<TacSignExtend*>(node)->src.get());
+            break;
+        case AST_T::TacTruncate_t:
+            alias_analysis_escape_value(static_cast<TacTruncate*>(node)->src.get());
+            break;
+        case AST_T::TacZeroExtend_t:
+            alias_analysis_escape_value(static_cast<TacZeroExtend*>(node)->src.get());
+            break;
+        case AST_T::TacIntToDouble_t:
+            alias_analysis_escape_value(static_cast<TacIntToDouble*>(node)->src.get());
+            break;
+        case AST_T::TacUIntToDouble_t:
+            alias_analysis_escape_value(static_cast<TacUIntToDouble*>(node)->src.get());
+            break;
+        case AST_T::TacFunCall_t:
+            for (const auto& arg : static_cast<TacFunCall*>(node)->args) {
+                alias_analysis_escape_value(arg.get());
+            }
+            break;
+        case AST_T::TacUnary_t:
+            alias_analysis_escape_value(static_cast<TacUnary*>(node)->src.get());
+            break;
+        case AST_T::TacBinary_t: {
+            TacBinary* p_node = static_cast<TacBinary*>(node);
+            if (!is_alias_compare_binary_op(p_node->binary_op.get())) {
+                alias_analysis_escape_value(p_node->src1.get());
+                alias_analysis_escape_value(p_node->src2.get());
+            }
+            break;
         }
-        size_t mask_set_size = i + 64;
-        if (mask_set_size > context->data_flow_analysis->set_size) {
-            mask_set_size = context->data_flow_analysis->set_size;
+        case AST_T::TacCopy_t: {
+            TacCopy* p_node = static_cast<TacCopy*>(node);
+            if (!get_alias_points_to_set(p_node->dst.get())) {
+                alias_analysis_escape_value(p_node->src.get());
+            }
+            break;
         }
-        for (; i < mask_set_size; ++i) {
-            if (GET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i)) {
-                if (GET_DFA_INSTRUCTION(i)->type() != AST_T::TacCopy_t) {
-                    RAISE_INTERNAL_ERROR;
-                }
-                TacCopy* copy = static_cast<TacCopy*>(GET_DFA_INSTRUCTION(i).get());
-                if (copy->dst->type() != AST_T::TacVariable_t) {
+        case AST_T::TacSelect_t: {
+            TacSelect* p_node = static_cast<TacSelect*>(node);
+            if (!get_alias_points_to_set(p_node->dst.get())) {
+                alias_analysis_escape_value(p_node->src_true.get());
+                alias_analysis_escape_value(p_node->src_false.get());
+            }
+            break;
+        }
+        case AST_T::TacGetAddress_t: {
+            TacGetAddress* p_node = static_cast<TacGetAddress*>(node);
+            if (!get_alias_points_to_set(p_node->dst.get())) {
+                if (p_node->src->type() != AST_T::TacVariable_t) {
                     RAISE_INTERNAL_ERROR;
                 }
-                else if (is_same_value(node, copy->src.get()) || is_same_value(node, copy->dst.get())) {
-                    SET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i, false);
-                    if (GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, j) == MASK_FALSE) {
-                        i = mask_set_size;
-                    }
-                }
+                context->data_flow_analysis->escaped_set.insert(static_cast<TacVariable*>(p_node->src.get())->name);
+            }
+            break;
+        }
+        case AST_T::TacStore_t:
+            alias_analysis_escape_value(static_cast<TacStore*>(node)->src.get());
+            break;
+        case AST_T::TacAddPtr_t: {
+            TacAddPtr* p_node = static_cast<TacAddPtr*>(node);
+            if (!get_alias_points_to_set(p_node->dst.get())) {
+                alias_analysis_escape_value(p_node->src_ptr.get());
             }
+            alias_analysis_escape_value(p_node->index.get());
+            break;
         }
+        case AST_T::TacCopyToOffset_t:
+            alias_analysis_escape_value(static_cast<TacCopyToOffset*>(node)->src.get());
+            break;
+        default:
+            break;
     }
 }
 
-static void copy_propagation_transfer_fun_call_reaching_copies(TacFunCall* node, size_t next_instruction_index) {
-    if (node->dst && node->dst->type() != AST_T::TacVariable_t) {
+static void alias_analysis_initialize() {
+    context->data_flow_analysis->escaped_set.clear();
+    context->data_flow_analysis->points_to_map.clear();
+    if (context->data_flow_analysis->alias_set.empty()) {
+        return;
+    }
+    {
+        std::vector<TIdentifier> unknown_names;
+        for (const auto& instruction : *context->p_instructions) {
+            if (instruction) {
+                alias_analysis_add_instructions(instruction.get(), unknown_names);
+            }
+        }
+        for (const auto& name : unknown_names) {
+            context->data_flow_analysis->points_to_map.erase(name);
+        }
+    }
+    bool is_changed;
+    do {
+        is_changed = false;
+        for (const auto& instruction : *context->p_instructions) {
+            if (instruction) {
+                alias_analysis_transfer_instructions(instruction.get(), is_changed);
+            }
+        }
+    }
+    while (is_changed);
+    for (const auto& instruction : *context->p_instructions) {
+        if (instruction) {
+            alias_analysis_escape_instructions(instruction.get());
+        }
+    }
+}
+
+static bool is_alias_char_type(Type* type) {
+    switch (type->type()) {
+        case AST_T::Char_t:
+        case AST_T::SChar_t:
+        case AST_T::UChar_t:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool is_alias_aggregate_type(Type* type) {
+    return type->type() == AST_T::Array_t || type->type() == AST_T::Structure_t;
+}
+
+// Type based aliasing only tells apart the scalars of different sizes, and doubles from integers and pointers, as
+// signed and unsigned variants may alias, and characters and aggregates may alias anything.
+static bool is_alias_type_compatible(Type* access_type, Type* var_type) {
+    if (is_alias_char_type(access_type) || is_alias_aggregate_type(access_type)
+        || is_alias_char_type(var_type) || is_alias_aggregate_type(var_type)) {
+        return true;
+    }
+    return get_type_scale(access_type) == get_type_scale(var_type)
+           && (access_type->type() == AST_T::Double_t) == (var_type->type() == AST_T::Double_t);
+}
+
+static std::shared_ptr<Type> get_alias_constant_type(CConst* node) {
+    switch (node->type()) {
+        case AST_T::CConstChar_t:
+            return intern_scalar_type(AST_T::Char_t);
+        case AST_T::CConstInt_t:
+            return intern_scalar_type(AST_T::Int_t);
+        case AST_T::CConstLong_t:
+            return intern_scalar_type(AST_T::Long_t);
+        case AST_T::CConstDouble_t:
+            return intern_scalar_type(AST_T::Double_t);
+        case AST_T::CConstUChar_t:
+            return intern_scalar_type(AST_T::UChar_t);
+        case AST_T::CConstUInt_t:
+            return intern_scalar_type(AST_T::UInt_t);
+        case AST_T::CConstULong_t:
+            return intern_scalar_type(AST_T::ULong_t);
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+static std::shared_ptr<Type> get_alias_value_type(TacValue* node) {
+    switch (node->type()) {
+        case AST_T::TacConstant_t:
+            return get_alias_constant_type(static_cast<TacConstant*>(node)->constant.get());
+        case AST_T::TacVariable_t:
+            return frontend->symbol_table.at(static_cast<TacVariable*>(node)->name)->type_t;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+// May a load or a store through the pointer access the variable. The access is typed by the value that is loaded or
+// stored, as copy propagation can replace the pointer with one of another type.
+static bool is_alias_accessed_name(TacValue* node, TacValue* access_value, const TIdentifier& name) {
+    bool is_static = is_static_name(name);
+    if (!is_static && !is_addressed_name(name)) {
+        return false;
+    }
+    std::unordered_set<TIdentifier>* points_to_set = get_alias_points_to_set(node);
+    if (points_to_set) {
+        if (points_to_set->find(name) == points_to_set->end()) {
+            return false;
+        }
+    }
+    else if (!is_static && !is_escaped_name(name)) {
+        return false;
+    }
+    return is_alias_type_compatible(
+        get_alias_value_type(access_value).get(), frontend->symbol_table.at(name)->type_t.get());
+}
+
+static bool is_alias_accessed_value(TacValue* node, TacValue* access_value, TacValue* value) {
+    return value->type() == AST_T::TacVariable_t
+           && is_alias_accessed_name(node, access_value, static_cast<TacVariable*>(value)->name);
+}
+
+// May a function call access the variable.
+static bool is_alias_called_value(TacValue* node) {
+    if (node->type() == AST_T::TacVariable_t) {
+        const TIdentifier& name = static_cast<TacVariable*>(node)->name;
+        return is_static_name(name) || is_escaped_name(name);
+    }
+    return false;
+}
+
+static bool is_alias_called_points_to_set(std::unordered_set<TIdentifier>* points_to_set) {
+    for (const auto& name : *points_to_set) {
+        if (is_static_name(name) || is_escaped_name(name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// May a function call access the memory the pointer points to. An unknown pointer may point to any memory.
+static bool is_alias_called_pointer(TacValue* node) {
+    std::unordered_set<TIdentifier>* points_to_set = get_alias_points_to_set(node);
+    return !points_to_set || is_alias_called_points_to_set(points_to_set);
+}
+
+// May accesses through two pointers overlap. A known pointer only overlaps an unknown one through the static and
+// escaped variables it may point to.
+static bool is_alias_accessed_pointer(
+    TacValue* node_1, TacValue* access_value_1, TacValue* node_2, TacValue* access_value_2) {
+    if (is_same_value(node_1, node_2)) {
+        return true;
+    }
+    else if (!is_alias_type_compatible(
+                 get_alias_value_type(access_value_1).get(), get_alias_value_type(access_value_2).get())) {
+        return false;
+    }
+    std::unordered_set<TIdentifier>* points_to_set_1 = get_alias_points_to_set(node_1);
+    std::unordered_set<TIdentifier>* points_to_set_2 = get_alias_points_to_set(node_2);
+    if (points_to_set_1 && points_to_set_2) {
+        for (const auto& name : *points_to_set_1) {
+            if (points_to_set_2->find(name) != points_to_set_2->end()) {
+                return true;
+            }
+        }
+        return false;
+    }
+    else if (points_to_set_1) {
+        return is_alias_called_points_to_set(points_to_set_1);
+    }
+    else if (points_to_set_2) {
+        return is_alias_called_points_to_set(points_to_set_2);
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Copy propagation
+
+static bool is_constant_value_signed(TacConstant* node) {
+    switch (node->constant->type()) {
+        case AST_T::CConstChar_t:
+        case AST_T::CConstInt_t:
+        case AST_T::CConstLong_t:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool is_variable_value_signed(TacVariable* node) {
+    switch (frontend->symbol_table.at(node->name)->type_t->type()) {
+        case AST_T::Char_t:
+        case AST_T::SChar_t:
+        case AST_T::Int_t:
+        case AST_T::Long_t:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool is_value_signed(TacValue* node) {
+    switch (node->type()) {
+        case AST_T::TacConstant_t:
+            return is_constant_value_signed(static_cast<TacConstant*>(node));
+        case AST_T::TacVariable_t:
+            return is_variable_value_signed(static_cast<TacVariable*>(node));
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+static bool is_constant_null_pointer(TacConstant* node) {
+    switch (node->constant->type()) {
+        case AST_T::CConstInt_t:
+            return static_cast<CConstInt*>(node->constant.get())->value == 0;
+        case AST_T::CConstLong_t:
+            return static_cast<CConstLong*>(node->constant.get())->value == 0l;
+        case AST_T::CConstUInt_t:
+            return static_cast<CConstUInt*>(node->constant.get())->value == 0u;
+        case AST_T::CConstULong_t:
+            return static_cast<CConstULong*>(node->constant.get())->value == 0ul;
+        default:
+            return false;
+    }
+}
+
+static bool is_double_constant_same_value(CConstDouble* constant_1, CConstDouble* constant_2) {
+    if (constant_1->value == constant_2->value) {
+        if (constant_1->value != 0.0) {
+            return true;
+        }
+        else {
+            return double_to_binary(constant_1->value) == double_to_binary(constant_2->value);
+        }
+    }
+    else if (constant_1->value != constant_1->value && constant_2->value != constant_2->value) {
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+static bool is_constant_same_value(TacConstant* node_1, TacConstant* node_2) {
+    if (node_1->constant->type() == node_2->constant->type()) {
+        switch (node_1->constant->type()) {
+            case AST_T::CConstChar_t:
+                return static_cast<CConstChar*>(node_1->constant.get())->value
+                       == static_cast<CConstChar*>(node_2->constant.get())->value;
+            case AST_T::CConstInt_t:
+                return static_cast<CConstInt*>(node_1->constant.get())->value
+                       == static_cast<CConstInt*>(node_2->constant.get())->value;
+            case AST_T::CConstLong_t:
+                return static_cast<CConstLong*>(node_1->constant.get())->value
+                       == static_cast<CConstLong*>(node_2->constant.get())->value;
+            case AST_T::CConstDouble_t:
+                return is_double_constant_same_value(static_cast<CConstDouble*>(node_1->constant.get()),
+                    static_cast<CConstDouble*>(node_2->constant.get()));
+            case AST_T::CConstUChar_t:
+                return static_cast<CConstUChar*>(node_1->constant.get())->value
+                       == static_cast<CConstUChar*>(node_2->constant.get())->value;
+            case AST_T::CConstUInt_t:
+                return static_cast<CConstUInt*>(node_1->constant.get())->value
+                       == static_cast<CConstUInt*>(node_2->constant.get())->value;
+            case AST_T::CConstULong_t:
+                return static_cast<CConstULong*>(node_1->constant.get())->value
+                       == static_cast<CConstULong*>(node_2->constant.get())->value;
+            default:
+                RAISE_INTERNAL_ERROR;
+        }
+    }
+    return false;
+}
+
+static bool is_variable_same_value(TacVariable* node_1, TacVariable* node_2) {
+    return node_1->name.compare(node_2->name) == 0;
+}
+
+static bool is_same_value(TacValue* node_1, TacValue* node_2) {
+    if (node_1->type() == node_2->type()) {
+        switch (node_1->type()) {
+            case AST_T::TacConstant_t:
+                return is_constant_same_value(static_cast<TacConstant*>(node_1), static_cast<TacConstant*>(node_2));
+            case AST_T::TacVariable_t:
+                return is_variable_same_value(static_cast<TacVariable*>(node_1), static_cast<TacVariable*>(node_2));
+            default:
+                RAISE_INTERNAL_ERROR;
+        }
+    }
+    return false;
+}
+
+static bool is_name_same_value(TacValue* node, const TIdentifier& name) {
+    switch (node->type()) {
+        case AST_T::TacConstant_t:
+            return false;
+        case AST_T::TacVariable_t:
+            return static_cast<TacVariable*>(node)->name.compare(name) == 0;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+static bool is_copy_signedness(TacCopy* node) {
+    return is_value_signed(node->src.get()) == is_value_signed(node->dst.get());
+}
+
+static bool is_copy_null_pointer(TacCopy* node) {
+    if (node->src->type() == AST_T::TacConstant_t && node->dst->type() == AST_T::TacVariable_t
+        && frontend->symbol_table.at(static_cast<TacVariable*>(node->dst.get())->name)->type_t->type()
+               == AST_T::Pointer_t) {
+        return is_constant_null_pointer(static_cast<TacConstant*>(node->src.get()));
+    }
+    else {
+        return false;
+    }
+}
+
+static void copy_propagation_transfer_dst_value_reaching_copies(TacValue* node, size_t next_instruction_index) {
+    if (node->type() != AST_T::TacVariable_t) {
         RAISE_INTERNAL_ERROR;
     }
     size_t i = 0;
@@ -1607,13 +2060,10 @@ static void copy_propagation_transfer_fun_call_reaching_copies(TacFunCall* node,
                 if (copy->dst->type() != AST_T::TacVariable_t) {
                     RAISE_INTERNAL_ERROR;
                 }
-                else if (is_aliased_value(copy->src.get()) || is_aliased_value(copy->dst.get())
-                         || (node->dst
-                             && (is_same_value(node->dst.get(), copy->src.get())
-                                 || is_same_value(node->dst.get(), copy->dst.get())))) {
+                else if (is_same_value(node, copy->src.get()) || is_same_value(node, copy->dst.get())) {
                     SET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i, false);
                     if (GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, j) == MASK_FALSE) {
-                        i = mask_set_size;
+                        i = mask_set_size - 1;
                     }
                 }
             }
@@ -1621,20 +2071,57 @@ static void copy_propagation_transfer_fun_call_reaching_copies(TacFunCall* node,
     }
 }
 
-static bool copy_propagation_transfer_copy_reaching_copies(TacCopy* node, size_t next_instruction_index) {
-    if (node->dst->type() != AST_T::TacVariable_t) {
+static void copy_propagation_transfer_fun_call_reaching_copies(TacFunCall* node, size_t next_instruction_index) {
+    if (node->dst && node->dst->type() != AST_T::TacVariable_t) {
         RAISE_INTERNAL_ERROR;
     }
-    for (size_t i = 0; i < context->data_flow_analysis->set_size; ++i) {
-        if (GET_DFA_INSTRUCTION(i)->type() != AST_T::TacCopy_t) {
-            RAISE_INTERNAL_ERROR;
+    size_t i = 0;
+    for (size_t j = 0; j < context->data_flow_analysis->mask_size; ++j) {
+        if (GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, j) == MASK_FALSE) {
+            i += 64;
+            continue;
         }
-        TacCopy* copy = static_cast<TacCopy*>(GET_DFA_INSTRUCTION(i).get());
-        if (copy->dst->type() != AST_T::TacVariable_t) {
-            RAISE_INTERNAL_ERROR;
+        size_t mask_set_size = i + 64;
+        if (mask_set_size > context->data_flow_analysis->set_size) {
+            mask_set_size = context->data_flow_analysis->set_size;
         }
-        else if (is_same_value(node->dst.get(), copy->dst.get())) {
-            if ((is_copy_signedness(copy) || is_copy_null_pointer(copy))
+        for (; i < mask_set_size; ++i) {
+            if (GET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i)) {
+                if (GET_DFA_INSTRUCTION(i)->type() != AST_T::TacCopy_t) {
+                    RAISE_INTERNAL_ERROR;
+                }
+                TacCopy* copy = static_cast<TacCopy*>(GET_DFA_INSTRUCTION(i).get());
+                if (copy->dst->type() != AST_T::TacVariable_t) {
+                    RAISE_INTERNAL_ERROR;
+                }
+                else if (is_alias_called_value(copy->src.get()) || is_alias_called_value(copy->dst.get())
+                         || (node->dst
+                             && (is_same_value(node->dst.get(), copy->src.get())
+                                 || is_same_value(node->dst.get(), copy->dst.get())))) {
+                    SET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i, false);
+                    if (GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, j) == MASK_FALSE) {
+                        i = mask_set_size - 1;
+                    }
+                }
+            }
+        }
+    }
+}
+
+static bool copy_propagation_transfer_copy_reaching_copies(TacCopy* node, size_t next_instruction_index) {
+    if (node->dst->type() != AST_T::TacVariable_t) {
+        RAISE_INTERNAL_ERROR;
+    }
+    for (size_t i = 0; i < context->data_flow_analysis->set_size; ++i) {
+        if (GET_DFA_INSTRUCTION(i)->type() != AST_T::TacCopy_t) {
+            RAISE_INTERNAL_ERROR;
+        }
+        TacCopy* copy = static_cast<TacCopy*>(GET_DFA_INSTRUCTION(i).get());
+        if (copy->dst->type() != AST_T::TacVariable_t) {
+            RAISE_INTERNAL_ERROR;
+        }
+        else if (is_same_value(node->dst.get(), copy->dst.get())) {
+            if ((is_copy_signedness(copy) || is_copy_null_pointer(copy))
                 && is_same_value(node->src.get(), copy->src.get())) {
                 SET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i, true);
             }
@@ -1656,7 +2143,7 @@ static bool copy_propagation_transfer_copy_reaching_copies(TacCopy* node, size_t
     return true;
 }
 
-static void copy_propagation_transfer_store_reaching_copies(size_t next_instruction_index) {
+static void copy_propagation_transfer_store_reaching_copies(TacStore* node, size_t next_instruction_index) {
     size_t i = 0;
     for (size_t j = 0; j < context->data_flow_analysis->mask_size; ++j) {
         if (GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, j) == MASK_FALSE) {
@@ -1676,10 +2163,11 @@ static void copy_propagation_transfer_store_reaching_copies(size_t next_instruct
                 if (copy->dst->type() != AST_T::TacVariable_t) {
                     RAISE_INTERNAL_ERROR;
                 }
-                else if (is_aliased_value(copy->src.get()) || is_aliased_value(copy->dst.get())) {
+                else if (is_alias_accessed_value(node->dst_ptr.get(), node->src.get(), copy->src.get())
+                         || is_alias_accessed_value(node->dst_ptr.get(), node->src.get(), copy->dst.get())) {
                     SET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i, false);
                     if (GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, j) == MASK_FALSE) {
-                        i = mask_set_size;
+                        i = mask_set_size - 1;
                     }
                 }
             }
@@ -1712,7 +2200,7 @@ static void copy_propagation_transfer_copy_to_offset_reaching_copies(
                          || is_name_same_value(copy->dst.get(), node->dst_name)) {
                     SET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i, false);
                     if (GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, j) == MASK_FALSE) {
-                        i = mask_set_size;
+                        i = mask_set_size - 1;
                     }
                 }
             }
@@ -1763,6 +2251,10 @@ static bool copy_propagation_transfer_reaching_copies(TacInstruction* node, size
             break;
         case AST_T::TacCopy_t:
             return copy_propagation_transfer_copy_reaching_copies(static_cast<TacCopy*>(node), next_instruction_index);
+        case AST_T::TacSelect_t:
+            copy_propagation_transfer_dst_value_reaching_copies(
+                static_cast<TacSelect*>(node)->dst.get(), next_instruction_index);
+            break;
         case AST_T::TacGetAddress_t:
             copy_propagation_transfer_dst_value_reaching_copies(
                 static_cast<TacGetAddress*>(node)->dst.get(), next_instruction_index);
@@ -1772,7 +2264,7 @@ static bool copy_propagation_transfer_reaching_copies(TacInstruction* node, size
                 static_cast<TacLoad*>(node)->dst.get(), next_instruction_index);
             break;
         case AST_T::TacStore_t:
-            copy_propagation_transfer_store_reaching_copies(next_instruction_index);
+            copy_propagation_transfer_store_reaching_copies(static_cast<TacStore*>(node), next_instruction_index);
             break;
         case AST_T::TacAddPtr_t:
             copy_propagation_transfer_dst_value_reaching_copies(
@@ -1832,6 +2324,7 @@ static void propagate_copies_return_instructions(TacReturn* node, size_t incomin
                     else if (is_same_value(node->val.get(), copy->dst.get())) {
                         node->val = copy->src;
                         context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                         return;
                     }
                 }
@@ -1861,6 +2354,7 @@ static void propagate_copies_sign_extend_instructions(TacSignExtend* node, size_
                     else if (is_same_value(node->src.get(), copy->dst.get())) {
                         node->src = copy->src;
                         context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                         return;
                     }
                 }
@@ -1890,6 +2384,7 @@ static void propagate_copies_truncate_instructions(TacTruncate* node, size_t ins
                     else if (is_same_value(node->src.get(), copy->dst.get())) {
                         node->src = copy->src;
                         context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                         return;
                     }
                 }
@@ -1919,6 +2414,7 @@ static void propagate_copies_zero_extend_instructions(TacZeroExtend* node, size_
                     else if (is_same_value(node->src.get(), copy->dst.get())) {
                         node->src = copy->src;
                         context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                         return;
                     }
                 }
@@ -1948,6 +2444,7 @@ static void propagate_copies_double_to_int_instructions(TacDoubleToInt* node, si
                     else if (is_same_value(node->src.get(), copy->dst.get())) {
                         node->src = copy->src;
                         context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                         return;
                     }
                 }
@@ -1977,6 +2474,7 @@ static void propagate_copies_double_to_uint_instructions(TacDoubleToUInt* node,
                     else if (is_same_value(node->src.get(), copy->dst.get())) {
                         node->src = copy->src;
                         context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                         return;
                     }
                 }
@@ -2006,6 +2504,7 @@ static void propagate_copies_int_to_double_instructions(TacIntToDouble* node, si
                     else if (is_same_value(node->src.get(), copy->dst.get())) {
                         node->src = copy->src;
                         context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                         return;
                     }
                 }
@@ -2035,6 +2534,7 @@ static void propagate_copies_uint_to_double_instructions(TacUIntToDouble* node,
                     else if (is_same_value(node->src.get(), copy->dst.get())) {
                         node->src = copy->src;
                         context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                         return;
                     }
                 }
@@ -2065,6 +2565,7 @@ static void propagate_copies_fun_call_instructions(TacFunCall* node, size_t inst
                         else if (is_same_value(node->args[i].get(), copy->dst.get())) {
                             node->args[i] = copy->src;
                             context->is_fixed_point = false;
+                            INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                             goto Lbreak;
                         }
                     }
@@ -2096,6 +2597,7 @@ static void propagate_copies_unary_instructions(TacUnary* node, size_t instructi
                     else if (is_same_value(node->src.get(), copy->dst.get())) {
                         node->src = copy->src;
                         context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                         return;
                     }
                 }
@@ -2104,6 +2606,8 @@ static void propagate_copies_unary_instructions(TacUnary* node, size_t instructi
     }
 }
 
+// The first operand is moved to the destination before the second operand is read, so the second operand can not be
+// replaced with the destination.
 static void propagate_copies_binary_instructions(TacBinary* node, size_t instruction_index) {
     bool is_src1 = node->src1->type() == AST_T::TacVariable_t;
     bool is_src2 = node->src2->type() == AST_T::TacVariable_t;
@@ -2127,14 +2631,17 @@ static void propagate_copies_binary_instructions(TacBinary* node, size_t instruc
                     else if (is_src1 && is_same_value(node->src1.get(), copy->dst.get())) {
                         node->src1 = copy->src;
                         context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                         is_src1 = false;
                         if (!is_src2) {
                             return;
                         }
                     }
-                    if (is_src2 && is_same_value(node->src2.get(), copy->dst.get())) {
+                    if (is_src2 && is_same_value(node->src2.get(), copy->dst.get())
+                        && !is_same_value(copy->src.get(), node->dst.get())) {
                         node->src2 = copy->src;
                         context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                         is_src2 = false;
                         if (!is_src1) {
                             return;
@@ -2146,6 +2653,57 @@ static void propagate_copies_binary_instructions(TacBinary* node, size_t instruc
     }
 }
 
+// The false operand is moved to the destination before the true operand is read, so the true operand can not be
+// replaced with the destination.
+static void propagate_copies_select_instructions(TacSelect* node, size_t instruction_index) {
+    bool is_condition = node->condition->type() == AST_T::TacVariable_t;
+    bool is_src_true = node->src_true->type() == AST_T::TacVariable_t;
+    bool is_src_false = node->src_false->type() == AST_T::TacVariable_t;
+    if (is_condition || is_src_true || is_src_false) {
+        size_t i = 0;
+        for (size_t j = 0; j < context->data_flow_analysis->mask_size; ++j) {
+            if (GET_DFA_INSTRUCTION_SET_MASK(instruction_index, j) == MASK_FALSE) {
+                i += 64;
+                continue;
+            }
+            size_t mask_set_size = i + 64;
+            if (mask_set_size > context->data_flow_analysis->set_size) {
+                mask_set_size = context->data_flow_analysis->set_size;
+            }
+            for (; i < mask_set_size; ++i) {
+                if (GET_DFA_INSTRUCTION_SET_AT(instruction_index, i)) {
+                    TacCopy* copy = get_dfa_bak_copy_instruction(i);
+                    if (copy->dst->type() != AST_T::TacVariable_t) {
+                        RAISE_INTERNAL_ERROR;
+                    }
+                    if (is_condition && is_same_value(node->condition.get(), copy->dst.get())) {
+                        node->condition = copy->src;
+                        context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
+                        is_condition = false;
+                    }
+                    if (is_src_true && is_same_value(node->src_true.get(), copy->dst.get())
+                        && !is_same_value(copy->src.get(), node->dst.get())) {
+                        node->src_true = copy->src;
+                        context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
+                        is_src_true = false;
+                    }
+                    if (is_src_false && is_same_value(node->src_false.get(), copy->dst.get())) {
+                        node->src_false = copy->src;
+                        context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
+                        is_src_false = false;
+                    }
+                    if (!is_condition && !is_src_true && !is_src_false) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
+
 static void propagate_copies_copy_instructions(TacCopy* node, size_t instruction_index, size_t block_id) {
     if (node->dst->type() != AST_T::TacVariable_t) {
         RAISE_INTERNAL_ERROR;
@@ -2171,12 +2729,14 @@ static void propagate_copies_copy_instructions(TacCopy* node, size_t instruction
                              && is_same_value(node->dst.get(), copy->src.get()))) {
                     set_dfa_bak_copy_instruction(node, instruction_index);
                     control_flow_graph_remove_block_instruction(instruction_index, block_id);
+                    INCREMENT_STATS(STATS_COUNTER::removed_redundant_copies);
                     return;
                 }
                 else if (is_same_value(node->src.get(), copy->dst.get())) {
                     set_dfa_bak_copy_instruction(node, instruction_index);
                     node->src = copy->src;
                     context->is_fixed_point = false;
+                    INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                     return;
                 }
             }
@@ -2205,6 +2765,7 @@ static void propagate_copies_load_instructions(TacLoad* node, size_t instruction
                     else if (is_same_value(node->src_ptr.get(), copy->dst.get())) {
                         node->src_ptr = copy->src;
                         context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                         return;
                     }
                 }
@@ -2234,6 +2795,7 @@ static void propagate_copies_store_instructions(TacStore* node, size_t instructi
                     else if (is_same_value(node->src.get(), copy->dst.get())) {
                         node->src = copy->src;
                         context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                         return;
                     }
                 }
@@ -2265,6 +2827,7 @@ static void propagate_copies_add_ptr_instructions(TacAddPtr* node, size_t instru
                     else if (is_src_ptr && is_same_value(node->src_ptr.get(), copy->dst.get())) {
                         node->src_ptr = copy->src;
                         context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                         is_src_ptr = false;
                         if (!is_index) {
                             return;
@@ -2273,6 +2836,7 @@ static void propagate_copies_add_ptr_instructions(TacAddPtr* node, size_t instru
                     if (is_index && is_same_value(node->index.get(), copy->dst.get())) {
                         node->index = copy->src;
                         context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                         is_index = false;
                         if (!is_src_ptr) {
                             return;
@@ -2305,6 +2869,7 @@ static void propagate_copies_copy_to_offset_instructions(TacCopyToOffset* node,
                     else if (is_same_value(node->src.get(), copy->dst.get())) {
                         node->src = copy->src;
                         context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                         return;
                     }
                 }
@@ -2336,6 +2901,7 @@ static void propagate_copies_copy_from_offset_instructions(TacCopyFromOffset* no
                     }
                     node->src_name = static_cast<TacVariable*>(copy->src.get())->name;
                     context->is_fixed_point = false;
+                    INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                     return;
                 }
             }
@@ -2366,6 +2932,7 @@ static void propagate_copies_jump_if_zero_instructions(TacJumpIfZero* node, size
                     else if (is_same_value(node->condition.get(), copy->dst.get())) {
                         node->condition = copy->src;
                         context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                         return;
                     }
                 }
@@ -2398,6 +2965,7 @@ static void propagate_copies_jump_if_not_zero_instructions(
                     else if (is_same_value(node->condition.get(), copy->dst.get())) {
                         node->condition = copy->src;
                         context->is_fixed_point = false;
+                        INCREMENT_STATS(STATS_COUNTER::propagated_copy_operands);
                         return;
                     }
                 }
@@ -2406,386 +2974,2351 @@ static void propagate_copies_jump_if_not_zero_instructions(
     }
 }
 
-static void propagate_copies_instructions(TacInstruction* node, size_t instruction_index, size_t block_id) {
+static void propagate_copies_instructions(TacInstruction* node, size_t instruction_index, size_t block_id) {
+    switch (node->type()) {
+        case AST_T::TacReturn_t:
+            propagate_copies_return_instructions(static_cast<TacReturn*>(node), instruction_index, block_id > 0);
+            break;
+        case AST_T::TacSignExtend_t:
+            propagate_copies_sign_extend_instructions(static_cast<TacSignExtend*>(node), instruction_index);
+            break;
+        case AST_T::TacTruncate_t:
+            propagate_copies_truncate_instructions(static_cast<TacTruncate*>(node), instruction_index);
+            break;
+        case AST_T::TacZeroExtend_t:
+            propagate_copies_zero_extend_instructions(static_cast<TacZeroExtend*>(node), instruction_index);
+            break;
+        case AST_T::TacDoubleToInt_t:
+            propagate_copies_double_to_int_instructions(static_cast<TacDoubleToInt*>(node), instruction_index);
+            break;
+        case AST_T::TacDoubleToUInt_t:
+            propagate_copies_double_to_uint_instructions(static_cast<TacDoubleToUInt*>(node), instruction_index);
+            break;
+        case AST_T::TacIntToDouble_t:
+            propagate_copies_int_to_double_instructions(static_cast<TacIntToDouble*>(node), instruction_index);
+            break;
+        case AST_T::TacUIntToDouble_t:
+            propagate_copies_uint_to_double_instructions(static_cast<TacUIntToDouble*>(node), instruction_index);
+            break;
+        case AST_T::TacFunCall_t:
+            propagate_copies_fun_call_instructions(static_cast<TacFunCall*>(node), instruction_index);
+            break;
+        case AST_T::TacUnary_t:
+            propagate_copies_unary_instructions(static_cast<TacUnary*>(node), instruction_index);
+            break;
+        case AST_T::TacBinary_t:
+            propagate_copies_binary_instructions(static_cast<TacBinary*>(node), instruction_index);
+            break;
+        case AST_T::TacCopy_t:
+            propagate_copies_copy_instructions(static_cast<TacCopy*>(node), instruction_index, block_id);
+            break;
+        case AST_T::TacSelect_t:
+            propagate_copies_select_instructions(static_cast<TacSelect*>(node), instruction_index);
+            break;
+        case AST_T::TacLoad_t:
+            propagate_copies_load_instructions(static_cast<TacLoad*>(node), instruction_index);
+            break;
+        case AST_T::TacStore_t:
+            propagate_copies_store_instructions(static_cast<TacStore*>(node), instruction_index);
+            break;
+        case AST_T::TacAddPtr_t:
+            propagate_copies_add_ptr_instructions(static_cast<TacAddPtr*>(node), instruction_index);
+            break;
+        case AST_T::TacCopyToOffset_t:
+            propagate_copies_copy_to_offset_instructions(static_cast<TacCopyToOffset*>(node), instruction_index);
+            break;
+        case AST_T::TacCopyFromOffset_t:
+            propagate_copies_copy_from_offset_instructions(static_cast<TacCopyFromOffset*>(node), instruction_index);
+            break;
+        case AST_T::TacJumpIfZero_t:
+            propagate_copies_jump_if_zero_instructions(
+                static_cast<TacJumpIfZero*>(node), instruction_index, block_id > 0);
+            break;
+        case AST_T::TacJumpIfNotZero_t:
+            propagate_copies_jump_if_not_zero_instructions(
+                static_cast<TacJumpIfNotZero*>(node), instruction_index, block_id > 0);
+            break;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+static void propagate_copies_control_flow_graph() {
+    if (!data_flow_analysis_initialize(false, false, true)) {
+        return;
+    }
+    data_flow_analysis_forward_iterative_algorithm();
+
+    for (size_t block_id = 0; block_id < context->control_flow_graph->blocks.size(); ++block_id) {
+        if (GET_CFG_BLOCK(block_id).size > 0) {
+            size_t incoming_index = block_id;
+            size_t exit_block = 1;
+            for (size_t instruction_index = GET_CFG_BLOCK(block_id).instructions_back_index + 1;
+                 instruction_index-- > GET_CFG_BLOCK(block_id).instructions_front_index;) {
+                if (GET_INSTRUCTION(instruction_index)) {
+                    switch (GET_INSTRUCTION(instruction_index)->type()) {
+                        case AST_T::TacReturn_t:
+                        case AST_T::TacJumpIfZero_t:
+                        case AST_T::TacJumpIfNotZero_t:
+                            propagate_copies_instructions(
+                                GET_INSTRUCTION(instruction_index).get(), incoming_index, exit_block);
+                            break;
+                        case AST_T::TacSignExtend_t:
+                        case AST_T::TacTruncate_t:
+                        case AST_T::TacZeroExtend_t:
+                        case AST_T::TacDoubleToInt_t:
+                        case AST_T::TacDoubleToUInt_t:
+                        case AST_T::TacIntToDouble_t:
+                        case AST_T::TacUIntToDouble_t:
+                        case AST_T::TacFunCall_t:
+                        case AST_T::TacUnary_t:
+                        case AST_T::TacBinary_t:
+                        case AST_T::TacCopy_t:
+                        case AST_T::TacSelect_t:
+                        case AST_T::TacLoad_t:
+                        case AST_T::TacStore_t:
+                        case AST_T::TacAddPtr_t:
+                        case AST_T::TacCopyToOffset_t:
+                        case AST_T::TacCopyFromOffset_t: {
+                            propagate_copies_instructions(
+                                GET_INSTRUCTION(instruction_index).get(), instruction_index, block_id);
+                            incoming_index = instruction_index;
+                            exit_block = 0;
+                            break;
+                        }
+                        case AST_T::TacGetAddress_t: {
+                            incoming_index = instruction_index;
+                            exit_block = 0;
+                            break;
+                        }
+                        default:
+                            break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Redundant load elimination
+
+// Available loads are the loads, stores, pointer additions and structure member accesses whose value is still held by a
+// variable. They are killed when a variable they use is assigned, and when a store or a function call may write the
+// memory they access, as told by the alias analysis.
+
+static bool is_available_load_name(TacInstruction* node, const TIdentifier& name) {
+    switch (node->type()) {
+        case AST_T::TacLoad_t: {
+            TacLoad* p_node = static_cast<TacLoad*>(node);
+            return is_name_same_value(p_node->src_ptr.get(), name) || is_name_same_value(p_node->dst.get(), name)
+                   || is_alias_accessed_name(p_node->src_ptr.get(), p_node->dst.get(), name);
+        }
+        case AST_T::TacStore_t: {
+            TacStore* p_node = static_cast<TacStore*>(node);
+            return is_name_same_value(p_node->src.get(), name) || is_name_same_value(p_node->dst_ptr.get(), name)
+                   || is_alias_accessed_name(p_node->dst_ptr.get(), p_node->src.get(), name);
+        }
+        case AST_T::TacAddPtr_t: {
+            TacAddPtr* p_node = static_cast<TacAddPtr*>(node);
+            return is_name_same_value(p_node->src_ptr.get(), name) || is_name_same_value(p_node->index.get(), name)
+                   || is_name_same_value(p_node->dst.get(), name);
+        }
+        case AST_T::TacCopyToOffset_t: {
+            TacCopyToOffset* p_node = static_cast<TacCopyToOffset*>(node);
+            return p_node->dst_name.compare(name) == 0 || is_name_same_value(p_node->src.get(), name);
+        }
+        case AST_T::TacCopyFromOffset_t: {
+            TacCopyFromOffset* p_node = static_cast<TacCopyFromOffset*>(node);
+            return p_node->src_name.compare(name) == 0 || is_name_same_value(p_node->dst.get(), name);
+        }
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+static bool is_available_load_stored(TacInstruction* node, TacStore* store) {
+    TacValue* dst_ptr = store->dst_ptr.get();
+    TacValue* src = store->src.get();
+    switch (node->type()) {
+        case AST_T::TacLoad_t: {
+            TacLoad* p_node = static_cast<TacLoad*>(node);
+            return is_alias_accessed_pointer(p_node->src_ptr.get(), p_node->dst.get(), dst_ptr, src)
+                   || is_alias_accessed_value(dst_ptr, src, p_node->src_ptr.get())
+                   || is_alias_accessed_value(dst_ptr, src, p_node->dst.get());
+        }
+        case AST_T::TacStore_t: {
+            TacStore* p_node = static_cast<TacStore*>(node);
+            return is_alias_accessed_pointer(p_node->dst_ptr.get(), p_node->src.get(), dst_ptr, src)
+                   || is_alias_accessed_value(dst_ptr, src, p_node->src.get())
+                   || is_alias_accessed_value(dst_ptr, src, p_node->dst_ptr.get());
+        }
+        case AST_T::TacAddPtr_t: {
+            TacAddPtr* p_node = static_cast<TacAddPtr*>(node);
+            return is_alias_accessed_value(dst_ptr, src, p_node->src_ptr.get())
+                   || is_alias_accessed_value(dst_ptr, src, p_node->index.get())
+                   || is_alias_accessed_value(dst_ptr, src, p_node->dst.get());
+        }
+        case AST_T::TacCopyToOffset_t: {
+            TacCopyToOffset* p_node = static_cast<TacCopyToOffset*>(node);
+            return is_alias_accessed_name(dst_ptr, src, p_node->dst_name)
+                   || is_alias_accessed_value(dst_ptr, src, p_node->src.get());
+        }
+        case AST_T::TacCopyFromOffset_t: {
+            TacCopyFromOffset* p_node = static_cast<TacCopyFromOffset*>(node);
+            return is_alias_accessed_name(dst_ptr, src, p_node->src_name)
+                   || is_alias_accessed_value(dst_ptr, src, p_node->dst.get());
+        }
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+static bool is_available_load_called(TacInstruction* node) {
+    switch (node->type()) {
+        case AST_T::TacLoad_t: {
+            TacLoad* p_node = static_cast<TacLoad*>(node);
+            return is_alias_called_pointer(p_node->src_ptr.get()) || is_alias_called_value(p_node->src_ptr.get())
+                   || is_alias_called_value(p_node->dst.get());
+        }
+        case AST_T::TacStore_t: {
+            TacStore* p_node = static_cast<TacStore*>(node);
+            return is_alias_called_pointer(p_node->dst_ptr.get()) || is_alias_called_value(p_node->dst_ptr.get())
+                   || is_alias_called_value(p_node->src.get());
+        }
+        case AST_T::TacAddPtr_t: {
+            TacAddPtr* p_node = static_cast<TacAddPtr*>(node);
+            return is_alias_called_value(p_node->src_ptr.get()) || is_alias_called_value(p_node->index.get())
+                   || is_alias_called_value(p_node->dst.get());
+        }
+        case AST_T::TacCopyToOffset_t: {
+            TacCopyToOffset* p_node = static_cast<TacCopyToOffset*>(node);
+            return is_static_name(p_node->dst_name) || is_escaped_name(p_node->dst_name)
+                   || is_alias_called_value(p_node->src.get());
+        }
+        case AST_T::TacCopyFromOffset_t: {
+            TacCopyFromOffset* p_node = static_cast<TacCopyFromOffset*>(node);
+            return is_static_name(p_node->src_name) || is_escaped_name(p_node->src_name)
+                   || is_alias_called_value(p_node->dst.get());
+        }
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+static void eliminate_redundant_load_transfer_dst_name_available_loads(
+    const TIdentifier& name, size_t next_instruction_index) {
+    size_t i = 0;
+    for (size_t j = 0; j < context->data_flow_analysis->mask_size; ++j) {
+        if (GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, j) == MASK_FALSE) {
+            i += 64;
+            continue;
+        }
+        size_t mask_set_size = i + 64;
+        if (mask_set_size > context->data_flow_analysis->set_size) {
+            mask_set_size = context->data_flow_analysis->set_size;
+        }
+        for (; i < mask_set_size; ++i) {
+            if (GET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i)
+                && is_available_load_name(GET_DFA_INSTRUCTION(i).get(), name)) {
+                SET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i, false);
+                if (GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, j) == MASK_FALSE) {
+                    i = mask_set_size - 1;
+                }
+            }
+        }
+    }
+}
+
+static void eliminate_redundant_load_transfer_dst_value_available_loads(TacValue* node, size_t next_instruction_index) {
+    if (node->type() != AST_T::TacVariable_t) {
+        RAISE_INTERNAL_ERROR;
+    }
+    eliminate_redundant_load_transfer_dst_name_available_loads(
+        static_cast<TacVariable*>(node)->name, next_instruction_index);
+}
+
+static void eliminate_redundant_load_transfer_fun_call_available_loads(
+    TacFunCall* node, size_t next_instruction_index) {
+    if (node->dst && node->dst->type() != AST_T::TacVariable_t) {
+        RAISE_INTERNAL_ERROR;
+    }
+    size_t i = 0;
+    for (size_t j = 0; j < context->data_flow_analysis->mask_size; ++j) {
+        if (GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, j) == MASK_FALSE) {
+            i += 64;
+            continue;
+        }
+        size_t mask_set_size = i + 64;
+        if (mask_set_size > context->data_flow_analysis->set_size) {
+            mask_set_size = context->data_flow_analysis->set_size;
+        }
+        for (; i < mask_set_size; ++i) {
+            if (GET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i)) {
+                TacInstruction* load = GET_DFA_INSTRUCTION(i).get();
+                if (is_available_load_called(load)
+                    || (node->dst
+                        && is_available_load_name(load, static_cast<TacVariable*>(node->dst.get())->name))) {
+                    SET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i, false);
+                    if (GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, j) == MASK_FALSE) {
+                        i = mask_set_size - 1;
+                    }
+                }
+            }
+        }
+    }
+}
+
+static void eliminate_redundant_load_transfer_store_available_loads(TacStore* node, size_t next_instruction_index) {
+    size_t i = 0;
+    for (size_t j = 0; j < context->data_flow_analysis->mask_size; ++j) {
+        if (GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, j) == MASK_FALSE) {
+            i += 64;
+            continue;
+        }
+        size_t mask_set_size = i + 64;
+        if (mask_set_size > context->data_flow_analysis->set_size) {
+            mask_set_size = context->data_flow_analysis->set_size;
+        }
+        for (; i < mask_set_size; ++i) {
+            if (GET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i)
+                && is_available_load_stored(GET_DFA_INSTRUCTION(i).get(), node)) {
+                SET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i, false);
+                if (GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, j) == MASK_FALSE) {
+                    i = mask_set_size - 1;
+                }
+            }
+        }
+    }
+}
+
+static void eliminate_redundant_load_transfer_gen_available_loads(TacInstruction* node, size_t next_instruction_index) {
+    for (size_t i = 0; i < context->data_flow_analysis->set_size; ++i) {
+        if (GET_DFA_INSTRUCTION(i).get() == node) {
+            SET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i, true);
+            return;
+        }
+    }
+    RAISE_INTERNAL_ERROR;
+}
+
+// A load or a pointer addition that assigns one of its own operands does not stay available.
+static void eliminate_redundant_load_transfer_available_loads(TacInstruction* node, size_t next_instruction_index) {
+    switch (node->type()) {
+        case AST_T::TacSignExtend_t:
+            eliminate_redundant_load_transfer_dst_value_available_loads(
+                static_cast<TacSignExtend*>(node)->dst.get(), next_instruction_index);
+            break;
+        case AST_T::TacTruncate_t:
+            eliminate_redundant_load_transfer_dst_value_available_loads(
+                static_cast<TacTruncate*>(node)->dst.get(), next_instruction_index);
+            break;
+        case AST_T::TacZeroExtend_t:
+            eliminate_redundant_load_transfer_dst_value_available_loads(
+                static_cast<TacZeroExtend*>(node)->dst.get(), next_instruction_index);
+            break;
+        case AST_T::TacDoubleToInt_t:
+            eliminate_redundant_load_transfer_dst_value_available_loads(
+                static_cast<TacDoubleToInt*>(node)->dst.get(), next_instruction_index);
+            break;
+        case AST_T::TacDoubleToUInt_t:
+            eliminate_redundant_load_transfer_dst_value_available_loads(
+                static_cast<TacDoubleToUInt*>(node)->dst.get(), next_instruction_index);
+            break;
+        case AST_T::TacIntToDouble_t:
+            eliminate_redundant_load_transfer_dst_value_available_loads(
+                static_cast<TacIntToDouble*>(node)->dst.get(), next_instruction_index);
+            break;
+        case AST_T::TacUIntToDouble_t:
+            eliminate_redundant_load_transfer_dst_value_available_loads(
+                static_cast<TacUIntToDouble*>(node)->dst.get(), next_instruction_index);
+            break;
+        case AST_T::TacFunCall_t:
+            eliminate_redundant_load_transfer_fun_call_available_loads(
+                static_cast<TacFunCall*>(node), next_instruction_index);
+            break;
+        case AST_T::TacUnary_t:
+            eliminate_redundant_load_transfer_dst_value_available_loads(
+                static_cast<TacUnary*>(node)->dst.get(), next_instruction_index);
+            break;
+        case AST_T::TacBinary_t:
+            eliminate_redundant_load_transfer_dst_value_available_loads(
+                static_cast<TacBinary*>(node)->dst.get(), next_instruction_index);
+            break;
+        case AST_T::TacCopy_t:
+            eliminate_redundant_load_transfer_dst_value_available_loads(
+                static_cast<TacCopy*>(node)->dst.get(), next_instruction_index);
+            break;
+        case AST_T::TacSelect_t:
+            eliminate_redundant_load_transfer_dst_value_available_loads(
+                static_cast<TacSelect*>(node)->dst.get(), next_instruction_index);
+            break;
+        case AST_T::TacGetAddress_t:
+            eliminate_redundant_load_transfer_dst_value_available_loads(
+                static_cast<TacGetAddress*>(node)->dst.get(), next_instruction_index);
+            break;
+        case AST_T::TacLoad_t: {
+            TacLoad* p_node = static_cast<TacLoad*>(node);
+            eliminate_redundant_load_transfer_dst_value_available_loads(p_node->dst.get(), next_instruction_index);
+            if (!is_same_value(p_node->src_ptr.get(), p_node->dst.get())) {
+                eliminate_redundant_load_transfer_gen_available_loads(node, next_instruction_index);
+            }
+            break;
+        }
+        case AST_T::TacStore_t: {
+            TacStore* p_node = static_cast<TacStore*>(node);
+            eliminate_redundant_load_transfer_store_available_loads(p_node, next_instruction_index);
+            if (!is_alias_accessed_value(p_node->dst_ptr.get(), p_node->src.get(), p_node->dst_ptr.get())) {
+                eliminate_redundant_load_transfer_gen_available_loads(node, next_instruction_index);
+            }
+            break;
+        }
+        case AST_T::TacAddPtr_t: {
+            TacAddPtr* p_node = static_cast<TacAddPtr*>(node);
+            eliminate_redundant_load_transfer_dst_value_available_loads(p_node->dst.get(), next_instruction_index);
+            if (!is_same_value(p_node->src_ptr.get(), p_node->dst.get())
+                && !is_same_value(p_node->index.get(), p_node->dst.get())) {
+                eliminate_redundant_load_transfer_gen_available_loads(node, next_instruction_index);
+            }
+            break;
+        }
+        case AST_T::TacCopyToOffset_t:
+            eliminate_redundant_load_transfer_dst_name_available_loads(
+                static_cast<TacCopyToOffset*>(node)->dst_name, next_instruction_index);
+            eliminate_redundant_load_transfer_gen_available_loads(node, next_instruction_index);
+            break;
+        case AST_T::TacCopyFromOffset_t:
+            eliminate_redundant_load_transfer_dst_value_available_loads(
+                static_cast<TacCopyFromOffset*>(node)->dst.get(), next_instruction_index);
+            eliminate_redundant_load_transfer_gen_available_loads(node, next_instruction_index);
+            break;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+// The value is only reused by a copy between scalars of the same size and register class.
+static bool is_available_load_value(TacValue* node_1, TacValue* node_2) {
+    std::shared_ptr<Type> type_1 = get_alias_value_type(node_1);
+    std::shared_ptr<Type> type_2 = get_alias_value_type(node_2);
+    return !is_alias_aggregate_type(type_1.get()) && !is_alias_aggregate_type(type_2.get())
+           && get_type_scale(type_1.get()) == get_type_scale(type_2.get())
+           && (type_1->type() == AST_T::Double_t) == (type_2->type() == AST_T::Double_t);
+}
+
+// The replaced instruction may still be available to other instructions, so it is kept as a backup.
+static void eliminate_redundant_load_instructions(
+    std::shared_ptr<TacValue> src, std::shared_ptr<TacValue> dst, size_t instruction_index) {
+    size_t i;
+    if (set_dfa_bak_instruction(instruction_index, i)) {
+        context->data_flow_analysis->bak_instructions[i] = std::move(GET_INSTRUCTION(instruction_index));
+    }
+    set_instruction(std::make_unique<TacCopy>(std::move(src), std::move(dst)), instruction_index);
+    INCREMENT_STATS(STATS_COUNTER::eliminated_redundant_loads);
+}
+
+static std::shared_ptr<TacValue> get_available_load_value(TacLoad* node, TacInstruction* load) {
+    switch (load->type()) {
+        case AST_T::TacLoad_t: {
+            TacLoad* p_load = static_cast<TacLoad*>(load);
+            if (is_same_value(node->src_ptr.get(), p_load->src_ptr.get())
+                && is_available_load_value(node->dst.get(), p_load->dst.get())) {
+                return p_load->dst;
+            }
+            break;
+        }
+        case AST_T::TacStore_t: {
+            TacStore* p_load = static_cast<TacStore*>(load);
+            if (is_same_value(node->src_ptr.get(), p_load->dst_ptr.get())
+                && is_available_load_value(node->dst.get(), p_load->src.get())) {
+                return p_load->src;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return nullptr;
+}
+
+static std::shared_ptr<TacValue> get_available_copy_from_offset_value(
+    TacCopyFromOffset* node, TacInstruction* load) {
+    switch (load->type()) {
+        case AST_T::TacCopyToOffset_t: {
+            TacCopyToOffset* p_load = static_cast<TacCopyToOffset*>(load);
+            if (node->src_name.compare(p_load->dst_name) == 0 && node->offset == p_load->offset
+                && is_available_load_value(node->dst.get(), p_load->src.get())) {
+                return p_load->src;
+            }
+            break;
+        }
+        case AST_T::TacCopyFromOffset_t: {
+            TacCopyFromOffset* p_load = static_cast<TacCopyFromOffset*>(load);
+            if (node->src_name.compare(p_load->src_name) == 0 && node->offset == p_load->offset
+                && is_available_load_value(node->dst.get(), p_load->dst.get())) {
+                return p_load->dst;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return nullptr;
+}
+
+static std::shared_ptr<TacValue> get_available_add_ptr_value(TacAddPtr* node, TacInstruction* load) {
+    if (load->type() == AST_T::TacAddPtr_t) {
+        TacAddPtr* p_load = static_cast<TacAddPtr*>(load);
+        if (node->scale == p_load->scale && is_same_value(node->src_ptr.get(), p_load->src_ptr.get())
+            && is_same_value(node->index.get(), p_load->index.get())) {
+            return p_load->dst;
+        }
+    }
+    return nullptr;
+}
+
+static std::shared_ptr<TacValue> get_available_value(TacInstruction* node, TacInstruction* load) {
+    switch (node->type()) {
+        case AST_T::TacLoad_t:
+            return get_available_load_value(static_cast<TacLoad*>(node), load);
+        case AST_T::TacAddPtr_t:
+            return get_available_add_ptr_value(static_cast<TacAddPtr*>(node), load);
+        case AST_T::TacCopyFromOffset_t:
+            return get_available_copy_from_offset_value(static_cast<TacCopyFromOffset*>(node), load);
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+static std::shared_ptr<TacValue> get_available_dst_value(TacInstruction* node) {
+    switch (node->type()) {
+        case AST_T::TacLoad_t:
+            return static_cast<TacLoad*>(node)->dst;
+        case AST_T::TacAddPtr_t:
+            return static_cast<TacAddPtr*>(node)->dst;
+        case AST_T::TacCopyFromOffset_t:
+            return static_cast<TacCopyFromOffset*>(node)->dst;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+static void eliminate_redundant_load_available_instructions(TacInstruction* node, size_t instruction_index) {
+    size_t i = 0;
+    for (size_t j = 0; j < context->data_flow_analysis->mask_size; ++j) {
+        if (GET_DFA_INSTRUCTION_SET_MASK(instruction_index, j) == MASK_FALSE) {
+            i += 64;
+            continue;
+        }
+        size_t mask_set_size = i + 64;
+        if (mask_set_size > context->data_flow_analysis->set_size) {
+            mask_set_size = context->data_flow_analysis->set_size;
+        }
+        for (; i < mask_set_size; ++i) {
+            if (GET_DFA_INSTRUCTION_SET_AT(instruction_index, i)
+                && context->data_flow_analysis->data_index_map[i] != instruction_index) {
+                std::shared_ptr<TacValue> src = get_available_value(node, get_dfa_bak_instruction(i));
+                if (src) {
+                    eliminate_redundant_load_instructions(
+                        std::move(src), get_available_dst_value(node), instruction_index);
+                    return;
+                }
+            }
+        }
+    }
+}
+
+// Loads, pointer additions and structure member reads whose value is available in a variable are replaced with a copy
+// of it, which copy propagation then removes.
+static void eliminate_redundant_load_control_flow_graph(bool init_alias_set) {
+    if (!data_flow_analysis_initialize(false, true, init_alias_set)) {
+        return;
+    }
+    data_flow_analysis_forward_iterative_algorithm();
+
+    for (size_t block_id = 0; block_id < context->control_flow_graph->blocks.size(); ++block_id) {
+        if (GET_CFG_BLOCK(block_id).size > 0) {
+            for (size_t instruction_index = GET_CFG_BLOCK(block_id).instructions_front_index;
+                 instruction_index <= GET_CFG_BLOCK(block_id).instructions_back_index; ++instruction_index) {
+                if (GET_INSTRUCTION(instruction_index)) {
+                    switch (GET_INSTRUCTION(instruction_index)->type()) {
+                        case AST_T::TacLoad_t:
+                        case AST_T::TacAddPtr_t:
+                        case AST_T::TacCopyFromOffset_t:
+                            eliminate_redundant_load_available_instructions(
+                                GET_INSTRUCTION(instruction_index).get(), instruction_index);
+                            break;
+                        default:
+                            break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Dead store elimination
+
+static void eliminate_dead_store_transfer_load_live_values(TacLoad* node, size_t next_instruction_index) {
+    for (const auto& name : context->data_flow_analysis->aliased_names) {
+        if (is_alias_accessed_name(node->src_ptr.get(), node->dst.get(), name)) {
+            size_t i = context->control_flow_graph->identifier_id_map[name];
+            SET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i, true);
+        }
+    }
+}
+
+static void eliminate_dead_store_transfer_aliased_live_values(size_t next_instruction_index) {
+    for (size_t i = 0; i < context->data_flow_analysis->mask_size; ++i) {
+        GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, i) |=
+            GET_DFA_INSTRUCTION_SET_MASK(context->data_flow_analysis->static_index, i);
+        GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, i) |=
+            GET_DFA_INSTRUCTION_SET_MASK(context->data_flow_analysis->escaped_index, i);
+    }
+}
+
+static void eliminate_dead_store_transfer_src_name_live_values(const TIdentifier& name, size_t next_instruction_index) {
+    size_t i = context->control_flow_graph->identifier_id_map[name];
+    SET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i, true);
+}
+
+static void eliminate_dead_store_transfer_src_value_live_values(TacValue* node, size_t next_instruction_index) {
+    if (node->type() == AST_T::TacVariable_t) {
+        eliminate_dead_store_transfer_src_name_live_values(
+            static_cast<TacVariable*>(node)->name, next_instruction_index);
+    }
+}
+
+static void eliminate_dead_store_transfer_dst_value_live_values(TacValue* node, size_t next_instruction_index) {
+    if (node->type() != AST_T::TacVariable_t) {
+        RAISE_INTERNAL_ERROR;
+    }
+    size_t i = context->control_flow_graph->identifier_id_map[static_cast<TacVariable*>(node)->name];
+    SET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i, false);
+}
+
+static void eliminate_dead_store_transfer_live_values(TacInstruction* node, size_t next_instruction_index) {
+    switch (node->type()) {
+        case AST_T::TacReturn_t: {
+            TacReturn* p_node = static_cast<TacReturn*>(node);
+            if (p_node->val) {
+                eliminate_dead_store_transfer_src_value_live_values(p_node->val.get(), next_instruction_index);
+            }
+            break;
+        }
+        case AST_T::TacSignExtend_t: {
+            TacSignExtend* p_node = static_cast<TacSignExtend*>(node);
+            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
+            break;
+        }
+        case AST_T::TacTruncate_t: {
+            TacTruncate* p_node = static_cast<TacTruncate*>(node);
+            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
+            break;
+        }
+        case AST_T::TacZeroExtend_t: {
+            TacZeroExtend* p_node = static_cast<TacZeroExtend*>(node);
+            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
+            break;
+        }
+        case AST_T::TacDoubleToInt_t: {
+            TacDoubleToInt* p_node = static_cast<TacDoubleToInt*>(node);
+            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
+            break;
+        }
+        case AST_T::TacDoubleToUInt_t: {
+            TacDoubleToUInt* p_node = static_cast<TacDoubleToUInt*>(node);
+            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
+            break;
+        }
+        case AST_T::TacIntToDouble_t: {
+            TacIntToDouble* p_node = static_cast<TacIntToDouble*>(node);
+            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
+            break;
+        }
+        case AST_T::TacUIntToDouble_t: {
+            TacUIntToDouble* p_node = static_cast<TacUIntToDouble*>(node);
+            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
+            break;
+        }
+        case AST_T::TacFunCall_t: {
+            TacFunCall* p_node = static_cast<TacFunCall*>(node);
+            if (p_node->dst) {
+                eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
+            }
+            for (const auto& arg : p_node->args) {
+                eliminate_dead_store_transfer_src_value_live_values(arg.get(), next_instruction_index);
+            }
+            eliminate_dead_store_transfer_aliased_live_values(next_instruction_index);
+            break;
+        }
+        case AST_T::TacUnary_t: {
+            TacUnary* p_node = static_cast<TacUnary*>(node);
+            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
+            break;
+        }
+        case AST_T::TacBinary_t: {
+            TacBinary* p_node = static_cast<TacBinary*>(node);
+            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->src1.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->src2.get(), next_instruction_index);
+            break;
+        }
+        case AST_T::TacCopy_t: {
+            TacCopy* p_node = static_cast<TacCopy*>(node);
+            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
+            break;
+        }
+        case AST_T::TacSelect_t: {
+            TacSelect* p_node = static_cast<TacSelect*>(node);
+            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->condition.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->src_true.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->src_false.get(), next_instruction_index);
+            break;
+        }
+        case AST_T::TacGetAddress_t:
+            eliminate_dead_store_transfer_dst_value_live_values(
+                static_cast<TacGetAddress*>(node)->dst.get(), next_instruction_index);
+            break;
+        case AST_T::TacLoad_t: {
+            TacLoad* p_node = static_cast<TacLoad*>(node);
+            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->src_ptr.get(), next_instruction_index);
+            eliminate_dead_store_transfer_load_live_values(p_node, next_instruction_index);
+            break;
+        }
+        case AST_T::TacStore_t: {
+            TacStore* p_node = static_cast<TacStore*>(node);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->dst_ptr.get(), next_instruction_index);
+            break;
+        }
+        case AST_T::TacAddPtr_t: {
+            TacAddPtr* p_node = static_cast<TacAddPtr*>(node);
+            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->src_ptr.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_value_live_values(p_node->index.get(), next_instruction_index);
+            break;
+        }
+        case AST_T::TacCopyToOffset_t:
+            eliminate_dead_store_transfer_src_value_live_values(
+                static_cast<TacCopyToOffset*>(node)->src.get(), next_instruction_index);
+            break;
+        case AST_T::TacCopyFromOffset_t: {
+            TacCopyFromOffset* p_node = static_cast<TacCopyFromOffset*>(node);
+            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
+            eliminate_dead_store_transfer_src_name_live_values(p_node->src_name, next_instruction_index);
+            break;
+        }
+        case AST_T::TacJumpIfZero_t:
+            eliminate_dead_store_transfer_src_value_live_values(
+                static_cast<TacJumpIfZero*>(node)->condition.get(), next_instruction_index);
+            break;
+        case AST_T::TacJumpIfNotZero_t:
+            eliminate_dead_store_transfer_src_value_live_values(
+                static_cast<TacJumpIfNotZero*>(node)->condition.get(), next_instruction_index);
+            break;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+static void eliminate_dead_store_dst_name_instructions(const TIdentifier& name, size_t instruction_index) {
+    size_t i = context->control_flow_graph->identifier_id_map[name];
+    if (!GET_DFA_INSTRUCTION_SET_AT(instruction_index, i)) {
+        set_instruction(nullptr, instruction_index);
+        INCREMENT_STATS(STATS_COUNTER::removed_dead_stores);
+    }
+}
+
+static void eliminate_dead_store_dst_value_instructions(TacValue* node, size_t instruction_index) {
+    if (node->type() != AST_T::TacVariable_t) {
+        RAISE_INTERNAL_ERROR;
+    }
+    eliminate_dead_store_dst_name_instructions(static_cast<TacVariable*>(node)->name, instruction_index);
+}
+
+static void eliminate_dead_store_instructions(TacInstruction* node, size_t instruction_index) {
+    switch (node->type()) {
+        case AST_T::TacSignExtend_t:
+            eliminate_dead_store_dst_value_instructions(
+                static_cast<TacSignExtend*>(node)->dst.get(), instruction_index);
+            break;
+        case AST_T::TacTruncate_t:
+            eliminate_dead_store_dst_value_instructions(static_cast<TacTruncate*>(node)->dst.get(), instruction_index);
+            break;
+        case AST_T::TacZeroExtend_t:
+            eliminate_dead_store_dst_value_instructions(
+                static_cast<TacZeroExtend*>(node)->dst.get(), instruction_index);
+            break;
+        case AST_T::TacDoubleToInt_t:
+            eliminate_dead_store_dst_value_instructions(
+                static_cast<TacDoubleToInt*>(node)->dst.get(), instruction_index);
+            break;
+        case AST_T::TacDoubleToUInt_t:
+            eliminate_dead_store_dst_value_instructions(
+                static_cast<TacDoubleToUInt*>(node)->dst.get(), instruction_index);
+            break;
+        case AST_T::TacIntToDouble_t:
+            eliminate_dead_store_dst_value_instructions(
+                static_cast<TacIntToDouble*>(node)->dst.get(), instruction_index);
+            break;
+        case AST_T::TacUIntToDouble_t:
+            eliminate_dead_store_dst_value_instructions(
+                static_cast<TacUIntToDouble*>(node)->dst.get(), instruction_index);
+            break;
+        case AST_T::TacUnary_t:
+            eliminate_dead_store_dst_value_instructions(static_cast<TacUnary*>(node)->dst.get(), instruction_index);
+            break;
+        case AST_T::TacBinary_t:
+            eliminate_dead_store_dst_value_instructions(static_cast<TacBinary*>(node)->dst.get(), instruction_index);
+            break;
+        case AST_T::TacCopy_t:
+            eliminate_dead_store_dst_value_instructions(static_cast<TacCopy*>(node)->dst.get(), instruction_index);
+            break;
+        case AST_T::TacSelect_t:
+            eliminate_dead_store_dst_value_instructions(static_cast<TacSelect*>(node)->dst.get(), instruction_index);
+            break;
+        case AST_T::TacGetAddress_t:
+            eliminate_dead_store_dst_value_instructions(
+                static_cast<TacGetAddress*>(node)->dst.get(), instruction_index);
+            break;
+        case AST_T::TacLoad_t:
+            eliminate_dead_store_dst_value_instructions(static_cast<TacLoad*>(node)->dst.get(), instruction_index);
+            break;
+        case AST_T::TacAddPtr_t:
+            eliminate_dead_store_dst_value_instructions(static_cast<TacAddPtr*>(node)->dst.get(), instruction_index);
+            break;
+        case AST_T::TacCopyToOffset_t:
+            eliminate_dead_store_dst_name_instructions(
+                static_cast<TacCopyToOffset*>(node)->dst_name, instruction_index);
+            break;
+        case AST_T::TacCopyFromOffset_t:
+            eliminate_dead_store_dst_value_instructions(
+                static_cast<TacCopyFromOffset*>(node)->dst.get(), instruction_index);
+            break;
+        default:
+            break;
+    }
+}
+
+static void eliminate_dead_store_control_flow_graph(bool init_alias_set) {
+    if (!data_flow_analysis_initialize(true, false, init_alias_set)) {
+        return;
+    }
+    data_flow_analysis_backward_iterative_algorithm();
+
+    for (size_t block_id = 0; block_id < context->control_flow_graph->blocks.size(); ++block_id) {
+        if (GET_CFG_BLOCK(block_id).size > 0) {
+            for (size_t instruction_index = GET_CFG_BLOCK(block_id).instructions_front_index;
+                 instruction_index <= GET_CFG_BLOCK(block_id).instructions_back_index; ++instruction_index) {
+                if (GET_INSTRUCTION(instruction_index)) {
+                    eliminate_dead_store_instructions(GET_INSTRUCTION(instruction_index).get(), instruction_index);
+                }
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Tail call elimination
+
+// A call is in tail position when the next instruction returns its result. The frame of the caller must then be dead
+// at the call, which holds unless the address of a local escapes.
+static bool is_addressed_local_function(TacFunction* node) {
+    for (const auto& instruction : node->body) {
+        if (instruction && instruction->type() == AST_T::TacGetAddress_t) {
+            TacValue* src = static_cast<TacGetAddress*>(instruction.get())->src.get();
+            if (src->type() == AST_T::TacVariable_t
+                && frontend->symbol_table.at(static_cast<TacVariable*>(src)->name)->attrs->type()
+                       == AST_T::LocalAttr_t) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static size_t get_tail_call_return_index(
+    const std::vector<std::unique_ptr<TacInstruction>>& instructions, TacFunCall* node, size_t instruction_index) {
+    for (size_t i = instruction_index + 1; i < instructions.size(); ++i) {
+        if (instructions[i]) {
+            if (instructions[i]->type() == AST_T::TacReturn_t) {
+                TacReturn* p_return = static_cast<TacReturn*>(instructions[i].get());
+                if (!node->dst && !p_return->val) {
+                    return i;
+                }
+                else if (node->dst && p_return->val && is_same_value(node->dst.get(), p_return->val.get())) {
+                    return i;
+                }
+            }
+            break;
+        }
+    }
+    return instructions.size();
+}
+
+static std::shared_ptr<TacVariable> eliminate_tail_recursion_arg_value(const TIdentifier& param) {
+    TIdentifier name = resolve_variable_identifier(param);
+    {
+        std::shared_ptr<Type> type = frontend->symbol_table.at(param)->type_t;
+        std::unique_ptr<IdentifierAttr> attrs = std::make_unique<LocalAttr>();
+        frontend->symbol_table[name] = std::make_unique<Symbol>(std::move(type), std::move(attrs));
+    }
+    return std::make_shared<TacVariable>(std::move(name));
+}
+
+// Arguments are copied to new variables before any parameter is assigned, as they may read the parameters.
+static void eliminate_tail_recursion_instructions(TacFunction* node, TacFunCall* p_node, const TIdentifier& label) {
+    std::vector<std::shared_ptr<TacValue>> args;
+    args.reserve(p_node->args.size());
+    for (size_t i = 0; i < p_node->args.size(); ++i) {
+        if (p_node->args[i]->type() == AST_T::TacVariable_t) {
+            std::shared_ptr<TacValue> src = p_node->args[i];
+            std::shared_ptr<TacValue> dst = eliminate_tail_recursion_arg_value(node->params[i]);
+            args.push_back(dst);
+            node->body.push_back(std::make_unique<TacCopy>(std::move(src), std::move(dst)));
+        }
+        else {
+            args.push_back(p_node->args[i]);
+        }
+    }
+    for (size_t i = 0; i < args.size(); ++i) {
+        std::shared_ptr<TacValue> src = std::move(args[i]);
+        std::shared_ptr<TacValue> dst;
+        {
+            TIdentifier name = node->params[i];
+            dst = std::make_shared<TacVariable>(std::move(name));
+        }
+        node->body.push_back(std::make_unique<TacCopy>(std::move(src), std::move(dst)));
+    }
+    {
+        TIdentifier target = label;
+        node->body.push_back(std::make_unique<TacJump>(std::move(target)));
+    }
+}
+
+// Self recursive calls in tail position jump back to the start of the function with the arguments as parameters. This
+// allocates new variables and labels, so that it runs on all functions before they are optimized on jobs.
+static void eliminate_tail_recursion_function(TacFunction* node) {
+    if (is_addressed_local_function(node)) {
+        return;
+    }
+    std::vector<std::unique_ptr<TacInstruction>> instructions = std::move(node->body);
+    node->body.clear();
+    node->body.reserve(instructions.size() + 1);
+    node->body.emplace_back();
+
+    TIdentifier label;
+    for (size_t instruction_index = 0; instruction_index < instructions.size(); ++instruction_index) {
+        if (instructions[instruction_index]
+            && instructions[instruction_index]->type() == AST_T::TacFunCall_t) {
+            TacFunCall* p_node = static_cast<TacFunCall*>(instructions[instruction_index].get());
+            if (p_node->name.compare(node->name) == 0 && p_node->args.size() == node->params.size()) {
+                size_t return_index = get_tail_call_return_index(instructions, p_node, instruction_index);
+                if (return_index < instructions.size()) {
+                    if (label.empty()) {
+                        label = represent_label_identifier(LABEL_KIND::Ltail_call);
+                    }
+                    eliminate_tail_recursion_instructions(node, p_node, label);
+                    instructions[return_index].reset();
+                    INCREMENT_STATS(STATS_COUNTER::eliminated_tail_recursions);
+                    continue;
+                }
+            }
+        }
+        node->body.push_back(std::move(instructions[instruction_index]));
+    }
+    if (!label.empty()) {
+        node->body[0] = std::make_unique<TacLabel>(std::move(label));
+    }
+}
+
+static void eliminate_tail_recursion_program(TacProgram* node) {
+    for (const auto& top_level : node->function_top_levels) {
+        if (top_level->type() != AST_T::TacFunction_t) {
+            RAISE_INTERNAL_ERROR;
+        }
+        eliminate_tail_recursion_function(static_cast<TacFunction*>(top_level.get()));
+    }
+}
+
+// Other calls in tail position are only marked once the function is optimized, as the return of their result must
+// stay for the data flow analysis. The backend turns them into a jump when they take no stack arguments.
+static void mark_tail_calls_function(TacFunction* node) {
+    if (is_addressed_local_function(node)) {
+        return;
+    }
+    for (size_t instruction_index = 0; instruction_index < node->body.size(); ++instruction_index) {
+        if (node->body[instruction_index] && node->body[instruction_index]->type() == AST_T::TacFunCall_t) {
+            TacFunCall* p_node = static_cast<TacFunCall*>(node->body[instruction_index].get());
+            if (get_tail_call_return_index(node->body, p_node, instruction_index) < node->body.size()) {
+                p_node->is_tail_call = true;
+                INCREMENT_STATS(STATS_COUNTER::marked_tail_calls);
+            }
+        }
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Block layout
+
+static size_t get_block_jump_target_id(TacInstruction* node) {
+    switch (node->type()) {
+        case AST_T::TacJump_t:
+            return context->control_flow_graph->identifier_id_map[static_cast<TacJump*>(node)->target];
+        case AST_T::TacJumpIfZero_t:
+            return context->control_flow_graph->identifier_id_map[static_cast<TacJumpIfZero*>(node)->target];
+        case AST_T::TacJumpIfNotZero_t:
+            return context->control_flow_graph->identifier_id_map[static_cast<TacJumpIfNotZero*>(node)->target];
+        default:
+            return context->control_flow_graph->exit_id;
+    }
+}
+
+static bool is_block_conditional_jump(size_t block_id) {
+    AST_T type = GET_INSTRUCTION(GET_CFG_BLOCK(block_id).instructions_back_index)->type();
+    return type == AST_T::TacJumpIfZero_t || type == AST_T::TacJumpIfNotZero_t;
+}
+
+static bool is_block_fall_through(size_t block_id) {
+    AST_T type = GET_INSTRUCTION(GET_CFG_BLOCK(block_id).instructions_back_index)->type();
+    return type != AST_T::TacReturn_t && type != AST_T::TacJump_t;
+}
+
+// A loop header that tests for a forward exit is moved after the latch, the last block in the loop that jumps back to
+// it. The latch then falls through into the test, which jumps back to the body, so that an iteration takes a single
+// branch. Returns the latch, or the exit id if the block does not head a loop.
+static size_t get_layout_latch_id(size_t block_id) {
+    if (!is_block_conditional_jump(block_id)) {
+        return context->control_flow_graph->exit_id;
+    }
+    size_t exit_block_id =
+        get_block_jump_target_id(GET_INSTRUCTION(GET_CFG_BLOCK(block_id).instructions_back_index).get());
+    if (exit_block_id <= block_id + 1 || exit_block_id >= context->control_flow_graph->exit_id) {
+        return context->control_flow_graph->exit_id;
+    }
+    size_t latch_id = context->control_flow_graph->exit_id;
+    for (size_t predecessor_id : GET_CFG_BLOCK(block_id).predecessor_ids) {
+        if (predecessor_id > block_id && predecessor_id < exit_block_id
+            && GET_INSTRUCTION(GET_CFG_BLOCK(predecessor_id).instructions_back_index)->type() == AST_T::TacJump_t
+            && (latch_id == context->control_flow_graph->exit_id || predecessor_id > latch_id)) {
+            latch_id = predecessor_id;
+        }
+    }
+    return latch_id;
+}
+
+// An early return that is only reached by falling through a conditional jump is predicted not taken, and is moved to
+// the end of the function, so that the jump is inverted and the common path falls through.
+static bool is_layout_return_block(size_t block_id) {
+    return block_id > 0 && block_id + 1 < context->control_flow_graph->exit_id
+           && GET_INSTRUCTION(GET_CFG_BLOCK(block_id).instructions_back_index)->type() == AST_T::TacReturn_t
+           && GET_CFG_BLOCK(block_id).predecessor_ids.size() == 1
+           && GET_CFG_BLOCK(block_id).predecessor_ids[0] == block_id - 1 && is_block_conditional_jump(block_id - 1)
+           && get_block_jump_target_id(GET_INSTRUCTION(GET_CFG_BLOCK(block_id - 1).instructions_back_index).get())
+                  == block_id + 1;
+}
+
+// A block that only jumps, and is only reached by falling through a conditional jump, is threaded into that jump,
+// which is inverted to go straight to the target of the block.
+static bool is_layout_jump_block(size_t block_id) {
+    return block_id > 0 && GET_CFG_BLOCK(block_id).size == 1
+           && GET_INSTRUCTION(GET_CFG_BLOCK(block_id).instructions_back_index)->type() == AST_T::TacJump_t
+           && GET_CFG_BLOCK(block_id).predecessor_ids.size() == 1
+           && GET_CFG_BLOCK(block_id).predecessor_ids[0] == block_id - 1 && is_block_conditional_jump(block_id - 1)
+           && get_block_jump_target_id(GET_INSTRUCTION(GET_CFG_BLOCK(block_id).instructions_back_index).get())
+                  != block_id;
+}
+
+static bool layout_control_flow_graph_block_ids(std::vector<size_t>& block_ids, std::vector<bool>& is_threaded) {
+    size_t blocks_size = context->control_flow_graph->blocks.size();
+    std::vector<size_t> header_ids(blocks_size, context->control_flow_graph->exit_id);
+    std::vector<bool> is_moved(blocks_size + 1, false);
+    bool is_layout = false;
+    for (size_t block_id = 0; block_id < blocks_size; ++block_id) {
+        size_t latch_id = get_layout_latch_id(block_id);
+        if (latch_id < context->control_flow_graph->exit_id) {
+            header_ids[latch_id] = block_id;
+            is_moved[block_id] = true;
+            is_layout = true;
+            INCREMENT_STATS(STATS_COUNTER::rotated_loops);
+        }
+    }
+    std::vector<bool> is_returned(blocks_size, false);
+    for (size_t block_id = 0; block_id < blocks_size; ++block_id) {
+        if (is_layout_return_block(block_id) && !is_moved[block_id] && !is_moved[block_id + 1]) {
+            is_returned[block_id] = true;
+            is_layout = true;
+            INCREMENT_STATS(STATS_COUNTER::moved_return_blocks);
+        }
+    }
+    is_threaded.resize(blocks_size, false);
+    for (size_t block_id = 0; block_id < blocks_size; ++block_id) {
+        if (is_layout_jump_block(block_id) && !is_moved[block_id]
+            && header_ids[block_id] == context->control_flow_graph->exit_id) {
+            is_threaded[block_id] = true;
+            is_layout = true;
+            INCREMENT_STATS(STATS_COUNTER::threaded_layout_jumps);
+        }
+    }
+    if (!is_layout) {
+        return false;
+    }
+
+    block_ids.reserve(blocks_size);
+    for (size_t block_id = 0; block_id < blocks_size; ++block_id) {
+        if (!is_moved[block_id] && !is_returned[block_id] && !is_threaded[block_id]) {
+            block_ids.push_back(block_id);
+            if (header_ids[block_id] < context->control_flow_graph->exit_id) {
+                block_ids.push_back(header_ids[block_id]);
+            }
+        }
+    }
+    for (size_t block_id = 0; block_id < blocks_size; ++block_id) {
+        if (is_returned[block_id]) {
+            block_ids.push_back(block_id);
+        }
+    }
+    return true;
+}
+
+static const TIdentifier& get_layout_block_label(std::vector<TIdentifier>& block_labels, size_t block_id) {
+    if (block_labels[block_id].empty()) {
+        block_labels[block_id] = represent_label_identifier(LABEL_KIND::Lblock);
+    }
+    return block_labels[block_id];
+}
+
+// Blocks that only hold a label are skipped when they still fall through to the block laid out after them.
+static bool is_layout_next_block(const std::vector<size_t>& block_ids, size_t i, size_t block_id) {
+    for (size_t j = i + 1; j < block_ids.size(); ++j) {
+        if (block_ids[j] == block_id) {
+            return true;
+        }
+        else if (GET_CFG_BLOCK(block_ids[j]).size != 1
+                 || GET_INSTRUCTION(GET_CFG_BLOCK(block_ids[j]).instructions_front_index)->type() != AST_T::TacLabel_t
+                 || j + 1 == block_ids.size() || block_ids[j + 1] != block_ids[j] + 1) {
+            return false;
+        }
+    }
+    return false;
+}
+
+static void invert_layout_jump_instructions(std::unique_ptr<TacInstruction>& node, TIdentifier&& target) {
+    switch (node->type()) {
+        case AST_T::TacJumpIfZero_t: {
+            std::shared_ptr<TacValue> condition = static_cast<TacJumpIfZero*>(node.get())->condition;
+            node = std::make_unique<TacJumpIfNotZero>(std::move(target), std::move(condition));
+            break;
+        }
+        case AST_T::TacJumpIfNotZero_t: {
+            std::shared_ptr<TacValue> condition = static_cast<TacJumpIfNotZero*>(node.get())->condition;
+            node = std::make_unique<TacJumpIfZero>(std::move(target), std::move(condition));
+            break;
+        }
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+// Blocks that were reached by falling through get a jump to their old successor, and conditional jumps to the next
+// block are inverted. Blocks without a label get a free slot, where a label is set if they become a jump target.
+static void layout_control_flow_graph_block(std::vector<std::unique_ptr<TacInstruction>>& instructions,
+    std::vector<TIdentifier>& block_labels, std::vector<size_t>& label_indices, const std::vector<size_t>& block_ids,
+    const std::vector<bool>& is_threaded, size_t i) {
+    size_t block_id = block_ids[i];
+    label_indices[block_id] = instructions.size();
+    if (GET_INSTRUCTION(GET_CFG_BLOCK(block_id).instructions_front_index)->type() != AST_T::TacLabel_t) {
+        instructions.emplace_back();
+    }
+    for (size_t instruction_index = GET_CFG_BLOCK(block_id).instructions_front_index;
+         instruction_index < GET_CFG_BLOCK(block_id).instructions_back_index; ++instruction_index) {
+        if (GET_INSTRUCTION(instruction_index)) {
+            instructions.push_back(std::move(GET_INSTRUCTION(instruction_index)));
+        }
+    }
+
+    std::unique_ptr<TacInstruction> node = std::move(GET_INSTRUCTION(GET_CFG_BLOCK(block_id).instructions_back_index));
+    size_t target_id = get_block_jump_target_id(node.get());
+    size_t fall_through_id = block_id + 1;
+    bool is_fall_through = !is_layout_next_block(block_ids, i, fall_through_id);
+    switch (node->type()) {
+        case AST_T::TacReturn_t:
+            is_fall_through = false;
+            break;
+        case AST_T::TacJump_t: {
+            is_fall_through = false;
+            if (is_layout_next_block(block_ids, i, target_id)) {
+                node.reset();
+                INCREMENT_STATS(STATS_COUNTER::removed_layout_jumps);
+            }
+            break;
+        }
+        case AST_T::TacJumpIfZero_t:
+        case AST_T::TacJumpIfNotZero_t: {
+            if (is_threaded[fall_through_id]) {
+                TIdentifier target =
+                    static_cast<TacJump*>(GET_INSTRUCTION(GET_CFG_BLOCK(fall_through_id).instructions_back_index).get())
+                        ->target;
+                invert_layout_jump_instructions(node, std::move(target));
+                fall_through_id = target_id;
+                is_fall_through = !is_layout_next_block(block_ids, i, fall_through_id);
+            }
+            else if (is_fall_through && is_layout_next_block(block_ids, i, target_id)) {
+                invert_layout_jump_instructions(
+                    node, TIdentifier(get_layout_block_label(block_labels, fall_through_id)));
+                is_fall_through = false;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    if (node) {
+        instructions.push_back(std::move(node));
+    }
+    if (is_fall_through) {
+        TIdentifier target = get_layout_block_label(block_labels, fall_through_id);
+        instructions.push_back(std::make_unique<TacJump>(std::move(target)));
+    }
+}
+
+// Blocks are laid out once the function is optimized, with static predictions: back edges are taken, early returns
+// are not taken, and jumps to the next block are removed. The last block must not fall through to the end of the
+// function, so that any block can be placed last.
+static void layout_control_flow_graph() {
+    if (context->control_flow_graph->blocks.empty()
+        || is_block_fall_through(context->control_flow_graph->blocks.size() - 1)) {
+        return;
+    }
+    std::vector<size_t> block_ids;
+    std::vector<bool> is_threaded;
+    if (!layout_control_flow_graph_block_ids(block_ids, is_threaded)) {
+        return;
+    }
+
+    std::vector<TIdentifier> block_labels(context->control_flow_graph->blocks.size());
+    for (size_t block_id : block_ids) {
+        TacInstruction* node = GET_INSTRUCTION(GET_CFG_BLOCK(block_id).instructions_front_index).get();
+        if (node->type() == AST_T::TacLabel_t) {
+            block_labels[block_id] = static_cast<TacLabel*>(node)->name;
+        }
+    }
+    std::vector<size_t> label_indices(context->control_flow_graph->blocks.size(), 0);
+    std::vector<std::unique_ptr<TacInstruction>> instructions;
+    instructions.reserve(context->p_instructions->size() + block_ids.size() * 2 + 1);
+    if (block_ids[0] != 0) {
+        TIdentifier target = get_layout_block_label(block_labels, 0);
+        instructions.push_back(std::make_unique<TacJump>(std::move(target)));
+    }
+    for (size_t i = 0; i < block_ids.size(); ++i) {
+        layout_control_flow_graph_block(instructions, block_labels, label_indices, block_ids, is_threaded, i);
+    }
+    for (size_t block_id : block_ids) {
+        if (!instructions[label_indices[block_id]] && !block_labels[block_id].empty()) {
+            TIdentifier name = block_labels[block_id];
+            instructions[label_indices[block_id]] = std::make_unique<TacLabel>(std::move(name));
+        }
+    }
+    *context->p_instructions = std::move(instructions);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Scalar replacement of aggregates
+
+#define MAX_REPLACED_AGGREGATE_SIZE 64l
+
+// Only small local structures are replaced, as a structure that is also used as a whole is stored back member by
+// member before each use.
+static bool is_aggregate_variable(const TIdentifier& name) {
+    Symbol* symbol = frontend->symbol_table.at(name).get();
+    if (symbol->type_t->type() == AST_T::Structure_t && symbol->attrs->type() == AST_T::LocalAttr_t) {
+        Structure* struct_type = static_cast<Structure*>(symbol->type_t.get());
+        return !struct_type->is_union && get_type_scale(struct_type) <= MAX_REPLACED_AGGREGATE_SIZE;
+    }
+    return false;
+}
+
+static AggregateReplacement* get_aggregate_replacement(
+    std::unordered_map<TIdentifier, AggregateReplacement>& aggregates, const TIdentifier& name) {
+    auto aggregate = aggregates.find(name);
+    if (aggregate != aggregates.end()) {
+        return &aggregate->second;
+    }
+    else if (is_aggregate_variable(name)) {
+        AggregateReplacement& replacement = aggregates[name];
+        replacement.is_escaped = false;
+        return &replacement;
+    }
+    return nullptr;
+}
+
+static void collect_aggregate_escaped_value(
+    std::unordered_map<TIdentifier, AggregateReplacement>& aggregates, TacValue* node) {
+    if (node->type() == AST_T::TacVariable_t) {
+        AggregateReplacement* aggregate =
+            get_aggregate_replacement(aggregates, static_cast<TacVariable*>(node)->name);
+        if (aggregate) {
+            aggregate->is_escaped = true;
+        }
+    }
+}
+
+// Every access at an offset must move a scalar of the same size and register class, and accesses at different
+// offsets must not overlap, which also rules out byte-wise copies of string initializers.
+static void collect_aggregate_member(std::unordered_map<TIdentifier, AggregateReplacement>& aggregates,
+    const TIdentifier& name, TLong offset, TacValue* node) {
+    AggregateReplacement* aggregate = get_aggregate_replacement(aggregates, name);
+    if (!aggregate || aggregate->is_escaped) {
+        return;
+    }
+    std::shared_ptr<Type> member_type = get_alias_value_type(node);
+    if (member_type->type() == AST_T::Structure_t || member_type->type() == AST_T::Array_t) {
+        aggregate->is_escaped = true;
+        return;
+    }
+    TLong size = get_type_scale(member_type.get());
+    bool is_double = member_type->type() == AST_T::Double_t;
+    for (const auto& member : aggregate->members) {
+        if (member.offset == offset) {
+            if (member.size != size || member.is_double != is_double) {
+                aggregate->is_escaped = true;
+            }
+            return;
+        }
+    }
+    aggregate->members.push_back({offset, size, is_double, std::move(member_type), ""});
+}
+
+static void collect_aggregate_instructions(
+    std::unordered_map<TIdentifier, AggregateReplacement>& aggregates, TacInstruction* node) {
+    switch (node->type()) {
+        case AST_T::TacGetAddress_t:
+            collect_aggregate_escaped_value(aggregates, static_cast<TacGetAddress*>(node)->src.get());
+            break;
+        case AST_T::TacCopyToOffset_t: {
+            TacCopyToOffset* p_node = static_cast<TacCopyToOffset*>(node);
+            collect_aggregate_member(aggregates, p_node->dst_name, p_node->offset, p_node->src.get());
+            break;
+        }
+        case AST_T::TacCopyFromOffset_t: {
+            TacCopyFromOffset* p_node = static_cast<TacCopyFromOffset*>(node);
+            collect_aggregate_member(aggregates, p_node->src_name, p_node->offset, p_node->dst.get());
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static bool is_aggregate_member_before(const AggregateMember& member_1, const AggregateMember& member_2) {
+    return member_1.offset < member_2.offset;
+}
+
+static void replace_aggregate_members(const TIdentifier& name, AggregateReplacement& aggregate) {
+    if (aggregate.is_escaped || aggregate.members.empty()) {
+        return;
+    }
+    std::sort(aggregate.members.begin(), aggregate.members.end(), is_aggregate_member_before);
+    for (size_t i = 1; i < aggregate.members.size(); ++i) {
+        if (aggregate.members[i - 1].offset + aggregate.members[i - 1].size > aggregate.members[i].offset) {
+            aggregate.is_escaped = true;
+            return;
+        }
+    }
+    for (auto& member : aggregate.members) {
+        member.name = resolve_variable_identifier(name);
+        std::shared_ptr<Type> type = member.member_type;
+        std::unique_ptr<IdentifierAttr> attrs = std::make_unique<LocalAttr>();
+        frontend->symbol_table[member.name] = std::make_unique<Symbol>(std::move(type), std::move(attrs));
+    }
+    INCREMENT_STATS(STATS_COUNTER::replaced_aggregates);
+}
+
+static AggregateReplacement* get_replaced_aggregate(
+    std::unordered_map<TIdentifier, AggregateReplacement>& aggregates, const TIdentifier& name) {
+    auto aggregate = aggregates.find(name);
+    if (aggregate != aggregates.end() && !aggregate->second.is_escaped && !aggregate->second.members.empty()) {
+        return &aggregate->second;
+    }
+    return nullptr;
+}
+
+static AggregateReplacement* get_replaced_aggregate_value(
+    std::unordered_map<TIdentifier, AggregateReplacement>& aggregates, TacValue* node) {
+    if (node && node->type() == AST_T::TacVariable_t) {
+        return get_replaced_aggregate(aggregates, static_cast<TacVariable*>(node)->name);
+    }
+    return nullptr;
+}
+
+static std::shared_ptr<TacVariable> get_aggregate_member_value(AggregateReplacement* aggregate, TLong offset) {
+    for (const auto& member : aggregate->members) {
+        if (member.offset == offset) {
+            TIdentifier name = member.name;
+            return std::make_shared<TacVariable>(std::move(name));
+        }
+    }
+    RAISE_INTERNAL_ERROR;
+}
+
+static void store_aggregate_members_instructions(
+    std::vector<std::unique_ptr<TacInstruction>>& instructions, TacValue* node, AggregateReplacement* aggregate) {
+    for (const auto& member : aggregate->members) {
+        TIdentifier dst_name = static_cast<TacVariable*>(node)->name;
+        TLong offset = member.offset;
+        std::shared_ptr<TacValue> src;
+        {
+            TIdentifier name = member.name;
+            src = std::make_shared<TacVariable>(std::move(name));
+        }
+        instructions.push_back(
+            std::make_unique<TacCopyToOffset>(std::move(dst_name), std::move(offset), std::move(src)));
+    }
+}
+
+static void load_aggregate_members_instructions(std::vector<std::unique_ptr<TacInstruction>>& instructions,
+    const TIdentifier& name, AggregateReplacement* aggregate) {
+    for (const auto& member : aggregate->members) {
+        TIdentifier src_name = name;
+        TLong offset = member.offset;
+        std::shared_ptr<TacValue> dst;
+        {
+            TIdentifier member_name = member.name;
+            dst = std::make_shared<TacVariable>(std::move(member_name));
+        }
+        instructions.push_back(
+            std::make_unique<TacCopyFromOffset>(std::move(src_name), std::move(offset), std::move(dst)));
+    }
+}
+
+static void load_aggregate_value_instructions(std::vector<std::unique_ptr<TacInstruction>>& instructions,
+    std::unordered_map<TIdentifier, AggregateReplacement>& aggregates, TacValue* node) {
+    AggregateReplacement* aggregate = get_replaced_aggregate_value(aggregates, node);
+    if (aggregate) {
+        load_aggregate_members_instructions(instructions, static_cast<TacVariable*>(node)->name, aggregate);
+    }
+}
+
+static void store_aggregate_value_instructions(std::vector<std::unique_ptr<TacInstruction>>& instructions,
+    std::unordered_map<TIdentifier, AggregateReplacement>& aggregates, TacValue* node) {
+    AggregateReplacement* aggregate = get_replaced_aggregate_value(aggregates, node);
+    if (aggregate) {
+        store_aggregate_members_instructions(instructions, node, aggregate);
+    }
+}
+
+// Member accesses become copies of the member variables. Uses of the whole structure are kept on its memory, so the
+// members are stored back before the structure is read, and loaded again after it is written.
+static void replace_aggregates_instructions(std::vector<std::unique_ptr<TacInstruction>>& instructions,
+    std::unordered_map<TIdentifier, AggregateReplacement>& aggregates, std::unique_ptr<TacInstruction>&& node) {
+    switch (node->type()) {
+        case AST_T::TacReturn_t:
+            store_aggregate_value_instructions(
+                instructions, aggregates, static_cast<TacReturn*>(node.get())->val.get());
+            instructions.push_back(std::move(node));
+            break;
+        case AST_T::TacFunCall_t: {
+            TacFunCall* p_node = static_cast<TacFunCall*>(node.get());
+            for (const auto& arg : p_node->args) {
+                store_aggregate_value_instructions(instructions, aggregates, arg.get());
+            }
+            std::shared_ptr<TacValue> dst = p_node->dst;
+            instructions.push_back(std::move(node));
+            load_aggregate_value_instructions(instructions, aggregates, dst.get());
+            break;
+        }
+        case AST_T::TacCopy_t: {
+            TacCopy* p_node = static_cast<TacCopy*>(node.get());
+            store_aggregate_value_instructions(instructions, aggregates, p_node->src.get());
+            std::shared_ptr<TacValue> dst = p_node->dst;
+            instructions.push_back(std::move(node));
+            load_aggregate_value_instructions(instructions, aggregates, dst.get());
+            break;
+        }
+        case AST_T::TacLoad_t: {
+            std::shared_ptr<TacValue> dst = static_cast<TacLoad*>(node.get())->dst;
+            instructions.push_back(std::move(node));
+            load_aggregate_value_instructions(instructions, aggregates, dst.get());
+            break;
+        }
+        case AST_T::TacStore_t:
+            store_aggregate_value_instructions(instructions, aggregates, static_cast<TacStore*>(node.get())->src.get());
+            instructions.push_back(std::move(node));
+            break;
+        case AST_T::TacCopyToOffset_t: {
+            TacCopyToOffset* p_node = static_cast<TacCopyToOffset*>(node.get());
+            store_aggregate_value_instructions(instructions, aggregates, p_node->src.get());
+            AggregateReplacement* aggregate = get_replaced_aggregate(aggregates, p_node->dst_name);
+            if (aggregate) {
+                std::shared_ptr<TacValue> src = std::move(p_node->src);
+                std::shared_ptr<TacValue> dst = get_aggregate_member_value(aggregate, p_node->offset);
+                instructions.push_back(std::make_unique<TacCopy>(std::move(src), std::move(dst)));
+            }
+            else {
+                instructions.push_back(std::move(node));
+            }
+            break;
+        }
+        case AST_T::TacCopyFromOffset_t: {
+            TacCopyFromOffset* p_node = static_cast<TacCopyFromOffset*>(node.get());
+            std::shared_ptr<TacValue> dst = p_node->dst;
+            AggregateReplacement* aggregate = get_replaced_aggregate(aggregates, p_node->src_name);
+            if (aggregate) {
+                std::shared_ptr<TacValue> src = get_aggregate_member_value(aggregate, p_node->offset);
+                instructions.push_back(std::make_unique<TacCopy>(std::move(src), dst));
+            }
+            else {
+                instructions.push_back(std::move(node));
+            }
+            load_aggregate_value_instructions(instructions, aggregates, dst.get());
+            break;
+        }
+        default:
+            instructions.push_back(std::move(node));
+            break;
+    }
+}
+
+// Local structures whose address is never taken are split into a variable per member, which copy propagation and
+// dead store elimination then optimize as scalars. This allocates new variables, so that it runs on all functions
+// before they are optimized on jobs.
+static void replace_aggregates_function(TacFunction* node) {
+    std::unordered_map<TIdentifier, AggregateReplacement> aggregates;
+    for (const auto& instruction : node->body) {
+        if (instruction) {
+            collect_aggregate_instructions(aggregates, instruction.get());
+        }
+    }
+    bool is_replaced = false;
+    for (auto& aggregate : aggregates) {
+        replace_aggregate_members(aggregate.first, aggregate.second);
+        if (!aggregate.second.is_escaped && !aggregate.second.members.empty()) {
+            is_replaced = true;
+        }
+    }
+    if (!is_replaced) {
+        return;
+    }
+
+    std::vector<std::unique_ptr<TacInstruction>> instructions = std::move(node->body);
+    node->body.clear();
+    node->body.reserve(instructions.size());
+    for (const auto& param : node->params) {
+        AggregateReplacement* aggregate = get_replaced_aggregate(aggregates, param);
+        if (aggregate) {
+            load_aggregate_members_instructions(node->body, param, aggregate);
+        }
+    }
+    for (auto& instruction : instructions) {
+        if (instruction) {
+            replace_aggregates_instructions(node->body, aggregates, std::move(instruction));
+        }
+    }
+}
+
+static void replace_aggregates_program(TacProgram* node) {
+    for (const auto& top_level : node->function_top_levels) {
+        if (top_level->type() != AST_T::TacFunction_t) {
+            RAISE_INTERNAL_ERROR;
+        }
+        replace_aggregates_function(static_cast<TacFunction*>(top_level.get()));
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Loop unrolling
+
+#define MAX_UNROLLED_TRIP_COUNT 16l
+#define MAX_UNROLLED_LOOP_SIZE 128l
+
+static bool is_unroll_label_prefix(const TIdentifier& name, const char* prefix) {
+    return name.rfind(prefix, 0) == 0;
+}
+
+static bool get_unroll_constant(CConst* node, TLong& value) {
+    switch (node->type()) {
+        case AST_T::CConstInt_t:
+            value = static_cast<TLong>(static_cast<CConstInt*>(node)->value);
+            return true;
+        case AST_T::CConstLong_t:
+            value = static_cast<CConstLong*>(node)->value;
+            return true;
+        case AST_T::CConstUInt_t:
+            value = static_cast<TLong>(static_cast<CConstUInt*>(node)->value);
+            return true;
+        case AST_T::CConstULong_t: {
+            TULong ulong_value = static_cast<CConstULong*>(node)->value;
+            value = static_cast<TLong>(ulong_value);
+            return ulong_value <= 9223372036854775807ul;
+        }
+        case AST_T::CConstChar_t:
+            value = static_cast<TLong>(static_cast<CConstChar*>(node)->value);
+            return true;
+        case AST_T::CConstUChar_t:
+            value = static_cast<TLong>(static_cast<CConstUChar*>(node)->value);
+            return true;
+        case AST_T::CConstDouble_t:
+            return false;
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+static TacValue* get_unroll_dst_value(TacInstruction* node) {
     switch (node->type()) {
-        case AST_T::TacReturn_t:
-            propagate_copies_return_instructions(static_cast<TacReturn*>(node), instruction_index, block_id > 0);
-            break;
         case AST_T::TacSignExtend_t:
-            propagate_copies_sign_extend_instructions(static_cast<TacSignExtend*>(node), instruction_index);
-            break;
+            return static_cast<TacSignExtend*>(node)->dst.get();
         case AST_T::TacTruncate_t:
-            propagate_copies_truncate_instructions(static_cast<TacTruncate*>(node), instruction_index);
-            break;
+            return static_cast<TacTruncate*>(node)->dst.get();
         case AST_T::TacZeroExtend_t:
-            propagate_copies_zero_extend_instructions(static_cast<TacZeroExtend*>(node), instruction_index);
-            break;
+            return static_cast<TacZeroExtend*>(node)->dst.get();
         case AST_T::TacDoubleToInt_t:
-            propagate_copies_double_to_int_instructions(static_cast<TacDoubleToInt*>(node), instruction_index);
-            break;
+            return static_cast<TacDoubleToInt*>(node)->dst.get();
         case AST_T::TacDoubleToUInt_t:
-            propagate_copies_double_to_uint_instructions(static_cast<TacDoubleToUInt*>(node), instruction_index);
-            break;
+            return static_cast<TacDoubleToUInt*>(node)->dst.get();
         case AST_T::TacIntToDouble_t:
-            propagate_copies_int_to_double_instructions(static_cast<TacIntToDouble*>(node), instruction_index);
-            break;
+            return static_cast<TacIntToDouble*>(node)->dst.get();
         case AST_T::TacUIntToDouble_t:
-            propagate_copies_uint_to_double_instructions(static_cast<TacUIntToDouble*>(node), instruction_index);
-            break;
+            return static_cast<TacUIntToDouble*>(node)->dst.get();
         case AST_T::TacFunCall_t:
-            propagate_copies_fun_call_instructions(static_cast<TacFunCall*>(node), instruction_index);
-            break;
+            return static_cast<TacFunCall*>(node)->dst.get();
         case AST_T::TacUnary_t:
-            propagate_copies_unary_instructions(static_cast<TacUnary*>(node), instruction_index);
-            break;
+            return static_cast<TacUnary*>(node)->dst.get();
         case AST_T::TacBinary_t:
-            propagate_copies_binary_instructions(static_cast<TacBinary*>(node), instruction_index);
-            break;
+            return static_cast<TacBinary*>(node)->dst.get();
         case AST_T::TacCopy_t:
-            propagate_copies_copy_instructions(static_cast<TacCopy*>(node), instruction_index, block_id);
-            break;
+            return static_cast<TacCopy*>(node)->dst.get();
+        case AST_T::TacSelect_t:
+            return static_cast<TacSelect*>(node)->dst.get();
+        case AST_T::TacGetAddress_t:
+            return static_cast<TacGetAddress*>(node)->dst.get();
         case AST_T::TacLoad_t:
-            propagate_copies_load_instructions(static_cast<TacLoad*>(node), instruction_index);
-            break;
-        case AST_T::TacStore_t:
-            propagate_copies_store_instructions(static_cast<TacStore*>(node), instruction_index);
-            break;
+            return static_cast<TacLoad*>(node)->dst.get();
         case AST_T::TacAddPtr_t:
-            propagate_copies_add_ptr_instructions(static_cast<TacAddPtr*>(node), instruction_index);
-            break;
-        case AST_T::TacCopyToOffset_t:
-            propagate_copies_copy_to_offset_instructions(static_cast<TacCopyToOffset*>(node), instruction_index);
-            break;
+            return static_cast<TacAddPtr*>(node)->dst.get();
         case AST_T::TacCopyFromOffset_t:
-            propagate_copies_copy_from_offset_instructions(static_cast<TacCopyFromOffset*>(node), instruction_index);
-            break;
+            return static_cast<TacCopyFromOffset*>(node)->dst.get();
+        case AST_T::TacReturn_t:
+        case AST_T::TacStore_t:
+        case AST_T::TacCopyToOffset_t:
+        case AST_T::TacJump_t:
         case AST_T::TacJumpIfZero_t:
-            propagate_copies_jump_if_zero_instructions(
-                static_cast<TacJumpIfZero*>(node), instruction_index, block_id > 0);
-            break;
         case AST_T::TacJumpIfNotZero_t:
-            propagate_copies_jump_if_not_zero_instructions(
-                static_cast<TacJumpIfNotZero*>(node), instruction_index, block_id > 0);
-            break;
+        case AST_T::TacLabel_t:
+            return nullptr;
         default:
             RAISE_INTERNAL_ERROR;
     }
 }
 
-static void propagate_copies_control_flow_graph() {
-    if (!data_flow_analysis_initialize(false, true)) {
-        return;
+static const TIdentifier* get_unroll_jump_target(TacInstruction* node) {
+    switch (node->type()) {
+        case AST_T::TacJump_t:
+            return &static_cast<TacJump*>(node)->target;
+        case AST_T::TacJumpIfZero_t:
+            return &static_cast<TacJumpIfZero*>(node)->target;
+        case AST_T::TacJumpIfNotZero_t:
+            return &static_cast<TacJumpIfNotZero*>(node)->target;
+        default:
+            return nullptr;
     }
-    data_flow_analysis_forward_iterative_algorithm();
+}
 
-    for (size_t block_id = 0; block_id < context->control_flow_graph->blocks.size(); ++block_id) {
-        if (GET_CFG_BLOCK(block_id).size > 0) {
-            size_t incoming_index = block_id;
-            size_t exit_block = 1;
-            for (size_t instruction_index = GET_CFG_BLOCK(block_id).instructions_back_index + 1;
-                 instruction_index-- > GET_CFG_BLOCK(block_id).instructions_front_index;) {
-                if (GET_INSTRUCTION(instruction_index)) {
-                    switch (GET_INSTRUCTION(instruction_index)->type()) {
-                        case AST_T::TacReturn_t:
-                        case AST_T::TacJumpIfZero_t:
-                        case AST_T::TacJumpIfNotZero_t:
-                            propagate_copies_instructions(
-                                GET_INSTRUCTION(instruction_index).get(), incoming_index, exit_block);
-                            break;
-                        case AST_T::TacSignExtend_t:
-                        case AST_T::TacTruncate_t:
-                        case AST_T::TacZeroExtend_t:
-                        case AST_T::TacDoubleToInt_t:
-                        case AST_T::TacDoubleToUInt_t:
-                        case AST_T::TacIntToDouble_t:
-                        case AST_T::TacUIntToDouble_t:
-                        case AST_T::TacFunCall_t:
-                        case AST_T::TacUnary_t:
-                        case AST_T::TacBinary_t:
-                        case AST_T::TacCopy_t:
-                        case AST_T::TacLoad_t:
-                        case AST_T::TacStore_t:
-                        case AST_T::TacAddPtr_t:
-                        case AST_T::TacCopyToOffset_t:
-                        case AST_T::TacCopyFromOffset_t: {
-                            propagate_copies_instructions(
-                                GET_INSTRUCTION(instruction_index).get(), instruction_index, block_id);
-                            incoming_index = instruction_index;
-                            exit_block = 0;
-                            break;
-                        }
-                        case AST_T::TacGetAddress_t: {
-                            incoming_index = instruction_index;
-                            exit_block = 0;
-                            break;
-                        }
-                        default:
-                            break;
-                    }
+static bool is_unroll_defined_name(std::vector<std::unique_ptr<TacInstruction>>& instructions, const TIdentifier& name,
+    size_t begin_index, size_t end_index) {
+    for (size_t instruction_index = begin_index; instruction_index < end_index; ++instruction_index) {
+        if (instructions[instruction_index]) {
+            TacValue* dst = get_unroll_dst_value(instructions[instruction_index].get());
+            if (dst && is_name_same_value(dst, name)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// A constant that is cast to the type of the loop variable is first copied or extended into a temporary, which is
+// defined before its use in the same block.
+static bool get_unroll_value_constant(std::vector<std::unique_ptr<TacInstruction>>& instructions,
+    size_t instruction_index, TacValue* node, TLong& value) {
+    if (node->type() == AST_T::TacConstant_t) {
+        return get_unroll_constant(static_cast<TacConstant*>(node)->constant.get(), value);
+    }
+    else if (node->type() != AST_T::TacVariable_t) {
+        RAISE_INTERNAL_ERROR;
+    }
+    const TIdentifier& name = static_cast<TacVariable*>(node)->name;
+    while (instruction_index-- > 0) {
+        TacInstruction* instruction = instructions[instruction_index].get();
+        if (!instruction) {
+            continue;
+        }
+        TacValue* src;
+        switch (instruction->type()) {
+            case AST_T::TacLabel_t:
+                return false;
+            case AST_T::TacSignExtend_t:
+                src = static_cast<TacSignExtend*>(instruction)->src.get();
+                break;
+            case AST_T::TacZeroExtend_t:
+                src = static_cast<TacZeroExtend*>(instruction)->src.get();
+                break;
+            case AST_T::TacCopy_t:
+                src = static_cast<TacCopy*>(instruction)->src.get();
+                break;
+            default:
+                src = nullptr;
+                break;
+        }
+        TacValue* dst = get_unroll_dst_value(instruction);
+        if (dst && is_name_same_value(dst, name)) {
+            return src && src->type() == AST_T::TacConstant_t
+                   && get_unroll_constant(static_cast<TacConstant*>(src)->constant.get(), value);
+        }
+    }
+    return false;
+}
+
+static bool is_unroll_type_value(Type* type, TLong value) {
+    switch (type->type()) {
+        case AST_T::Int_t:
+            return value >= -2147483648l && value <= 2147483647l;
+        case AST_T::UInt_t:
+            return value >= 0l && value <= 4294967295l;
+        case AST_T::Long_t:
+            return value >= -4611686018427387904l && value <= 4611686018427387904l;
+        case AST_T::ULong_t:
+            return value >= 0l && value <= 4611686018427387904l;
+        default:
+            return false;
+    }
+}
+
+// The bound and the induction variable are compared each iteration, so they must be locals that are not accessed
+// through a pointer.
+static bool is_unroll_local_name(const std::unordered_set<TIdentifier>& addressed_names, const TIdentifier& name) {
+    return frontend->symbol_table.at(name)->attrs->type() == AST_T::LocalAttr_t
+           && addressed_names.find(name) == addressed_names.end();
+}
+
+// Labels in the loop must only be jumped to from the loop, and the start of the loop only by its back edge.
+static bool is_unroll_loop_closed(std::vector<std::unique_ptr<TacInstruction>>& instructions, UnrolledLoop& loop) {
+    const TIdentifier& start_label = static_cast<TacJump*>(instructions[loop.jump_index].get())->target;
+    std::unordered_set<TIdentifier> labels;
+    for (size_t instruction_index = loop.start_index + 1; instruction_index < loop.jump_index; ++instruction_index) {
+        TacInstruction* instruction = instructions[instruction_index].get();
+        if (instruction) {
+            if (instruction->type() == AST_T::TacLabel_t) {
+                labels.insert(static_cast<TacLabel*>(instruction)->name);
+            }
+            else {
+                const TIdentifier* target = get_unroll_jump_target(instruction);
+                if (target && target->compare(start_label) == 0) {
+                    return false;
                 }
             }
         }
     }
+    for (size_t instruction_index = 0; instruction_index < instructions.size(); ++instruction_index) {
+        if (instruction_index == loop.start_index) {
+            instruction_index = loop.jump_index;
+        }
+        else if (instructions[instruction_index]) {
+            const TIdentifier* target = get_unroll_jump_target(instructions[instruction_index].get());
+            if (target && (labels.find(*target) != labels.end() || target->compare(start_label) == 0)) {
+                return false;
+            }
+        }
+    }
+    return true;
 }
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// The induction variable is only updated by the post expression, with a constant step.
+static bool get_unroll_loop_step(std::vector<std::unique_ptr<TacInstruction>>& instructions, UnrolledLoop& loop,
+    const TIdentifier& name) {
+    size_t update_index = loop.jump_index;
+    for (size_t instruction_index = loop.start_index + 1; instruction_index < loop.jump_index; ++instruction_index) {
+        TacInstruction* instruction = instructions[instruction_index].get();
+        if (instruction) {
+            if (instruction_index > loop.continue_index
+                && (instruction->type() == AST_T::TacLabel_t || get_unroll_jump_target(instruction))) {
+                return false;
+            }
+            TacValue* dst = get_unroll_dst_value(instruction);
+            if (dst && is_name_same_value(dst, name)) {
+                if (update_index < loop.jump_index || instruction_index < loop.continue_index
+                    || instruction->type() != AST_T::TacCopy_t) {
+                    return false;
+                }
+                update_index = instruction_index;
+            }
+        }
+    }
+    if (update_index == loop.jump_index) {
+        return false;
+    }
+    TacValue* update = static_cast<TacCopy*>(instructions[update_index].get())->src.get();
+    if (update->type() != AST_T::TacVariable_t) {
+        return false;
+    }
+    for (size_t instruction_index = update_index; instruction_index-- > loop.continue_index + 1;) {
+        TacInstruction* instruction = instructions[instruction_index].get();
+        if (!instruction) {
+            continue;
+        }
+        TacValue* dst = get_unroll_dst_value(instruction);
+        if (dst && is_same_value(dst, update)) {
+            if (instruction->type() != AST_T::TacBinary_t) {
+                return false;
+            }
+            TacBinary* p_node = static_cast<TacBinary*>(instruction);
+            if (!is_name_same_value(p_node->src1.get(), name)
+                || !get_unroll_value_constant(instructions, instruction_index, p_node->src2.get(), loop.step)
+                || loop.step == 0l || loop.step < -2147483648l || loop.step > 2147483647l) {
+                return false;
+            }
+            switch (p_node->binary_op->type()) {
+                case AST_T::TacAdd_t:
+                    return true;
+                case AST_T::TacSubtract_t:
+                    loop.step = -loop.step;
+                    return true;
+                default:
+                    return false;
+            }
+        }
+    }
+    return false;
+}
 
-// Dead store elimination
+// Only loops in the shape of a for statement are unrolled: the condition compares the induction variable with a loop
+// invariant bound, and the post expression adds a constant step to it.
+static bool get_unroll_loop(std::vector<std::unique_ptr<TacInstruction>>& instructions,
+    const std::unordered_set<TIdentifier>& addressed_names, size_t jump_index, UnrolledLoop& loop) {
+    if (!instructions[jump_index] || instructions[jump_index]->type() != AST_T::TacJump_t
+        || jump_index + 1 >= instructions.size() || !instructions[jump_index + 1]
+        || instructions[jump_index + 1]->type() != AST_T::TacLabel_t) {
+        return false;
+    }
+    const TIdentifier& start_label = static_cast<TacJump*>(instructions[jump_index].get())->target;
+    const TIdentifier& break_label = static_cast<TacLabel*>(instructions[jump_index + 1].get())->name;
+    if (!is_unroll_label_prefix(start_label, "for_start") || !is_unroll_label_prefix(break_label, "break_")) {
+        return false;
+    }
+    loop.jump_index = jump_index;
 
-static void eliminate_dead_store_transfer_addressed_live_values(size_t next_instruction_index) {
-    for (size_t i = 0; i < context->data_flow_analysis->mask_size; ++i) {
-        GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, i) |=
-            GET_DFA_INSTRUCTION_SET_MASK(context->data_flow_analysis->addressed_index, i);
+    loop.start_index = jump_index;
+    while (loop.start_index-- > 0) {
+        if (instructions[loop.start_index] && instructions[loop.start_index]->type() == AST_T::TacLabel_t
+            && static_cast<TacLabel*>(instructions[loop.start_index].get())->name.compare(start_label) == 0) {
+            break;
+        }
+    }
+    if (loop.start_index >= jump_index) {
+        return false;
+    }
+
+    size_t compare_index = loop.start_index + 1;
+    for (; compare_index < jump_index; ++compare_index) {
+        TacInstruction* instruction = instructions[compare_index].get();
+        if (instruction && instruction->type() != AST_T::TacCopy_t && instruction->type() != AST_T::TacSignExtend_t
+            && instruction->type() != AST_T::TacZeroExtend_t) {
+            break;
+        }
+    }
+    if (compare_index + 1 >= jump_index || instructions[compare_index]->type() != AST_T::TacBinary_t
+        || !instructions[compare_index + 1] || instructions[compare_index + 1]->type() != AST_T::TacJumpIfZero_t) {
+        return false;
+    }
+    loop.condition_index = compare_index + 1;
+    loop.p_condition = static_cast<TacBinary*>(instructions[compare_index].get());
+    // The condition is dropped when the loop is fully unrolled, so it may only cast a constant bound.
+    for (size_t instruction_index = loop.start_index + 1; instruction_index < compare_index; ++instruction_index) {
+        if (instructions[instruction_index]
+            && !is_same_value(get_unroll_dst_value(instructions[instruction_index].get()),
+                loop.p_condition->src2.get())) {
+            return false;
+        }
+    }
+    {
+        TacJumpIfZero* p_node = static_cast<TacJumpIfZero*>(instructions[loop.condition_index].get());
+        if (p_node->target.compare(break_label) != 0
+            || !is_same_value(p_node->condition.get(), loop.p_condition->dst.get())) {
+            return false;
+        }
+    }
+    switch (loop.p_condition->binary_op->type()) {
+        case AST_T::TacLessThan_t:
+        case AST_T::TacLessOrEqual_t:
+        case AST_T::TacGreaterThan_t:
+        case AST_T::TacGreaterOrEqual_t:
+            break;
+        default:
+            return false;
+    }
+    if (loop.p_condition->src1->type() != AST_T::TacVariable_t) {
+        return false;
+    }
+    const TIdentifier& name = static_cast<TacVariable*>(loop.p_condition->src1.get())->name;
+    if (!is_unroll_local_name(addressed_names, name)) {
+        return false;
+    }
+    switch (frontend->symbol_table.at(name)->type_t->type()) {
+        case AST_T::Int_t:
+        case AST_T::Long_t:
+        case AST_T::UInt_t:
+        case AST_T::ULong_t:
+            break;
+        default:
+            return false;
+    }
+
+    {
+        TIdentifier continue_label = "continue_" + break_label.substr(6);
+        for (loop.continue_index = jump_index; loop.continue_index-- > loop.condition_index + 1;) {
+            if (instructions[loop.continue_index] && instructions[loop.continue_index]->type() == AST_T::TacLabel_t
+                && static_cast<TacLabel*>(instructions[loop.continue_index].get())->name.compare(continue_label)
+                       == 0) {
+                break;
+            }
+        }
+        if (loop.continue_index <= loop.condition_index) {
+            return false;
+        }
+    }
+    if (!get_unroll_loop_step(instructions, loop, name)) {
+        return false;
+    }
+    switch (loop.p_condition->binary_op->type()) {
+        case AST_T::TacLessThan_t:
+        case AST_T::TacLessOrEqual_t: {
+            if (loop.step < 0l) {
+                return false;
+            }
+            break;
+        }
+        case AST_T::TacGreaterThan_t:
+        case AST_T::TacGreaterOrEqual_t: {
+            if (loop.step > 0l) {
+                return false;
+            }
+            break;
+        }
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+
+    loop.is_constant_bound =
+        get_unroll_value_constant(instructions, compare_index, loop.p_condition->src2.get(), loop.bound_value);
+    if (loop.is_constant_bound) {
+        if (!is_unroll_type_value(frontend->symbol_table.at(name)->type_t.get(), loop.bound_value)) {
+            return false;
+        }
+    }
+    else if (loop.p_condition->src2->type() != AST_T::TacVariable_t) {
+        return false;
+    }
+    else {
+        const TIdentifier& bound_name = static_cast<TacVariable*>(loop.p_condition->src2.get())->name;
+        if (!is_unroll_local_name(addressed_names, bound_name)
+            || is_unroll_defined_name(instructions, bound_name, loop.start_index + 1, jump_index)) {
+            return false;
+        }
     }
+    return is_unroll_loop_closed(instructions, loop);
 }
 
-static void eliminate_dead_store_transfer_aliased_live_values(size_t next_instruction_index) {
-    for (size_t i = 0; i < context->data_flow_analysis->mask_size; ++i) {
-        GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, i) |=
-            GET_DFA_INSTRUCTION_SET_MASK(context->data_flow_analysis->static_index, i);
-        GET_DFA_INSTRUCTION_SET_MASK(next_instruction_index, i) |=
-            GET_DFA_INSTRUCTION_SET_MASK(context->data_flow_analysis->addressed_index, i);
+// The trip count is known when the induction variable is initialized to a constant right before the loop.
+static bool get_unroll_trip_count(
+    std::vector<std::unique_ptr<TacInstruction>>& instructions, UnrolledLoop& loop, TLong& trip_count) {
+    if (!loop.is_constant_bound || loop.start_index == 0 || !instructions[loop.start_index - 1]
+        || instructions[loop.start_index - 1]->type() != AST_T::TacCopy_t) {
+        return false;
+    }
+    TacCopy* p_node = static_cast<TacCopy*>(instructions[loop.start_index - 1].get());
+    if (!is_same_value(p_node->dst.get(), loop.p_condition->src1.get())) {
+        return false;
+    }
+    TLong value;
+    Type* type = frontend->symbol_table.at(static_cast<TacVariable*>(p_node->dst.get())->name)->type_t.get();
+    if (!get_unroll_value_constant(instructions, loop.start_index - 1, p_node->src.get(), value)
+        || !is_unroll_type_value(type, value)) {
+        return false;
+    }
+    TLong distance;
+    switch (loop.p_condition->binary_op->type()) {
+        case AST_T::TacLessThan_t:
+            distance = loop.bound_value - value;
+            break;
+        case AST_T::TacLessOrEqual_t:
+            distance = loop.bound_value - value + 1l;
+            break;
+        case AST_T::TacGreaterThan_t:
+            distance = value - loop.bound_value;
+            break;
+        case AST_T::TacGreaterOrEqual_t:
+            distance = value - loop.bound_value + 1l;
+            break;
+        default:
+            RAISE_INTERNAL_ERROR;
     }
+    TLong step = loop.step > 0l ? loop.step : -loop.step;
+    trip_count = distance > 0l ? (distance + step - 1l) / step : 0l;
+    return trip_count <= MAX_UNROLLED_TRIP_COUNT && is_unroll_type_value(type, value + trip_count * loop.step);
 }
 
-static void eliminate_dead_store_transfer_src_name_live_values(const TIdentifier& name, size_t next_instruction_index) {
-    size_t i = context->control_flow_graph->identifier_id_map[name];
-    SET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i, true);
+static std::unique_ptr<TacUnaryOp> clone_unroll_unary_op(TacUnaryOp* node) {
+    switch (node->type()) {
+        case AST_T::TacComplement_t:
+            return std::make_unique<TacComplement>();
+        case AST_T::TacNegate_t:
+            return std::make_unique<TacNegate>();
+        case AST_T::TacNot_t:
+            return std::make_unique<TacNot>();
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
 }
 
-static void eliminate_dead_store_transfer_src_value_live_values(TacValue* node, size_t next_instruction_index) {
-    if (node->type() == AST_T::TacVariable_t) {
-        eliminate_dead_store_transfer_src_name_live_values(
-            static_cast<TacVariable*>(node)->name, next_instruction_index);
+static std::unique_ptr<TacBinaryOp> clone_unroll_binary_op(TacBinaryOp* node) {
+    switch (node->type()) {
+        case AST_T::TacAdd_t:
+            return std::make_unique<TacAdd>();
+        case AST_T::TacSubtract_t:
+            return std::make_unique<TacSubtract>();
+        case AST_T::TacMultiply_t:
+            return std::make_unique<TacMultiply>();
+        case AST_T::TacDivide_t:
+            return std::make_unique<TacDivide>();
+        case AST_T::TacRemainder_t:
+            return std::make_unique<TacRemainder>();
+        case AST_T::TacBitAnd_t:
+            return std::make_unique<TacBitAnd>();
+        case AST_T::TacBitOr_t:
+            return std::make_unique<TacBitOr>();
+        case AST_T::TacBitXor_t:
+            return std::make_unique<TacBitXor>();
+        case AST_T::TacBitShiftLeft_t:
+            return std::make_unique<TacBitShiftLeft>();
+        case AST_T::TacBitShiftRight_t:
+            return std::make_unique<TacBitShiftRight>();
+        case AST_T::TacBitShrArithmetic_t:
+            return std::make_unique<TacBitShrArithmetic>();
+        case AST_T::TacEqual_t:
+            return std::make_unique<TacEqual>();
+        case AST_T::TacNotEqual_t:
+            return std::make_unique<TacNotEqual>();
+        case AST_T::TacLessThan_t:
+            return std::make_unique<TacLessThan>();
+        case AST_T::TacLessOrEqual_t:
+            return std::make_unique<TacLessOrEqual>();
+        case AST_T::TacGreaterThan_t:
+            return std::make_unique<TacGreaterThan>();
+        case AST_T::TacGreaterOrEqual_t:
+            return std::make_unique<TacGreaterOrEqual>();
+        default:
+            RAISE_INTERNAL_ERROR;
     }
 }
 
-static void eliminate_dead_store_transfer_dst_value_live_values(TacValue* node, size_t next_instruction_index) {
-    if (node->type() != AST_T::TacVariable_t) {
-        RAISE_INTERNAL_ERROR;
-    }
-    size_t i = context->control_flow_graph->identifier_id_map[static_cast<TacVariable*>(node)->name];
-    SET_DFA_INSTRUCTION_SET_AT(next_instruction_index, i, false);
+static TIdentifier get_unroll_label(std::unordered_map<TIdentifier, TIdentifier>& labels, const TIdentifier& name) {
+    auto label = labels.find(name);
+    return label != labels.end() ? label->second : name;
 }
 
-static void eliminate_dead_store_transfer_live_values(TacInstruction* node, size_t next_instruction_index) {
+// Values are immutable and shared between the copies, only the labels in the loop are renamed.
+static std::unique_ptr<TacInstruction> clone_unroll_instruction(
+    TacInstruction* node, std::unordered_map<TIdentifier, TIdentifier>& labels) {
     switch (node->type()) {
-        case AST_T::TacReturn_t: {
-            TacReturn* p_node = static_cast<TacReturn*>(node);
-            if (p_node->val) {
-                eliminate_dead_store_transfer_src_value_live_values(p_node->val.get(), next_instruction_index);
-            }
-            break;
-        }
+        case AST_T::TacReturn_t:
+            return std::make_unique<TacReturn>(static_cast<TacReturn*>(node)->val);
         case AST_T::TacSignExtend_t: {
             TacSignExtend* p_node = static_cast<TacSignExtend*>(node);
-            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
-            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
-            break;
+            return std::make_unique<TacSignExtend>(p_node->src, p_node->dst);
         }
         case AST_T::TacTruncate_t: {
             TacTruncate* p_node = static_cast<TacTruncate*>(node);
-            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
-            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
-            break;
+            return std::make_unique<TacTruncate>(p_node->src, p_node->dst);
         }
         case AST_T::TacZeroExtend_t: {
             TacZeroExtend* p_node = static_cast<TacZeroExtend*>(node);
-            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
-            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
-            break;
+            return std::make_unique<TacZeroExtend>(p_node->src, p_node->dst);
         }
         case AST_T::TacDoubleToInt_t: {
             TacDoubleToInt* p_node = static_cast<TacDoubleToInt*>(node);
-            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
-            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
-            break;
+            return std::make_unique<TacDoubleToInt>(p_node->src, p_node->dst);
         }
         case AST_T::TacDoubleToUInt_t: {
             TacDoubleToUInt* p_node = static_cast<TacDoubleToUInt*>(node);
-            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
-            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
-            break;
+            return std::make_unique<TacDoubleToUInt>(p_node->src, p_node->dst);
         }
         case AST_T::TacIntToDouble_t: {
             TacIntToDouble* p_node = static_cast<TacIntToDouble*>(node);
-            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
-            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
-            break;
+            return std::make_unique<TacIntToDouble>(p_node->src, p_node->dst);
         }
         case AST_T::TacUIntToDouble_t: {
             TacUIntToDouble* p_node = static_cast<TacUIntToDouble*>(node);
-            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
-            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
-            break;
+            return std::make_unique<TacUIntToDouble>(p_node->src, p_node->dst);
         }
         case AST_T::TacFunCall_t: {
             TacFunCall* p_node = static_cast<TacFunCall*>(node);
-            if (p_node->dst) {
-                eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
-            }
-            for (const auto& arg : p_node->args) {
-                eliminate_dead_store_transfer_src_value_live_values(arg.get(), next_instruction_index);
-            }
-            eliminate_dead_store_transfer_aliased_live_values(next_instruction_index);
-            break;
+            TIdentifier name = p_node->name;
+            return std::make_unique<TacFunCall>(std::move(name), p_node->args, p_node->dst, p_node->is_tail_call);
         }
         case AST_T::TacUnary_t: {
             TacUnary* p_node = static_cast<TacUnary*>(node);
-            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
-            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
-            break;
+            return std::make_unique<TacUnary>(clone_unroll_unary_op(p_node->unary_op.get()), p_node->src, p_node->dst);
         }
         case AST_T::TacBinary_t: {
             TacBinary* p_node = static_cast<TacBinary*>(node);
-            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
-            eliminate_dead_store_transfer_src_value_live_values(p_node->src1.get(), next_instruction_index);
-            eliminate_dead_store_transfer_src_value_live_values(p_node->src2.get(), next_instruction_index);
-            break;
+            return std::make_unique<TacBinary>(
+                clone_unroll_binary_op(p_node->binary_op.get()), p_node->src1, p_node->src2, p_node->dst);
         }
         case AST_T::TacCopy_t: {
             TacCopy* p_node = static_cast<TacCopy*>(node);
-            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
-            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
-            break;
+            return std::make_unique<TacCopy>(p_node->src, p_node->dst);
+        }
+        case AST_T::TacSelect_t: {
+            TacSelect* p_node = static_cast<TacSelect*>(node);
+            return std::make_unique<TacSelect>(p_node->condition, p_node->src_true, p_node->src_false, p_node->dst);
+        }
+        case AST_T::TacGetAddress_t: {
+            TacGetAddress* p_node = static_cast<TacGetAddress*>(node);
+            return std::make_unique<TacGetAddress>(p_node->src, p_node->dst);
         }
-        case AST_T::TacGetAddress_t:
-            eliminate_dead_store_transfer_dst_value_live_values(
-                static_cast<TacGetAddress*>(node)->dst.get(), next_instruction_index);
-            break;
         case AST_T::TacLoad_t: {
             TacLoad* p_node = static_cast<TacLoad*>(node);
-            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
-            eliminate_dead_store_transfer_src_value_live_values(p_node->src_ptr.get(), next_instruction_index);
-            eliminate_dead_store_transfer_addressed_live_values(next_instruction_index);
-            break;
+            return std::make_unique<TacLoad>(p_node->src_ptr, p_node->dst);
         }
         case AST_T::TacStore_t: {
             TacStore* p_node = static_cast<TacStore*>(node);
-            eliminate_dead_store_transfer_src_value_live_values(p_node->src.get(), next_instruction_index);
-            eliminate_dead_store_transfer_src_value_live_values(p_node->dst_ptr.get(), next_instruction_index);
-            break;
+            return std::make_unique<TacStore>(p_node->src, p_node->dst_ptr);
         }
         case AST_T::TacAddPtr_t: {
             TacAddPtr* p_node = static_cast<TacAddPtr*>(node);
-            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
-            eliminate_dead_store_transfer_src_value_live_values(p_node->src_ptr.get(), next_instruction_index);
-            eliminate_dead_store_transfer_src_value_live_values(p_node->index.get(), next_instruction_index);
-            break;
+            return std::make_unique<TacAddPtr>(p_node->scale, p_node->src_ptr, p_node->index, p_node->dst);
+        }
+        case AST_T::TacCopyToOffset_t: {
+            TacCopyToOffset* p_node = static_cast<TacCopyToOffset*>(node);
+            TIdentifier dst_name = p_node->dst_name;
+            return std::make_unique<TacCopyToOffset>(std::move(dst_name), p_node->offset, p_node->src);
         }
-        case AST_T::TacCopyToOffset_t:
-            eliminate_dead_store_transfer_src_value_live_values(
-                static_cast<TacCopyToOffset*>(node)->src.get(), next_instruction_index);
-            break;
         case AST_T::TacCopyFromOffset_t: {
             TacCopyFromOffset* p_node = static_cast<TacCopyFromOffset*>(node);
-            eliminate_dead_store_transfer_dst_value_live_values(p_node->dst.get(), next_instruction_index);
-            eliminate_dead_store_transfer_src_name_live_values(p_node->src_name, next_instruction_index);
-            break;
+            TIdentifier src_name = p_node->src_name;
+            return std::make_unique<TacCopyFromOffset>(std::move(src_name), p_node->offset, p_node->dst);
         }
-        case AST_T::TacJumpIfZero_t:
-            eliminate_dead_store_transfer_src_value_live_values(
-                static_cast<TacJumpIfZero*>(node)->condition.get(), next_instruction_index);
-            break;
-        case AST_T::TacJumpIfNotZero_t:
-            eliminate_dead_store_transfer_src_value_live_values(
-                static_cast<TacJumpIfNotZero*>(node)->condition.get(), next_instruction_index);
-            break;
+        case AST_T::TacJump_t:
+            return std::make_unique<TacJump>(get_unroll_label(labels, static_cast<TacJump*>(node)->target));
+        case AST_T::TacJumpIfZero_t: {
+            TacJumpIfZero* p_node = static_cast<TacJumpIfZero*>(node);
+            return std::make_unique<TacJumpIfZero>(get_unroll_label(labels, p_node->target), p_node->condition);
+        }
+        case AST_T::TacJumpIfNotZero_t: {
+            TacJumpIfNotZero* p_node = static_cast<TacJumpIfNotZero*>(node);
+            return std::make_unique<TacJumpIfNotZero>(get_unroll_label(labels, p_node->target), p_node->condition);
+        }
+        case AST_T::TacLabel_t:
+            return std::make_unique<TacLabel>(get_unroll_label(labels, static_cast<TacLabel*>(node)->name));
         default:
             RAISE_INTERNAL_ERROR;
     }
 }
 
-static void eliminate_dead_store_dst_name_instructions(const TIdentifier& name, size_t instruction_index) {
-    size_t i = context->control_flow_graph->identifier_id_map[name];
-    if (!GET_DFA_INSTRUCTION_SET_AT(instruction_index, i)) {
-        set_instruction(nullptr, instruction_index);
+// Each copy of the body, from after the condition to before the back edge, gets its own labels.
+static void unroll_loop_body_instructions(std::vector<std::unique_ptr<TacInstruction>>& unrolled_instructions,
+    std::vector<std::unique_ptr<TacInstruction>>& instructions, UnrolledLoop& loop) {
+    std::unordered_map<TIdentifier, TIdentifier> labels;
+    for (size_t instruction_index = loop.condition_index + 1; instruction_index < loop.jump_index;
+         ++instruction_index) {
+        if (instructions[instruction_index] && instructions[instruction_index]->type() == AST_T::TacLabel_t) {
+            labels[static_cast<TacLabel*>(instructions[instruction_index].get())->name] =
+                represent_label_identifier(LABEL_KIND::Lunroll);
+        }
+    }
+    for (size_t instruction_index = loop.condition_index + 1; instruction_index < loop.jump_index;
+         ++instruction_index) {
+        if (instructions[instruction_index]) {
+            unrolled_instructions.push_back(clone_unroll_instruction(instructions[instruction_index].get(), labels));
+        }
     }
 }
 
-static void eliminate_dead_store_dst_value_instructions(TacValue* node, size_t instruction_index) {
-    if (node->type() != AST_T::TacVariable_t) {
-        RAISE_INTERNAL_ERROR;
+static std::shared_ptr<TacVariable> unroll_loop_variable_value(const TIdentifier& name, AST_T type_t) {
+    TIdentifier unrolled_name = resolve_variable_identifier(name);
+    {
+        std::shared_ptr<Type> type = intern_scalar_type(type_t);
+        std::unique_ptr<IdentifierAttr> attrs = std::make_unique<LocalAttr>();
+        frontend->symbol_table[unrolled_name] = std::make_unique<Symbol>(std::move(type), std::move(attrs));
     }
-    eliminate_dead_store_dst_name_instructions(static_cast<TacVariable*>(node)->name, instruction_index);
+    return std::make_shared<TacVariable>(std::move(unrolled_name));
 }
 
-static void eliminate_dead_store_instructions(TacInstruction* node, size_t instruction_index) {
-    switch (node->type()) {
-        case AST_T::TacSignExtend_t:
-            eliminate_dead_store_dst_value_instructions(
-                static_cast<TacSignExtend*>(node)->dst.get(), instruction_index);
-            break;
-        case AST_T::TacTruncate_t:
-            eliminate_dead_store_dst_value_instructions(static_cast<TacTruncate*>(node)->dst.get(), instruction_index);
-            break;
-        case AST_T::TacZeroExtend_t:
-            eliminate_dead_store_dst_value_instructions(
-                static_cast<TacZeroExtend*>(node)->dst.get(), instruction_index);
-            break;
-        case AST_T::TacDoubleToInt_t:
-            eliminate_dead_store_dst_value_instructions(
-                static_cast<TacDoubleToInt*>(node)->dst.get(), instruction_index);
-            break;
-        case AST_T::TacDoubleToUInt_t:
-            eliminate_dead_store_dst_value_instructions(
-                static_cast<TacDoubleToUInt*>(node)->dst.get(), instruction_index);
-            break;
-        case AST_T::TacIntToDouble_t:
-            eliminate_dead_store_dst_value_instructions(
-                static_cast<TacIntToDouble*>(node)->dst.get(), instruction_index);
-            break;
-        case AST_T::TacUIntToDouble_t:
-            eliminate_dead_store_dst_value_instructions(
-                static_cast<TacUIntToDouble*>(node)->dst.get(), instruction_index);
-            break;
-        case AST_T::TacUnary_t:
-            eliminate_dead_store_dst_value_instructions(static_cast<TacUnary*>(node)->dst.get(), instruction_index);
-            break;
-        case AST_T::TacBinary_t:
-            eliminate_dead_store_dst_value_instructions(static_cast<TacBinary*>(node)->dst.get(), instruction_index);
-            break;
-        case AST_T::TacCopy_t:
-            eliminate_dead_store_dst_value_instructions(static_cast<TacCopy*>(node)->dst.get(), instruction_index);
-            break;
-        case AST_T::TacGetAddress_t:
-            eliminate_dead_store_dst_value_instructions(
-                static_cast<TacGetAddress*>(node)->dst.get(), instruction_index);
-            break;
-        case AST_T::TacLoad_t:
-            eliminate_dead_store_dst_value_instructions(static_cast<TacLoad*>(node)->dst.get(), instruction_index);
-            break;
-        case AST_T::TacAddPtr_t:
-            eliminate_dead_store_dst_value_instructions(static_cast<TacAddPtr*>(node)->dst.get(), instruction_index);
-            break;
-        case AST_T::TacCopyToOffset_t:
-            eliminate_dead_store_dst_name_instructions(
-                static_cast<TacCopyToOffset*>(node)->dst_name, instruction_index);
-            break;
-        case AST_T::TacCopyFromOffset_t:
-            eliminate_dead_store_dst_value_instructions(
-                static_cast<TacCopyFromOffset*>(node)->dst.get(), instruction_index);
-            break;
+static std::shared_ptr<TacValue> unroll_loop_long_value(
+    std::vector<std::unique_ptr<TacInstruction>>& unrolled_instructions, const std::shared_ptr<TacValue>& node) {
+    const TIdentifier& name = static_cast<TacVariable*>(node.get())->name;
+    std::shared_ptr<TacValue> src = node;
+    std::shared_ptr<TacValue> dst = unroll_loop_variable_value(name, AST_T::Long_t);
+    if (frontend->symbol_table.at(name)->type_t->type() == AST_T::Int_t) {
+        unrolled_instructions.push_back(std::make_unique<TacSignExtend>(std::move(src), dst));
+    }
+    else {
+        unrolled_instructions.push_back(std::make_unique<TacZeroExtend>(std::move(src), dst));
+    }
+    return dst;
+}
+
+// The unrolled loop runs while the last of its iterations would still pass the condition, which is checked on 64 bits
+// so that it can not overflow, then the original loop runs the remaining iterations.
+static void unroll_loop_partially_instructions(std::vector<std::unique_ptr<TacInstruction>>& unrolled_instructions,
+    std::vector<std::unique_ptr<TacInstruction>>& instructions, UnrolledLoop& loop, size_t unroll_factor) {
+    TIdentifier label = represent_label_identifier(LABEL_KIND::Lunroll);
+    {
+        TIdentifier name = label;
+        unrolled_instructions.push_back(std::make_unique<TacLabel>(std::move(name)));
+    }
+    std::shared_ptr<TacValue> src1;
+    {
+        std::shared_ptr<TacValue> src = unroll_loop_long_value(unrolled_instructions, loop.p_condition->src1);
+        std::shared_ptr<TacValue> step;
+        {
+            TLong value = static_cast<TLong>(unroll_factor - 1) * (loop.step > 0l ? loop.step : -loop.step);
+            std::shared_ptr<CConst> constant = std::make_shared<CConstLong>(value);
+            step = std::make_shared<TacConstant>(std::move(constant));
+        }
+        src1 = unroll_loop_variable_value(static_cast<TacVariable*>(loop.p_condition->src1.get())->name, AST_T::Long_t);
+        if (loop.step > 0l) {
+            unrolled_instructions.push_back(
+                std::make_unique<TacBinary>(std::make_unique<TacAdd>(), std::move(src), std::move(step), src1));
+        }
+        else {
+            unrolled_instructions.push_back(
+                std::make_unique<TacBinary>(std::make_unique<TacSubtract>(), std::move(src), std::move(step), src1));
+        }
+    }
+    std::shared_ptr<TacValue> src2;
+    if (loop.is_constant_bound) {
+        std::shared_ptr<CConst> constant = std::make_shared<CConstLong>(loop.bound_value);
+        src2 = std::make_shared<TacConstant>(std::move(constant));
+    }
+    else {
+        src2 = unroll_loop_long_value(unrolled_instructions, loop.p_condition->src2);
+    }
+    std::shared_ptr<TacValue> condition =
+        unroll_loop_variable_value(static_cast<TacVariable*>(loop.p_condition->dst.get())->name, AST_T::Int_t);
+    unrolled_instructions.push_back(std::make_unique<TacBinary>(
+        clone_unroll_binary_op(loop.p_condition->binary_op.get()), std::move(src1), std::move(src2), condition));
+    {
+        TIdentifier target = static_cast<TacJump*>(instructions[loop.jump_index].get())->target;
+        unrolled_instructions.push_back(std::make_unique<TacJumpIfZero>(std::move(target), std::move(condition)));
+    }
+    for (size_t i = 0; i < unroll_factor; ++i) {
+        unroll_loop_body_instructions(unrolled_instructions, instructions, loop);
+    }
+    unrolled_instructions.push_back(std::make_unique<TacJump>(std::move(label)));
+    for (size_t instruction_index = loop.start_index; instruction_index <= loop.jump_index; ++instruction_index) {
+        if (instructions[instruction_index]) {
+            unrolled_instructions.push_back(std::move(instructions[instruction_index]));
+        }
+    }
+}
+
+static size_t get_unroll_loop_size(std::vector<std::unique_ptr<TacInstruction>>& instructions, UnrolledLoop& loop) {
+    size_t loop_size = 0;
+    for (size_t instruction_index = loop.condition_index + 1; instruction_index < loop.jump_index;
+         ++instruction_index) {
+        if (instructions[instruction_index]) {
+            loop_size++;
+        }
+    }
+    return loop_size;
+}
+
+// The guard of the unrolled loop is widened to 64 bits, which only has room for the steps of 32 bits variables.
+static bool is_unroll_partial_loop(UnrolledLoop& loop, size_t unroll_factor, TLong loop_size) {
+    if (unroll_factor < 2 || static_cast<TLong>(unroll_factor) * loop_size > MAX_UNROLLED_LOOP_SIZE) {
+        return false;
+    }
+    switch (frontend->symbol_table.at(static_cast<TacVariable*>(loop.p_condition->src1.get())->name)->type_t->type()) {
+        case AST_T::Int_t:
+        case AST_T::UInt_t:
+            return true;
         default:
-            break;
+            return false;
     }
 }
 
-static void eliminate_dead_store_control_flow_graph(bool init_alias_set) {
-    if (!data_flow_analysis_initialize(true, init_alias_set)) {
-        return;
+// Loops with a small constant trip count are replaced by copies of their body, other loops are unrolled by the factor
+// when the induction variable is an int. Inner loops come first, so that an outer loop sees their unrolled size.
+static void unroll_loops_function(TacFunction* node, size_t unroll_factor) {
+    std::unordered_set<TIdentifier> addressed_names;
+    for (const auto& instruction : node->body) {
+        if (instruction && instruction->type() == AST_T::TacGetAddress_t) {
+            TacValue* src = static_cast<TacGetAddress*>(instruction.get())->src.get();
+            if (src->type() == AST_T::TacVariable_t) {
+                addressed_names.insert(static_cast<TacVariable*>(src)->name);
+            }
+        }
     }
-    data_flow_analysis_backward_iterative_algorithm();
 
-    for (size_t block_id = 0; block_id < context->control_flow_graph->blocks.size(); ++block_id) {
-        if (GET_CFG_BLOCK(block_id).size > 0) {
-            for (size_t instruction_index = GET_CFG_BLOCK(block_id).instructions_front_index;
-                 instruction_index <= GET_CFG_BLOCK(block_id).instructions_back_index; ++instruction_index) {
-                if (GET_INSTRUCTION(instruction_index)) {
-                    eliminate_dead_store_instructions(GET_INSTRUCTION(instruction_index).get(), instruction_index);
-                }
+    std::vector<std::unique_ptr<TacInstruction>>& instructions = node->body;
+    for (size_t instruction_index = 0; instruction_index < instructions.size(); ++instruction_index) {
+        UnrolledLoop loop;
+        if (!get_unroll_loop(instructions, addressed_names, instruction_index, loop)) {
+            continue;
+        }
+        TLong loop_size = static_cast<TLong>(get_unroll_loop_size(instructions, loop));
+        TLong trip_count;
+        std::vector<std::unique_ptr<TacInstruction>> unrolled_instructions;
+        if (get_unroll_trip_count(instructions, loop, trip_count)
+            && trip_count * loop_size <= MAX_UNROLLED_LOOP_SIZE) {
+            for (TLong i = 0l; i < trip_count; ++i) {
+                unroll_loop_body_instructions(unrolled_instructions, instructions, loop);
             }
+            INCREMENT_STATS(STATS_COUNTER::fully_unrolled_loops);
+        }
+        else if (is_unroll_partial_loop(loop, unroll_factor, loop_size)) {
+            unroll_loop_partially_instructions(unrolled_instructions, instructions, loop, unroll_factor);
+            INCREMENT_STATS(STATS_COUNTER::partially_unrolled_loops);
+        }
+        else {
+            continue;
         }
+        size_t unrolled_size = unrolled_instructions.size();
+        instructions.erase(instructions.begin() + loop.start_index, instructions.begin() + loop.jump_index + 1);
+        instructions.insert(instructions.begin() + loop.start_index,
+            std::make_move_iterator(unrolled_instructions.begin()),
+            std::make_move_iterator(unrolled_instructions.end()));
+        instruction_index = loop.start_index + unrolled_size - 1;
+    }
+}
+
+// This allocates new variables and labels, so that it runs on all functions before they are optimized on jobs.
+static void unroll_loops_program(TacProgram* node, size_t unroll_factor) {
+    for (const auto& top_level : node->function_top_levels) {
+        if (top_level->type() != AST_T::TacFunction_t) {
+            RAISE_INTERNAL_ERROR;
+        }
+        unroll_loops_function(static_cast<TacFunction*>(top_level.get()), unroll_factor);
     }
 }
 
@@ -2795,30 +5328,73 @@ static void eliminate_dead_store_control_flow_graph(bool init_alias_set) {
 #define COPY_PROPAGATION 1
 #define UNREACHABLE_CODE_ELIMINATION 2
 #define DEAD_STORE_ELMININATION 3
-#define CONTROL_FLOW_GRAPH 4
+#define TAIL_CALL_ELIMINATION 4
+#define BLOCK_LAYOUT 5
+#define REDUNDANT_LOAD_ELIMINATION 6
+#define CONTROL_FLOW_GRAPH 7
 
 static void optimize_function_top_level(TacFunction* node) {
+    TRACE_EVENT_BEGIN("optimize_function");
+    TRACE_EVENT_ARG("function", node->name);
+    TRACE_EVENT_ARG("instructions", node->body.size());
     context->p_instructions = &node->body;
+    size_t iteration = 0;
     do {
+        TRACE_EVENT_BEGIN("fixed_point_iteration");
+        TRACE_EVENT_ARG("iteration", iteration);
+        iteration++;
         context->is_fixed_point = true;
         if (context->enabled_optimizations[CONSTANT_FOLDING]) {
+            TRACE_EVENT_BEGIN("fold_constants");
             fold_constants_list_instructions();
+            TRACE_EVENT_END("fold_constants");
         }
         if (context->enabled_optimizations[CONTROL_FLOW_GRAPH]) {
+            TRACE_EVENT_BEGIN("control_flow_graph");
             control_flow_graph_initialize();
+            TRACE_EVENT_ARG("blocks", context->control_flow_graph->blocks.size());
+            TRACE_EVENT_END("control_flow_graph");
             if (context->enabled_optimizations[UNREACHABLE_CODE_ELIMINATION]) {
+                TRACE_EVENT_BEGIN("eliminate_unreachable_code");
                 eliminate_unreachable_code_control_flow_graph();
+                TRACE_EVENT_END("eliminate_unreachable_code");
             }
             if (context->enabled_optimizations[COPY_PROPAGATION]) {
+                TRACE_EVENT_BEGIN("propagate_copies");
                 propagate_copies_control_flow_graph();
+                TRACE_EVENT_END("propagate_copies");
+            }
+            if (context->enabled_optimizations[REDUNDANT_LOAD_ELIMINATION]) {
+                TRACE_EVENT_BEGIN("eliminate_redundant_loads");
+                eliminate_redundant_load_control_flow_graph(!context->enabled_optimizations[COPY_PROPAGATION]);
+                TRACE_EVENT_END("eliminate_redundant_loads");
             }
             if (context->enabled_optimizations[DEAD_STORE_ELMININATION]) {
-                eliminate_dead_store_control_flow_graph(!context->enabled_optimizations[COPY_PROPAGATION]);
+                TRACE_EVENT_BEGIN("eliminate_dead_stores");
+                eliminate_dead_store_control_flow_graph(!context->enabled_optimizations[COPY_PROPAGATION]
+                                                        && !context->enabled_optimizations[REDUNDANT_LOAD_ELIMINATION]);
+                TRACE_EVENT_END("eliminate_dead_stores");
             }
         }
+        TRACE_EVENT_END("fixed_point_iteration");
     }
     while (!context->is_fixed_point);
+    if (context->enabled_optimizations[BLOCK_LAYOUT]) {
+        TRACE_EVENT_BEGIN("layout_blocks");
+        control_flow_graph_initialize();
+        layout_control_flow_graph();
+        TRACE_EVENT_END("layout_blocks");
+    }
+    if (context->enabled_optimizations[TAIL_CALL_ELIMINATION]) {
+        TRACE_EVENT_BEGIN("mark_tail_calls");
+        mark_tail_calls_function(node);
+        TRACE_EVENT_END("mark_tail_calls");
+    }
     context->p_instructions = nullptr;
+    INCREMENT_STATS(STATS_COUNTER::optimized_functions);
+    ADD_STATS(STATS_COUNTER::fixed_point_iterations, iteration);
+    TRACE_EVENT_ARG("iterations", iteration);
+    TRACE_EVENT_END("optimize_function");
 }
 
 static void optimize_top_level(TacTopLevel* node) {
@@ -2838,15 +5414,55 @@ static void optimize_program(TacProgram* node) {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void three_address_code_optimization(TacProgram* node, uint8_t optim_1_mask) {
+static void init_optimization(uint8_t optim_1_mask) {
     context = std::make_unique<OptimTacContext>(optim_1_mask);
-    if (context->enabled_optimizations[CONTROL_FLOW_GRAPH]) {
+    if (context->enabled_optimizations[CONTROL_FLOW_GRAPH] || context->enabled_optimizations[BLOCK_LAYOUT]) {
         context->control_flow_graph = std::make_unique<ControlFlowGraph>();
         if (context->enabled_optimizations[COPY_PROPAGATION]
+            || context->enabled_optimizations[REDUNDANT_LOAD_ELIMINATION]
             || context->enabled_optimizations[DEAD_STORE_ELMININATION]) {
             context->data_flow_analysis = std::make_unique<DataFlowAnalysis>();
         }
     }
+}
+
+// Functions are optimized independently, so each job thread has its own context and takes whole functions.
+static void init_optimization_job() { init_optimization(jobs_context->optim_1_mask); }
+
+static void optimize_function_job(size_t function_index) {
+    begin_label_shard(function_index);
+    optimize_top_level(jobs_context->p_node->function_top_levels[function_index].get());
+    end_label_shard();
+}
+
+static void free_optimization_job() { context.reset(); }
+
+void three_address_code_optimization(TacProgram* node, uint8_t optim_1_mask, size_t unroll_factor, size_t jobs) {
+    if ((optim_1_mask & (static_cast<uint8_t>(1u) << 4)) > 0) {
+        TRACE_EVENT_BEGIN("eliminate_tail_recursion");
+        eliminate_tail_recursion_program(node);
+        TRACE_EVENT_END("eliminate_tail_recursion");
+    }
+    if ((optim_1_mask & (static_cast<uint8_t>(1u) << 1)) > 0) {
+        TRACE_EVENT_BEGIN("replace_aggregates");
+        replace_aggregates_program(node);
+        TRACE_EVENT_END("replace_aggregates");
+    }
+    if ((optim_1_mask & (static_cast<uint8_t>(1u) << 7)) > 0) {
+        TRACE_EVENT_BEGIN("unroll_loops");
+        unroll_loops_program(node, unroll_factor);
+        TRACE_EVENT_END("unroll_loops");
+    }
+    if (jobs > 1) {
+        jobs_context = std::make_unique<OptimTacJobsContext>();
+        jobs_context->p_node = node;
+        jobs_context->optim_1_mask = optim_1_mask;
+        run_jobs(jobs, node->function_top_levels.size(), init_optimization_job, optimize_function_job,
+            free_optimization_job);
+        jobs_context.reset();
+        return;
+    }
+    init_optimization(optim_1_mask);
     optimize_program(node);
     context.reset();
 }
@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <dirent.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "util/comp_cache.hpp"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Compile cache
+
+// A cache entry is the emitted assembly of a translation unit, in a file named after two 64-bit hashes of a key that
+// holds the compiler binary identity, the optimization options and the fully included token stream of the unit. Hits
+// touch their entry, so that eviction by size removes the least recently used entries first.
+
+static uint64_t get_fnv_1a_hash(const std::string& key) {
+    uint64_t hash = 14695981039346656037ul;
+    for (char c : key) {
+        hash ^= static_cast<uint64_t>(static_cast<unsigned char>(c));
+        hash *= 1099511628211ul;
+    }
+    return hash;
+}
+
+// The compiler binary is identified by its size and mtime, so that rebuilding it invalidates every entry.
+static bool get_compiler_id(std::string& compiler_id) {
+    struct stat file_stat;
+    if (stat("/proc/self/exe", &file_stat) == -1) {
+        return false;
+    }
+    compiler_id = std::to_string(static_cast<uint64_t>(file_stat.st_size));
+    compiler_id += ":";
+    compiler_id += std::to_string(static_cast<uint64_t>(file_stat.st_mtime));
+    compiler_id += ";";
+    return true;
+}
+
+bool get_compile_cache_key(const std::string& key, CompileCacheKey& cache_key) {
+    std::string compiler_key;
+    if (!get_compiler_id(compiler_key)) {
+        return false;
+    }
+    compiler_key += key;
+    cache_key.hash_1 = get_fnv_1a_hash(compiler_key);
+    cache_key.hash_2 = static_cast<uint64_t>(std::hash<std::string> {}(compiler_key));
+    return true;
+}
+
+static std::string get_cache_dirname(const std::string& cachedir) {
+    std::string cache_dirname = cachedir;
+    if (cache_dirname.back() != '/') {
+        cache_dirname += '/';
+    }
+    return cache_dirname;
+}
+
+// Entries keep the extension of the output file, either .s for assembly or .o for object code.
+static std::string get_cache_filename(
+    const std::string& cachedir, const CompileCacheKey& cache_key, const std::string& filename) {
+    std::string cache_filename = get_cache_dirname(cachedir);
+    char key_hash[33];
+    snprintf(key_hash, sizeof(key_hash), "%016" PRIx64 "%016" PRIx64, cache_key.hash_1, cache_key.hash_2);
+    cache_filename += key_hash;
+    cache_filename += filename.substr(filename.size() - 2, 2);
+    return cache_filename;
+}
+
+static bool copy_file(int file_descriptor_read, const std::string& filename) {
+    FILE* file_descriptor_write = fopen(filename.c_str(), "wb");
+    if (!file_descriptor_write) {
+        return false;
+    }
+    bool is_copied = true;
+    {
+        char buffer[65536];
+        ssize_t len;
+        while ((len = read(file_descriptor_read, buffer, sizeof(buffer))) > 0) {
+            if (fwrite(buffer, sizeof(char), static_cast<size_t>(len), file_descriptor_write)
+                != static_cast<size_t>(len)) {
+                is_copied = false;
+                break;
+            }
+        }
+        is_copied = is_copied && len == 0;
+    }
+    is_copied = fclose(file_descriptor_write) == 0 && is_copied;
+    return is_copied;
+}
+
+bool load_compile_cache(const std::string& cachedir, const CompileCacheKey& cache_key, const std::string& filename) {
+    int file_descriptor = open(get_cache_filename(cachedir, cache_key, filename).c_str(), O_RDONLY);
+    if (file_descriptor == -1) {
+        return false;
+    }
+    bool is_loaded = copy_file(file_descriptor, filename);
+    if (is_loaded) {
+        futimens(file_descriptor, nullptr);
+    }
+    close(file_descriptor);
+    if (!is_loaded) {
+        remove(filename.c_str());
+    }
+    return is_loaded;
+}
+
+// Once the entries take more than max_size bytes, the least recently used ones are removed until they take at most
+// three quarters of it, so that the next few stores do not have to remove entries again.
+static void evict_compile_cache(const std::string& cachedir, uint64_t max_size) {
+    std::string cache_dirname = get_cache_dirname(cachedir);
+    DIR* directory = opendir(cache_dirname.c_str());
+    if (!directory) {
+        return;
+    }
+    uint64_t cache_size = 0;
+    std::vector<std::pair<time_t, std::string>> cache_files;
+    for (struct dirent* entry = readdir(directory); entry; entry = readdir(directory)) {
+        size_t len = strlen(entry->d_name);
+        if (len != 34 || (strcmp(entry->d_name + 32, ".s") != 0 && strcmp(entry->d_name + 32, ".o") != 0)) {
+            continue;
+        }
+        std::string cache_filename = cache_dirname;
+        cache_filename += entry->d_name;
+        struct stat file_stat;
+        if (stat(cache_filename.c_str(), &file_stat) == 0) {
+            cache_size += static_cast<uint64_t>(file_stat.st_size);
+            cache_files.emplace_back(file_stat.st_mtime, std::move(cache_filename));
+        }
+    }
+    closedir(directory);
+    if (cache_size <= max_size) {
+        return;
+    }
+
+    std::sort(cache_files.begin(), cache_files.end());
+    for (const auto& cache_file : cache_files) {
+        if (cache_size <= max_size / 4 * 3) {
+            break;
+        }
+        struct stat file_stat;
+        if (stat(cache_file.second.c_str(), &file_stat) == 0 && remove(cache_file.second.c_str()) == 0) {
+            cache_size -= std::min(cache_size, static_cast<uint64_t>(file_stat.st_size));
+        }
+    }
+}
+
+// Caching is best effort: any failure to write the cache entry leaves the compilation unaffected.
+void store_compile_cache(
+    const std::string& cachedir, const CompileCacheKey& cache_key, const std::string& filename, uint64_t max_size) {
+    int file_descriptor = open(filename.c_str(), O_RDONLY);
+    if (file_descriptor == -1) {
+        return;
+    }
+    mkdir(cachedir.c_str(), 0755);
+    std::string cache_filename = get_cache_filename(cachedir, cache_key, filename);
+    std::string temp_filename = cache_filename;
+    temp_filename += ".";
+    temp_filename += std::to_string(getpid());
+    bool is_copied = copy_file(file_descriptor, temp_filename);
+    close(file_descriptor);
+    if (!is_copied || rename(temp_filename.c_str(), cache_filename.c_str()) != 0) {
+        remove(temp_filename.c_str());
+        return;
+    }
+    evict_compile_cache(cachedir, max_size);
+}
@@ -96,6 +96,13 @@ void write_line(std::string&& line) {
     write_file(std::move(line), 4096);
 }
 
+// Binary output is written at once, as it is assembled in memory before.
+void write_bytes(std::string&& bytes) {
+    write_chunk(util->write_buffer);
+    util->write_buffer = "";
+    write_chunk(bytes);
+}
+
 void file_close_read(size_t line_number) {
     fclose(util->file_reads.back().file_descriptor);
     util->file_reads.back().file_descriptor = nullptr;
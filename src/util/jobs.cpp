@@ -0,0 +1,66 @@
+#include <atomic>
+#include <inttypes.h>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "util/jobs.hpp"
+#include "util/report.hpp"
+
+#include "ast/ast.hpp"
+
+static std::unique_ptr<JobsContext> context;
+
+JobsContext::JobsContext(size_t size, void (*init_job)(), void (*run_job)(size_t), void (*free_job)()) :
+    size(size), init_job(init_job), run_job(run_job), free_job(free_job), next_index(0), is_failed(false) {}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Jobs
+
+// Each thread takes the next job index until there is none left, so that jobs of uneven size are balanced. The first
+// error stops the other threads from taking new jobs, and is raised again on the calling thread.
+static void run_thread_jobs() {
+    try {
+        context->init_job();
+        for (size_t i = context->next_index++; i < context->size && !context->is_failed; i = context->next_index++) {
+            context->run_job(i);
+        }
+        context->free_job();
+    }
+    catch (const std::runtime_error& error) {
+        std::lock_guard<std::mutex> lock(context->error_mutex);
+        if (!context->is_failed) {
+            context->is_failed = true;
+            context->error_message = error.what();
+        }
+    }
+}
+
+static void run_worker_thread_jobs() {
+    run_thread_jobs();
+    fold_alloc_counters();
+    fold_ast_node_count();
+}
+
+// The calling thread runs jobs too, so jobs threads in total share the work.
+void run_jobs(size_t jobs, size_t size, void (*init_job)(), void (*run_job)(size_t), void (*free_job)()) {
+    context = std::make_unique<JobsContext>(size, init_job, run_job, free_job);
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < jobs && i < size; ++i) {
+        threads.emplace_back(run_worker_thread_jobs);
+    }
+    run_thread_jobs();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    bool is_failed = context->is_failed;
+    std::string error_message = std::move(context->error_message);
+    context.reset();
+    if (is_failed) {
+        throw std::runtime_error(error_message);
+    }
+}
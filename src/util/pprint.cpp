@@ -368,6 +368,8 @@ static void print_ast(Ast* node, size_t t) {
             field("BackendFun", "", ++t);
             BackendFun* p_node = static_cast<BackendFun*>(node);
             field("Bool", std::to_string(p_node->is_defined), t + 1);
+            field("Bool", std::to_string(p_node->is_local), t + 1);
+            field("Bool", std::to_string(p_node->is_got), t + 1);
             break;
         }
         case AST_T::CUnaryOp_t: {
@@ -1127,6 +1129,7 @@ static void print_ast(Ast* node, size_t t) {
                 print_ast(item.get(), t + 1);
             }
             print_ast(p_node->dst.get(), t);
+            field("Bool", std::to_string(p_node->is_tail_call), t + 1);
             break;
         }
         case AST_T::TacUnary_t: {
@@ -1153,6 +1156,15 @@ static void print_ast(Ast* node, size_t t) {
             print_ast(p_node->dst.get(), t);
             break;
         }
+        case AST_T::TacSelect_t: {
+            field("TacSelect", "", ++t);
+            TacSelect* p_node = static_cast<TacSelect*>(node);
+            print_ast(p_node->condition.get(), t);
+            print_ast(p_node->src_true.get(), t);
+            print_ast(p_node->src_false.get(), t);
+            print_ast(p_node->dst.get(), t);
+            break;
+        }
         case AST_T::TacGetAddress_t: {
             field("TacGetAddress", "", ++t);
             TacGetAddress* p_node = static_cast<TacGetAddress*>(node);
@@ -1560,6 +1572,13 @@ static void print_ast(Ast* node, size_t t) {
             print_ast(p_node->dst.get(), t);
             break;
         }
+        case AST_T::AsmMovdqu_t: {
+            field("AsmMovdqu", "", ++t);
+            AsmMovdqu* p_node = static_cast<AsmMovdqu*>(node);
+            print_ast(p_node->src.get(), t);
+            print_ast(p_node->dst.get(), t);
+            break;
+        }
         case AST_T::AsmLea_t: {
             field("AsmLea", "", ++t);
             AsmLea* p_node = static_cast<AsmLea*>(node);
@@ -1628,6 +1647,10 @@ static void print_ast(Ast* node, size_t t) {
             print_ast(p_node->assembly_type.get(), t);
             break;
         }
+        case AST_T::AsmRepMovsb_t: {
+            field("AsmRepMovsb", "", ++t);
+            break;
+        }
         case AST_T::AsmJmp_t: {
             field("AsmJmp", "", ++t);
             AsmJmp* p_node = static_cast<AsmJmp*>(node);
@@ -1648,6 +1671,15 @@ static void print_ast(Ast* node, size_t t) {
             print_ast(p_node->dst.get(), t);
             break;
         }
+        case AST_T::AsmCmov_t: {
+            field("AsmCmov", "", ++t);
+            AsmCmov* p_node = static_cast<AsmCmov*>(node);
+            print_ast(p_node->cond_code.get(), t);
+            print_ast(p_node->assembly_type.get(), t);
+            print_ast(p_node->src.get(), t);
+            print_ast(p_node->dst.get(), t);
+            break;
+        }
         case AST_T::AsmLabel_t: {
             field("AsmLabel", "", ++t);
             AsmLabel* p_node = static_cast<AsmLabel*>(node);
@@ -1666,6 +1698,12 @@ static void print_ast(Ast* node, size_t t) {
             field("TIdentifier", p_node->name, t + 1);
             break;
         }
+        case AST_T::AsmTailCall_t: {
+            field("AsmTailCall", "", ++t);
+            AsmTailCall* p_node = static_cast<AsmTailCall*>(node);
+            field("TIdentifier", p_node->name, t + 1);
+            break;
+        }
         case AST_T::AsmRet_t: {
             field("AsmRet", "", ++t);
             break;
@@ -1680,6 +1718,7 @@ static void print_ast(Ast* node, size_t t) {
             field("TIdentifier", p_node->name, t + 1);
             field("Bool", std::to_string(p_node->is_global), t + 1);
             field("Bool", std::to_string(p_node->is_return_memory), t + 1);
+            field("Bool", std::to_string(p_node->is_frame_pointer), t + 1);
             field("List[" + std::to_string(p_node->instructions.size()) + "]", "", t + 1);
             for (const auto& item : p_node->instructions) {
                 print_ast(item.get(), t + 1);
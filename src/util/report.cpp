@@ -0,0 +1,196 @@
+#include <atomic>
+#include <inttypes.h>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <sys/resource.h>
+#include <time.h>
+
+#include "util/report.hpp"
+
+std::unique_ptr<ReportContext> report;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Allocation counters
+
+// Global allocations are always counted, as two increments per allocation cost next to nothing compared to malloc.
+// Counters are per thread, so that jobs do not contend on them, and are folded into the totals when a job thread ends.
+
+static thread_local size_t alloc_count = 0;
+static thread_local size_t alloc_bytes = 0;
+static std::atomic<size_t> folded_alloc_count(0);
+static std::atomic<size_t> folded_alloc_bytes(0);
+
+void* operator new(size_t size) {
+    alloc_count++;
+    alloc_bytes += size;
+    void* ptr = malloc(size > 0 ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void* ptr) noexcept { free(ptr); }
+
+void operator delete[](void* ptr) noexcept { free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { free(ptr); }
+
+void operator delete[](void* ptr, size_t) noexcept { free(ptr); }
+
+void fold_alloc_counters() {
+    folded_alloc_count += alloc_count;
+    folded_alloc_bytes += alloc_bytes;
+    alloc_count = 0;
+    alloc_bytes = 0;
+}
+
+static size_t get_alloc_count() { return alloc_count + folded_alloc_count; }
+
+static size_t get_alloc_bytes() { return alloc_bytes + folded_alloc_bytes; }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Report
+
+static double get_clock_time(clockid_t clock_id) {
+    struct timespec time_spec;
+    clock_gettime(clock_id, &time_spec);
+    return static_cast<double>(time_spec.tv_sec) * 1000.0 + static_cast<double>(time_spec.tv_nsec) / 1000000.0;
+}
+
+static size_t get_peak_rss() {
+    struct rusage resource_usage;
+    if (getrusage(RUSAGE_SELF, &resource_usage) == -1) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<size_t>(resource_usage.ru_maxrss) / 1024;
+#else
+    return static_cast<size_t>(resource_usage.ru_maxrss);
+#endif
+}
+
+ReportContext::ReportContext(bool is_json) :
+    is_json(is_json), wall_time(0.0), cpu_time(0.0), alloc_count(0), alloc_bytes(0) {}
+
+void begin_phase_report() {
+    if (!report) {
+        return;
+    }
+    report->wall_time = get_clock_time(CLOCK_MONOTONIC);
+    report->cpu_time = get_clock_time(CLOCK_PROCESS_CPUTIME_ID);
+    report->alloc_count = get_alloc_count();
+    report->alloc_bytes = get_alloc_bytes();
+}
+
+// Returns the report of the phase so that the caller can record the size of the ir, or null when reports are off.
+PhaseReport* end_phase_report(std::string&& name) {
+    if (!report) {
+        return nullptr;
+    }
+    PhaseReport phase_report = {std::move(name), get_clock_time(CLOCK_MONOTONIC) - report->wall_time,
+        get_clock_time(CLOCK_PROCESS_CPUTIME_ID) - report->cpu_time, get_peak_rss(),
+        get_alloc_count() - report->alloc_count, get_alloc_bytes() - report->alloc_bytes, "", 0, {}};
+    report->phase_reports.emplace_back(std::move(phase_report));
+    return &report->phase_reports.back();
+}
+
+static void print_table_report() {
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer), "%-26s %10s %10s %10s %10s %12s  %s\n", "phase", "wall (ms)", "cpu (ms)",
+        "rss (kB)", "allocs", "alloc (kB)", "ir");
+    std::string table = buffer;
+    double wall_time = 0.0;
+    double cpu_time = 0.0;
+    size_t peak_rss = 0;
+    size_t alloc_count = 0;
+    size_t alloc_bytes = 0;
+    for (const auto& phase_report : report->phase_reports) {
+        std::string ir_size = "-";
+        if (!phase_report.ir_name.empty()) {
+            ir_size = std::to_string(phase_report.ir_size);
+            ir_size += " ";
+            ir_size += phase_report.ir_name;
+            const std::pair<std::string, size_t>* max_function_size = nullptr;
+            for (const auto& function_size : phase_report.ir_function_sizes) {
+                if (!max_function_size || function_size.second > max_function_size->second) {
+                    max_function_size = &function_size;
+                }
+            }
+            if (max_function_size) {
+                ir_size += " (max ";
+                ir_size += std::to_string(max_function_size->second);
+                ir_size += " in ";
+                ir_size += max_function_size->first;
+                ir_size += ")";
+            }
+        }
+        snprintf(buffer, sizeof(buffer), "%-26s %10.3f %10.3f %10zu %10zu %12.1f  %s\n", phase_report.name.c_str(),
+            phase_report.wall_time, phase_report.cpu_time, phase_report.peak_rss, phase_report.alloc_count,
+            static_cast<double>(phase_report.alloc_bytes) / 1024.0, ir_size.c_str());
+        table += buffer;
+        wall_time += phase_report.wall_time;
+        cpu_time += phase_report.cpu_time;
+        peak_rss = phase_report.peak_rss;
+        alloc_count += phase_report.alloc_count;
+        alloc_bytes += phase_report.alloc_bytes;
+    }
+    snprintf(buffer, sizeof(buffer), "%-26s %10.3f %10.3f %10zu %10zu %12.1f\n", "total", wall_time, cpu_time,
+        peak_rss, alloc_count, static_cast<double>(alloc_bytes) / 1024.0);
+    table += buffer;
+    std::cout << table;
+}
+
+static void print_json_report() {
+    char buffer[256];
+    std::string json = "{\"phases\": [";
+    for (size_t i = 0; i < report->phase_reports.size(); ++i) {
+        const PhaseReport& phase_report = report->phase_reports[i];
+        snprintf(buffer, sizeof(buffer),
+            "%s\n  {\"name\": \"%s\", \"wall_ms\": %.3f, \"cpu_ms\": %.3f, \"peak_rss_kb\": %zu, \"allocs\": %zu, "
+            "\"alloc_bytes\": %zu",
+            i > 0 ? "," : "", phase_report.name.c_str(), phase_report.wall_time, phase_report.cpu_time,
+            phase_report.peak_rss, phase_report.alloc_count, phase_report.alloc_bytes);
+        json += buffer;
+        if (!phase_report.ir_name.empty()) {
+            json += ", \"ir\": {\"name\": \"";
+            json += phase_report.ir_name;
+            json += "\", \"size\": ";
+            json += std::to_string(phase_report.ir_size);
+            json += ", \"functions\": {";
+            for (size_t j = 0; j < phase_report.ir_function_sizes.size(); ++j) {
+                if (j > 0) {
+                    json += ", ";
+                }
+                json += "\"";
+                json += phase_report.ir_function_sizes[j].first;
+                json += "\": ";
+                json += std::to_string(phase_report.ir_function_sizes[j].second);
+            }
+            json += "}}";
+        }
+        json += "}";
+    }
+    json += "\n]}\n";
+    std::cout << json;
+}
+
+void print_report() {
+    if (!report) {
+        return;
+    }
+    if (report->is_json) {
+        print_json_report();
+    }
+    else {
+        print_table_report();
+    }
+}
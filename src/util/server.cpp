@@ -0,0 +1,384 @@
+#include <errno.h>
+#include <inttypes.h>
+#include <iostream>
+#include <poll.h>
+#include <signal.h>
+#include <stdexcept>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+#include "util/server.hpp"
+
+extern char** environ;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Server
+
+// A client sends its stdout and stderr file descriptors with a single request laid out as:
+// length | working directory | arg count | (arg)... | env count | (WHEELCC_ env variable)...
+// and the server replies with: length | status | error message
+// Requests are compiled one at a time in the server process, so that anything cached in memory is kept warm for the
+// next requests. A compile error is sent back to the client, which raises it as if it compiled the file itself.
+
+constexpr int SERVER_IDLE_TIMEOUT = 15 * 60 * 1000;
+constexpr size_t SERVER_MAX_REQUEST_SIZE = 1 << 24;
+
+struct ServerRequest {
+    std::string cwd;
+    std::vector<std::string> args;
+    std::vector<std::string> envs;
+};
+
+static bool write_all(int file_descriptor, const char* buffer, size_t len) {
+    while (len > 0) {
+        ssize_t written = write(file_descriptor, buffer, len);
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        buffer += written;
+        len -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+static bool read_all(int file_descriptor, char* buffer, size_t len) {
+    while (len > 0) {
+        ssize_t bytes_read = read(file_descriptor, buffer, len);
+        if (bytes_read == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        else if (bytes_read == 0) {
+            return false;
+        }
+        buffer += bytes_read;
+        len -= static_cast<size_t>(bytes_read);
+    }
+    return true;
+}
+
+static void append_uint32(std::string& buffer, uint32_t value) {
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(uint32_t));
+}
+
+static void append_string(std::string& buffer, const std::string& value) {
+    append_uint32(buffer, static_cast<uint32_t>(value.size()));
+    buffer += value;
+}
+
+static bool read_uint32(const std::string& buffer, size_t& i, uint32_t& value) {
+    if (buffer.size() - i < sizeof(uint32_t)) {
+        return false;
+    }
+    memcpy(&value, &buffer[i], sizeof(uint32_t));
+    i += sizeof(uint32_t);
+    return true;
+}
+
+static bool read_string(const std::string& buffer, size_t& i, std::string& value) {
+    uint32_t len;
+    if (!read_uint32(buffer, i, len) || buffer.size() - i < len) {
+        return false;
+    }
+    value.assign(buffer, i, len);
+    i += len;
+    return true;
+}
+
+static bool read_strings(const std::string& buffer, size_t& i, std::vector<std::string>& values) {
+    uint32_t count;
+    if (!read_uint32(buffer, i, count)) {
+        return false;
+    }
+    for (uint32_t j = 0; j < count; ++j) {
+        std::string value;
+        if (!read_string(buffer, i, value)) {
+            return false;
+        }
+        values.emplace_back(std::move(value));
+    }
+    return true;
+}
+
+static bool get_socket_address(const std::string& socket_filename, struct sockaddr_un& socket_address) {
+    if (socket_filename.size() >= sizeof(socket_address.sun_path)) {
+        return false;
+    }
+    memset(&socket_address, 0, sizeof(struct sockaddr_un));
+    socket_address.sun_family = AF_UNIX;
+    memcpy(socket_address.sun_path, socket_filename.c_str(), socket_filename.size());
+    return true;
+}
+
+static bool is_server_env(const char* env) { return strncmp(env, "WHEELCC_", 8) == 0; }
+
+static int connect_socket(struct sockaddr_un& socket_address) {
+    int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (connection == -1) {
+        return -1;
+    }
+    else if (connect(connection, reinterpret_cast<struct sockaddr*>(&socket_address), sizeof(struct sockaddr_un))
+             == -1) {
+        int connect_errno = errno;
+        close(connection);
+        errno = connect_errno;
+        return -1;
+    }
+    return connection;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Server side
+
+// The stdout and stderr of the client come with the length of the request as an SCM_RIGHTS control message.
+static bool receive_request(int connection, ServerRequest& request, int (&client_fds)[2]) {
+    uint32_t len;
+    char control[CMSG_SPACE(sizeof(client_fds))];
+    struct iovec io_vector = {&len, sizeof(uint32_t)};
+    struct msghdr message;
+    memset(&message, 0, sizeof(struct msghdr));
+    message.msg_iov = &io_vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    if (recvmsg(connection, &message, MSG_WAITALL) != static_cast<ssize_t>(sizeof(uint32_t))) {
+        return false;
+    }
+    struct cmsghdr* control_message = CMSG_FIRSTHDR(&message);
+    if (!control_message || control_message->cmsg_type != SCM_RIGHTS
+        || control_message->cmsg_len != CMSG_LEN(sizeof(client_fds))) {
+        return false;
+    }
+    memcpy(client_fds, CMSG_DATA(control_message), sizeof(client_fds));
+    if (len > SERVER_MAX_REQUEST_SIZE) {
+        return false;
+    }
+
+    std::string buffer(len, '\0');
+    size_t i = 0;
+    return read_all(connection, &buffer[0], len) && read_string(buffer, i, request.cwd)
+           && read_strings(buffer, i, request.args) && read_strings(buffer, i, request.envs) && i == buffer.size();
+}
+
+static void send_reply(int connection, uint32_t status, const std::string& error_message) {
+    std::string buffer;
+    append_uint32(buffer, status);
+    append_string(buffer, error_message);
+    std::string reply;
+    append_uint32(reply, static_cast<uint32_t>(buffer.size()));
+    reply += buffer;
+    write_all(connection, reply.c_str(), reply.size());
+}
+
+// Only the WHEELCC_ variables of the client are visible to the request, which reads its options from them.
+static void set_request_envs(const std::vector<std::string>& envs) {
+    std::vector<std::string> names;
+    for (char** env = environ; *env; ++env) {
+        if (is_server_env(*env)) {
+            std::string name = *env;
+            names.emplace_back(name.substr(0, name.find('=')));
+        }
+    }
+    for (const auto& name : names) {
+        unsetenv(name.c_str());
+    }
+    for (const auto& env : envs) {
+        size_t i = env.find('=');
+        if (i != std::string::npos && is_server_env(env.c_str())) {
+            setenv(env.substr(0, i).c_str(), env.substr(i + 1).c_str(), 1);
+        }
+    }
+}
+
+static void serve_request(int connection, void (*compile_request)(std::vector<std::string>&& args)) {
+    ServerRequest request;
+    int client_fds[2] = {-1, -1};
+    if (!receive_request(connection, request, client_fds) || chdir(request.cwd.c_str()) != 0) {
+        send_reply(connection, 2, "");
+    }
+    else {
+        set_request_envs(request.envs);
+        int server_fds[2] = {dup(STDOUT_FILENO), dup(STDERR_FILENO)};
+        dup2(client_fds[0], STDOUT_FILENO);
+        dup2(client_fds[1], STDERR_FILENO);
+        uint32_t status = 0;
+        std::string error_message;
+        try {
+            compile_request(std::move(request.args));
+        }
+        catch (const std::runtime_error& error) {
+            status = 1;
+            error_message = error.what();
+        }
+        std::cout.flush();
+        fflush(stdout);
+        fflush(stderr);
+        dup2(server_fds[0], STDOUT_FILENO);
+        dup2(server_fds[1], STDERR_FILENO);
+        close(server_fds[0]);
+        close(server_fds[1]);
+        send_reply(connection, status, error_message);
+    }
+    for (int client_fd : client_fds) {
+        if (client_fd != -1) {
+            close(client_fd);
+        }
+    }
+}
+
+static void stop_server(int) {}
+
+// Listens until no request came in for SERVER_IDLE_TIMEOUT, or until it is interrupted by a signal, then removes the
+// socket and exits. A server that is already listening on the socket is left running instead.
+int run_server(const std::string& socket_filename, void (*compile_request)(std::vector<std::string>&& args)) {
+    struct sockaddr_un socket_address;
+    if (!get_socket_address(socket_filename, socket_address)) {
+        return 1;
+    }
+    {
+        int connection = connect_socket(socket_address);
+        if (connection != -1) {
+            close(connection);
+            return 0;
+        }
+    }
+    int server_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server_socket == -1) {
+        return 1;
+    }
+    unlink(socket_filename.c_str());
+    mode_t mode = umask(0077);
+    if (bind(server_socket, reinterpret_cast<struct sockaddr*>(&socket_address), sizeof(struct sockaddr_un)) == -1
+        || listen(server_socket, 64) == -1) {
+        umask(mode);
+        close(server_socket);
+        return 1;
+    }
+    umask(mode);
+    signal(SIGPIPE, SIG_IGN);
+    {
+        struct sigaction signal_action;
+        memset(&signal_action, 0, sizeof(struct sigaction));
+        signal_action.sa_handler = stop_server;
+        sigaction(SIGINT, &signal_action, nullptr);
+        sigaction(SIGTERM, &signal_action, nullptr);
+        sigaction(SIGHUP, &signal_action, nullptr);
+    }
+
+    struct pollfd poll_socket = {server_socket, POLLIN, 0};
+    while (poll(&poll_socket, 1, SERVER_IDLE_TIMEOUT) > 0) {
+        int connection = accept(server_socket, nullptr, nullptr);
+        if (connection == -1) {
+            continue;
+        }
+        serve_request(connection, compile_request);
+        close(connection);
+    }
+    close(server_socket);
+    unlink(socket_filename.c_str());
+    return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Client side
+
+static bool send_request(int connection, int argc, char** argv) {
+    std::string buffer;
+    {
+        char* cwd = getcwd(nullptr, 0);
+        if (!cwd) {
+            return false;
+        }
+        append_string(buffer, cwd);
+        free(cwd);
+    }
+    append_uint32(buffer, static_cast<uint32_t>(argc));
+    for (int i = 0; i < argc; ++i) {
+        append_string(buffer, argv[i]);
+    }
+    {
+        std::vector<std::string> envs;
+        for (char** env = environ; *env; ++env) {
+            if (is_server_env(*env)) {
+                envs.emplace_back(*env);
+            }
+        }
+        append_uint32(buffer, static_cast<uint32_t>(envs.size()));
+        for (const auto& env : envs) {
+            append_string(buffer, env);
+        }
+    }
+
+    uint32_t len = static_cast<uint32_t>(buffer.size());
+    int client_fds[2] = {STDOUT_FILENO, STDERR_FILENO};
+    char control[CMSG_SPACE(sizeof(client_fds))];
+    memset(control, 0, sizeof(control));
+    struct iovec io_vector = {&len, sizeof(uint32_t)};
+    struct msghdr message;
+    memset(&message, 0, sizeof(struct msghdr));
+    message.msg_iov = &io_vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    struct cmsghdr* control_message = CMSG_FIRSTHDR(&message);
+    control_message->cmsg_level = SOL_SOCKET;
+    control_message->cmsg_type = SCM_RIGHTS;
+    control_message->cmsg_len = CMSG_LEN(sizeof(client_fds));
+    memcpy(CMSG_DATA(control_message), client_fds, sizeof(client_fds));
+    return sendmsg(connection, &message, 0) == static_cast<ssize_t>(sizeof(uint32_t))
+           && write_all(connection, buffer.c_str(), buffer.size());
+}
+
+static bool receive_reply(int connection, uint32_t& status, std::string& error_message) {
+    uint32_t len;
+    if (!read_all(connection, reinterpret_cast<char*>(&len), sizeof(uint32_t)) || len > SERVER_MAX_REQUEST_SIZE) {
+        return false;
+    }
+    std::string buffer(len, '\0');
+    size_t i = 0;
+    return read_all(connection, &buffer[0], len) && read_uint32(buffer, i, status)
+           && read_string(buffer, i, error_message);
+}
+
+// Returns false when no server is listening, or when it could not take the request before compiling it, and then the
+// client compiles by itself. Once the server compiled the request, its compile error is raised here instead.
+bool run_client(const std::string& socket_filename, int argc, char** argv) {
+    struct sockaddr_un socket_address;
+    if (!get_socket_address(socket_filename, socket_address)) {
+        return false;
+    }
+    int connection = connect_socket(socket_address);
+    if (connection == -1) {
+        // A socket left behind by a server that was killed is removed, so that the driver starts a new server.
+        if (errno == ECONNREFUSED) {
+            unlink(socket_filename.c_str());
+        }
+        return false;
+    }
+    uint32_t status;
+    std::string error_message;
+    if (!send_request(connection, argc, argv) || !receive_reply(connection, status, error_message) || status == 2) {
+        close(connection);
+        return false;
+    }
+    close(connection);
+    if (status != 0) {
+        throw std::runtime_error(error_message);
+    }
+    return true;
+}
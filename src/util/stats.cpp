@@ -0,0 +1,97 @@
+#include <array>
+#include <inttypes.h>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "util/stats.hpp"
+#include "util/throw.hpp"
+
+std::unique_ptr<StatsContext> stats;
+
+StatsContext::StatsContext() {
+    for (auto& counter : counters) {
+        counter = 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Stats
+
+// Counter names are stable keys, grouped by the pass that increments them, so that runs can be diffed by scripts.
+static const char* get_stats_counter_name(STATS_COUNTER stats_counter) {
+    switch (stats_counter) {
+        case STATS_COUNTER::folded_instructions:
+            return "fold_constants.instructions_folded";
+        case STATS_COUNTER::folded_copies:
+            return "fold_constants.copies_folded";
+        case STATS_COUNTER::folded_jumps:
+            return "fold_constants.jumps_folded";
+        case STATS_COUNTER::removed_unreachable_blocks:
+            return "unreachable_code.blocks_removed";
+        case STATS_COUNTER::removed_unreachable_jumps:
+            return "unreachable_code.jumps_removed";
+        case STATS_COUNTER::removed_unreachable_labels:
+            return "unreachable_code.labels_removed";
+        case STATS_COUNTER::propagated_copy_operands:
+            return "copy_propagation.operands_replaced";
+        case STATS_COUNTER::removed_redundant_copies:
+            return "copy_propagation.copies_removed";
+        case STATS_COUNTER::removed_dead_stores:
+            return "dead_store.instructions_removed";
+        case STATS_COUNTER::optimized_functions:
+            return "optimize.functions";
+        case STATS_COUNTER::fixed_point_iterations:
+            return "optimize.fixed_point_iterations";
+        case STATS_COUNTER::eliminated_tail_recursions:
+            return "tail_call.recursions_eliminated";
+        case STATS_COUNTER::marked_tail_calls:
+            return "tail_call.calls_marked";
+        case STATS_COUNTER::rotated_loops:
+            return "block_layout.loops_rotated";
+        case STATS_COUNTER::moved_return_blocks:
+            return "block_layout.return_blocks_moved";
+        case STATS_COUNTER::removed_layout_jumps:
+            return "block_layout.jumps_removed";
+        case STATS_COUNTER::threaded_layout_jumps:
+            return "block_layout.jumps_threaded";
+        case STATS_COUNTER::replaced_aggregates:
+            return "scalar_replacement.aggregates_replaced";
+        case STATS_COUNTER::eliminated_redundant_loads:
+            return "load_elimination.loads_eliminated";
+        case STATS_COUNTER::fully_unrolled_loops:
+            return "loop_unrolling.loops_fully_unrolled";
+        case STATS_COUNTER::partially_unrolled_loops:
+            return "loop_unrolling.loops_partially_unrolled";
+        case STATS_COUNTER::fixed_stack_functions:
+            return "stack_fix.functions";
+        case STATS_COUNTER::allocated_pseudo_registers:
+            return "stack_fix.pseudo_registers_allocated";
+        case STATS_COUNTER::allocated_stack_bytes:
+            return "stack_fix.stack_bytes_allocated";
+        case STATS_COUNTER::inserted_fix_instructions:
+            return "stack_fix.instructions_inserted";
+        case STATS_COUNTER::omitted_frame_pointers:
+            return "stack_fix.frame_pointers_omitted";
+        case STATS_COUNTER::red_zone_functions:
+            return "stack_fix.red_zone_functions";
+        default:
+            RAISE_INTERNAL_ERROR;
+    }
+}
+
+void print_stats() {
+    if (!stats) {
+        return;
+    }
+    std::string json = "{\"stats\": {";
+    for (size_t i = 0; i < stats_counter_size; ++i) {
+        json += i > 0 ? ",\n  \"" : "\n  \"";
+        json += get_stats_counter_name(static_cast<STATS_COUNTER>(i));
+        json += "\": ";
+        json += std::to_string(stats->counters[i].load());
+    }
+    json += "\n}}\n";
+    std::cout << json;
+}
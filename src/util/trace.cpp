@@ -0,0 +1,112 @@
+#include <atomic>
+#include <inttypes.h>
+#include <memory>
+#include <mutex>
+#include <stdio.h>
+#include <string>
+#include <time.h>
+#include <vector>
+
+#include "util/throw.hpp"
+#include "util/trace.hpp"
+
+std::unique_ptr<TraceContext> trace;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Trace
+
+// Events are written in the chrome trace event format, as pairs of begin and end events on the thread that runs them.
+// Arguments are attached to the end event, which trace viewers merge with the arguments of the matching begin event.
+// Threads are numbered in the order they push their first event, and keep their own stack of pending arguments.
+
+static std::atomic<size_t> trace_thread_count(0);
+static thread_local size_t trace_thread_id = 0;
+static thread_local std::vector<std::string> event_args_stack;
+
+static double get_trace_time() {
+    struct timespec time_spec;
+    clock_gettime(CLOCK_MONOTONIC, &time_spec);
+    return static_cast<double>(time_spec.tv_sec) * 1000000.0 + static_cast<double>(time_spec.tv_nsec) / 1000.0;
+}
+
+TraceContext::TraceContext(std::string&& filename) : filename(std::move(filename)), start_time(get_trace_time()) {}
+
+static void push_trace_event(const char* name, char phase, const std::string& event_args) {
+    if (trace_thread_id == 0) {
+        trace_thread_id = ++trace_thread_count;
+    }
+    char buffer[80];
+    snprintf(buffer, sizeof(buffer), "\", \"ph\": \"%c\", \"ts\": %.3f, \"pid\": 1, \"tid\": %zu", phase,
+        get_trace_time() - trace->start_time, trace_thread_id);
+    std::lock_guard<std::mutex> lock(trace->mutex);
+    trace->trace_events += trace->trace_events.empty() ? "\n  {\"name\": \"" : ",\n  {\"name\": \"";
+    trace->trace_events += name;
+    trace->trace_events += buffer;
+    if (!event_args.empty()) {
+        trace->trace_events += ", \"args\": {";
+        trace->trace_events += event_args;
+        trace->trace_events += "}";
+    }
+    trace->trace_events += "}";
+}
+
+void begin_trace_event(const char* name) {
+    push_trace_event(name, 'B', "");
+    event_args_stack.emplace_back();
+}
+
+static void push_trace_arg_key(const char* key) {
+    if (event_args_stack.empty()) {
+        RAISE_INTERNAL_ERROR;
+    }
+    std::string& event_args = event_args_stack.back();
+    if (!event_args.empty()) {
+        event_args += ", ";
+    }
+    event_args += "\"";
+    event_args += key;
+    event_args += "\": ";
+}
+
+void add_trace_arg(const char* key, size_t value) {
+    push_trace_arg_key(key);
+    event_args_stack.back() += std::to_string(value);
+}
+
+void add_trace_arg(const char* key, const std::string& value) {
+    push_trace_arg_key(key);
+    std::string& event_args = event_args_stack.back();
+    event_args += "\"";
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            event_args += '\\';
+        }
+        event_args += c;
+    }
+    event_args += "\"";
+}
+
+void end_trace_event(const char* name) {
+    if (event_args_stack.empty()) {
+        RAISE_INTERNAL_ERROR;
+    }
+    push_trace_event(name, 'E', event_args_stack.back());
+    event_args_stack.pop_back();
+}
+
+// Tracing is best effort: a trace file that cannot be written leaves the compilation unaffected.
+void write_trace() {
+    if (!trace) {
+        return;
+    }
+    FILE* file_descriptor = fopen(trace->filename.c_str(), "wb");
+    if (!file_descriptor) {
+        return;
+    }
+    std::string trace_json = "{\"traceEvents\": [";
+    trace_json += trace->trace_events;
+    trace_json += "\n], \"displayTimeUnit\": \"ms\"}\n";
+    fwrite(trace_json.c_str(), sizeof(char), trace_json.size(), file_descriptor);
+    fclose(file_descriptor);
+}
@@ -4,7 +4,10 @@
 
 std::unique_ptr<UtilContext> util;
 
-MainContext::MainContext() : is_verbose(false) {}
+MainContext::MainContext() :
+    is_verbose(false), is_omit_frame_pointer(false), is_no_plt(false), unroll_factor(4), jobs(1),
+    compile_cache_size(512ul * 1024ul * 1024ul), is_object(false), is_preprocessed(false), report_code(0),
+    is_stats(false) {}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
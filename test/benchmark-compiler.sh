@@ -0,0 +1,275 @@
+#!/bin/bash
+
+PACKAGE_NAME="$(cat ../bin/package_name.txt)"
+
+BENCH_DIR="${PWD}/tests/benchmark/compiler"
+BENCH_CASES=("statements" "nested_blocks" "functions" "switch" "static_init" "include_chain" "structs")
+PHASE_NAMES=("lex" "parse" "sema" "tac" "optim1" "asm" "optim2" "symt" "fix" "emit")
+
+function usage () {
+    echo "Usage: ./benchmark-compiler.sh [-O0|-O1|-O2|-O3] [--scale=N] [--runs=N] [--save=FILE] [--compare=FILE]"
+    echo "                               [CASE...]"
+    echo ""
+    echo "Generate scalable stress inputs, compile each of them N times and report the fastest run."
+    echo "CASE is one of: ${BENCH_CASES[@]} (default: all)"
+    echo ""
+    echo "    --scale=N       size of the generated inputs (default: 1000)"
+    echo "    --runs=N        number of compilations per case (default: 5)"
+    echo "    --save=FILE     write the results to FILE"
+    echo "    --compare=FILE  compare the results with a FILE saved by a previous run"
+    exit 1
+}
+
+# Generators
+
+function gen_statements () {
+    echo "int main(void) {"
+    echo "    int a = 1;"
+    echo "    int b = 2;"
+    for i in $(seq 1 ${SCALE})
+    do
+        echo "    a = a + b * ${i};"
+        echo "    b = (a ^ ${i}) - b;"
+    done
+    echo "    return a + b;"
+    echo "}"
+}
+
+function gen_nested_blocks () {
+    DEPTH=$((${SCALE} / 10))
+    echo "int main(void) {"
+    echo "    int a = 0;"
+    for i in $(seq 1 ${DEPTH})
+    do
+        echo "    if (a < ${i}) { int b${i} = a + ${i}; a = b${i};"
+    done
+    for i in $(seq 1 ${DEPTH})
+    do
+        echo "    }"
+    done
+    echo "    return a;"
+    echo "}"
+}
+
+function gen_functions () {
+    for i in $(seq 1 ${SCALE})
+    do
+        echo "int f${i}(int a, int b) { int c = a * ${i} + b; return c - a; }"
+    done
+    echo "int main(void) {"
+    echo "    int a = 0;"
+    for i in $(seq 1 ${SCALE})
+    do
+        echo "    a = f${i}(a, ${i});"
+    done
+    echo "    return a;"
+    echo "}"
+}
+
+function gen_switch () {
+    echo "int f(int a) {"
+    echo "    switch (a) {"
+    for i in $(seq 1 ${SCALE})
+    do
+        echo "        case ${i}: return a * ${i};"
+    done
+    echo "        default: return 0;"
+    echo "    }"
+    echo "}"
+    echo "int main(void) { return f(7); }"
+}
+
+function gen_static_init () {
+    echo "static long values[${SCALE}] = {"
+    for i in $(seq 1 ${SCALE})
+    do
+        echo "    ${i}l,"
+    done
+    echo "};"
+    echo "static char* names[${SCALE}] = {"
+    for i in $(seq 1 ${SCALE})
+    do
+        echo "    \"name ${i}\","
+    done
+    echo "};"
+    echo "int main(void) { return (int)values[${SCALE} - 1] + names[0][0]; }"
+}
+
+function gen_include_chain () {
+    DEPTH=$((${SCALE} / 10))
+    if [ ${DEPTH} -gt 150 ]; then DEPTH=150; fi
+    for i in $(seq 1 ${DEPTH})
+    do
+        {
+            echo "#pragma once"
+            echo "#define MACRO_${i} ${i}"
+            for j in $(seq 1 10)
+            do
+                echo "int x${i}_${j} = ${j};"
+            done
+            if [ ${i} -lt ${DEPTH} ]; then
+                echo "#include \"include_chain_$((${i} + 1)).h\""
+            fi
+        } > ${BENCH_DIR}/include_chain_${i}.h
+    done
+    echo "#include \"include_chain_1.h\""
+    echo "int main(void) { return x${DEPTH}_10; }"
+}
+
+function gen_structs () {
+    echo "struct s0 { int a; };"
+    for i in $(seq 1 ${SCALE})
+    do
+        echo "struct s${i} { long a; char b[${i}]; struct s$((${i} - 1)) c; double d; };"
+    done
+    echo "int main(void) {"
+    echo "    static struct s${SCALE} s;"
+    echo "    s.c.a = 1;"
+    echo "    return (int)s.c.a;"
+    echo "}"
+}
+
+# Measurements
+
+# Reads a --time-report=json report and prints one line: tokens, total wall time, then each phase wall time in ms, with
+# a "-" for the phases that did not run at this optimization level.
+function parse_report () {
+    awk '
+        BEGIN {
+            split("Lexing,Parsing,Semantic analysis,TAC representation,Level 1 optimization,Assembly generation," \
+                  "Level 2 optimization,Symbol table conversion,Stack fix,Code emission", names, ",")
+        }
+        /"name": "Lexing"/ { match($0, /"size": [0-9]+/); tokens = substr($0, RSTART + 8, RLENGTH - 8) }
+        /"wall_ms"/ {
+            match($0, /"name": "[^"]*"/)
+            name = substr($0, RSTART + 9, RLENGTH - 10)
+            match($0, /"wall_ms": [0-9.]+/)
+            wall_ms[name] = substr($0, RSTART + 11, RLENGTH - 11)
+            total += wall_ms[name]
+        }
+        END {
+            printf "%s %.3f", tokens, total
+            for (i = 1; i <= 10; i++) { printf " %s", (names[i] in wall_ms) ? wall_ms[names[i]] : "-" }
+            printf "\n"
+        }
+    '
+}
+
+function bench_case () {
+    CASE=${1}
+    FILE="${BENCH_DIR}/${CASE}"
+    gen_${CASE} > ${FILE}.c
+    LINES=$(cat ${FILE}.c ${BENCH_DIR}/${CASE}_*.h 2> /dev/null | wc -l)
+
+    BEST=""
+    for i in $(seq 1 ${RUNS})
+    do
+        REPORT=$(${PACKAGE_NAME} ${OPTIM} -s --time-report=json ${FILE}.c 2> /dev/null)
+        if [ ${?} -ne 0 ]; then
+            echo "${CASE}: compilation failed" 1>&2
+            return 1
+        fi
+        RUN=$(echo "${REPORT}" | parse_report)
+        if [ -z "${BEST}" ]; then
+            BEST="${RUN}"
+        elif awk "BEGIN { exit !($(echo ${RUN} | cut -d' ' -f2) < $(echo ${BEST} | cut -d' ' -f2)) }"; then
+            BEST="${RUN}"
+        fi
+    done
+    rm -f ${FILE}.s
+
+    echo "${CASE} ${LINES} ${BEST}" | awk '{
+        printf "%-14s %8s %8s %10s %12.0f %12.0f", $1, $2, $3, $4, $2 * 1000.0 / $4, $3 * 1000.0 / $4
+        for (i = 5; i <= NF; i++) { printf " %8s", $i }
+        printf "\n"
+    }'
+}
+
+function print_header () {
+    printf "%-14s %8s %8s %10s %12s %12s" "case" "lines" "tokens" "total_ms" "lines/s" "tokens/s"
+    for PHASE_NAME in ${PHASE_NAMES[@]}
+    do
+        printf " %8s" "${PHASE_NAME}"
+    done
+    printf "\n"
+}
+
+# Prints the relative change of total_ms for each case found in both the saved and the current results.
+function compare_results () {
+    echo ""
+    echo "----------------------------------------------------------------------"
+    echo "compare total_ms with ${COMPARE_FILE}"
+    echo "----------------------------------------------------------------------"
+    awk '
+        NR == FNR { if (FNR > 1) { saved[$1] = $4 } next }
+        FNR > 1 && ($1 in saved) {
+            printf "%-14s %10s -> %10s  %+7.1f%%\n", $1, saved[$1], $4, ($4 - saved[$1]) * 100.0 / saved[$1]
+        }
+    ' ${COMPARE_FILE} <(echo "${RESULTS}")
+}
+
+OPTIM="-O0"
+SCALE=1000
+RUNS=5
+SAVE_FILE=""
+COMPARE_FILE=""
+CASES=()
+for ARG in ${@}
+do
+    case "${ARG}" in
+        "-O0"|"-O1"|"-O2"|"-O3")
+            OPTIM="${ARG}"
+            ;;
+        "--scale="*)
+            SCALE="${ARG:8}"
+            ;;
+        "--runs="*)
+            RUNS="${ARG:7}"
+            ;;
+        "--save="*)
+            SAVE_FILE="$(readlink -f ${ARG:7})"
+            ;;
+        "--compare="*)
+            COMPARE_FILE="$(readlink -f ${ARG:10})"
+            if [ ! -f "${COMPARE_FILE}" ]; then usage; fi
+            ;;
+        "--help")
+            usage
+            ;;
+        *)
+            if [[ ! " ${BENCH_CASES[@]} " == *" ${ARG} "* ]]; then usage; fi
+            CASES+=("${ARG}")
+    esac
+done
+if [ ${#CASES[@]} -eq 0 ]; then
+    CASES=(${BENCH_CASES[@]})
+fi
+
+if [ -d "${BENCH_DIR}" ]; then
+    rm -r ${BENCH_DIR}
+fi
+mkdir -p ${BENCH_DIR}
+
+echo "----------------------------------------------------------------------"
+echo "${PACKAGE_NAME} ${OPTIM} --scale=${SCALE} --runs=${RUNS}"
+echo "----------------------------------------------------------------------"
+RESULTS=$(
+    print_header
+    for CASE in ${CASES[@]}
+    do
+        bench_case ${CASE}
+    done
+)
+echo "${RESULTS}"
+
+if [ ! -z "${SAVE_FILE}" ]; then
+    echo "${RESULTS}" > ${SAVE_FILE}
+fi
+if [ ! -z "${COMPARE_FILE}" ]; then
+    compare_results
+fi
+
+rm -r ${BENCH_DIR}
+rmdir --ignore-fail-on-non-empty $(dirname ${BENCH_DIR})
+
+exit 0
@@ -0,0 +1,184 @@
+#!/bin/bash
+
+PACKAGE_NAME="$(cat ../bin/package_name.txt)"
+
+BENCH_DIR="${PWD}/tests/benchmark/runtime"
+BUILD_DIR="${BENCH_DIR}/build"
+BENCH_CONFIGS=("${PACKAGE_NAME} -O0" "${PACKAGE_NAME} -O1" "${PACKAGE_NAME} -O2" "${PACKAGE_NAME} -O3" "gcc -O0"
+    "gcc -O1")
+
+function usage () {
+    echo "Usage: ./benchmark-runtime.sh [--runs=N] [--save=FILE] [--compare=FILE] [KERNEL...]"
+    echo ""
+    echo "Build each kernel at every optimization level and with gcc as a reference, then run it N times."
+    echo "KERNEL is the name of a source file in ${BENCH_DIR} (default: all)"
+    echo ""
+    echo "    --runs=N        number of runs per build (default: 5)"
+    echo "    --save=FILE     write the results to FILE"
+    echo "    --compare=FILE  compare the results with a FILE saved by a previous run"
+    exit 1
+}
+
+# Builds
+
+function build_kernel () {
+    COMPILER=${1}
+    OPTIM=${2}
+    BIN="${BUILD_DIR}/${KERNEL}_${COMPILER}${OPTIM}"
+    cp ${BENCH_DIR}/${KERNEL}.c ${BIN}.c
+    if [ "${COMPILER}" = "gcc" ]; then
+        gcc ${OPTIM} -w -S ${BIN}.c -o ${BIN}.s > /dev/null 2>&1
+    else
+        ${PACKAGE_NAME} ${OPTIM} -s ${BIN}.c > /dev/null 2>&1
+    fi
+    if [ ${?} -ne 0 ]; then
+        return 1
+    fi
+    # Both assembly outputs are assembled and linked the same way.
+    gcc ${BIN}.s -o ${BIN} -lm > /dev/null 2>&1
+}
+
+# Counts the lines of the assembly output that are neither labels nor directives.
+function count_static_instructions () {
+    awk '
+        NF == 0 || $1 ~ /^\./ || $1 ~ /:$/ || $1 ~ /^#/ { next }
+        { count++ }
+        END { print count + 0 }
+    ' ${BIN}.s
+}
+
+# Runs
+
+# Prints the exit code, then the cycles, instructions and fastest wall time of the runs, with a "-" for the hardware
+# counters when perf is not available.
+function run_kernel () {
+    ${BIN} > /dev/null 2>&1
+    RETURN=${?}
+    CYCLES="-"
+    INSTRUCTIONS="-"
+    if [ ${IS_PERF} -eq 1 ]; then
+        PERF_STAT=$(perf stat -x, -e cycles,instructions -r ${RUNS} ${BIN} 2>&1 > /dev/null)
+        CYCLES=$(echo "${PERF_STAT}" | awk -F, '$3 ~ /^cycles/ { print $1 }')
+        INSTRUCTIONS=$(echo "${PERF_STAT}" | awk -F, '$3 ~ /^instructions/ { print $1 }')
+    fi
+    BEST=""
+    for i in $(seq 1 ${RUNS})
+    do
+        START=$(date +%s%N)
+        ${BIN} > /dev/null 2>&1
+        TIME=$(( ($(date +%s%N) - ${START}) / 1000 ))
+        if [ -z "${BEST}" ] || [ ${TIME} -lt ${BEST} ]; then
+            BEST=${TIME}
+        fi
+    done
+    echo "${RETURN} ${CYCLES} ${INSTRUCTIONS} $(echo ${BEST} | awk '{ printf "%.3f", $1 / 1000.0 }')"
+}
+
+function bench_kernel () {
+    KERNEL=${1}
+    EXPECTED=""
+    for CONFIG in "${BENCH_CONFIGS[@]}"
+    do
+        build_kernel ${CONFIG}
+        if [ ${?} -ne 0 ]; then
+            printf "%-16s %-12s %s\n" "${KERNEL}" "${CONFIG// /}" "build failed"
+            continue
+        fi
+        RUN=($(run_kernel))
+        # The first config that runs is the reference for the exit code of the others.
+        STATUS="ok"
+        if [ -z "${EXPECTED}" ]; then
+            EXPECTED=${RUN[0]}
+        elif [ ${RUN[0]} -ne ${EXPECTED} ]; then
+            STATUS="wrong exit code ${RUN[0]} (expected ${EXPECTED})"
+        fi
+        printf "%-16s %-12s %14s %14s %10s %10s %10s  %s\n" "${KERNEL}" "${CONFIG// /}" "${RUN[1]}" "${RUN[2]}" \
+            "${RUN[3]}" "$(size ${BIN} | awk 'NR == 2 { print $1 }')" "$(count_static_instructions)" "${STATUS}"
+    done
+}
+
+function print_header () {
+    printf "%-16s %-12s %14s %14s %10s %10s %10s\n" "kernel" "config" "cycles" "instructions" "time_ms" \
+        "text_bytes" "asm_insns"
+}
+
+# Prints the relative change of time_ms for each build found in both the saved and the current results.
+function compare_results () {
+    echo ""
+    echo "----------------------------------------------------------------------"
+    echo "compare time_ms with ${COMPARE_FILE}"
+    echo "----------------------------------------------------------------------"
+    awk '
+        NR == FNR { if (FNR > 1) { saved[$1 " " $2] = $5 } next }
+        FNR > 1 && (($1 " " $2) in saved) && saved[$1 " " $2] > 0 {
+            printf "%-16s %-12s %10s -> %10s  %+7.1f%%\n", $1, $2, saved[$1 " " $2], $5,
+                ($5 - saved[$1 " " $2]) * 100.0 / saved[$1 " " $2]
+        }
+    ' ${COMPARE_FILE} <(echo "${RESULTS}")
+}
+
+RUNS=5
+SAVE_FILE=""
+COMPARE_FILE=""
+KERNELS=()
+for ARG in ${@}
+do
+    case "${ARG}" in
+        "--runs="*)
+            RUNS="${ARG:7}"
+            ;;
+        "--save="*)
+            SAVE_FILE="$(readlink -f ${ARG:7})"
+            ;;
+        "--compare="*)
+            COMPARE_FILE="$(readlink -f ${ARG:10})"
+            if [ ! -f "${COMPARE_FILE}" ]; then usage; fi
+            ;;
+        "--help")
+            usage
+            ;;
+        *)
+            if [ ! -f "${BENCH_DIR}/${ARG%.*}.c" ]; then usage; fi
+            KERNELS+=("${ARG%.*}")
+    esac
+done
+if [ ${#KERNELS[@]} -eq 0 ]; then
+    for FILE in $(find ${BENCH_DIR} -maxdepth 1 -name "*.c" -type f | sort --uniq)
+    do
+        KERNELS+=("$(basename ${FILE%.*})")
+    done
+fi
+
+IS_PERF=0
+perf stat -e cycles,instructions true > /dev/null 2>&1
+if [ ${?} -eq 0 ]; then
+    IS_PERF=1
+fi
+
+if [ -d "${BUILD_DIR}" ]; then
+    rm -r ${BUILD_DIR}
+fi
+mkdir -p ${BUILD_DIR}
+
+echo "----------------------------------------------------------------------"
+echo "--runs=${RUNS}"
+echo "----------------------------------------------------------------------"
+RESULTS=$(
+    print_header
+    for KERNEL in ${KERNELS[@]}
+    do
+        bench_kernel ${KERNEL}
+    done
+)
+echo "${RESULTS}"
+
+if [ ! -z "${SAVE_FILE}" ]; then
+    echo "${RESULTS}" > ${SAVE_FILE}
+fi
+if [ ! -z "${COMPARE_FILE}" ]; then
+    compare_results
+fi
+
+rm -r ${BUILD_DIR}
+
+exit 0
@@ -0,0 +1,128 @@
+#!/bin/bash
+
+PACKAGE_NAME="$(cat ../bin/package_name.txt)"
+
+LIGHT_RED='\033[1;31m'
+LIGHT_GREEN='\033[1;32m'
+NC='\033[0m'
+
+TEST_DIR="${PWD}/tests/compiler"
+TEST_SRCS=()
+for i in $(seq 1 19); do
+    TEST_SRCS+=("$(basename $(find ${TEST_DIR} -maxdepth 1 -name "${i}_*" -type d))")
+done
+
+function file () {
+    FILE=${1%.*}
+    if [ -f "${FILE}.o" ]; then rm ${FILE}.o; fi
+    echo "${FILE}"
+}
+
+function total () {
+    echo "----------------------------------------------------------------------"
+    RESULT="${PASS} / ${TOTAL}"
+    if [ ${PASS} -eq ${TOTAL} ]; then
+        RESULT="${LIGHT_GREEN}PASS: ${RESULT}${NC}"
+    else
+        RESULT="${LIGHT_RED}FAIL: ${RESULT}${NC}"
+    fi
+    echo -e "${RESULT}"
+}
+
+function print_check () {
+    echo " ${OPTIM} check ${1} -> ${2}"
+}
+
+function print_assembler () {
+    echo -e -n "${TOTAL} ${RESULT} ${FILE}.c${NC}"
+    print_check "assembler" "[${1}]"
+}
+
+# The bytes of the sections and the relocations of an object are dumped without symbol names in the disassembly, as the
+# gnu assembler leaves symbols untyped and objdump then annotates addresses with any nearby symbol. Relocations are
+# sorted by offset, as the gnu assembler does not write them in order.
+function dump_object () {
+    objdump -s -j .text -j .rodata -j .data ${FILE}.o 2> /dev/null | tail -n +3
+    for SECTION in .text .rodata .data; do
+        echo "${SECTION}"
+        objdump -r -j ${SECTION} ${FILE}.o 2> /dev/null | grep "^[0-9a-f]\{16\} " | sort
+    done
+    rm ${FILE}.o
+}
+
+# Every file is assembled once by the integrated assembler and once by the gnu assembler, and both objects must hold
+# the same code, constants, data and relocations.
+function check_assembler () {
+    ${PACKAGE_NAME} ${OPTIM} -c ${FILE}.c > /dev/null 2>&1
+    if [ ${?} -ne 0 ]; then return 2; fi
+    OBJECT_INTEGRATED="$(dump_object)"
+
+    ${PACKAGE_NAME} ${OPTIM} -c --no-integrated-as ${FILE}.c > /dev/null 2>&1
+    if [ ${?} -ne 0 ]; then return 1; fi
+    OBJECT_GNU="$(dump_object)"
+
+    if [[ "${OBJECT_INTEGRATED}" == "${OBJECT_GNU}" ]]; then
+        return 0
+    fi
+    diff <(echo "${OBJECT_INTEGRATED}") <(echo "${OBJECT_GNU}") | head -8
+    return 1
+}
+
+function check_test () {
+    FILE=$(file ${1})
+    if [[ "${FILE}" == *"/invalid_"* ]]; then
+        return
+    fi
+
+    check_assembler
+    RETURN=${?}
+    if [ ${RETURN} -eq 2 ]; then
+        return
+    fi
+    let TOTAL+=1
+    if [ ${RETURN} -eq 0 ]; then
+        RESULT="${LIGHT_GREEN}[y]"
+        let PASS+=1
+    else
+        RESULT="${LIGHT_RED}[n]"
+    fi
+    print_assembler ".text .rodata .data"
+}
+
+function test_src () {
+    SRC=${1}
+    for FILE in $(find ${SRC} -name "*.c" -type f | sort --uniq)
+    do
+        check_test ${FILE}
+    done
+}
+
+function test_all () {
+    for SRC in ${TEST_SRCS[@]}
+    do
+        test_src ${SRC}
+    done
+}
+
+PASS=0
+TOTAL=0
+
+ARG=${1}
+
+OPTIM="-O0"
+if [ "${1}" = "-O0" ]; then
+    ARG=${2}
+elif [ "${1}" = "-O3" ]; then
+    OPTIM="-O3"
+    ARG=${2}
+fi
+
+cd ${TEST_DIR}
+if [ ! -z "${ARG}" ]; then
+    test_src ${TEST_SRCS["$((${ARG} - 1))"]}
+else
+    test_all
+fi
+total
+
+exit 0
@@ -292,22 +292,32 @@ LIBS=""
 PASS=0
 TOTAL=0
 
-ARG=${1}
-
 OPTIM="-O0"
 if [ "${1}" = "-O0" ]; then
-    ARG=${2}
+    shift
 elif [ "${1}" = "-O1" ]; then
     OPTIM="-O0 -O1"
-    ARG=${2}
+    shift
 elif [ "${1}" = "-O2" ]; then
     OPTIM="-O0 -O2"
-    ARG=${2}
+    shift
 elif [ "${1}" = "-O3" ]; then
     OPTIM="-O3"
-    ARG=${2}
+    shift
 fi
 
+while [[ "${1}" == "--"* ]]; do
+    if [ "${1}" = "--omit-frame-pointer" ] || [ "${1}" = "--no-plt" ] || [[ "${1}" == "--unroll-factor="* ]]; then
+        OPTIM="${OPTIM} ${1}"
+    else
+        echo -e "${PACKAGE_NAME}: \033[0;31merror:\033[0m unknown option \033[1m‘${1}’\033[0m" 1>&2
+        exit 1
+    fi
+    shift
+done
+
+ARG=${1}
+
 cd ${TEST_DIR}
 if [ ! -z "${ARG}" ]; then
     test_src ${TEST_SRCS["$((${ARG} - 1))"]}
@@ -0,0 +1,146 @@
+#!/bin/bash
+
+PACKAGE_NAME="$(cat ../bin/package_name.txt)"
+
+LIGHT_RED='\033[1;31m'
+LIGHT_GREEN='\033[1;32m'
+NC='\033[0m'
+
+TEST_DIR="${PWD}/tests/compiler"
+TEST_SRCS=()
+for i in $(seq 1 19); do
+    TEST_SRCS+=("$(basename $(find ${TEST_DIR} -maxdepth 1 -name "${i}_*" -type d))")
+done
+
+function file () {
+    FILE=${1%.*}
+    if [ -f "${FILE}" ]; then rm ${FILE}; fi
+    echo "${FILE}"
+}
+
+function total () {
+    echo "----------------------------------------------------------------------"
+    RESULT="${PASS} / ${TOTAL}"
+    if [ ${PASS} -eq ${TOTAL} ]; then
+        RESULT="${LIGHT_GREEN}PASS: ${RESULT}${NC}"
+    else
+        RESULT="${LIGHT_RED}FAIL: ${RESULT}${NC}"
+    fi
+    echo -e "${RESULT}"
+}
+
+function print_check () {
+    echo " ${OPTIM} check ${1} -> ${2}"
+}
+
+function print_jobs () {
+    echo -e -n "${TOTAL} ${RESULT} ${FILE}.c${NC}"
+    print_check "jobs" "[${1}]"
+}
+
+function compile_asm () {
+    ${PACKAGE_NAME} ${OPTIM} ${1} -s ${LIBS} ${FILE}.c > /dev/null 2>&1
+    RETURN=${?}
+    ASM=""
+    if [ ${RETURN} -eq 0 ]; then
+        ASM="$(cat ${FILE}.s)"
+        rm ${FILE}.s
+    fi
+}
+
+function compile_run () {
+    STDOUT=$(${PACKAGE_NAME} ${OPTIM} ${1} ${LIBS} ${FILE}.c 2>&1)
+    RETURN=${?}
+    if [ ${RETURN} -eq 0 ]; then
+        STDOUT=$(${FILE})
+        RETURN=${?}
+        rm ${FILE}
+    fi
+}
+
+# Labels are numbered per function on more than 1 job, so the assembly must be the same for any number of jobs above 1,
+# and the programs built with 1 job or more must behave the same.
+function check_jobs () {
+    compile_asm "-j2"
+    RETURN_ASM=${RETURN}
+    ASM_JOBS="${ASM}"
+    compile_asm "-j8"
+    if [ ${RETURN_ASM} -ne ${RETURN} ] || [[ "${ASM_JOBS}" != "${ASM}" ]]; then
+        PRINT="-j2 != -j8"
+        return 1
+    fi
+
+    compile_run "-j1"
+    RETURN_JOB=${RETURN}
+    STDOUT_JOB="${STDOUT}"
+    for JOBS in -j2 -j8; do
+        compile_run "${JOBS}"
+        if [ ${RETURN_JOB} -ne ${RETURN} ] || [[ "${STDOUT_JOB}" != "${STDOUT}" ]]; then
+            PRINT="-j1: ${RETURN_JOB}, ${JOBS}: ${RETURN}"
+            return 1
+        fi
+    done
+    PRINT="-j1: ${RETURN_JOB}, -j2 -j8: ${RETURN}"
+    return 0
+}
+
+function check_test () {
+    FILE=$(file ${1})
+    if [[ "${FILE}" == *"_client" ]] || [ -f "${FILE}_client.c" ] || [ -f "${FILE}_data.s" ]; then
+        return
+    fi
+
+    LIBS=""
+    if [[ "${FILE}" == *"__+l"* ]]; then
+        LIBS=" -"$(echo "${FILE}" | cut -d "+" -f2- | tr "+" "-" | tr "_" " ")
+    fi
+
+    let TOTAL+=1
+    check_jobs
+    if [ ${?} -eq 0 ]; then
+        RESULT="${LIGHT_GREEN}[y]"
+        let PASS+=1
+    else
+        RESULT="${LIGHT_RED}[n]"
+    fi
+    print_jobs "${PRINT}"
+}
+
+function test_src () {
+    SRC=${1}
+    for FILE in $(find ${SRC} -name "*.c" -type f | sort --uniq)
+    do
+        check_test ${FILE}
+    done
+}
+
+function test_all () {
+    for SRC in ${TEST_SRCS[@]}
+    do
+        test_src ${SRC}
+    done
+}
+
+LIBS=""
+PASS=0
+TOTAL=0
+
+ARG=${1}
+
+OPTIM="-O0"
+if [ "${1}" = "-O0" ]; then
+    ARG=${2}
+elif [ "${1}" = "-O3" ]; then
+    OPTIM="-O3"
+    ARG=${2}
+fi
+
+cd ${TEST_DIR}
+if [ ! -z "${ARG}" ]; then
+    test_src ${TEST_SRCS["$((${ARG} - 1))"]}
+else
+    test_all
+fi
+total
+
+exit 0
@@ -61,6 +61,15 @@ function header_dir () {
     echo "${HEADER_DIR}"
 }
 
+# Unknown pragmas are ignored, but with macro expansion the headers include each other and need to be included once.
+function pragma () {
+    if [ "${OPTS}" = "-E" ]; then
+        echo "once"
+    else
+        echo "pragma${1}"
+    fi
+}
+
 function make_test () {
     if [ -d "${TEST_SRC}" ]; then
         rm -r ${TEST_SRC}
@@ -71,7 +80,7 @@ function make_test () {
     do
         echo "int x${i} = 1;" > ${TEST_SRC}/$(header_dir ${i})test-header_${i}.h
         echo "// a single-line comment ${i}" >> ${TEST_SRC}/$(header_dir ${i})test-header_${i}.h
-        echo "#pragma pragma${i}" >> ${TEST_SRC}/$(header_dir ${i})test-header_${i}.h
+        echo "#pragma $(pragma ${i})" >> ${TEST_SRC}/$(header_dir ${i})test-header_${i}.h
         echo "#include \"$(header_dir $((${N}-${i})))test-header_$((${N}-${i})).h\"" >> ${TEST_SRC}/$(header_dir ${i})test-header_${i}.h
         echo "/* a multi-line" >> ${TEST_SRC}/$(header_dir ${i})test-header_${i}.h
         echo "comment ${i}" >> ${TEST_SRC}/$(header_dir ${i})test-header_${i}.h
@@ -82,7 +91,7 @@ function make_test () {
 
     echo "int x${N} = 1;" > ${TEST_SRC}/test-header_${N}.h
     echo "// a single-line comment ${N}" >> ${TEST_SRC}/test-header_${N}.h
-    echo "#pragma pragma${N}" >> ${TEST_SRC}/test-header_${N}.h
+    echo "#pragma $(pragma ${N})" >> ${TEST_SRC}/test-header_${N}.h
     echo "#include \"test-header_0.h\"" >> ${TEST_SRC}/test-header_${N}.h
     echo "/* a multi-line" >> ${TEST_SRC}/test-header_${N}.h
     echo "comment ${N}" >> ${TEST_SRC}/test-header_${N}.h
@@ -129,7 +138,7 @@ check_preprocess () {
     
     make_test
 
-    ${PACKAGE_NAME} ${FILE}.c > /dev/null 2>&1
+    ${PACKAGE_NAME} ${OPTS} ${FILE}.c > /dev/null 2>&1
     RETURN=${?}
     STDOUT=""
     if [ ${RETURN} -ne 0 ]; then
@@ -169,7 +178,7 @@ check_error () {
         rm ${FILE}
     fi
 
-    STDOUT=$(${PACKAGE_NAME} ${FILE}.c 2>&1)
+    STDOUT=$(${PACKAGE_NAME} ${OPTS} ${FILE}.c 2>&1)
     RETURN=${?}
     if [ ${RETURN} -eq 0 ]; then
         rm ${FILE}
@@ -197,10 +206,234 @@ check_error () {
     print_error
 }
 
+function print_expand () {
+    echo -e -n "${TOTAL} ${RESULT} ${FILE}.c${NC}"
+    PRINT="gcc -E -P: ${RETURN_GCC}, ${PACKAGE_NAME} -E: ${RETURN}"
+    print_check "expand" "[${PRINT}]"
+}
+
+# Macros are expanded like gcc does when the source expanded by gcc compiles to the same assembly, and an invalid
+# source fails with both.
+check_expand () {
+    let TOTAL+=1
+
+    gcc -E -P ${FILE}.c > ${FILE}_gcc.c 2> /dev/null
+    RETURN_GCC=${?}
+    ${PACKAGE_NAME} -E -s ${FILE}.c > /dev/null 2>&1
+    RETURN=${?}
+    RESULT="${LIGHT_RED}[n]"
+    if [ ${RETURN_GCC} -ne 0 ]; then
+        if [ ${RETURN} -ne 0 ]; then
+            RESULT="${LIGHT_GREEN}[y]"
+            let PASS+=1
+        fi
+    elif [ ${RETURN} -eq 0 ]; then
+        ${PACKAGE_NAME} -s ${FILE}_gcc.c > /dev/null 2>&1
+        if [ ${?} -eq 0 ]; then
+            diff -sq ${FILE}.s ${FILE}_gcc.s | grep -q "identical"
+            if [ ${?} -eq 0 ]; then
+                RESULT="${LIGHT_GREEN}[y]"
+                let PASS+=1
+            fi
+        fi
+    fi
+
+    for EXT in "_gcc.c" "_gcc.s" ".s"; do
+        if [ -f "${FILE}${EXT}" ]; then rm ${FILE}${EXT}; fi
+    done
+    print_expand
+}
+
+function print_cache () {
+    echo -e -n "${TOTAL} ${RESULT} ${FILE}.c${NC}"
+    print_check "${1}" "[${PRINT}]"
+}
+
+# The program must still return the sum of the variables defined by the headers.
+function run_cache () {
+    if [ ${RETURN} -eq 0 ]; then
+        ${FILE} > /dev/null
+        RETURN=${?}
+        rm ${FILE}
+        if [ ${RETURN} -eq $((${N}+1)) ]; then
+            RETURN=0
+        fi
+    fi
+}
+
+# A compile is a hit when the compiler skips parsing, and every miss stores a new entry.
+check_compile_cache () {
+    let TOTAL+=1
+
+    STDOUT=$(${PACKAGE_NAME} -v ${OPTS} --compile-cache=${CACHE_DIR} ${CACHE_SIZE} ${FILE}.c 2>&1)
+    RETURN=${?}
+    run_cache
+    IS_HIT=0
+    echo "${STDOUT}" | grep -q -- "-- Compile cache hit"
+    if [ ${?} -eq 0 ]; then
+        IS_HIT=1
+    fi
+    ENTRIES=$(find ${CACHE_DIR} -maxdepth 1 -name "*.[os]" -type f | wc -l)
+
+    if [ ${RETURN} -eq 0 ] && [ ${IS_HIT} -eq ${1} ] && [ ${ENTRIES} -eq ${2} ]; then
+        RESULT="${LIGHT_GREEN}[y]"
+        let PASS+=1
+    else
+        RESULT="${LIGHT_RED}[n]"
+    fi
+    PRINT="${OPTS} ${CACHE_SIZE} return: ${RETURN}, hit: ${IS_HIT}, entries: ${ENTRIES}"
+    print_cache "cache"
+}
+
+function cache_entry () {
+    FAKE_ENTRY="${CACHE_DIR}/$(printf "%032d" ${1}).o"
+    head -c 524288 /dev/zero > ${FAKE_ENTRY}
+    touch -d "-${2} hours" ${FAKE_ENTRY}
+}
+
+function check_cache_entry () {
+    let TOTAL+=1
+
+    if [ -f "${CACHE_DIR}/$(printf "%032d" ${1}).o" ]; then
+        RETURN=1
+    else
+        RETURN=0
+    fi
+
+    if [ ${RETURN} -eq ${2} ]; then
+        RESULT="${LIGHT_GREEN}[y]"
+        let PASS+=1
+    else
+        RESULT="${LIGHT_RED}[n]"
+    fi
+    PRINT="entry ${1}: ${RETURN}"
+    print_cache "evict"
+}
+
+# Every header is a dependency of the output file, and gets an empty rule so that make does not fail once it is gone.
+check_depend () {
+    let TOTAL+=1
+
+    if [ -f "${FILE}.d" ]; then rm ${FILE}.d; fi
+    ${PACKAGE_NAME} -MD ${OPTS} ${FILE}.c > /dev/null 2>&1
+    RETURN=${?}
+    run_cache
+
+    RESULT="${LIGHT_RED}[n]"
+    if [ ${RETURN} -eq 0 ] && [ -f "${FILE}.d" ]; then
+        DEPENDS=$(find ${TEST_SRC} -name "*.h" -type f | sort --uniq)
+        diff -sq <(
+            echo "${FILE}: \\"
+            (echo "${FILE}.c"; echo "${DEPENDS}") | sort
+            echo "${DEPENDS}"
+        ) <(
+            head -n 1 ${FILE}.d
+            sed -n '2,/^$/p' ${FILE}.d | sed -r 's/^ +//; s/ \\$//' | grep -v "^$" | sort
+            grep ":$" ${FILE}.d | sed 's/:$//' | sort
+        ) | grep -q "identical"
+        if [ ${?} -eq 0 ]; then
+            RESULT="${LIGHT_GREEN}[y]"
+            let PASS+=1
+        fi
+    fi
+    if [ -f "${FILE}.d" ]; then rm ${FILE}.d; fi
+    PRINT="${OPTS} return: ${RETURN}"
+    print_cache "depend"
+}
+
 function check_test () {
     FILE=$(file ${1})
+    OPTS=""
+    check_preprocess
+    check_error
+}
+
+function check_macro_test () {
+    FILE=$(file ${1})
+    OPTS="-E"
+    check_preprocess
+    check_error
+}
+
+function check_compile_cache_test () {
+    FILE=$(file ${1})
+    OPTS=""
+    CACHE_SIZE=""
+    CACHE_DIR="${TEST_DIR}/cache-compile"
+    if [ -d "${CACHE_DIR}" ]; then
+        rm -r ${CACHE_DIR}
+    fi
+    make_test
+
+    # cold cache, then a comment-only edit still hits
+    check_compile_cache 0 1
+    sed -i "1i // a comment-only edit\\n" ${FILE}.c
+    check_compile_cache 1 1
+    # the optimization options are part of the key
+    OPTS="-O1"
+    check_compile_cache 0 2
+    OPTS=""
+    check_compile_cache 1 2
+
+    # entries are evicted least recently used first once they take more than the size, and a hit refreshes its entry
+    touch -d "-4 hours" ${CACHE_DIR}/*.o
+    cache_entry 1 3
+    cache_entry 2 2
+    check_compile_cache 1 4
+    OPTS="--fold-constants"
+    CACHE_SIZE="--compile-cache-size=1"
+    check_compile_cache 0 3
+    CACHE_SIZE=""
+    check_cache_entry 1 0
+    check_cache_entry 2 1
+    OPTS=""
+    check_compile_cache 1 3
+    OPTS="-O1"
+    check_compile_cache 0 4
+    rm -r ${CACHE_DIR}
+}
+
+function check_depend_test () {
+    FILE=$(file ${1})
+    OPTS=""
+    CACHE_DIR="${TEST_DIR}/cache"
+    for DIR in "${CACHE_DIR}" "${CACHE_DIR}-compile"; do
+        if [ -d "${DIR}" ]; then rm -r ${DIR}; fi
+    done
+    make_test
+
+    check_depend
+    # headers replayed from a cold, then warm header cache
+    OPTS="--header-cache=${CACHE_DIR}"
+    check_depend
+    check_depend
+    # and on compile cache hits
+    OPTS="${OPTS} --compile-cache=${CACHE_DIR}-compile"
+    check_depend
+    check_depend
+    rm -r ${CACHE_DIR} ${CACHE_DIR}-compile
+}
+
+function check_expand_test () {
+    for FILE in $(find ${1} -name "*.c" -type f | sort --uniq)
+    do
+        FILE=$(file ${FILE})
+        check_expand
+    done
+}
+
+function check_cache_test () {
+    FILE=$(file ${1})
+    OPTS="--header-cache=${TEST_DIR}/cache"
+    if [ -d "${TEST_DIR}/cache" ]; then
+        rm -r ${TEST_DIR}/cache
+    fi
+    # cold cache, then warm cache
+    check_preprocess
     check_preprocess
     check_error
+    check_error
+    rm -r ${TEST_DIR}/cache
 }
 
 N=63
@@ -209,6 +442,11 @@ ERR=27
 PASS=0
 TOTAL=0
 check_test ${TEST_SRC}/main.c
+check_macro_test ${TEST_SRC}/main.c
+check_cache_test ${TEST_SRC}/main.c
+check_compile_cache_test ${TEST_SRC}/main.c
+check_depend_test ${TEST_SRC}/main.c
+check_expand_test ${TEST_DIR}/macros
 total
 
 exit 0
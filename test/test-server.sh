@@ -0,0 +1,170 @@
+#!/bin/bash
+
+PACKAGE_NAME="$(cat ../bin/package_name.txt)"
+
+LIGHT_RED='\033[1;31m'
+LIGHT_GREEN='\033[1;32m'
+NC='\033[0m'
+
+TEST_DIR="${PWD}/tests/compiler"
+TEST_SRCS=()
+for i in $(seq 1 19); do
+    TEST_SRCS+=("$(basename $(find ${TEST_DIR} -maxdepth 1 -name "${i}_*" -type d))")
+done
+SOCKET="${PWD}/tests/server.sock"
+unset WHEELCC_SERVER_SOCKET
+
+function file () {
+    FILE=${1%.*}
+    if [ -f "${FILE}" ]; then rm ${FILE}; fi
+    echo "${FILE}"
+}
+
+function total () {
+    echo "----------------------------------------------------------------------"
+    RESULT="${PASS} / ${TOTAL}"
+    if [ ${PASS} -eq ${TOTAL} ]; then
+        RESULT="${LIGHT_GREEN}PASS: ${RESULT}${NC}"
+    else
+        RESULT="${LIGHT_RED}FAIL: ${RESULT}${NC}"
+    fi
+    echo -e "${RESULT}"
+}
+
+function print_check () {
+    echo " ${OPTIM} check ${1} -> ${2}"
+}
+
+function print_server () {
+    echo -e -n "${TOTAL} ${RESULT} ${FILE}.c${NC}"
+    PRINT="local: ${RETURN_LOCAL}, ${1}: ${RETURN_SERVER}"
+    print_check "server" "[${PRINT}]"
+}
+
+function stop_server () {
+    PID=$(pgrep -f "${PACKAGE_NAME} --server ${SOCKET}")
+    if [ ! -z "${PID}" ]; then
+        kill ${1} ${PID}
+        while kill -0 ${PID} > /dev/null 2>&1; do
+            sleep 0.01
+        done
+    fi
+}
+
+# Every file is compiled once locally and once through the server, and both compiles must fail with the same error or
+# build programs with the same output.
+function compile_run () {
+    STDOUT=$(${PACKAGE_NAME} ${OPTIM} ${1} ${LIBS} ${FILE}.c 2>&1)
+    RETURN=${?}
+    if [ ${RETURN} -eq 0 ]; then
+        STDOUT=$(${FILE})
+        RETURN=${?}
+        rm ${FILE}
+    fi
+}
+
+function check_server () {
+    let TOTAL+=1
+
+    compile_run ""
+    RETURN_LOCAL=${RETURN}
+    STDOUT_LOCAL="${STDOUT}"
+
+    compile_run "--server=${SOCKET}"
+    RETURN_SERVER=${RETURN}
+    STDOUT_SERVER="${STDOUT}"
+
+    if [ ${RETURN_LOCAL} -eq ${RETURN_SERVER} ] && [[ "${STDOUT_LOCAL}" == "${STDOUT_SERVER}" ]]; then
+        return 0
+    fi
+    return 1
+}
+
+function check_test () {
+    FILE=$(file ${1})
+    if [[ "${FILE}" == *"_client" ]] || [ -f "${FILE}_client.c" ] || [ -f "${FILE}_data.s" ]; then
+        return
+    fi
+
+    LIBS=""
+    if [[ "${FILE}" == *"__+l"* ]]; then
+        LIBS=" -"$(echo "${FILE}" | cut -d "+" -f2- | tr "+" "-" | tr "_" " ")
+    fi
+
+    check_server
+    if [ ${?} -eq 0 ]; then
+        RESULT="${LIGHT_GREEN}[y]"
+        let PASS+=1
+    else
+        RESULT="${LIGHT_RED}[n]"
+    fi
+    print_server "server"
+}
+
+# A server killed without cleaning up leaves its socket behind, then clients compile locally and remove it.
+function check_stale () {
+    stop_server -9
+    FILE=$(file ${1})
+    LIBS=""
+    if [ ! -S "${SOCKET}" ]; then
+        let TOTAL+=1
+        RESULT="${LIGHT_RED}[n]"
+        RETURN_LOCAL="-"
+        RETURN_SERVER="-"
+        print_server "stale"
+        return
+    fi
+
+    check_server
+    if [ ${?} -eq 0 ] && [ ! -S "${SOCKET}" ]; then
+        RESULT="${LIGHT_GREEN}[y]"
+        let PASS+=1
+    else
+        RESULT="${LIGHT_RED}[n]"
+        if [ -S "${SOCKET}" ]; then rm ${SOCKET}; fi
+    fi
+    print_server "stale"
+}
+
+function test_src () {
+    SRC=${1}
+    for FILE in $(find ${SRC} -name "*.c" -type f | sort --uniq)
+    do
+        check_test ${FILE}
+    done
+}
+
+function test_all () {
+    for SRC in ${TEST_SRCS[@]}
+    do
+        test_src ${SRC}
+    done
+}
+
+LIBS=""
+PASS=0
+TOTAL=0
+
+ARG=${1}
+
+OPTIM="-O0"
+if [ "${1}" = "-O0" ]; then
+    ARG=${2}
+elif [ "${1}" = "-O3" ]; then
+    OPTIM="-O3"
+    ARG=${2}
+fi
+
+stop_server
+if [ -S "${SOCKET}" ]; then rm ${SOCKET}; fi
+
+cd ${TEST_DIR}
+if [ ! -z "${ARG}" ]; then
+    test_src ${TEST_SRCS["$((${ARG} - 1))"]}
+else
+    test_all
+fi
+check_stale ${TEST_DIR}/${TEST_SRCS[0]}/valid/return_2.c
+total
+
+exit 0
@@ -0,0 +1,45 @@
+// Inserts and looks up keys in an open-addressing hash table.
+
+static unsigned long keys[262144];
+static long counts[262144];
+
+static unsigned long hash(unsigned long key) {
+    key ^= key >> 33;
+    key *= 1099511628211ul;
+    key ^= key >> 29;
+    return key;
+}
+
+static unsigned long probe(unsigned long key) {
+    unsigned long i = hash(key) & 262143ul;
+    while (keys[i] != 0ul && keys[i] != key) {
+        i = (i + 1ul) & 262143ul;
+    }
+    return i;
+}
+
+static void insert(unsigned long key) {
+    unsigned long i = probe(key);
+    keys[i] = key;
+    counts[i] += 1;
+}
+
+static long lookup(unsigned long key) {
+    unsigned long i = probe(key);
+    return keys[i] == key ? counts[i] : 0;
+}
+
+int main(void) {
+    unsigned long key = 1ul;
+    for (int i = 0; i < 3000000; i++) {
+        key = (key * 6364136223846793005ul + 1442695040888963407ul);
+        insert((key >> 47) + 1ul);
+    }
+    long checksum = 0;
+    for (int n = 0; n < 20; n++) {
+        for (unsigned long k = 1ul; k < 200000ul; k++) {
+            checksum += lookup(k * 3ul + n) * (long)(k & 7ul);
+        }
+    }
+    return checksum % 256;
+}
@@ -0,0 +1,85 @@
+// Runs a bytecode loop on a switch-based stack machine interpreter.
+
+static long stack[256];
+static int code[25] = {
+    0, 0,       // 0: push 0 (accumulator)
+    0, 1000000, // 2: push 1000000 (counter)
+    7,          // 4: dup counter
+    8, 23,      // 5: pop, jump to 23 if zero
+    2,          // 7: swap
+    0, 3,       // 8: push 3
+    3,          // 10: mul
+    0, 7,       // 11: push 7
+    1,          // 13: add
+    0, 1000003, // 14: push 1000003
+    4,          // 16: mod
+    2,          // 17: swap
+    0, 1,       // 18: push 1
+    5,          // 20: sub
+    6, 4,       // 21: jump to 4
+    9,          // 23: pop counter
+    10          // 24: halt
+};
+
+static long run(void) {
+    int sp = 0;
+    int pc = 0;
+    while (1) {
+        switch (code[pc]) {
+            case 0:
+                stack[sp] = code[pc + 1];
+                sp++;
+                pc += 2;
+                break;
+            case 1:
+                sp--;
+                stack[sp - 1] += stack[sp];
+                pc++;
+                break;
+            case 2: {
+                long tmp = stack[sp - 1];
+                stack[sp - 1] = stack[sp - 2];
+                stack[sp - 2] = tmp;
+                pc++;
+                break;
+            }
+            case 3:
+                sp--;
+                stack[sp - 1] *= stack[sp];
+                pc++;
+                break;
+            case 4:
+                sp--;
+                stack[sp - 1] %= stack[sp];
+                pc++;
+                break;
+            case 5:
+                sp--;
+                stack[sp - 1] -= stack[sp];
+                pc++;
+                break;
+            case 6:
+                pc = code[pc + 1];
+                break;
+            case 7:
+                stack[sp] = stack[sp - 1];
+                sp++;
+                pc++;
+                break;
+            case 8:
+                sp--;
+                pc = stack[sp] == 0 ? code[pc + 1] : pc + 2;
+                break;
+            case 9:
+                sp--;
+                pc++;
+                break;
+            case 10:
+                return stack[sp - 1];
+            default:
+                return -1;
+        }
+    }
+}
+
+int main(void) { return run() % 256; }
@@ -0,0 +1,63 @@
+// Builds, traverses and reverses singly linked lists of structures.
+
+void* calloc(unsigned long nmemb, unsigned long size);
+void free(void* ptr);
+
+struct point {
+    long x;
+    long y;
+};
+
+struct node {
+    struct point point;
+    int id;
+    struct node* next;
+};
+
+static struct node* push(struct node* head, int id) {
+    struct node* node = calloc(1, sizeof(struct node));
+    node->id = id;
+    node->point.x = id * 3;
+    node->point.y = id % 17;
+    node->next = head;
+    return node;
+}
+
+static struct node* reverse(struct node* head) {
+    struct node* previous = 0;
+    while (head) {
+        struct node* next = head->next;
+        head->next = previous;
+        previous = head;
+        head = next;
+    }
+    return previous;
+}
+
+static struct point sum(struct node* head) {
+    struct point result = {0, 0};
+    for (; head; head = head->next) {
+        result.x += head->point.x;
+        result.y += head->point.y * head->id;
+    }
+    return result;
+}
+
+int main(void) {
+    struct node* head = 0;
+    for (int i = 0; i < 200000; i++) {
+        head = push(head, i);
+    }
+    long checksum = 0;
+    for (int n = 0; n < 40; n++) {
+        head = reverse(head);
+        struct point point = sum(head);
+        checksum += point.x % 1000 + point.y % 1000;
+    }
+    while (head) {
+        struct node* next = head->next;
+        free(head);
+        head = next;
+    }
+    return checksum % 256;
+}
@@ -0,0 +1,39 @@
+// Multiplies two 160x160 integer matrices, several times.
+
+static long a[160][160];
+static long b[160][160];
+static long c[160][160];
+
+static void init(void) {
+    for (int i = 0; i < 160; i++) {
+        for (int j = 0; j < 160; j++) {
+            a[i][j] = (i * 7 + j * 3) % 13;
+            b[i][j] = (i * 5 + j * 11) % 17;
+        }
+    }
+}
+
+static void multiply(void) {
+    for (int i = 0; i < 160; i++) {
+        for (int j = 0; j < 160; j++) {
+            long sum = 0;
+            for (int k = 0; k < 160; k++) {
+                sum += a[i][k] * b[k][j];
+            }
+            c[i][j] = sum;
+        }
+    }
+}
+
+int main(void) {
+    unsigned long checksum = 0;
+    init();
+    for (int n = 0; n < 4; n++) {
+        multiply();
+        for (int i = 0; i < 160; i++) {
+            checksum += c[i][(i + n) % 160];
+        }
+        a[n][n] = checksum % 7;
+    }
+    return checksum % 256;
+}
@@ -0,0 +1,83 @@
+// Simulates a 5-body gravitational system in double precision.
+
+double sqrt(double x);
+
+struct body {
+    double x;
+    double y;
+    double z;
+    double vx;
+    double vy;
+    double vz;
+    double mass;
+};
+
+static struct body bodies[5];
+
+static void init_body(int i, double x, double y, double z, double vx, double vy, double vz, double mass) {
+    bodies[i].x = x;
+    bodies[i].y = y;
+    bodies[i].z = z;
+    bodies[i].vx = vx;
+    bodies[i].vy = vy;
+    bodies[i].vz = vz;
+    bodies[i].mass = mass;
+}
+
+static void init(void) {
+    init_body(0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 39.47841760435743);
+    init_body(1, 4.84143144246472090, -1.16032004402742839, -0.103622044471123109, 0.606326392995832,
+        2.81198684491626, -0.02521836165988763, 0.03769367487038949);
+    init_body(2, 8.34336671824457987, 4.12479856412430479, -0.403523417114321381, -1.01077434617879,
+        1.82566237123041, 0.008415761376584154, 0.011286326131968767);
+    init_body(3, 12.8943695621391310, -15.1111514016986312, -0.223307578892655734, 1.08279100644154,
+        0.868713018169608, -0.01083270493825372, 0.0017237240570597112);
+    init_body(4, 15.3796971148509165, -25.9193146099879641, 0.179258772950371181, 0.979090732243898,
+        0.594698998647676, -0.034755955504078104, 0.0020336868699246304);
+}
+
+static void advance(double dt) {
+    for (int i = 0; i < 5; i++) {
+        for (int j = i + 1; j < 5; j++) {
+            double dx = bodies[i].x - bodies[j].x;
+            double dy = bodies[i].y - bodies[j].y;
+            double dz = bodies[i].z - bodies[j].z;
+            double distance2 = dx * dx + dy * dy + dz * dz;
+            double magnitude = dt / (distance2 * sqrt(distance2));
+            bodies[i].vx -= dx * bodies[j].mass * magnitude;
+            bodies[i].vy -= dy * bodies[j].mass * magnitude;
+            bodies[i].vz -= dz * bodies[j].mass * magnitude;
+            bodies[j].vx += dx * bodies[i].mass * magnitude;
+            bodies[j].vy += dy * bodies[i].mass * magnitude;
+            bodies[j].vz += dz * bodies[i].mass * magnitude;
+        }
+    }
+    for (int i = 0; i < 5; i++) {
+        bodies[i].x += dt * bodies[i].vx;
+        bodies[i].y += dt * bodies[i].vy;
+        bodies[i].z += dt * bodies[i].vz;
+    }
+}
+
+static double energy(void) {
+    double e = 0.0;
+    for (int i = 0; i < 5; i++) {
+        e += 0.5 * bodies[i].mass
+             * (bodies[i].vx * bodies[i].vx + bodies[i].vy * bodies[i].vy + bodies[i].vz * bodies[i].vz);
+        for (int j = i + 1; j < 5; j++) {
+            double dx = bodies[i].x - bodies[j].x;
+            double dy = bodies[i].y - bodies[j].y;
+            double dz = bodies[i].z - bodies[j].z;
+            e -= bodies[i].mass * bodies[j].mass / sqrt(dx * dx + dy * dy + dz * dz);
+        }
+    }
+    return e;
+}
+
+int main(void) {
+    init();
+    for (int n = 0; n < 1000000; n++) {
+        advance(0.001);
+    }
+    return (int)(-energy() * 1000000.0) % 256;
+}
@@ -0,0 +1,60 @@
+// Sorts 500000 pseudo-random integers with quicksort, then checks the order.
+
+static int values[500000];
+
+static unsigned int seed = 12345u;
+
+static unsigned int next_random(void) {
+    seed = seed * 1103515245u + 12345u;
+    return (seed >> 16) & 32767u;
+}
+
+static void swap(int* x, int* y) {
+    int tmp = *x;
+    *x = *y;
+    *y = tmp;
+}
+
+static void quicksort(int* v, int lo, int hi) {
+    while (lo < hi) {
+        int pivot = v[lo + (hi - lo) / 2];
+        int i = lo;
+        int j = hi;
+        while (i <= j) {
+            while (v[i] < pivot) {
+                i++;
+            }
+            while (v[j] > pivot) {
+                j--;
+            }
+            if (i <= j) {
+                swap(&v[i], &v[j]);
+                i++;
+                j--;
+            }
+        }
+        if (j - lo < hi - i) {
+            quicksort(v, lo, j);
+            lo = i;
+        }
+        else {
+            quicksort(v, i, hi);
+            hi = j;
+        }
+    }
+}
+
+int main(void) {
+    for (int i = 0; i < 500000; i++) {
+        values[i] = (int)(next_random() * 32768u + next_random());
+    }
+    quicksort(values, 0, 499999);
+    unsigned long checksum = 0;
+    for (int i = 1; i < 500000; i++) {
+        if (values[i - 1] > values[i]) {
+            return 255;
+        }
+        checksum += (unsigned long)values[i] * i;
+    }
+    return checksum % 251;
+}
@@ -0,0 +1,27 @@
+// Counts the primes below 2000000 with the sieve of Eratosthenes, several times.
+
+static char composite[2000000];
+
+static int sieve(int n) {
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        composite[i] = 0;
+    }
+    for (int i = 2; i < n; i++) {
+        if (!composite[i]) {
+            count++;
+            for (long j = (long)i * i; j < n; j += i) {
+                composite[j] = 1;
+            }
+        }
+    }
+    return count;
+}
+
+int main(void) {
+    int checksum = 0;
+    for (int n = 0; n < 5; n++) {
+        checksum += sieve(2000000 - n);
+    }
+    return checksum % 256;
+}
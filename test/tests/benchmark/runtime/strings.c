@@ -0,0 +1,55 @@
+// Tokenizes, reverses and hashes character strings.
+
+static char text[65536];
+static char word[256];
+
+static unsigned long hash_string(char* s) {
+    unsigned long h = 5381ul;
+    for (; *s; s++) {
+        h = h * 33ul + (unsigned char)*s;
+    }
+    return h;
+}
+
+static void reverse_string(char* s, int length) {
+    int j = length - 1;
+    for (int i = 0; i < j; i++) {
+        char c = s[i];
+        s[i] = s[j];
+        s[j] = c;
+        j--;
+    }
+}
+
+static void fill_text(void) {
+    char* alphabet = "the quick brown fox jumps over the lazy dog ";
+    int i = 0;
+    for (; i < 65535; i++) {
+        text[i] = alphabet[(i * 7 + i / 44) % 44];
+    }
+    text[i] = 0;
+}
+
+int main(void) {
+    unsigned long checksum = 0ul;
+    fill_text();
+    for (int n = 0; n < 200; n++) {
+        char* p = text;
+        while (*p) {
+            while (*p == ' ') {
+                p++;
+            }
+            int length = 0;
+            while (*p && *p != ' ' && length < 255) {
+                word[length] = *p;
+                length++;
+                p++;
+            }
+            word[length] = 0;
+            reverse_string(word, length);
+            checksum += hash_string(word) % 1009ul;
+        }
+        text[n] = 'a' + n % 26;
+    }
+    return checksum % 256;
+}
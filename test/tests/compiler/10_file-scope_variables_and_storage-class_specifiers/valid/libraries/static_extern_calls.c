@@ -0,0 +1,48 @@
+/* Functions with internal linkage are always called directly, and the other
+ * functions are called through the PLT, or through the GOT with --no-plt.
+ * Call and tail call both kinds of functions defined in this file, and a
+ * function defined in the C library, from this file and from the client */
+
+int putchar(int c);
+
+static int counter = 0;
+
+static int bump(int n) {
+    counter = counter + n;
+    return counter;
+}
+
+static int static_fact(int n) {
+    if (n <= 1) {
+        return 1;
+    }
+    return n * static_fact(n - 1);
+}
+
+static int static_tail(int n) {
+    return bump(n);
+}
+
+int extern_add(int a, int b) {
+    return bump(a) + b;
+}
+
+int extern_tail(int a) {
+    return extern_add(a, 1);
+}
+
+int extern_static_tail(int a) {
+    return static_tail(a);
+}
+
+int extern_fact(int n) {
+    return static_fact(n);
+}
+
+int extern_print(int c) {
+    return putchar(c);
+}
+
+int extern_counter(void) {
+    return counter;
+}
@@ -0,0 +1,51 @@
+/* This file defines its own function with internal linkage named 'bump',
+ * which must not be confused with the one in static_extern_calls.c,
+ * and calls the functions with external linkage defined there */
+
+int putchar(int c);
+
+int extern_add(int a, int b);
+int extern_tail(int a);
+int extern_static_tail(int a);
+int extern_fact(int n);
+int extern_print(int c);
+int extern_counter(void);
+
+static int bump(int n) {
+    return n * 100;
+}
+
+static int client_tail(int n) {
+    return extern_add(n, 2);
+}
+
+int main(void) {
+    if (bump(1) != 100) {
+        return 1;
+    }
+    if (extern_add(1, 10) != 11) {
+        return 2;
+    }
+    if (extern_tail(2) != 4) {
+        return 3;
+    }
+    if (extern_static_tail(3) != 6) {
+        return 4;
+    }
+    if (client_tail(4) != 12) {
+        return 5;
+    }
+    if (extern_counter() != 10) {
+        return 6;
+    }
+    if (extern_fact(6) != 720) {
+        return 7;
+    }
+    if (extern_print('o') != 'o' || putchar('k') != 'k' || extern_print('\n') != '\n') {
+        return 8;
+    }
+    if (bump(2) != 200) {
+        return 9;
+    }
+    return 0;
+}
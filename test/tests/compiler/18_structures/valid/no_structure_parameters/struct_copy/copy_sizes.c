@@ -0,0 +1,449 @@
+/* Test copying structures of 3, 4, 15, 16, 17, 256 and 257 bytes, which are
+ * moved a byte, a longword, a quadword or 16 bytes at a time with an
+ * overlapping last move, or with a block move above 256 bytes.
+ * Copy automatic, static, array element and member structures, through
+ * pointers and conditional expressions, and check that the bytes around the
+ * destination are not overwritten */
+
+void fill(char *p, int n, int seed) {
+    for (int i = 0; i < n; i = i + 1) {
+        p[i] = seed + i;
+    }
+}
+
+int check(char *p, int n, int seed) {
+    for (int i = 0; i < n; i = i + 1) {
+        if (p[i] != (char)(seed + i)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+int flag(int n) {
+    return n;
+}
+
+struct s3 {
+    char c[3];
+};
+
+struct guarded_s3 {
+    char before[3];
+    struct s3 s;
+    char after[5];
+};
+
+static struct s3 static_s3;
+
+int test_3(void) {
+    struct s3 a;
+    struct s3 b;
+    struct guarded_s3 g;
+    struct s3 arr[3];
+    fill(a.c, 3, 1);
+    fill(b.c, 3, 2);
+    fill(g.before, 3, 3);
+    fill(g.s.c, 3, 4);
+    fill(g.after, 5, 5);
+    for (int i = 0; i < 3; i = i + 1) {
+        fill(arr[i].c, 3, 6 + i);
+    }
+
+    b = a;
+    if (!check(b.c, 3, 1)) {
+        return 1;
+    }
+    g.s = b;
+    if (!check(g.before, 3, 3) || !check(g.s.c, 3, 1) || !check(g.after, 5, 5)) {
+        return 2;
+    }
+    fill(a.c, 3, 10);
+    struct s3 *dst = &g.s;
+    struct s3 *src = &a;
+    *dst = *src;
+    if (!check(g.before, 3, 3) || !check(g.s.c, 3, 10) || !check(g.after, 5, 5)) {
+        return 3;
+    }
+    arr[1] = g.s;
+    if (!check(arr[0].c, 3, 6) || !check(arr[1].c, 3, 10) || !check(arr[2].c, 3, 8)) {
+        return 4;
+    }
+    static_s3 = arr[2];
+    b = static_s3;
+    if (!check(static_s3.c, 3, 8) || !check(b.c, 3, 8)) {
+        return 5;
+    }
+    a = flag(0) ? a : arr[0];
+    if (!check(a.c, 3, 6)) {
+        return 6;
+    }
+    return 0;
+}
+
+struct s4 {
+    char c[4];
+};
+
+struct guarded_s4 {
+    char before[3];
+    struct s4 s;
+    char after[5];
+};
+
+static struct s4 static_s4;
+
+int test_4(void) {
+    struct s4 a;
+    struct s4 b;
+    struct guarded_s4 g;
+    struct s4 arr[3];
+    fill(a.c, 4, 1);
+    fill(b.c, 4, 2);
+    fill(g.before, 3, 3);
+    fill(g.s.c, 4, 4);
+    fill(g.after, 5, 5);
+    for (int i = 0; i < 3; i = i + 1) {
+        fill(arr[i].c, 4, 6 + i);
+    }
+
+    b = a;
+    if (!check(b.c, 4, 1)) {
+        return 1;
+    }
+    g.s = b;
+    if (!check(g.before, 3, 3) || !check(g.s.c, 4, 1) || !check(g.after, 5, 5)) {
+        return 2;
+    }
+    fill(a.c, 4, 10);
+    struct s4 *dst = &g.s;
+    struct s4 *src = &a;
+    *dst = *src;
+    if (!check(g.before, 3, 3) || !check(g.s.c, 4, 10) || !check(g.after, 5, 5)) {
+        return 3;
+    }
+    arr[1] = g.s;
+    if (!check(arr[0].c, 4, 6) || !check(arr[1].c, 4, 10) || !check(arr[2].c, 4, 8)) {
+        return 4;
+    }
+    static_s4 = arr[2];
+    b = static_s4;
+    if (!check(static_s4.c, 4, 8) || !check(b.c, 4, 8)) {
+        return 5;
+    }
+    a = flag(0) ? a : arr[0];
+    if (!check(a.c, 4, 6)) {
+        return 6;
+    }
+    return 0;
+}
+
+struct s15 {
+    char c[15];
+};
+
+struct guarded_s15 {
+    char before[3];
+    struct s15 s;
+    char after[5];
+};
+
+static struct s15 static_s15;
+
+int test_15(void) {
+    struct s15 a;
+    struct s15 b;
+    struct guarded_s15 g;
+    struct s15 arr[3];
+    fill(a.c, 15, 1);
+    fill(b.c, 15, 2);
+    fill(g.before, 3, 3);
+    fill(g.s.c, 15, 4);
+    fill(g.after, 5, 5);
+    for (int i = 0; i < 3; i = i + 1) {
+        fill(arr[i].c, 15, 6 + i);
+    }
+
+    b = a;
+    if (!check(b.c, 15, 1)) {
+        return 1;
+    }
+    g.s = b;
+    if (!check(g.before, 3, 3) || !check(g.s.c, 15, 1) || !check(g.after, 5, 5)) {
+        return 2;
+    }
+    fill(a.c, 15, 10);
+    struct s15 *dst = &g.s;
+    struct s15 *src = &a;
+    *dst = *src;
+    if (!check(g.before, 3, 3) || !check(g.s.c, 15, 10) || !check(g.after, 5, 5)) {
+        return 3;
+    }
+    arr[1] = g.s;
+    if (!check(arr[0].c, 15, 6) || !check(arr[1].c, 15, 10) || !check(arr[2].c, 15, 8)) {
+        return 4;
+    }
+    static_s15 = arr[2];
+    b = static_s15;
+    if (!check(static_s15.c, 15, 8) || !check(b.c, 15, 8)) {
+        return 5;
+    }
+    a = flag(0) ? a : arr[0];
+    if (!check(a.c, 15, 6)) {
+        return 6;
+    }
+    return 0;
+}
+
+struct s16 {
+    char c[16];
+};
+
+struct guarded_s16 {
+    char before[3];
+    struct s16 s;
+    char after[5];
+};
+
+static struct s16 static_s16;
+
+int test_16(void) {
+    struct s16 a;
+    struct s16 b;
+    struct guarded_s16 g;
+    struct s16 arr[3];
+    fill(a.c, 16, 1);
+    fill(b.c, 16, 2);
+    fill(g.before, 3, 3);
+    fill(g.s.c, 16, 4);
+    fill(g.after, 5, 5);
+    for (int i = 0; i < 3; i = i + 1) {
+        fill(arr[i].c, 16, 6 + i);
+    }
+
+    b = a;
+    if (!check(b.c, 16, 1)) {
+        return 1;
+    }
+    g.s = b;
+    if (!check(g.before, 3, 3) || !check(g.s.c, 16, 1) || !check(g.after, 5, 5)) {
+        return 2;
+    }
+    fill(a.c, 16, 10);
+    struct s16 *dst = &g.s;
+    struct s16 *src = &a;
+    *dst = *src;
+    if (!check(g.before, 3, 3) || !check(g.s.c, 16, 10) || !check(g.after, 5, 5)) {
+        return 3;
+    }
+    arr[1] = g.s;
+    if (!check(arr[0].c, 16, 6) || !check(arr[1].c, 16, 10) || !check(arr[2].c, 16, 8)) {
+        return 4;
+    }
+    static_s16 = arr[2];
+    b = static_s16;
+    if (!check(static_s16.c, 16, 8) || !check(b.c, 16, 8)) {
+        return 5;
+    }
+    a = flag(0) ? a : arr[0];
+    if (!check(a.c, 16, 6)) {
+        return 6;
+    }
+    return 0;
+}
+
+struct s17 {
+    char c[17];
+};
+
+struct guarded_s17 {
+    char before[3];
+    struct s17 s;
+    char after[5];
+};
+
+static struct s17 static_s17;
+
+int test_17(void) {
+    struct s17 a;
+    struct s17 b;
+    struct guarded_s17 g;
+    struct s17 arr[3];
+    fill(a.c, 17, 1);
+    fill(b.c, 17, 2);
+    fill(g.before, 3, 3);
+    fill(g.s.c, 17, 4);
+    fill(g.after, 5, 5);
+    for (int i = 0; i < 3; i = i + 1) {
+        fill(arr[i].c, 17, 6 + i);
+    }
+
+    b = a;
+    if (!check(b.c, 17, 1)) {
+        return 1;
+    }
+    g.s = b;
+    if (!check(g.before, 3, 3) || !check(g.s.c, 17, 1) || !check(g.after, 5, 5)) {
+        return 2;
+    }
+    fill(a.c, 17, 10);
+    struct s17 *dst = &g.s;
+    struct s17 *src = &a;
+    *dst = *src;
+    if (!check(g.before, 3, 3) || !check(g.s.c, 17, 10) || !check(g.after, 5, 5)) {
+        return 3;
+    }
+    arr[1] = g.s;
+    if (!check(arr[0].c, 17, 6) || !check(arr[1].c, 17, 10) || !check(arr[2].c, 17, 8)) {
+        return 4;
+    }
+    static_s17 = arr[2];
+    b = static_s17;
+    if (!check(static_s17.c, 17, 8) || !check(b.c, 17, 8)) {
+        return 5;
+    }
+    a = flag(0) ? a : arr[0];
+    if (!check(a.c, 17, 6)) {
+        return 6;
+    }
+    return 0;
+}
+
+struct s256 {
+    char c[256];
+};
+
+struct guarded_s256 {
+    char before[3];
+    struct s256 s;
+    char after[5];
+};
+
+static struct s256 static_s256;
+
+int test_256(void) {
+    struct s256 a;
+    struct s256 b;
+    struct guarded_s256 g;
+    struct s256 arr[3];
+    fill(a.c, 256, 1);
+    fill(b.c, 256, 2);
+    fill(g.before, 3, 3);
+    fill(g.s.c, 256, 4);
+    fill(g.after, 5, 5);
+    for (int i = 0; i < 3; i = i + 1) {
+        fill(arr[i].c, 256, 6 + i);
+    }
+
+    b = a;
+    if (!check(b.c, 256, 1)) {
+        return 1;
+    }
+    g.s = b;
+    if (!check(g.before, 3, 3) || !check(g.s.c, 256, 1) || !check(g.after, 5, 5)) {
+        return 2;
+    }
+    fill(a.c, 256, 10);
+    struct s256 *dst = &g.s;
+    struct s256 *src = &a;
+    *dst = *src;
+    if (!check(g.before, 3, 3) || !check(g.s.c, 256, 10) || !check(g.after, 5, 5)) {
+        return 3;
+    }
+    arr[1] = g.s;
+    if (!check(arr[0].c, 256, 6) || !check(arr[1].c, 256, 10) || !check(arr[2].c, 256, 8)) {
+        return 4;
+    }
+    static_s256 = arr[2];
+    b = static_s256;
+    if (!check(static_s256.c, 256, 8) || !check(b.c, 256, 8)) {
+        return 5;
+    }
+    a = flag(0) ? a : arr[0];
+    if (!check(a.c, 256, 6)) {
+        return 6;
+    }
+    return 0;
+}
+
+struct s257 {
+    char c[257];
+};
+
+struct guarded_s257 {
+    char before[3];
+    struct s257 s;
+    char after[5];
+};
+
+static struct s257 static_s257;
+
+int test_257(void) {
+    struct s257 a;
+    struct s257 b;
+    struct guarded_s257 g;
+    struct s257 arr[3];
+    fill(a.c, 257, 1);
+    fill(b.c, 257, 2);
+    fill(g.before, 3, 3);
+    fill(g.s.c, 257, 4);
+    fill(g.after, 5, 5);
+    for (int i = 0; i < 3; i = i + 1) {
+        fill(arr[i].c, 257, 6 + i);
+    }
+
+    b = a;
+    if (!check(b.c, 257, 1)) {
+        return 1;
+    }
+    g.s = b;
+    if (!check(g.before, 3, 3) || !check(g.s.c, 257, 1) || !check(g.after, 5, 5)) {
+        return 2;
+    }
+    fill(a.c, 257, 10);
+    struct s257 *dst = &g.s;
+    struct s257 *src = &a;
+    *dst = *src;
+    if (!check(g.before, 3, 3) || !check(g.s.c, 257, 10) || !check(g.after, 5, 5)) {
+        return 3;
+    }
+    arr[1] = g.s;
+    if (!check(arr[0].c, 257, 6) || !check(arr[1].c, 257, 10) || !check(arr[2].c, 257, 8)) {
+        return 4;
+    }
+    static_s257 = arr[2];
+    b = static_s257;
+    if (!check(static_s257.c, 257, 8) || !check(b.c, 257, 8)) {
+        return 5;
+    }
+    a = flag(0) ? a : arr[0];
+    if (!check(a.c, 257, 6)) {
+        return 6;
+    }
+    return 0;
+}
+
+int main(void) {
+    if (test_3()) {
+        return 10 + test_3();
+    }
+    if (test_4()) {
+        return 20 + test_4();
+    }
+    if (test_15()) {
+        return 30 + test_15();
+    }
+    if (test_16()) {
+        return 40 + test_16();
+    }
+    if (test_17()) {
+        return 50 + test_17();
+    }
+    if (test_256()) {
+        return 60 + test_256();
+    }
+    if (test_257()) {
+        return 70 + test_257();
+    }
+    return 0;
+}
@@ -0,0 +1,239 @@
+/* Test passing and returning structures of 3, 4, 15, 16, 17, 256 and 257
+ * bytes by value, which are copied to and from the stack, or to and from
+ * registers for up to 16 bytes, and check that the callee works on a copy */
+
+void fill(char *p, int n, int seed) {
+    for (int i = 0; i < n; i = i + 1) {
+        p[i] = seed + i;
+    }
+}
+
+int check(char *p, int n, int seed) {
+    for (int i = 0; i < n; i = i + 1) {
+        if (p[i] != (char)(seed + i)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+struct s3 {
+    char c[3];
+};
+
+struct s3 modify_s3(struct s3 s, int seed) {
+    if (!check(s.c, 3, seed)) {
+        fill(s.c, 3, 0);
+        return s;
+    }
+    fill(s.c, 3, seed + 1);
+    return s;
+}
+
+int test_3(void) {
+    struct s3 a;
+    struct s3 b;
+    fill(a.c, 3, 1);
+    b = modify_s3(a, 1);
+    if (!check(a.c, 3, 1) || !check(b.c, 3, 2)) {
+        return 1;
+    }
+    a = modify_s3(modify_s3(b, 2), 3);
+    if (!check(a.c, 3, 4) || !check(b.c, 3, 2)) {
+        return 2;
+    }
+    return 0;
+}
+
+struct s4 {
+    char c[4];
+};
+
+struct s4 modify_s4(struct s4 s, int seed) {
+    if (!check(s.c, 4, seed)) {
+        fill(s.c, 4, 0);
+        return s;
+    }
+    fill(s.c, 4, seed + 1);
+    return s;
+}
+
+int test_4(void) {
+    struct s4 a;
+    struct s4 b;
+    fill(a.c, 4, 1);
+    b = modify_s4(a, 1);
+    if (!check(a.c, 4, 1) || !check(b.c, 4, 2)) {
+        return 1;
+    }
+    a = modify_s4(modify_s4(b, 2), 3);
+    if (!check(a.c, 4, 4) || !check(b.c, 4, 2)) {
+        return 2;
+    }
+    return 0;
+}
+
+struct s15 {
+    char c[15];
+};
+
+struct s15 modify_s15(struct s15 s, int seed) {
+    if (!check(s.c, 15, seed)) {
+        fill(s.c, 15, 0);
+        return s;
+    }
+    fill(s.c, 15, seed + 1);
+    return s;
+}
+
+int test_15(void) {
+    struct s15 a;
+    struct s15 b;
+    fill(a.c, 15, 1);
+    b = modify_s15(a, 1);
+    if (!check(a.c, 15, 1) || !check(b.c, 15, 2)) {
+        return 1;
+    }
+    a = modify_s15(modify_s15(b, 2), 3);
+    if (!check(a.c, 15, 4) || !check(b.c, 15, 2)) {
+        return 2;
+    }
+    return 0;
+}
+
+struct s16 {
+    char c[16];
+};
+
+struct s16 modify_s16(struct s16 s, int seed) {
+    if (!check(s.c, 16, seed)) {
+        fill(s.c, 16, 0);
+        return s;
+    }
+    fill(s.c, 16, seed + 1);
+    return s;
+}
+
+int test_16(void) {
+    struct s16 a;
+    struct s16 b;
+    fill(a.c, 16, 1);
+    b = modify_s16(a, 1);
+    if (!check(a.c, 16, 1) || !check(b.c, 16, 2)) {
+        return 1;
+    }
+    a = modify_s16(modify_s16(b, 2), 3);
+    if (!check(a.c, 16, 4) || !check(b.c, 16, 2)) {
+        return 2;
+    }
+    return 0;
+}
+
+struct s17 {
+    char c[17];
+};
+
+struct s17 modify_s17(struct s17 s, int seed) {
+    if (!check(s.c, 17, seed)) {
+        fill(s.c, 17, 0);
+        return s;
+    }
+    fill(s.c, 17, seed + 1);
+    return s;
+}
+
+int test_17(void) {
+    struct s17 a;
+    struct s17 b;
+    fill(a.c, 17, 1);
+    b = modify_s17(a, 1);
+    if (!check(a.c, 17, 1) || !check(b.c, 17, 2)) {
+        return 1;
+    }
+    a = modify_s17(modify_s17(b, 2), 3);
+    if (!check(a.c, 17, 4) || !check(b.c, 17, 2)) {
+        return 2;
+    }
+    return 0;
+}
+
+struct s256 {
+    char c[256];
+};
+
+struct s256 modify_s256(struct s256 s, int seed) {
+    if (!check(s.c, 256, seed)) {
+        fill(s.c, 256, 0);
+        return s;
+    }
+    fill(s.c, 256, seed + 1);
+    return s;
+}
+
+int test_256(void) {
+    struct s256 a;
+    struct s256 b;
+    fill(a.c, 256, 1);
+    b = modify_s256(a, 1);
+    if (!check(a.c, 256, 1) || !check(b.c, 256, 2)) {
+        return 1;
+    }
+    a = modify_s256(modify_s256(b, 2), 3);
+    if (!check(a.c, 256, 4) || !check(b.c, 256, 2)) {
+        return 2;
+    }
+    return 0;
+}
+
+struct s257 {
+    char c[257];
+};
+
+struct s257 modify_s257(struct s257 s, int seed) {
+    if (!check(s.c, 257, seed)) {
+        fill(s.c, 257, 0);
+        return s;
+    }
+    fill(s.c, 257, seed + 1);
+    return s;
+}
+
+int test_257(void) {
+    struct s257 a;
+    struct s257 b;
+    fill(a.c, 257, 1);
+    b = modify_s257(a, 1);
+    if (!check(a.c, 257, 1) || !check(b.c, 257, 2)) {
+        return 1;
+    }
+    a = modify_s257(modify_s257(b, 2), 3);
+    if (!check(a.c, 257, 4) || !check(b.c, 257, 2)) {
+        return 2;
+    }
+    return 0;
+}
+
+int main(void) {
+    if (test_3()) {
+        return 10 + test_3();
+    }
+    if (test_4()) {
+        return 20 + test_4();
+    }
+    if (test_15()) {
+        return 30 + test_15();
+    }
+    if (test_16()) {
+        return 40 + test_16();
+    }
+    if (test_17()) {
+        return 50 + test_17();
+    }
+    if (test_256()) {
+        return 60 + test_256();
+    }
+    if (test_257()) {
+        return 70 + test_257();
+    }
+    return 0;
+}
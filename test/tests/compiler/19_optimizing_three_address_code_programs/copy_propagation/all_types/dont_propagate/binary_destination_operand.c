@@ -0,0 +1,64 @@
+/* Test that a copy of the destination of a binary instruction is not
+ * propagated into its second operand. The first operand is moved to the
+ * destination before the second operand is read, so in t = 1 + t, where the
+ * temporary holding 1 + t is copied to t in the previous iteration of the
+ * loop, t must not be replaced with that temporary */
+
+int add(int n) {
+    int t = 0;
+    for (int i = 0; i < n; i = i + 1) {
+        t = 1 + t;
+    }
+    return t;
+}
+
+int subtract(int n) {
+    int t = 0;
+    for (int i = 0; i < n; i = i + 1) {
+        t = 10 - t;
+    }
+    return t;
+}
+
+long multiply(int n) {
+    long t = 1l;
+    for (int i = 0; i < n; i = i + 1) {
+        t = 3l * t;
+    }
+    return t;
+}
+
+unsigned subtract_unsigned(int n) {
+    unsigned t = 1u;
+    for (int i = 0; i < n; i = i + 1) {
+        t = 5u - t;
+    }
+    return t;
+}
+
+double add_double(int n) {
+    double t = 0.0;
+    for (int i = 0; i < n; i = i + 1) {
+        t = 0.5 + t;
+    }
+    return t;
+}
+
+int main(void) {
+    if (add(5) != 5) {
+        return 1;
+    }
+    if (subtract(3) != 10) {
+        return 2;
+    }
+    if (multiply(4) != 81l) {
+        return 3;
+    }
+    if (subtract_unsigned(3) != 4u) {
+        return 4;
+    }
+    if (add_double(6) != 3.0) {
+        return 5;
+    }
+    return 0;
+}
@@ -0,0 +1,182 @@
+/* Test a function call and a store that kill more than 64 copies, so that the
+ * first word of the set of reaching copies is emptied before the next word is
+ * scanned. The copies in the branch do not reach the kill, so the last copy
+ * killed in the first word is followed by a copy in the next word, which must
+ * not be skipped, or the old value of the variable would be propagated into
+ * the return statement after the kill */
+
+int x = 0;
+
+void clobber(void) {
+    x = 100;
+}
+
+int kill_call(int a, int c) {
+    int t;
+    x = a;
+    if (c) {
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+    }
+    int y1 = x;
+    int y2 = x;
+    int y3 = x;
+    int y4 = x;
+    int y5 = x;
+    int y6 = x;
+    int y7 = x;
+    int y8 = x;
+    clobber();
+    return y1 + y2 + y3 + y4 + y5 + y6 + y7 + y8;
+}
+
+int kill_store(int a, int c) {
+    int t;
+    int z;
+    int *p = &z;
+    z = a;
+    if (c) {
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+        t = a;
+    }
+    int y1 = z;
+    int y2 = z;
+    int y3 = z;
+    int y4 = z;
+    int y5 = z;
+    int y6 = z;
+    int y7 = z;
+    int y8 = z;
+    *p = 100;
+    return y1 + y2 + y3 + y4 + y5 + y6 + y7 + y8;
+}
+
+int main(void) {
+    if (kill_call(1, 0) != 8) {
+        return 1;
+    }
+    if (kill_store(1, 0) != 8) {
+        return 2;
+    }
+    if (kill_call(2, 1) != 16) {
+        return 3;
+    }
+    if (kill_store(2, 1) != 16) {
+        return 4;
+    }
+    return 0;
+}
@@ -0,0 +1,43 @@
+/* A variable escapes when its address is converted to an integer and used in
+ * arithmetic, after which a pointer to it can no longer be tracked. Passing
+ * the integer to a function also lets the function write the variable */
+
+static unsigned long saved;
+
+void keep(unsigned long address) {
+    saved = address;
+}
+
+void write_saved(int value) {
+    int *ptr = (int *)saved;
+    *ptr = value;
+}
+
+int hide_address(int key) {
+    int x = 1;
+    long address = (long)&x;
+    address = address ^ key;
+    int *ptr = (int *)(address ^ key);
+    x = 2;  // not a dead store, read through ptr
+    int result = *ptr;
+    *ptr = 3;
+    return result == 2 && x == 3;  // x is not propagated as 2
+}
+
+int pass_address(void) {
+    int x = 4;
+    keep((unsigned long)&x);
+    x = 5;
+    write_saved(6);
+    return x == 6;  // x is not propagated as 5
+}
+
+int main(void) {
+    if (!hide_address(12345)) {
+        return 1;
+    }
+    if (!pass_address()) {
+        return 2;
+    }
+    return 0;
+}
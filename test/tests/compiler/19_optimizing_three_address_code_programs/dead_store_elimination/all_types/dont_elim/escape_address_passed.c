@@ -0,0 +1,51 @@
+/* A variable escapes when its address, or an address derived from it, is
+ * passed to a function, which may keep it and read or write the variable in
+ * later calls */
+
+static long *saved;
+
+long *keep(long *ptr) {
+    saved = ptr;
+    return ptr;
+}
+
+void write_saved(long value) {
+    *saved = value;
+}
+
+long read_saved(void) {
+    return *saved;
+}
+
+int pass_address(void) {
+    long x = 1l;
+    keep(&x);
+    x = 2l;  // not a dead store, read by read_saved
+    if (read_saved() != 2l) {
+        return 0;
+    }
+    write_saved(3l);
+    return x == 3l;  // x is not propagated as 2
+}
+
+int pass_element_address(void) {
+    long arr[3] = {1l, 2l, 3l};
+    long *ptr = arr;
+    keep(ptr + 2);
+    arr[2] = 4l;  // not a dead store, read by read_saved
+    if (read_saved() != 4l) {
+        return 0;
+    }
+    write_saved(5l);
+    return arr[2] == 5l && arr[1] == 2l;
+}
+
+int main(void) {
+    if (!pass_address()) {
+        return 1;
+    }
+    if (!pass_element_address()) {
+        return 2;
+    }
+    return 0;
+}
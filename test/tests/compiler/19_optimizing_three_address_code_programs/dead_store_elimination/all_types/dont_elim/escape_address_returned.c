@@ -0,0 +1,30 @@
+/* A variable escapes when its address is returned, after which the caller
+ * may write it through the returned pointer between two calls */
+
+int *counter(int increment) {
+    static int count = 0;
+    int *ptr = &count;
+    count = count + increment;
+    return ptr;
+}
+
+double *scale(double factor) {
+    static double value = 1.0;
+    double *ptr = &value;
+    value = value * factor;
+    return ptr;
+}
+
+int main(void) {
+    int *count = counter(1);
+    *count = 10;
+    if (*counter(1) != 11 || *count != 11) {
+        return 1;
+    }
+    double *value = scale(2.0);
+    *value = *value + 1.0;
+    if (*scale(2.0) != 6.0) {
+        return 2;
+    }
+    return 0;
+}
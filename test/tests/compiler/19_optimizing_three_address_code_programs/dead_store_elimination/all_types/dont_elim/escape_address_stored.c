@@ -0,0 +1,48 @@
+/* A variable escapes when its address is stored to memory or copied to a
+ * static variable. A function call may then read or write it, so that the
+ * stores before the call are not dead, and the copies before the call are not
+ * propagated after it */
+
+static int *glob_ptr;
+
+void write_glob(int value) {
+    *glob_ptr = value;
+}
+
+int read_glob(void) {
+    return *glob_ptr;
+}
+
+int store_to_static(void) {
+    int x = 1;
+    glob_ptr = &x;
+    x = 2;  // not a dead store, read by read_glob
+    if (read_glob() != 2) {
+        return 0;
+    }
+    write_glob(3);
+    return x == 3;  // x is not propagated as 2
+}
+
+int store_through_pointer(int **ptr_ptr) {
+    double d = 0.0;
+    int x = 4;
+    *ptr_ptr = &x;
+    x = 5;  // not a dead store, read by read_glob
+    if (read_glob() != 5) {
+        return 0;
+    }
+    write_glob(6);
+    d = x;
+    return d == 6.0;
+}
+
+int main(void) {
+    if (!store_to_static()) {
+        return 1;
+    }
+    if (!store_through_pointer(&glob_ptr)) {
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,43 @@
+/* A store to a static variable is not dead when the variable is read through
+ * a pointer before it is stored again, whether the pointer is known to point
+ * to it or may point to any static variable */
+
+static int x;
+static long y;
+static int *glob_ptr;
+
+int read_known_pointer(void) {
+    int *ptr = &x;
+    x = 5;  // not a dead store, read through ptr
+    int result = *ptr;
+    x = 6;
+    return result;
+}
+
+long read_unknown_pointer(long *ptr) {
+    y = 7l;  // not a dead store, ptr may point to y
+    long result = *ptr;
+    y = 8l;
+    return result;
+}
+
+int read_global_pointer(void) {
+    x = 9;  // not a dead store, glob_ptr may point to x
+    int result = *glob_ptr;
+    x = 10;
+    return result;
+}
+
+int main(void) {
+    if (read_known_pointer() != 5 || x != 6) {
+        return 1;
+    }
+    if (read_unknown_pointer(&y) != 7l || y != 8l) {
+        return 2;
+    }
+    glob_ptr = &x;
+    if (read_global_pointer() != 9 || x != 10) {
+        return 3;
+    }
+    return 0;
+}
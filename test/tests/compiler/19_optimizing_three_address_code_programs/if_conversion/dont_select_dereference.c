@@ -0,0 +1,54 @@
+/* Test that conditional expressions whose operands may trap, like a load
+ * through a null pointer or a division by zero, are not compiled to
+ * conditional moves, which would evaluate both operands */
+
+struct s {
+    int a;
+    long b;
+};
+
+int load_or(int *p, int x) {
+    return p ? *p : x;
+}
+
+int index_or(int *p, int x) {
+    return p ? p[1] : x;
+}
+
+long member_or(struct s *p, long x) {
+    return p ? p->b : x;
+}
+
+int divide_or(int n, int x) {
+    return n != 0 ? x / n : x;
+}
+
+int *pointer_or(int *p, int *q) {
+    return p ? p : q;
+}
+
+int main(void) {
+    int arr[2] = {3, 4};
+    struct s st = {5, 6l};
+    int *null = 0;
+    struct s *null_s = 0;
+    if (load_or(arr, 1) != 3 || load_or(null, 1) != 1) {
+        return 1;
+    }
+    if (index_or(arr, 1) != 4 || index_or(null, 1) != 1) {
+        return 2;
+    }
+    if (member_or(&st, 1l) != 6l || member_or(null_s, 1l) != 1l) {
+        return 3;
+    }
+    if (divide_or(2, 10) != 5 || divide_or(0, 10) != 10) {
+        return 4;
+    }
+    if (pointer_or(arr, null) != arr || pointer_or(null, arr + 1) != arr + 1) {
+        return 5;
+    }
+    if (*pointer_or(null, arr + 1) != 4) {
+        return 6;
+    }
+    return 0;
+}
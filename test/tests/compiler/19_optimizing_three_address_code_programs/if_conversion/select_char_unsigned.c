@@ -0,0 +1,77 @@
+/* Test conditional expressions compiled to conditional moves whose operands
+ * are chars or unsigned integers, which are selected on the width of the
+ * result after they are sign or zero extended */
+
+int flag(int n) {
+    return n;
+}
+
+int select_chars(int c, char a, unsigned char b) {
+    return c ? a : b;
+}
+
+long select_signed_char(int c, signed char a) {
+    return c ? a : 0l;
+}
+
+unsigned select_unsigned(int c, unsigned a, unsigned b) {
+    return c ? a : b;
+}
+
+unsigned long select_unsigned_long(unsigned c, unsigned long a, unsigned b) {
+    return c ? a : b;
+}
+
+long select_mixed(int c, unsigned a, int b) {
+    // the int operand is converted to unsigned, so it is not sign extended
+    long l = c ? a : b;
+    return l;
+}
+
+int main(void) {
+    char neg = -5;
+    unsigned char big = 200;
+    if (select_chars(flag(1), neg, big) != -5) {
+        return 1;
+    }
+    if (select_chars(flag(0), neg, big) != 200) {
+        return 2;
+    }
+    if (select_signed_char(flag(1), -1) != -1l) {
+        return 3;
+    }
+    if (select_signed_char(flag(0), -1) != 0l) {
+        return 4;
+    }
+    if (select_unsigned(flag(1), 4294967295u, 1u) != 4294967295u) {
+        return 5;
+    }
+    if (select_unsigned(flag(0), 4294967295u, 1u) != 1u) {
+        return 6;
+    }
+    if (select_unsigned_long(2u, 18446744073709551615ul, 4294967295u) != 18446744073709551615ul) {
+        return 7;
+    }
+    if (select_unsigned_long(0u, 18446744073709551615ul, 4294967295u) != 4294967295ul) {
+        return 8;
+    }
+    if (select_mixed(flag(0), 3u, -1) != 4294967295l) {
+        return 9;
+    }
+    if (select_mixed(flag(1), 3u, -1) != 3l) {
+        return 10;
+    }
+    // the condition is a char or an unsigned char whose upper bits are not set
+    unsigned char uc = 0;
+    char sc = 0;
+    for (int i = 0; i < 300; i = i + 1) {
+        uc = uc + 1;
+        sc = sc + 3;
+        int from_uc = uc ? 1 : 2;
+        int from_sc = sc ? 3 : 4;
+        if (from_uc != (uc != 0 ? 1 : 2) || (uc == 0 && from_uc != 2) || (sc == 0 && from_sc != 4)) {
+            return 11;
+        }
+    }
+    return 0;
+}
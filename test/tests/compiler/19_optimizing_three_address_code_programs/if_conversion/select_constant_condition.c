@@ -0,0 +1,45 @@
+/* Test conditional expressions with a constant condition, or a condition
+ * that is only constant after copy propagation, which are folded into a copy
+ * of one of their operands */
+
+int flag(int n) {
+    return n;
+}
+
+int main(void) {
+    int a = flag(3);
+    int b = flag(4);
+    if ((1 ? a : b) != 3) {
+        return 1;
+    }
+    if ((0 ? a : b) != 4) {
+        return 2;
+    }
+    if ((3 > 2 ? a : b) != 3) {
+        return 3;
+    }
+    if ((0.5 ? a : b) != 3) {
+        return 4;
+    }
+    int k = 0;
+    if ((k ? a : b) != 4) {
+        return 5;
+    }
+    k = 10;
+    if ((k ? a : b) != 3) {
+        return 6;
+    }
+    if ((k ? 5 : 7) != 5 || (!k ? 5 : 7) != 7) {
+        return 7;
+    }
+    long l = 0l;
+    unsigned long ul = 0ul;
+    for (int i = 0; i < 3; i = i + 1) {
+        l = l + (i < 10 ? a : b);
+        ul = ul + (i > 10 ? 1ul : 2ul);
+    }
+    if (l != 9l || ul != 6ul) {
+        return 8;
+    }
+    return 0;
+}
@@ -0,0 +1,60 @@
+/* Test conditional expressions compiled to conditional moves whose operands
+ * are doubles, which are selected on their bits, including negative zero,
+ * infinities and NaNs, and conditional expressions that mix doubles and
+ * integers, which are not compiled to conditional moves */
+
+double max(double a, double b) {
+    return a > b ? a : b;
+}
+
+double min(double a, double b) {
+    return a < b ? a : b;
+}
+
+double select_constant(int c, double d) {
+    return c ? 1.5 : d;
+}
+
+double select_int(int c, int i, double d) {
+    return c ? i : d;
+}
+
+int is_negative_zero(double d) {
+    return d == 0.0 && 1.0 / d < 0.0;
+}
+
+int main(void) {
+    double zero = 0.0;
+    double neg_zero = -0.0;
+    double inf = 1.0 / zero;
+    double nan = zero / zero;
+    if (max(1.5, -2.5) != 1.5 || max(-2.5, 1.5) != 1.5 || min(1.5, -2.5) != -2.5) {
+        return 1;
+    }
+    // the comparison of zeros is false, so the second operand is selected
+    if (!is_negative_zero(max(zero, neg_zero)) || is_negative_zero(max(neg_zero, zero))) {
+        return 2;
+    }
+    if (max(inf, 1e308) != inf || min(-inf, -1e308) != -inf) {
+        return 3;
+    }
+    // comparisons with a NaN are false
+    if (max(nan, 1.0) != 1.0 || max(1.0, nan) == max(1.0, nan)) {
+        return 4;
+    }
+    if (select_constant(1, 2.5) != 1.5 || select_constant(0, 2.5) != 2.5) {
+        return 5;
+    }
+    if (select_int(1, -3, 2.5) != -3.0 || select_int(0, -3, 2.5) != 2.5) {
+        return 6;
+    }
+    double sum = 0.0;
+    for (int i = 0; i < 10; i = i + 1) {
+        double d = i * 0.5;
+        sum = sum + (i % 3 ? d : -d);
+    }
+    if (sum != 4.5) {
+        return 7;
+    }
+    return 0;
+}
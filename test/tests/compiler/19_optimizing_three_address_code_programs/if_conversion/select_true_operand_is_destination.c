@@ -0,0 +1,38 @@
+/* Test a conditional expression whose true operand is a copy of its own
+ * destination from the previous unrolled iteration. The false operand is
+ * moved to the destination before the true operand is read, so that the
+ * true operand must not be replaced with the destination */
+
+int select_loop(int n, int c) {
+    int y = 1;
+    for (int i = 0; i < n; i = i + 1) {
+        int z = i + 10;
+        y = c ? y : z;
+        c = i % 4 != 0;
+    }
+    return y;
+}
+
+int if_loop(int n, int c) {
+    int y = 1;
+    for (int i = 0; i < n; i = i + 1) {
+        int z = i + 10;
+        if (!c) {
+            y = z;
+        }
+        c = i % 4 != 0;
+    }
+    return y;
+}
+
+int main(void) {
+    for (int n = 0; n < 20; n = n + 1) {
+        if (select_loop(n, 1) != if_loop(n, 1)) {
+            return n + 1;
+        }
+        if (select_loop(n, 0) != if_loop(n, 0)) {
+            return n + 21;
+        }
+    }
+    return 0;
+}
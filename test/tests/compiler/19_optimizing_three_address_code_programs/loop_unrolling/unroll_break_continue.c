@@ -0,0 +1,103 @@
+/* Test unrolled loops whose bodies break out of the loop or continue to the
+ * next iteration, where every copy of the body must jump to the end of the
+ * loop or to its own increment, both in loops with a constant trip count,
+ * which are fully unrolled, and in loops with a variable bound, which are
+ * partially unrolled */
+
+int sum_until_full(int stop) {
+    int sum = 0;
+    for (int i = 0; i < 10; i = i + 1) {
+        if (i == stop) {
+            break;
+        }
+        sum = sum + i;
+    }
+    return sum;
+}
+
+int sum_odd_full(void) {
+    int sum = 0;
+    for (int i = 0; i < 10; i = i + 1) {
+        if (i % 2 == 0) {
+            continue;
+        }
+        sum = sum + i;
+    }
+    return sum;
+}
+
+int sum_until(int n, int stop) {
+    int sum = 0;
+    for (int i = 0; i < n; i = i + 1) {
+        if (i == stop) {
+            break;
+        }
+        sum = sum + i;
+    }
+    return sum;
+}
+
+int sum_skip(int n, int skip) {
+    int sum = 0;
+    for (int i = 0; i < n; i = i + 1) {
+        if (i % skip == 0) {
+            continue;
+        }
+        sum = sum + i;
+    }
+    return sum;
+}
+
+long count_break_continue(long n) {
+    long count = 0;
+    for (long i = 0; i < n; i = i + 3) {
+        if (i % 2 == 1) {
+            continue;
+        }
+        if (i > 60) {
+            break;
+        }
+        count = count + i;
+    }
+    return count;
+}
+
+int main(void) {
+    if (sum_until_full(0) != 0) {
+        return 1;
+    }
+    if (sum_until_full(5) != 10) {
+        return 2;
+    }
+    if (sum_until_full(20) != 45) {
+        return 3;
+    }
+    if (sum_odd_full() != 25) {
+        return 4;
+    }
+    for (int stop = 0; stop < 40; stop = stop + 1) {
+        int last = stop < 30 ? stop : 30;
+        if (sum_until(30, stop) != last * (last - 1) / 2) {
+            return 5;
+        }
+        if (sum_until(stop, 100) != stop * (stop - 1) / 2) {
+            return 6;
+        }
+    }
+    if (sum_skip(0, 2) != 0) {
+        return 7;
+    }
+    if (sum_skip(23, 3) != 169) {
+        return 8;
+    }
+    if (sum_skip(24, 5) != 226) {
+        return 9;
+    }
+    if (count_break_continue(5l) != 0l) {
+        return 10;
+    }
+    if (count_break_continue(100l) != 0l + 6l + 12l + 18l + 24l + 30l + 36l + 42l + 48l + 54l + 60l) {
+        return 11;
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+/* Test loops whose body is entered by a goto from outside of the loop, which
+ * must not be unrolled, as the copies of the body would leave the label in
+ * only one of them */
+
+int enter_full(int skip) {
+    int count = 0;
+    int i = 5;
+    if (skip) {
+        goto body;
+    }
+    for (i = 0; i < 10; i = i + 1) {
+    body:
+        count = count + 1;
+    }
+    return count * 100 + i;
+}
+
+int enter_partial(int n, int start) {
+    int count = 0;
+    int i = start;
+    if (start > 0) {
+        goto body;
+    }
+    for (i = 0; i < n; i = i + 1) {
+    body:
+        count = count + i;
+    }
+    return count;
+}
+
+int main(void) {
+    if (enter_full(0) != 1010) {
+        return 1;
+    }
+    if (enter_full(1) != 510) {
+        return 2;
+    }
+    if (enter_partial(30, 0) != 435) {
+        return 3;
+    }
+    if (enter_partial(30, 7) != 414) {
+        return 4;
+    }
+    if (enter_partial(30, 29) != 29) {
+        return 5;
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+/* Test loops whose bound is changed in the loop body, directly, through a
+ * pointer or by a function call, which must not be unrolled with the trip
+ * count computed from the bound at the start of the loop */
+
+int global_bound = 0;
+
+void shrink_global(void) {
+    global_bound = global_bound - 1;
+}
+
+int shrink_bound(int n) {
+    int count = 0;
+    for (int i = 0; i < n; i = i + 1) {
+        n = n - 1;
+        count = count + 1;
+    }
+    return count;
+}
+
+int grow_bound(int n) {
+    int count = 0;
+    for (int i = 0; i < n; i = i + 1) {
+        if (i % 3 == 0 && n < 30) {
+            n = n + 2;
+        }
+        count = count + 1;
+    }
+    return count;
+}
+
+int constant_bound_copy(void) {
+    int n = 12;
+    int count = 0;
+    for (int i = 0; i < n; i = i + 1) {
+        if (i == 2) {
+            n = 5;
+        }
+        count = count + 1;
+    }
+    return count;
+}
+
+int bound_through_pointer(int n) {
+    int *p = &n;
+    int count = 0;
+    for (int i = 0; i < n; i = i + 1) {
+        *p = *p - 1;
+        count = count + 1;
+    }
+    return count;
+}
+
+int global_bound_by_call(void) {
+    int count = 0;
+    for (int i = 0; i < global_bound; i = i + 1) {
+        shrink_global();
+        count = count + 1;
+    }
+    return count;
+}
+
+int main(void) {
+    if (shrink_bound(10) != 5) {
+        return 1;
+    }
+    if (shrink_bound(21) != 11) {
+        return 2;
+    }
+    if (grow_bound(4) != 12) {
+        return 3;
+    }
+    if (grow_bound(25) != 31) {
+        return 4;
+    }
+    if (constant_bound_copy() != 5) {
+        return 5;
+    }
+    if (bound_through_pointer(10) != 5) {
+        return 6;
+    }
+    if (bound_through_pointer(21) != 11) {
+        return 7;
+    }
+    global_bound = 10;
+    if (global_bound_by_call() != 5) {
+        return 8;
+    }
+    global_bound = 21;
+    if (global_bound_by_call() != 11) {
+        return 9;
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+/* Test loops whose induction variable is changed in the loop body, directly,
+ * through a pointer or by a function call, which must not be unrolled with a
+ * trip count computed from the step in the loop increment */
+
+int *global_ptr = 0;
+
+void skip_next(void) {
+    *global_ptr = *global_ptr + 1;
+}
+
+int skip_in_body(int n) {
+    int count = 0;
+    for (int i = 0; i < n; i = i + 1) {
+        if (i % 4 == 1) {
+            i = i + 2;
+        }
+        count = count + 1;
+    }
+    return count;
+}
+
+int skip_constant_trip(void) {
+    int count = 0;
+    for (int i = 0; i < 12; i = i + 1) {
+        i = i + 1;
+        count = count + 1;
+    }
+    return count;
+}
+
+int reset_in_body(int n) {
+    int count = 0;
+    int reset = 0;
+    for (int i = 0; i < n; i = i + 1) {
+        if (i == 5 && !reset) {
+            reset = 1;
+            i = 0;
+        }
+        count = count + 1;
+    }
+    return count;
+}
+
+int skip_through_pointer(int n) {
+    int count = 0;
+    int i;
+    int *p = &i;
+    for (i = 0; i < n; i = i + 1) {
+        *p = *p + 1;
+        count = count + 1;
+    }
+    return count;
+}
+
+int skip_by_call(int n) {
+    int count = 0;
+    int i;
+    global_ptr = &i;
+    for (i = 0; i < n; i = i + 1) {
+        skip_next();
+        count = count + 1;
+    }
+    return count;
+}
+
+unsigned long skip_unsigned(unsigned long n) {
+    unsigned long count = 0ul;
+    for (unsigned long u = n; u > 0ul; u = u - 1ul) {
+        if (u % 5ul == 0ul) {
+            u = u - 1ul;
+        }
+        count = count + 1ul;
+    }
+    return count;
+}
+
+int main(void) {
+    if (skip_in_body(20) != 10) {
+        return 1;
+    }
+    if (skip_in_body(23) != 12) {
+        return 2;
+    }
+    if (skip_constant_trip() != 6) {
+        return 3;
+    }
+    if (reset_in_body(20) != 25) {
+        return 4;
+    }
+    if (skip_through_pointer(20) != 10) {
+        return 5;
+    }
+    if (skip_through_pointer(21) != 11) {
+        return 6;
+    }
+    if (skip_by_call(20) != 10) {
+        return 7;
+    }
+    if (skip_by_call(21) != 11) {
+        return 8;
+    }
+    if (skip_unsigned(20ul) != 16ul) {
+        return 9;
+    }
+    return 0;
+}
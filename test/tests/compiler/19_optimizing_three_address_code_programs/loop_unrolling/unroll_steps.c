@@ -0,0 +1,135 @@
+/* Test unrolled loops that count up and down with steps other than one, on
+ * signed and unsigned induction variables, with inclusive and exclusive
+ * bounds, including bounds next to the limits of the type, where the last
+ * unrolled copy of the body must not run past the bound */
+
+int count_down(int start, int bound, int *last) {
+    int count = 0;
+    for (int i = start; i > bound; i = i - 3) {
+        *last = i;
+        count = count + 1;
+    }
+    return count;
+}
+
+int count_down_inclusive_full(void) {
+    int sum = 0;
+    for (int i = 22; i >= 0; i = i - 4) {
+        sum = sum + i;
+    }
+    return sum;
+}
+
+int count_up_inclusive(int start, int bound) {
+    int count = 0;
+    for (int i = start; i <= bound; i = i + 2) {
+        count = count + 1;
+    }
+    return count;
+}
+
+long count_up_long(long start, long bound) {
+    long sum = 0l;
+    for (long i = start; i < bound; i = i + 7l) {
+        sum = sum + i;
+    }
+    return sum;
+}
+
+unsigned count_up_unsigned(unsigned start, unsigned bound) {
+    unsigned count = 0u;
+    for (unsigned u = start; u < bound; u = u + 5u) {
+        count = count + 1u;
+    }
+    return count;
+}
+
+unsigned count_down_unsigned(unsigned start, unsigned bound) {
+    unsigned count = 0u;
+    for (unsigned u = start; u >= bound; u = u - 3u) {
+        count = count + 1u;
+    }
+    return count;
+}
+
+unsigned long count_down_unsigned_long_full(void) {
+    unsigned long sum = 0ul;
+    for (unsigned long u = 100ul; u > 85ul; u = u - 2ul) {
+        sum = sum + (100ul - u);
+    }
+    return sum;
+}
+
+unsigned long count_down_unsigned_long_max(void) {
+    unsigned long sum = 0ul;
+    for (unsigned long u = 18446744073709551615ul; u > 18446744073709551600ul; u = u - 2ul) {
+        sum = sum + (18446744073709551615ul - u);
+    }
+    return sum;
+}
+
+int count_up_to_max(int start) {
+    int count = 0;
+    for (int i = start; i < 2147483647; i = i + 1) {
+        count = count + 1;
+    }
+    return count;
+}
+
+int count_down_to_min(int start, int bound) {
+    int count = 0;
+    for (int i = start; i > bound; i = i - 2) {
+        count = count + 1;
+    }
+    return count;
+}
+
+int main(void) {
+    int last = 0;
+    if (count_down(20, 0, &last) != 7 || last != 2) {
+        return 1;
+    }
+    if (count_down(5, -40, &last) != 15 || last != -37) {
+        return 2;
+    }
+    if (count_down(0, 0, &last) != 0) {
+        return 3;
+    }
+    if (count_down_inclusive_full() != 72) {
+        return 4;
+    }
+    if (count_up_inclusive(-5, 30) != 18) {
+        return 5;
+    }
+    if (count_up_inclusive(2147483630, 2147483645) != 8) {
+        return 6;
+    }
+    if (count_up_long(-100l, 100l) != -58l) {
+        return 7;
+    }
+    if (count_up_unsigned(0u, 100u) != 20u) {
+        return 8;
+    }
+    if (count_up_unsigned(4294967200u, 4294967295u) != 19u) {
+        return 9;
+    }
+    if (count_down_unsigned(100u, 2u) != 33u) {
+        return 10;
+    }
+    if (count_down_unsigned(4294967295u, 4294967200u) != 32u) {
+        return 11;
+    }
+    if (count_down_unsigned_long_full() != 0ul + 2ul + 4ul + 6ul + 8ul + 10ul + 12ul + 14ul) {
+        return 12;
+    }
+    if (count_down_unsigned_long_max() != 0ul + 2ul + 4ul + 6ul + 8ul + 10ul + 12ul + 14ul) {
+        return 13;
+    }
+    if (count_up_to_max(2147483600) != 47) {
+        return 14;
+    }
+    if (count_down_to_min(-2147483600, -2147483647 - 1) != 24) {
+        return 15;
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+/* Test a function call that makes more than 64 loads and pointer additions
+ * unavailable, so that the first word of the set of available loads is
+ * emptied before the next word is scanned. The first load of the next word
+ * must not be skipped, or the pointer addition of p[32] would be reused with
+ * the old value of p after the call */
+
+static long *p;
+static long a[40];
+static long b[40];
+
+void clobber(void) {
+    p = b;
+}
+
+long sum_before_and_after_call(void) {
+    long sum = 0l;
+    sum = sum + p[0];
+    sum = sum + p[1];
+    sum = sum + p[2];
+    sum = sum + p[3];
+    sum = sum + p[4];
+    sum = sum + p[5];
+    sum = sum + p[6];
+    sum = sum + p[7];
+    sum = sum + p[8];
+    sum = sum + p[9];
+    sum = sum + p[10];
+    sum = sum + p[11];
+    sum = sum + p[12];
+    sum = sum + p[13];
+    sum = sum + p[14];
+    sum = sum + p[15];
+    sum = sum + p[16];
+    sum = sum + p[17];
+    sum = sum + p[18];
+    sum = sum + p[19];
+    sum = sum + p[20];
+    sum = sum + p[21];
+    sum = sum + p[22];
+    sum = sum + p[23];
+    sum = sum + p[24];
+    sum = sum + p[25];
+    sum = sum + p[26];
+    sum = sum + p[27];
+    sum = sum + p[28];
+    sum = sum + p[29];
+    sum = sum + p[30];
+    sum = sum + p[31];
+    sum = sum + p[32];
+    clobber();
+    return sum + p[32];
+}
+
+int main(void) {
+    for (int i = 0; i < 40; i = i + 1) {
+        a[i] = i;
+        b[i] = 1000 + i;
+    }
+    p = a;
+    return sum_before_and_after_call() != 528l + 1032l;
+}
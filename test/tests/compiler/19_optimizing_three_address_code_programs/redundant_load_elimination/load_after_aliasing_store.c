@@ -0,0 +1,53 @@
+/* Test that a load is not replaced with the value of a previous load or store
+ * of another address when a store in between may write the same memory */
+
+struct s {
+    int a;
+    int b;
+};
+
+int reload_after_store(int *a, int *b) {
+    int x = *a;
+    *b = x + 1;  // a and b may point to the same int
+    return *a;
+}
+
+int reload_after_char_store(int *a, char *c) {
+    int x = *a;
+    *c = 0;  // a char store may write any object
+    return x - *a;
+}
+
+int reload_member_after_store(struct s *ptr, int *member) {
+    int x = ptr->a;
+    *member = 10;  // member may point to ptr->a
+    return x + ptr->a;
+}
+
+long forward_store(long *a, long *b) {
+    *a = 1l;
+    *b = 2l;  // may overwrite *a
+    return *a;
+}
+
+int main(void) {
+    int x = 5;
+    int y = 5;
+    if (reload_after_store(&x, &x) != 6 || reload_after_store(&x, &y) != 6 || y != 7) {
+        return 1;
+    }
+    x = 511;
+    if (reload_after_char_store(&x, (char *)&x) != 255) {
+        return 2;
+    }
+    struct s st = {1, 2};
+    if (reload_member_after_store(&st, &st.a) != 11 || reload_member_after_store(&st, &st.b) != 20) {
+        return 3;
+    }
+    long l1 = 0l;
+    long l2 = 0l;
+    if (forward_store(&l1, &l1) != 2l || forward_store(&l1, &l2) != 1l) {
+        return 4;
+    }
+    return 0;
+}
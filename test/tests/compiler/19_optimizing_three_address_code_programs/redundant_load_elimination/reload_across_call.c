@@ -0,0 +1,59 @@
+/* Test that a load is not replaced with the value of a previous load across a
+ * function call that may write the memory, through a pointer that escaped
+ * before the call or through a static pointer */
+
+static int *saved;
+static int *glob;
+
+void save(int *ptr) {
+    saved = ptr;
+}
+
+void write_saved(int value) {
+    *saved = value;
+}
+
+void write_glob(void) {
+    glob[1] = glob[1] * 2;
+}
+
+void no_write(void) {
+}
+
+int reload_escaped(void) {
+    int x = 1;
+    int *ptr = &x;
+    save(ptr);
+    int before = *ptr;
+    write_saved(2);
+    return before + *ptr;
+}
+
+int reload_static(void) {
+    int before = glob[1];
+    write_glob();
+    return before + glob[1];
+}
+
+int reload_not_escaped(void) {
+    int arr[2] = {3, 4};
+    int *ptr = arr;
+    int before = ptr[1];
+    no_write();
+    return before + ptr[1];
+}
+
+int main(void) {
+    int arr[3] = {1, 5, 1};
+    glob = arr;
+    if (reload_escaped() != 3) {
+        return 1;
+    }
+    if (reload_static() != 15 || arr[1] != 10) {
+        return 2;
+    }
+    if (reload_not_escaped() != 8) {
+        return 3;
+    }
+    return 0;
+}
@@ -0,0 +1,54 @@
+/* Test that a load inside a loop is not replaced with the value of a load
+ * from a previous iteration, or from before the loop, when the loop stores to
+ * memory that may be the same */
+
+long sum_and_bump(long *a, long *b, int n) {
+    long sum = *a;
+    for (int i = 0; i < n; i = i + 1) {
+        sum = sum + *a;
+        *b = *b + 1l;  // a and b may point to the same long
+    }
+    return sum;
+}
+
+int count_down(int *counter) {
+    int steps = 0;
+    while (*counter > 0) {
+        *counter = *counter - 1;
+        steps = steps + 1;
+    }
+    return steps;
+}
+
+double scan(double *arr, double *out, int n) {
+    double total = 0.0;
+    for (int i = 0; i < n; i = i + 1) {
+        total = total + arr[i] + *out;
+        *out = arr[i];
+    }
+    return total;
+}
+
+int main(void) {
+    long x = 1l;
+    long y = 1l;
+    if (sum_and_bump(&x, &x, 4) != 11l || x != 5l) {
+        return 1;
+    }
+    if (sum_and_bump(&x, &y, 4) != 25l || y != 5l) {
+        return 2;
+    }
+    int counter = 7;
+    if (count_down(&counter) != 7 || counter != 0) {
+        return 3;
+    }
+    double arr[4] = {1.0, 2.0, 3.0, 4.0};
+    double out = 0.5;
+    if (scan(arr, &out, 4) != 16.5 || out != 4.0) {
+        return 4;
+    }
+    if (scan(arr, arr + 1, 3) != 9.0 || arr[1] != 3.0) {
+        return 5;
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+/* Test local structures whose members overlap, like unions, nested structures
+ * that are also accessed as a whole, or arrays initialized from a string,
+ * which are read at the same offsets with different sizes and are not split */
+
+union u {
+    long l;
+    int i;
+    char c[8];
+};
+
+struct with_union {
+    union u u;
+    int x;
+};
+
+struct inner {
+    int a;
+    int b;
+};
+
+struct outer {
+    struct inner in;
+    long l;
+};
+
+struct string {
+    char s[8];
+    int n;
+};
+
+int flag(int n) {
+    return n;
+}
+
+int union_member(void) {
+    struct with_union w;
+    w.u.l = 0;
+    w.u.i = -1;
+    w.x = flag(5);
+    if (w.u.l != 4294967295l || w.u.c[3] != -1 || w.u.c[4] != 0) {
+        return 0;
+    }
+    w.u.c[7] = 1;
+    return w.u.l == 72057598332895231l && w.x == 5;
+}
+
+int nested_struct(void) {
+    struct outer o;
+    struct inner in;
+    in.a = 1;
+    in.b = 2;
+    o.in.a = 10;
+    o.in = in;
+    o.l = flag(3);
+    if (o.in.a != 1 || o.in.b != 2) {
+        return 0;
+    }
+    o.in.b = 20;
+    in = o.in;
+    return in.a == 1 && in.b == 20 && o.l == 3;
+}
+
+int string_init(void) {
+    struct string str = {"abcdefg", 3};
+    str.s[1] = 'x';
+    str.n = str.n + str.s[0];
+    return str.s[0] == 'a' && str.s[1] == 'x' && str.s[6] == 'g' && str.s[7] == 0 && str.n == 100;
+}
+
+int main(void) {
+    if (!union_member()) {
+        return 1;
+    }
+    if (!nested_struct()) {
+        return 2;
+    }
+    if (!string_init()) {
+        return 3;
+    }
+    return 0;
+}
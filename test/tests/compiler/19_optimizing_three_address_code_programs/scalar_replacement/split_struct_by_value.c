@@ -0,0 +1,97 @@
+/* Test local structures that are split into one variable per member, and are
+ * also passed by value to functions, returned, or are themselves parameters,
+ * which are loaded into their members when the function starts */
+
+struct pair {
+    int a;
+    int b;
+};
+
+struct mixed {
+    double d;
+    long l;
+    char c;
+};
+
+struct memory {
+    long l[3];
+};
+
+int sum_pair(struct pair p) {
+    return p.a + p.b;
+}
+
+// the parameter is split, and its members are modified
+struct pair swap_pair(struct pair p) {
+    int tmp = p.a;
+    p.a = p.b;
+    p.b = tmp;
+    return p;
+}
+
+double sum_mixed(struct mixed m) {
+    m.d = m.d + m.l;
+    return m.d + m.c;
+}
+
+struct mixed make_mixed(double d, long l, char c) {
+    struct mixed m;
+    m.d = d;
+    m.l = l;
+    m.c = c;
+    return m;
+}
+
+long sum_memory(struct memory m) {
+    m.l[0] = m.l[0] * 2;
+    return m.l[0] + m.l[1] + m.l[2];
+}
+
+struct memory make_memory(long a) {
+    struct memory m;
+    m.l[0] = a;
+    m.l[1] = a + 1;
+    m.l[2] = a + 2;
+    return m;
+}
+
+int main(void) {
+    struct pair p;
+    p.a = 1;
+    p.b = 2;
+    if (sum_pair(p) != 3) {
+        return 1;
+    }
+    // the members are updated between two calls
+    p.a = 10;
+    if (sum_pair(p) != 12) {
+        return 2;
+    }
+    p = swap_pair(p);
+    if (p.a != 2 || p.b != 10) {
+        return 3;
+    }
+    p.b = p.b + 1;
+    if (sum_pair(swap_pair(p)) != 13 || p.a != 2 || p.b != 11) {
+        return 4;
+    }
+
+    struct mixed m = make_mixed(1.5, 2l, 3);
+    if (sum_mixed(m) != 6.5 || m.d != 1.5) {
+        return 5;
+    }
+    m.c = m.c + 1;
+    if (sum_mixed(m) != 7.5) {
+        return 6;
+    }
+
+    struct memory mem = make_memory(5l);
+    if (sum_memory(mem) != 23l || mem.l[0] != 5l) {
+        return 7;
+    }
+    mem.l[2] = 0l;
+    if (sum_memory(mem) != 16l) {
+        return 8;
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+/* Test local structures that are split into one variable per member, and are
+ * also read or written as a whole by structure copies, loads and stores.
+ * The members must be stored back before the structure is read, and loaded
+ * again after it is written */
+
+struct s {
+    int a;
+    char b;
+    double c;
+    long *d;
+};
+
+// 64 bytes, the largest structure that is split
+struct big {
+    long l[7];
+    int i;
+};
+
+// 72 bytes, which is not split
+struct bigger {
+    long l[8];
+    int i;
+};
+
+int flag(int n) {
+    return n;
+}
+
+int copy_whole(void) {
+    long l = 10;
+    struct s x;
+    struct s y;
+    x.a = 1;
+    x.b = 2;
+    x.c = 3.5;
+    x.d = &l;
+    y = x;
+    x.a = 4;
+    if (y.a != 1 || y.b != 2 || y.c != 3.5 || *y.d != 10) {
+        return 0;
+    }
+    y.b = y.b + 5;
+    x = y;
+    if (x.a != 1 || x.b != 7 || x.c != 3.5 || x.d != &l) {
+        return 0;
+    }
+    // a member is written in a loop and the structure is read after it
+    for (int i = 0; i < 10; i = i + 1) {
+        x.a = x.a + i;
+        if (i == 5) {
+            y = x;
+        }
+    }
+    return x.a == 46 && y.a == 16 && y.b == 7;
+}
+
+int load_store(struct s *ptr) {
+    struct s x;
+    x.a = 1;
+    x.b = 2;
+    x.c = 3.0;
+    x.d = 0;
+    // store the whole structure, then overwrite it through the pointer
+    *ptr = x;
+    ptr->a = 10;
+    x.a = x.a + ptr->a;
+    if (x.a != 11 || ptr->b != 2) {
+        return 0;
+    }
+    // load the whole structure, then update its members
+    x = *ptr;
+    x.c = x.c * 2.0;
+    return x.a == 10 && x.b == 2 && x.c == 6.0 && x.d == 0 && ptr->c == 3.0;
+}
+
+int conditional_copy(int c) {
+    struct s x;
+    struct s y;
+    x.a = 1;
+    x.b = 2;
+    x.c = 3.0;
+    x.d = 0;
+    y.a = 5;
+    y.b = 6;
+    y.c = 7.0;
+    y.d = 0;
+    struct s z = c ? x : y;
+    z.a = z.a + 100;
+    return z.a + z.b + x.a + y.a;
+}
+
+int big_structs(void) {
+    struct big b;
+    struct bigger c;
+    for (int i = 0; i < 7; i = i + 1) {
+        b.l[i] = i;
+        c.l[i] = i * 2;
+    }
+    b.i = flag(3);
+    c.l[7] = 14;
+    c.i = flag(4);
+    struct big b2 = b;
+    struct bigger c2 = c;
+    b.i = 0;
+    c.i = 0;
+    long sum = 0;
+    for (int i = 0; i < 7; i = i + 1) {
+        sum = sum + b2.l[i] + c2.l[i];
+    }
+    return sum == 63 && b2.i == 3 && c2.i == 4 && c2.l[7] == 14 && b.i == 0 && c.i == 0;
+}
+
+int main(void) {
+    struct s other;
+    if (!copy_whole()) {
+        return 1;
+    }
+    if (!load_store(&other)) {
+        return 2;
+    }
+    if (conditional_copy(flag(1)) != 109 || conditional_copy(flag(0)) != 117) {
+        return 3;
+    }
+    if (!big_structs()) {
+        return 4;
+    }
+    return 0;
+}
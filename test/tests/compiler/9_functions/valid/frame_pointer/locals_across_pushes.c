@@ -0,0 +1,79 @@
+/* Test that locals are still read and written at the right addresses while
+ * the stack arguments of a call are pushed, and after they are deallocated.
+ * This matters most with --omit-frame-pointer, where locals are addressed from
+ * the stack pointer, which every push moves */
+
+struct big {
+    long a;
+    long b;
+    long c;
+};
+
+int even_stack_args(int a, int b, int c, int d, int e, int f, int g, int h) {
+    return a + 2 * b + 3 * c + 4 * d + 5 * e + 6 * f + 7 * g + 8 * h;
+}
+
+long odd_stack_args(long a, long b, long c, long d, long e, long f, long g, long h, long i) {
+    return a - b + c - d + e - f + g * 100 + h * 10 + i;
+}
+
+double double_stack_args(double a, double b, double c, double d, double e, double f, double g, double h, double i,
+    double j) {
+    return a + b + c + d + e + f + g + h + i * 10.0 + j * 100.0;
+}
+
+int pointer_stack_args(int *a, int *b, int *c, int *d, int *e, int *f, int *g, int *h) {
+    *g = *g + 1;
+    *h = *h + 2;
+    return *a + *b + *c + *d + *e + *f + *g + *h;
+}
+
+long struct_stack_arg(int a, struct big s, int b) {
+    return s.a * 100 + s.b * 10 + s.c + a + b;
+}
+
+int main(void) {
+    int i1 = 1;
+    int i2 = 2;
+    int i3 = 3;
+    int i4 = 4;
+    int i5 = 5;
+    int i6 = 6;
+    int i7 = 7;
+    int i8 = 8;
+    long l7 = 7l;
+    long l8 = 8l;
+    long l9 = 9l;
+    double d9 = 9.0;
+    double d10 = 10.0;
+    struct big s = {1l, 2l, 3l};
+
+    // the locals pushed last are read after the first pushes moved the stack pointer
+    if (even_stack_args(i1, i2, i3, i4, i5, i6, i7, i8) != 204) {
+        return 1;
+    }
+    // an odd number of stack arguments is padded to keep the stack aligned
+    if (odd_stack_args(1l, 2l, 3l, 4l, 5l, 6l, l7, l8, l9) != 786l) {
+        return 2;
+    }
+    if (double_stack_args(1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, d9, d10) != 1126.0) {
+        return 3;
+    }
+    // the addresses of locals are computed while other pointers are pushed
+    if (pointer_stack_args(&i1, &i2, &i3, &i4, &i5, &i6, &i7, &i8) != 39) {
+        return 4;
+    }
+    if (i7 != 8 || i8 != 10) {
+        return 5;
+    }
+    // a structure in memory is copied to the stack after the stack pointer moved
+    if (struct_stack_arg(i1, s, i2) != 126l) {
+        return 6;
+    }
+    // the locals are at the same addresses once the arguments are deallocated
+    if (i1 != 1 || i2 != 2 || i3 != 3 || i4 != 4 || i5 != 5 || i6 != 6 || l7 != 7l || l8 != 8l || l9 != 9l
+        || d9 != 9.0 || d10 != 10.0 || s.a != 1l || s.b != 2l || s.c != 3l) {
+        return 7;
+    }
+    return 0;
+}
@@ -0,0 +1,120 @@
+/* Test leaf functions whose locals fit in the red zone below the stack pointer,
+ * next to leaf functions whose locals do not fit, and check that the
+ * locals of their callers are not clobbered when they return.
+ * This matters most with --omit-frame-pointer, where leaf functions with up to
+ * 120 bytes of locals do not move the stack pointer at all */
+
+struct pair {
+    long a;
+    double b;
+};
+
+int small_leaf(int a, int b) {
+    int x = a * 3;
+    int y = b - a;
+    return x + y;
+}
+
+// an array whose address is taken also stays in the red zone
+int array_leaf(int n) {
+    int arr[6];
+    for (int i = 0; i < 6; i = i + 1) {
+        arr[i] = n + i;
+    }
+    return arr[0] + arr[5];
+}
+
+// 32 longs do not fit in the red zone, so the stack pointer is moved
+long big_leaf(long n) {
+    long arr[32];
+    for (int i = 0; i < 32; i = i + 1) {
+        arr[i] = n * i;
+    }
+    long sum = 0;
+    for (int i = 31; i >= 0; i = i - 1) {
+        sum = sum + arr[i];
+    }
+    return sum;
+}
+
+double struct_leaf(long a, double b) {
+    struct pair p;
+    struct pair q;
+    p.a = a;
+    p.b = b;
+    q = p;
+    q.a = q.a + 1;
+    return q.a + q.b + p.a;
+}
+
+int pointer_leaf(int n) {
+    int x = n;
+    int *ptr = &x;
+    char c = 3;
+    char *c_ptr = &c;
+    *ptr = *ptr + *c_ptr;
+    *c_ptr = 5;
+    return x * c;
+}
+
+// a leaf function that reads and writes its locals in the red zone in a loop
+unsigned long fib_leaf(unsigned int n) {
+    unsigned long prev = 0;
+    unsigned long curr = 1;
+    for (unsigned int i = 0; i < n; i = i + 1) {
+        unsigned long next = prev + curr;
+        prev = curr;
+        curr = next;
+    }
+    return prev;
+}
+
+// a function with a tail call is still a leaf function
+int tail_leaf(int a, int b) {
+    int x = a + b;
+    int y = a - b;
+    return small_leaf(x, y);
+}
+
+int check_caller(int n) {
+    int locals[4];
+    locals[0] = n;
+    locals[1] = n + 1;
+    locals[2] = n + 2;
+    locals[3] = n + 3;
+    int a = small_leaf(locals[0], locals[1]);
+    int b = array_leaf(locals[2]);
+    long c = big_leaf(locals[3]);
+    if (locals[0] != n || locals[1] != n + 1 || locals[2] != n + 2 || locals[3] != n + 3) {
+        return 0;
+    }
+    return a + b + (int)c;
+}
+
+int main(void) {
+    if (small_leaf(4, 10) != 18) {
+        return 1;
+    }
+    if (array_leaf(2) != 9) {
+        return 2;
+    }
+    if (big_leaf(3l) != 1488l) {
+        return 3;
+    }
+    if (struct_leaf(10l, 0.5) != 21.5) {
+        return 4;
+    }
+    if (pointer_leaf(4) != 35) {
+        return 5;
+    }
+    if (fib_leaf(50u) != 12586269025ul) {
+        return 6;
+    }
+    if (tail_leaf(7, 2) != 23) {
+        return 7;
+    }
+    if (check_caller(1) != 4 + 11 + 1984) {
+        return 8;
+    }
+    return 0;
+}
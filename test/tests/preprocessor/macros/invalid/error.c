@@ -0,0 +1,16 @@
+/* An #error directive in a group that is taken stops the compilation.
+ * */
+
+#define LEVEL 2
+
+#if LEVEL > 3
+#error level too high
+#endif
+
+#if LEVEL == 2
+#error level 2 is not supported
+#endif
+
+int main(void) {
+    return 0;
+}
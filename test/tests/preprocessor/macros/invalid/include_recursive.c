@@ -0,0 +1,9 @@
+/* A header that includes itself without #pragma once nor include guard is
+ * included until it is nested too deeply.
+ * */
+
+#include "include_recursive.c"
+
+int main(void) {
+    return 0;
+}
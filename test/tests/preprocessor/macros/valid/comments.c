@@ -0,0 +1,21 @@
+/* Comments in directives are replaced by a space, so a comment opened on a
+ * directive line continues the directive up to the end of the comment.
+ * */
+
+#define ONE 1 /* a comment
+ * that spans lines */
+#define TWO 2 /* a comment */ + /* a comment
+ that spans lines */ 0
+#define SLASHES "/*" // "*/"
+
+#if ONE /* a comment
+ */ == 1
+int x1 = ONE;
+#else
+int x1 = 0;
+#endif
+
+int main(void) {
+    char *slashes = SLASHES;
+    return x1 + TWO + (slashes[1] == '*');
+}
@@ -0,0 +1,63 @@
+/* Conditional directives evaluate integer arithmetic on macros, where unknown
+ * identifiers are 0 and unsigned operands convert the others to unsigned, and
+ * skip nested groups of branches that are not taken.
+ * */
+
+#define LEVEL 3
+#define ENABLED
+#define WIDTH (LEVEL * 8 + 1)
+
+#if LEVEL * 2 + 1 == 7 && WIDTH % 5 == 0
+int x1 = 1;
+#else
+int x1 = 0;
+#endif
+
+#if (1 << LEVEL) != 8 || ~0 != -1 || -LEVEL / 2 != -1 || (5 ^ 3) != 6 || (5 | 2) != 7 || (5 & 6) != 4
+int x2 = 0;
+#elif UNDEFINED_NAME
+int x2 = 0;
+#elif defined(ENABLED) && defined LEVEL && !defined(DISABLED)
+int x2 = 1;
+#else
+int x2 = 0;
+#endif
+
+#ifdef DISABLED
+#if this is never evaluated
+#error not reached
+#endif
+int x3 = 0;
+#elif LEVEL > 2 ? LEVEL >= 3 : 0
+int x3 = 1;
+#endif
+
+#ifndef ENABLED
+int x4 = 0;
+#else
+#if LEVEL < 3
+int x4 = 0;
+#elif LEVEL <= 3
+int x4 = 1;
+#endif
+#endif
+
+#if 0
+int x5 = 0;
+#elif 1
+#if 0
+int x5 = 0;
+#else
+int x5 = 1;
+#endif
+#endif
+
+#if -1 > 0u && (0u - 1) / 2 == 9223372036854775807 && -1 >> 63 == -1 && (LEVEL ? 1u : -1) - 2 > 0
+int x6 = 1;
+#else
+int x6 = 0;
+#endif
+
+int main(void) {
+    return x1 + x2 + x3 + x4 + x5 + x6;
+}
@@ -0,0 +1,41 @@
+/* Function-like macros substitute fully expanded arguments, which may hold
+ * commas inside parentheses, and are only invoked when followed by a '('.
+ * */
+
+int putchar(int c);
+
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#define SQUARE(x) ((x) * (x))
+#define CALL(f, args) f args
+#define FIRST(a, b) a
+#define NOARGS() 42
+#define APPLY(f, x) f(x)
+#define MIN_OF_3(a, b, c) (-MAX(-(a), MAX(-(b), -(c))))
+#define twice(x) ((x) * 2)
+
+int main(void) {
+    int x = 3;
+    int y = MAX(x, SQUARE(x - 1));
+    int z = CALL(MAX, (1, 2));
+    int w = FIRST(MAX(1, 2), 3);
+    int v = APPLY(SQUARE, x + 1);
+    int twice = 7;
+    putchar('a' + MIN_OF_3(7, 3, 5));
+    putchar('\n');
+    if (y != 4) {
+        return 1;
+    }
+    if (z != 2) {
+        return 2;
+    }
+    if (w != 2) {
+        return 3;
+    }
+    if (v != 16) {
+        return 4;
+    }
+    if (twice + twice(1) != 9) {
+        return 5;
+    }
+    return NOARGS();
+}
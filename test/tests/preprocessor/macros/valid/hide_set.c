@@ -0,0 +1,43 @@
+/* A macro is not expanded again inside its own expansion, even through other
+ * macros, so that self-referential macros terminate.
+ * */
+
+int foo = 1;
+int a = 2;
+int b = 3;
+
+static int f(int x) {
+    return x * 10;
+}
+
+#define foo (foo + 4)
+#define a b
+#define b a
+#define f(x) (x + f(x))
+#define g(x) f(x)
+#define h f
+
+int main(void) {
+    if (foo != 5) {
+        return 1;
+    }
+    if (a != 2) {
+        return 2;
+    }
+    if (b != 3) {
+        return 3;
+    }
+    if (f(1) != 11) {
+        return 4;
+    }
+    if (g(2) != 22) {
+        return 5;
+    }
+    if (h(3) != 33) {
+        return 6;
+    }
+    if (f(f(1)) != 121) {
+        return 7;
+    }
+    return 0;
+}
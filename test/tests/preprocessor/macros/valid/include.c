@@ -0,0 +1,18 @@
+/* With macro expansion, a header is included again every time, unless it is
+ * marked with #pragma once, even when it is included by another path, or it
+ * has an include guard.
+ * */
+
+#include "include/once.h"
+#include "include/guard.h"
+#include "include/../include/once.h"
+#include "include/guard.h"
+
+int main(void) {
+    int count = 0;
+#define STEP 1
+#include "include/reinclude.h"
+#include "include/reinclude.h"
+#include "include/reinclude.h"
+    return count + once + guard;
+}
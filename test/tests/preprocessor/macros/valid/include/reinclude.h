@@ -0,0 +1,3 @@
+count += STEP;
+#undef STEP
+#define STEP 2
@@ -0,0 +1,29 @@
+/* Object-like macros are expanded where they are used, so a macro can refer
+ * to another one that is only defined later, and an identical redefinition
+ * is allowed.
+ * */
+
+int puts(char* s);
+
+#define ZERO 0
+#define ONE (ZERO + 1)
+#define THREE (ONE + TWO)
+#define TWO (ONE + ONE)
+#define EMPTY
+#define GREETING "hello"
+#define TWO (ONE + ONE)
+#define TYPE unsigned long
+#define DECLARE TYPE counter = THREE;
+
+int main(void) {
+    DECLARE
+    TYPE local = THREE * TWO EMPTY;
+    puts(GREETING);
+    if (counter != 3ul) {
+        return 1;
+    }
+    if (local != 6ul) {
+        return 2;
+    }
+    return ONE + TWO + THREE;
+}
@@ -0,0 +1,39 @@
+/* The # operator turns an unexpanded argument into a string literal, and the
+ * ## operator pastes tokens before the result is rescanned.
+ * */
+
+int puts(char* s);
+
+#define STR(x) #x
+#define XSTR(x) STR(x)
+#define CAT(a, b) a##b
+#define XCAT(a, b) CAT(a, b)
+#define VALUE 17
+#define PREFIX var
+#define DECLARE(name, value) int CAT(var_, name) = value;
+
+DECLARE(one, 1)
+DECLARE(two, 2)
+
+int var12 = 12;
+int var17 = 170;
+
+int main(void) {
+    puts(STR(VALUE));
+    puts(XSTR(VALUE));
+    puts(STR(a + b));
+    puts(XSTR(CAT(x, y)));
+    if (CAT(var_, one) + CAT(var_, two) != 3) {
+        return 1;
+    }
+    if (CAT(1, 2) != 12) {
+        return 2;
+    }
+    if (XCAT(PREFIX, 12) != 12) {
+        return 3;
+    }
+    if (XCAT(var, VALUE) != 170) {
+        return 4;
+    }
+    return 0;
+}
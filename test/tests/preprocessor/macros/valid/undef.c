@@ -0,0 +1,23 @@
+/* A macro can be removed with #undef and then defined again with another body,
+ * and removing a name that is not a macro is allowed.
+ * */
+
+int main(void) {
+#define VALUE 1
+    int x1 = VALUE;
+#undef VALUE
+#undef NOT_A_MACRO
+
+#ifdef VALUE
+    int x2 = 0;
+#else
+    int x2 = 2;
+#endif
+
+#define VALUE(x) (x * 3)
+    int x3 = VALUE(3);
+#undef VALUE
+#define VALUE 4
+    int x4 = VALUE;
+    return x1 + x2 + x3 + x4;
+}